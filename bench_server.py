@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+"""
+Benchmark server for ESP32 load tests
+Run with: python bench_server.py [--port 8000] [--interval 5] [--verbose]
+
+A threaded HTTP/1.1 server with keep-alive that answers every request as
+fast as it can and prints one aggregate line per interval instead of a
+report per request. It accepts everything simple_server.py does: plain
+messages, binary Hello World records, batches and gzip/deflate bodies.
+
+Report lines are key=value pairs starting with "SERVER ", for scripts:
+  rps            requests per second
+  records_ps     records per second (batch records count one each)
+  in_Bps         request body bytes per second as received
+  decoded_Bps    request body bytes per second after Content-Encoding
+  errors         requests answered with 4xx
+  conns          connections opened in the interval
+  clients        distinct client addresses in the interval
+  p50_us/p99_us/max_us  server handling time per request
+"""
+
+import argparse
+import threading
+import time
+from http.server import ThreadingHTTPServer, BaseHTTPRequestHandler
+
+from simple_server import (HELLO_RECORD_CONTENT_TYPE, HELLO_RECORD_MAGIC,
+                           decode_content_encoding, decode_hello_record,
+                           format_hello_record, read_request_body,
+                           split_batch)
+
+
+class IntervalStats:
+    """Counters of the current report interval, shared by handler threads"""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.reset()
+
+    def reset(self):
+        self.requests = 0
+        self.records = 0
+        self.bytes_in = 0
+        self.bytes_decoded = 0
+        self.errors = 0
+        self.connections = 0
+        self.clients = set()
+        self.durations_us = []
+
+    def connection(self):
+        with self.lock:
+            self.connections += 1
+
+    def request(self, client, duration_us, bytes_in, bytes_decoded, records, error):
+        with self.lock:
+            self.requests += 1
+            self.records += records
+            self.bytes_in += bytes_in
+            self.bytes_decoded += bytes_decoded
+            self.errors += error
+            self.clients.add(client)
+            self.durations_us.append(duration_us)
+
+    def take(self):
+        """Return the finished interval and start a new one"""
+        with self.lock:
+            snapshot = (self.requests, self.records, self.bytes_in,
+                        self.bytes_decoded, self.errors, self.connections,
+                        len(self.clients), self.durations_us)
+            self.reset()
+        return snapshot
+
+
+STATS = IntervalStats()
+VERBOSE = False
+RESPONSE_BODY = b'OK\n'
+
+
+def percentile(sorted_values, pct):
+    if not sorted_values:
+        return 0
+    rank = max(1, -(-len(sorted_values) * pct // 100))
+    return sorted_values[rank - 1]
+
+
+def report_loop(interval):
+    started = time.monotonic()
+    last = started
+    while True:
+        time.sleep(interval)
+        now = time.monotonic()
+        elapsed = now - last
+        last = now
+        (requests, records, bytes_in, bytes_decoded, errors, connections,
+         clients, durations) = STATS.take()
+        durations.sort()
+        print(f"SERVER t={now - started:.0f} rps={requests / elapsed:.1f} "
+              f"records_ps={records / elapsed:.1f} "
+              f"in_Bps={bytes_in / elapsed:.0f} decoded_Bps={bytes_decoded / elapsed:.0f} "
+              f"errors={errors} conns={connections} clients={clients} "
+              f"p50_us={percentile(durations, 50):.0f} p99_us={percentile(durations, 99):.0f} "
+              f"max_us={durations[-1] if durations else 0:.0f}", flush=True)
+
+
+class BenchRequestHandler(BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'  # keep-alive unless the client says otherwise
+    disable_nagle_algorithm = True  # headers and body are separate writes
+
+    def setup(self):
+        super().setup()
+        STATS.connection()
+
+    def respond(self, status, body=b''):
+        self.send_response(status)
+        self.send_header('Content-Type', 'text/plain')
+        self.send_header('Content-Length', str(len(body)))
+        self.end_headers()
+        if body and self.command != 'HEAD':
+            self.wfile.write(body)
+
+    def count_records(self, body):
+        """Validate the body and return the number of records it carries"""
+        if 'X-ESP32-Batch-Records' in self.headers:
+            records = split_batch(body)
+            for record in records:
+                if record[:2] == HELLO_RECORD_MAGIC:
+                    decoded = decode_hello_record(record)
+                    if VERBOSE:
+                        print(f"   {format_hello_record(decoded)}")
+            return len(records)
+
+        if self.headers.get('Content-Type', '').startswith(HELLO_RECORD_CONTENT_TYPE):
+            decoded = decode_hello_record(body)
+            if VERBOSE:
+                print(f"   {format_hello_record(decoded)}")
+        return 1
+
+    def handle_body(self):
+        started = time.perf_counter()
+        body = b''
+        status, records = 200, 0
+
+        try:
+            try:
+                body = read_request_body(self.rfile, self.headers)
+            except ValueError:
+                # Bad length or chunk size: the rest of the stream cannot be framed
+                self.close_connection = True
+                raise
+            encoding = self.headers.get('Content-Encoding', '')
+            decoded = decode_content_encoding(body, encoding) if encoding else body
+            if decoded is None:
+                status, decoded = 415, b''
+            else:
+                records = self.count_records(decoded)
+        except ValueError as e:
+            if VERBOSE:
+                print(f"❌ {self.client_address[0]} {self.path}: {e}")
+            status, decoded = 400, b''
+        wire_length = len(body)
+
+        self.respond(status, RESPONSE_BODY if status == 200 else b'')
+        if VERBOSE:
+            print(f"{self.client_address[0]} {self.command} {self.path} "
+                  f"{status} {wire_length}B records={records}")
+        STATS.request(self.client_address[0], (time.perf_counter() - started) * 1e6,
+                      wire_length, len(decoded), records, status >= 400)
+
+    def do_POST(self):
+        self.handle_body()
+
+    def do_PUT(self):
+        self.handle_body()
+
+    def do_GET(self):
+        started = time.perf_counter()
+        self.respond(200, RESPONSE_BODY)
+        STATS.request(self.client_address[0], (time.perf_counter() - started) * 1e6,
+                      0, 0, 0, False)
+
+    def do_HEAD(self):
+        self.do_GET()
+
+    def log_message(self, format, *args):
+        pass
+
+
+def run_server():
+    global VERBOSE, RESPONSE_BODY
+
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('--port', type=int, default=8000)
+    parser.add_argument('--interval', type=float, default=5.0,
+                        help='seconds between report lines')
+    parser.add_argument('--response-size', type=int, default=len(RESPONSE_BODY),
+                        help='bytes in each 200 response body')
+    parser.add_argument('--verbose', action='store_true',
+                        help='print every request and decoded record')
+    args = parser.parse_args()
+
+    VERBOSE = args.verbose
+    if args.response_size != len(RESPONSE_BODY):
+        RESPONSE_BODY = b'x' * (args.response_size - 1) + b'\n' if args.response_size > 0 else b''
+
+    httpd = ThreadingHTTPServer(('', args.port), BenchRequestHandler)
+    httpd.daemon_threads = True
+    threading.Thread(target=report_loop, args=(args.interval,), daemon=True).start()
+
+    print(f"Benchmark server on port {args.port}, reporting every {args.interval:g} s", flush=True)
+    try:
+        httpd.serve_forever()
+    except KeyboardInterrupt:
+        print("Server stopped")
+        httpd.server_close()
+
+
+if __name__ == '__main__':
+    run_server()
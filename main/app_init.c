@@ -1,31 +1,46 @@
 /**
  * @file app_init.c
  * @brief Application Initialization Implementation
- * 
+ *
  * This module coordinates the initialization of all application
  * components in the correct order: system -> drivers -> tasks.
+ *
+ * Nothing here paces the application: once the tasks are started the
+ * WiFi task keeps the link up, the Hello World task schedules messages
+ * and the http_async worker sends them, waiting for the link if it is
+ * down.
  */
 
 #include "app_init.h"
+#include <string.h>
 #include "esp_log.h"
 #include "nvs_flash.h"
 #include "esp_netif.h"
 #include "esp_event.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 
-// Include driver interfaces (TODO: Uncomment when implemented)
-// #include "drivers/wifi_driver.h"
-// #include "drivers/http_driver.h"
+// Driver interfaces
+#include "drivers/http_driver.h"
+#include "drivers/wifi_driver.h"
 
-// Include task interfaces (TODO: Uncomment when implemented)  
-// #include "tasks/wifi_task.h"
-// #include "tasks/hello_world_task.h"
-
-// For now, use existing modules
-#include "esp32_http_client.h"
+// Task interfaces
+#include "tasks/wifi_task.h"
+#include "tasks/hello_world_task.h"
 #include "hello_world_app.h"
 
+// Services
+#include "boot_trace.h"
+#include "scheduler.h"
+#include "log_ring.h"
+#include "http_arena.h"
+#include "http_async.h"
+#include "http_link.h"
+#include "http_spool.h"
+#include "http_bench.h"
+#include "esp32_http_server.h"
+
 // Include configuration
-#include "config/credentials.h"
 #include "config/esp32-config.h"
 
 static const char *TAG = "APP_INIT";
@@ -35,10 +50,99 @@ static bool g_system_initialized = false;
 static bool g_drivers_initialized = false;
 static bool g_tasks_initialized = false;
 
+/**
+ * @brief Follow WiFi connection changes (runs in the WiFi task)
+ */
+static void on_wifi_change(wifi_status_t status, const wifi_info_t *info)
+{
+    bool up = (status == WIFI_STATUS_CONNECTED);
+
+    // Requests wait for the link instead of failing in connect while it is down
+    http_link_set_up(up);
+    if (up) {
+        ESP_LOGI(TAG, "Got IP: %s", info->ip_address);
+        if (http_spool_is_running()) {
+            // Messages spooled while offline go out now instead of at the next retry
+            http_spool_kick();
+        }
+    }
+}
+
+#if POWER_SAVE_ENABLE
+/**
+ * @brief Radio control for http_link: power save off for the length of a burst
+ */
+static void radio_control(bool awake, void *ctx)
+{
+    wifi_driver_set_radio_awake(awake);
+}
+#endif
+
+/**
+ * @brief Start the WiFi task
+ *
+ * Waiting is only to start the application online; with
+ * FAST_BOOT_ENABLE the tasks start while the radio associates and the
+ * first message waits for the link.
+ */
+static esp_err_t start_wifi(void)
+{
+    wifi_task_config_t wifi_config = WIFI_TASK_CONFIG_DEFAULT();
+    strncpy(wifi_config.ssid, WIFI_SSID, sizeof(wifi_config.ssid) - 1);
+    strncpy(wifi_config.password, WIFI_PASSWORD, sizeof(wifi_config.password) - 1);
+    wifi_config.max_retries = WIFI_MAX_RETRY;
+    wifi_config.reuse_lease = FAST_BOOT_ENABLE;
+#if POWER_SAVE_ENABLE
+    wifi_config.power_save = WIFI_PS_MAX_MODEM;
+    wifi_config.listen_interval = POWER_LISTEN_INTERVAL;
+    http_link_set_radio_control(radio_control, NULL);
+#endif
+
+    // Nothing can be sent until the first IP
+    http_link_set_up(false);
+    wifi_task_subscribe(on_wifi_change);
+
+    esp_err_t ret = wifi_task_start(&wifi_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "❌ Failed to start WiFi task: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+#if !FAST_BOOT_ENABLE
+    if (wifi_task_wait_connected(WIFI_CONNECT_TIMEOUT_MS) == ESP_OK) {
+        ESP_LOGI(TAG, "   ✅ Connected to WiFi SSID:%s", WIFI_SSID);
+    } else {
+        ESP_LOGW(TAG, "   ⚠️ Not connected to SSID:%s yet, starting anyway", WIFI_SSID);
+    }
+#endif
+    return ESP_OK;
+}
+
+#if HTTP_BENCH_ENABLE
+/**
+ * @brief Sweep body sizes and keep-alive against the configured server
+ */
+static void bench_task(void *pvParameters)
+{
+    static const size_t body_sizes[] = { 0, 256, 4096 };
+
+    http_bench_config_t bench_config = HTTP_BENCH_CONFIG_DEFAULT();
+    strcpy(bench_config.host, HTTP_SERVER_IP);
+    bench_config.port = HTTP_SERVER_PORT;
+    strcpy(bench_config.path, HTTP_BENCH_PATH);
+    bench_config.duration_ms = HTTP_BENCH_DURATION_MS;
+    bench_config.concurrency = HTTP_BENCH_CONCURRENCY;
+
+    http_bench_sweep(&bench_config, body_sizes, sizeof(body_sizes) / sizeof(body_sizes[0]));
+    ESP_LOGI(TAG, "🏁 Benchmark completed!");
+    vTaskDelete(NULL);
+}
+#endif
+
 esp_err_t app_init_system(void)
 {
     ESP_LOGI(TAG, "🔧 Initializing system services...");
-    
+
     // Initialize NVS
     esp_err_t ret = nvs_flash_init();
     if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
@@ -46,110 +150,185 @@ esp_err_t app_init_system(void)
         ret = nvs_flash_init();
     }
     ESP_ERROR_CHECK(ret);
+    boot_trace_mark(BOOT_PHASE_NVS_READY);
     ESP_LOGI(TAG, "   ✅ NVS initialized");
-    
+
+#if CONFIG_APP_LOG_RING_ENABLE
+    // Per-request lines of the client and the app are printed from here
+    log_ring_start(NULL);
+#endif
+
     // Initialize networking
     ESP_ERROR_CHECK(esp_netif_init());
     ESP_ERROR_CHECK(esp_event_loop_create_default());
     ESP_LOGI(TAG, "   ✅ Network stack initialized");
-    
+
     g_system_initialized = true;
     ESP_LOGI(TAG, "✅ System services initialized successfully");
-    
+
     return ESP_OK;
 }
 
 esp_err_t app_init_drivers(void)
 {
     ESP_LOGI(TAG, "🔧 Initializing hardware drivers...");
-    
+
     if (!g_system_initialized) {
         ESP_LOGE(TAG, "❌ System not initialized - call app_init_system() first");
         return ESP_ERR_INVALID_STATE;
     }
-    
-    // TODO: Replace with modular drivers when implemented
-    // For now, drivers are initialized within the existing modules
-    ESP_LOGI(TAG, "   ✅ Using existing integrated drivers");
-    
+
+#if HTTP_ARENA_ENABLE
+    // Before any client, so no request ever needs the heap for its buffers
+    http_arena_config_t arena_config = HTTP_ARENA_CONFIG_DEFAULT();
+    arena_config.slot_count = HTTP_ARENA_SLOTS;
+    arena_config.slot_size = HTTP_ARENA_SLOT_SIZE;
+    if (HTTP_ARENA_PSRAM) {
+        arena_config.caps = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+    }
+    if (http_arena_init(&arena_config) != ESP_OK) {
+        ESP_LOGW(TAG, "   ⚠️ Buffer arena not available, using the heap");
+    }
+#endif
+
+    // URL-based requests for any task; shares the connection pool with the app
+    http_client_config_t http_config = HTTP_CLIENT_CONFIG_DEFAULT();
+    http_config.timeout_ms = HTTP_TIMEOUT_MS;
+    http_config.retry.max_retries = HTTP_MAX_RETRIES;
+    http_config.enable_logging = false;
+    // Polled GETs cost a 304 instead of a body transfer while nothing changes
+    http_config.response_cache = true;
+    esp_err_t ret = http_driver_init(&http_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "❌ HTTP driver initialization failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    ESP_LOGI(TAG, "   ✅ HTTP driver initialized");
+
     g_drivers_initialized = true;
     ESP_LOGI(TAG, "✅ Hardware drivers initialized successfully");
-    
+
     return ESP_OK;
 }
 
 esp_err_t app_init_tasks(void)
 {
     ESP_LOGI(TAG, "🔧 Starting application tasks...");
-    
+
     if (!g_drivers_initialized) {
         ESP_LOGE(TAG, "❌ Drivers not initialized - call app_init_drivers() first");
         return ESP_ERR_INVALID_STATE;
     }
-    
-    // TODO: Replace with modular tasks when implemented
-    // For now, use existing Hello World application
-    
-    // Configure Hello World application using existing module
-    hello_world_config_t hello_config = HELLO_WORLD_CONFIG_DEFAULT();
+
+    esp_err_t ret = start_wifi();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+#if DEVICE_SERVER_ENABLE
+    http_server_config_t server_config = HTTP_SERVER_CONFIG_DEFAULT();
+    server_config.port = DEVICE_SERVER_PORT;
+    if (esp32_http_server_start(&server_config) == ESP_OK) {
+        ESP_LOGI(TAG, "   ✅ Device server listening on port %d", DEVICE_SERVER_PORT);
+    } else {
+        ESP_LOGW(TAG, "   ⚠️ Device server not started");
+    }
+#endif
+
+#if HTTP_BENCH_ENABLE
+    ESP_LOGI(TAG, "📏 Benchmark mode");
+    if (xTaskCreate(bench_task, "http_bench", 8192, NULL, 5, NULL) != pdPASS) {
+        return ESP_FAIL;
+    }
+#else
+    // Auto mode sends the first message at once, then every HTTP_MESSAGE_INTERVAL_MS
+    hello_world_task_config_t hello_config = HELLO_WORLD_TASK_CONFIG_DEFAULT();
     strncpy(hello_config.target_host, HTTP_SERVER_IP, sizeof(hello_config.target_host) - 1);
     hello_config.target_port = HTTP_SERVER_PORT;
     strncpy(hello_config.target_path, HTTP_ENDPOINT, sizeof(hello_config.target_path) - 1);
-    hello_config.include_system_info = true;
-    hello_config.include_random_data = true;
-    hello_config.message_interval_ms = 5000;
-    
-    esp_err_t ret = hello_world_app_init(&hello_config);
+    hello_config.message_interval_ms = HTTP_MESSAGE_INTERVAL_MS;
+    hello_config.message_jitter_ms = HTTP_MESSAGE_JITTER_MS;
+    hello_config.max_retries = HTTP_MAX_RETRIES;
+    hello_config.auto_mode = true;
+
+#if PIPELINE_ENABLE
+    // The pipeline samples on its own; the task stays for commands
+    hello_config.auto_mode = false;
+#endif
+
+    // Started here rather than by the task so the worker count comes from the config
+    http_async_config_t async_config = HTTP_ASYNC_CONFIG_DEFAULT();
+    async_config.workers = HTTP_ASYNC_WORKERS;
+    async_config.max_inflight_per_origin = HTTP_ASYNC_MAX_INFLIGHT;
+    ret = http_async_init(&async_config);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "❌ Hello World app initialization failed: %s", esp_err_to_name(ret));
+        ESP_LOGE(TAG, "❌ Async HTTP queue failed to start: %s", esp_err_to_name(ret));
         return ret;
     }
-    ESP_LOGI(TAG, "   ✅ Hello World application initialized");
-    
+
+    ret = hello_world_task_start(&hello_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "❌ Hello World task failed to start: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+#if POWER_SAVE_ENABLE
+    // Auto mode now feeds the batch; the radio wakes once per slot to empty it
+    http_batch_config_t batch_config = HTTP_BATCH_CONFIG_DEFAULT();
+    batch_config.wake_interval_ms = POWER_WAKE_INTERVAL_MS;
+    ret = hello_world_app_start_batching(&batch_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "❌ Batching failed to start: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    ESP_LOGI(TAG, "   🔋 Power-aware mode: radio wakes every %d ms", POWER_WAKE_INTERVAL_MS);
+#endif
+
+#if PIPELINE_ENABLE
+    http_pipeline_config_t pipeline_config = HTTP_PIPELINE_CONFIG_DEFAULT();
+    pipeline_config.sample_interval_ms = PIPELINE_SAMPLE_MS;
+    pipeline_config.ring_depth = PIPELINE_RING_DEPTH;
+    pipeline_config.batch_records = PIPELINE_BATCH_RECORDS;
+    pipeline_config.producer_core = PIPELINE_PRODUCER_CORE;
+    pipeline_config.transmitter_core = PIPELINE_TX_CORE;
+    ret = hello_world_app_start_pipeline(&pipeline_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "❌ Pipeline failed to start: %s", esp_err_to_name(ret));
+        return ret;
+    }
+#endif
+    boot_trace_mark(BOOT_PHASE_CLIENT_READY);
+    ESP_LOGI(TAG, "   ✅ Hello World task started");
+    ESP_LOGI(TAG, "🎯 Target: %s:%d%s every %d ms", HTTP_SERVER_IP, HTTP_SERVER_PORT, HTTP_ENDPOINT,
+             HTTP_MESSAGE_INTERVAL_MS);
+    ESP_LOGI(TAG, "💡 Make sure simple_server.py is running on your computer!");
+#endif
+
     g_tasks_initialized = true;
     ESP_LOGI(TAG, "✅ Application tasks started successfully");
-    
-    // Demonstrate the Hello World functionality
-    ESP_LOGI(TAG, "");
-    ESP_LOGI(TAG, "🎯 Target: %s:%d%s", HTTP_SERVER_IP, HTTP_SERVER_PORT, HTTP_ENDPOINT);
-    ESP_LOGI(TAG, "💡 Make sure simple_server.py is running on your computer!");
-    ESP_LOGI(TAG, "");
-    ESP_LOGI(TAG, "🚀 Starting Hello World demonstration...");
-    
-    // Send a few test messages using existing module
-    hello_world_app_send_message();
-    vTaskDelay(pdMS_TO_TICKS(2000));
-    hello_world_app_send_custom_message("Modular architecture test message! 🎉");
-    vTaskDelay(pdMS_TO_TICKS(2000));
-    hello_world_app_send_demo_sequence(3, 1500);
-    
-    ESP_LOGI(TAG, "");
-    ESP_LOGI(TAG, "✨ Demo completed! System is ready for operation.");
-    
+
     return ESP_OK;
 }
 
 esp_err_t app_init_all(void)
 {
     ESP_LOGI(TAG, "🚀 Starting complete application initialization...");
-    ESP_LOGI(TAG, "");
-    
+
     // Initialize in correct order
     esp_err_t ret;
-    
+
     // 1. System services
     ret = app_init_system();
     if (ret != ESP_OK) return ret;
-    
+
     // 2. Hardware drivers
     ret = app_init_drivers();
     if (ret != ESP_OK) return ret;
-    
+
     // 3. Application tasks
     ret = app_init_tasks();
     if (ret != ESP_OK) return ret;
-    
-    ESP_LOGI(TAG, "");
+
     ESP_LOGI(TAG, "🎉 Complete application initialization successful!");
     return ESP_OK;
 }
@@ -162,20 +341,39 @@ bool app_is_initialized(void)
 esp_err_t app_deinit_all(void)
 {
     ESP_LOGI(TAG, "🔄 Shutting down application...");
-    
+
     if (g_tasks_initialized) {
-        // TODO: Replace with modular task shutdown when implemented
-        hello_world_app_deinit();
+        if (hello_world_task_is_running()) {
+            hello_world_task_stop();
+        }
+        if (http_async_is_running()) {
+            http_async_deinit();
+        }
+        if (esp32_http_server_is_running()) {
+            esp32_http_server_stop();
+        }
+        if (wifi_task_is_running()) {
+            wifi_task_stop();
+        }
+        if (scheduler_is_running()) {
+            scheduler_deinit();
+        }
         g_tasks_initialized = false;
     }
-    
+
     if (g_drivers_initialized) {
-        // TODO: Replace with modular driver shutdown when implemented  
+        http_driver_deinit();
+#if HTTP_ARENA_ENABLE
+        http_arena_deinit();
+#endif
         g_drivers_initialized = false;
     }
-    
+
+#if CONFIG_APP_LOG_RING_ENABLE
+    log_ring_stop();
+#endif
     g_system_initialized = false;
-    
+
     ESP_LOGI(TAG, "✅ Application shutdown complete");
     return ESP_OK;
-}
\ No newline at end of file
+}
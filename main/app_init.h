@@ -21,9 +21,9 @@ extern "C" {
  * @brief Initialize all system components
  * 
  * This function initializes all system components in the correct order:
- * 1. Hardware drivers (WiFi, HTTP client)
- * 2. System services
- * 3. Application tasks
+ * 1. System services (NVS, log ring, network stack)
+ * 2. Drivers (buffer arena, HTTP driver)
+ * 3. Application tasks (WiFi, device server, Hello World)
  * 
  * @return ESP_OK on success, ESP_ERR_* on failure
  */
@@ -0,0 +1,73 @@
+/**
+ * @file boot_trace.c
+ * @brief Boot Phase Timestamps Implementation
+ */
+
+#include "boot_trace.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "BOOT_TRACE";
+
+static const char *const s_phase_names[BOOT_PHASE_COUNT] = {
+    "app_main",
+    "nvs ready",
+    "wifi started",
+    "associated",
+    "got ip",
+    "client ready",
+    "first request",
+    "first response",
+};
+
+static int64_t s_marks_us[BOOT_PHASE_COUNT];
+
+static portMUX_TYPE s_trace_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void boot_trace_mark(boot_phase_t phase)
+{
+    if (phase >= BOOT_PHASE_COUNT || s_marks_us[phase]) {
+        return;
+    }
+
+    int64_t now = esp_timer_get_time();
+    taskENTER_CRITICAL(&s_trace_lock);
+    if (!s_marks_us[phase]) {
+        s_marks_us[phase] = now;
+    }
+    taskEXIT_CRITICAL(&s_trace_lock);
+}
+
+int64_t boot_trace_get(boot_phase_t phase)
+{
+    if (phase >= BOOT_PHASE_COUNT) {
+        return 0;
+    }
+    return s_marks_us[phase];
+}
+
+void boot_trace_log(void)
+{
+    int64_t marks[BOOT_PHASE_COUNT];
+
+    taskENTER_CRITICAL(&s_trace_lock);
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+        marks[i] = s_marks_us[i];
+    }
+    taskEXIT_CRITICAL(&s_trace_lock);
+
+    ESP_LOGI(TAG, "Boot timeline (ms since startup):");
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+        if (marks[i]) {
+            ESP_LOGI(TAG, "   %-15s %6lld.%01lld", s_phase_names[i],
+                     (long long)(marks[i] / 1000), (long long)((marks[i] / 100) % 10));
+        } else {
+            ESP_LOGI(TAG, "   %-15s      -", s_phase_names[i]);
+        }
+    }
+
+    if (marks[BOOT_PHASE_FIRST_RESPONSE]) {
+        ESP_LOGI(TAG, "Boot to first byte: %lld ms", (long long)(marks[BOOT_PHASE_FIRST_RESPONSE] / 1000));
+    }
+}
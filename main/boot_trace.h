@@ -0,0 +1,64 @@
+/**
+ * @file boot_trace.h
+ * @brief Boot Phase Timestamps
+ *
+ * Records when each step from power-on to the first HTTP response was
+ * first reached, so boot-to-first-byte can be measured and compared
+ * between builds. Only the first mark of each phase counts; later marks
+ * cost one comparison.
+ *
+ * Times are esp_timer microseconds, which start shortly after the
+ * second stage bootloader hands over. ROM and bootloader time is not
+ * included.
+ */
+
+#ifndef BOOT_TRACE_H
+#define BOOT_TRACE_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Boot phases, in the order they are usually reached
+ */
+typedef enum {
+    BOOT_PHASE_APP_MAIN = 0,        /**< app_main() entered */
+    BOOT_PHASE_NVS_READY,           /**< NVS initialized */
+    BOOT_PHASE_WIFI_STARTED,        /**< WiFi radio started, first attempt issued */
+    BOOT_PHASE_WIFI_ASSOCIATED,     /**< Associated with the access point */
+    BOOT_PHASE_GOT_IP,              /**< IP address available */
+    BOOT_PHASE_CLIENT_READY,        /**< Application and HTTP client initialized */
+    BOOT_PHASE_FIRST_REQUEST,       /**< First request started connecting */
+    BOOT_PHASE_FIRST_RESPONSE,      /**< First response headers received */
+    BOOT_PHASE_COUNT
+} boot_phase_t;
+
+/**
+ * @brief Record that a phase was reached (first call per phase only)
+ *
+ * @param phase Phase reached
+ */
+void boot_trace_mark(boot_phase_t phase);
+
+/**
+ * @brief Get the time a phase was reached
+ *
+ * @param phase Phase
+ * @return Microseconds since startup, 0 if not reached yet
+ */
+int64_t boot_trace_get(boot_phase_t phase);
+
+/**
+ * @brief Log all phases reached so far, with the time since the previous one
+ */
+void boot_trace_log(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BOOT_TRACE_H
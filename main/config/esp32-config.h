@@ -45,9 +45,9 @@
 // WiFi Configuration
 // ============================================================================
 
-#define WIFI_MAX_RETRY          10
-#define WIFI_CONNECTED_BIT      BIT0
-#define WIFI_FAIL_BIT           BIT1
+#define WIFI_MAX_RETRY          10                // Failed attempts before falling back to a full scan
+#define WIFI_CONNECT_TIMEOUT_MS 15000             // How long the boot waits for the first IP
+#define FAST_BOOT_ENABLE        0                 // 1 = init the app while associating and reuse the last DHCP lease
 
 // ============================================================================
 // HTTP Configuration
@@ -57,7 +57,50 @@
 #define HTTP_SERVER_PORT        8000              // Python server port
 #define HTTP_ENDPOINT           "/hello"          // Hello World endpoint
 #define HTTP_TIMEOUT_MS         5000
+#define HTTP_MESSAGE_INTERVAL_MS 5000             // Time between hello world messages
+#define HTTP_MESSAGE_JITTER_MS  0                 // >0 = spread each message randomly over this much of the interval
 #define HTTP_MAX_RETRIES        3
+#define HTTP_ASYNC_WORKERS      1                 // >1 = requests in flight at once, each on its own connection
+#define HTTP_ASYNC_MAX_INFLIGHT 2                 // Requests in flight to one server with HTTP_ASYNC_WORKERS > 1
+#define HTTP_ARENA_ENABLE       1                 // 1 = preallocate per-request buffers at boot
+#define HTTP_ARENA_SLOTS        4                 // Response bodies and queued messages in flight
+#define HTTP_ARENA_SLOT_SIZE    2048
+#define HTTP_ARENA_PSRAM        0                 // 1 = place the slots in PSRAM (boards with PSRAM only)
+
+// ============================================================================
+// Pipeline Configuration
+// ============================================================================
+
+#define PIPELINE_ENABLE         0                 // 1 = sample records on a producer task, send in batches
+#define PIPELINE_SAMPLE_MS      1000              // Time between samples
+#define PIPELINE_RING_DEPTH     32                // Records buffered between producer and transmitter (power of two)
+#define PIPELINE_BATCH_RECORDS  16                // Records per POST
+#define PIPELINE_PRODUCER_CORE  HTTP_PIPELINE_PRODUCER_CORE     // Core 1 on dual-core chips, any on single-core
+#define PIPELINE_TX_CORE        HTTP_PIPELINE_TRANSMITTER_CORE  // Core 0 (WiFi/lwIP) on dual-core chips
+
+// ============================================================================
+// Power Configuration
+// ============================================================================
+
+#define POWER_SAVE_ENABLE       0                 // 1 = max modem sleep; messages batched, radio woken once per wake interval
+#define POWER_LISTEN_INTERVAL   10                // Beacon intervals (~102 ms) between radio wakes while idle
+#define POWER_WAKE_INTERVAL_MS  30000             // Time between flushes; keep below the server's keep-alive timeout
+
+// ============================================================================
+// Device Server Configuration
+// ============================================================================
+
+#define DEVICE_SERVER_ENABLE    1                 // 1 = serve /status on the device
+#define DEVICE_SERVER_PORT      80
+
+// ============================================================================
+// Benchmark Configuration
+// ============================================================================
+
+#define HTTP_BENCH_ENABLE       0                 // 1 = run the load generator instead of the demo
+#define HTTP_BENCH_PATH         "/bench"          // Endpoint of bench_server.py / simple_server.py
+#define HTTP_BENCH_DURATION_MS  10000             // Length of each run
+#define HTTP_BENCH_CONCURRENCY  2                 // Closed-loop workers
 
 #endif // ESP32_CONFIG_H
 
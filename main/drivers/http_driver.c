@@ -0,0 +1,224 @@
+/**
+ * @file http_driver.c
+ * @brief HTTP Client Driver Implementation
+ *
+ * Maps the URL-based driver API onto esp32_http_client_request_url().
+ * Extra headers are split into a copy on the stack, so a request costs
+ * no heap beyond what the client itself needs.
+ */
+
+#include "http_driver.h"
+#include <string.h>
+#include "esp_log.h"
+
+static const char *TAG = "HTTP_DRIVER";
+
+/**
+ * @brief Driver state
+ */
+static struct {
+    esp32_http_client_handle_t client;
+    bool initialized;
+} g_driver_state = {0};
+
+/**
+ * @brief Map a driver method onto the client's
+ */
+static http_client_method_t convert_method(http_driver_method_t method)
+{
+    switch (method) {
+        case HTTP_DRIVER_METHOD_GET:    return HTTP_CLIENT_METHOD_GET;
+        case HTTP_DRIVER_METHOD_POST:   return HTTP_CLIENT_METHOD_POST;
+        case HTTP_DRIVER_METHOD_PUT:    return HTTP_CLIENT_METHOD_PUT;
+        case HTTP_DRIVER_METHOD_DELETE: return HTTP_CLIENT_METHOD_DELETE;
+        case HTTP_DRIVER_METHOD_PATCH:  return HTTP_CLIENT_METHOD_PATCH;
+        case HTTP_DRIVER_METHOD_HEAD:   return HTTP_CLIENT_METHOD_HEAD;
+        default:                        return HTTP_CLIENT_METHOD_GET;
+    }
+}
+
+/**
+ * @brief Split "Key: Value" lines into headers pointing into buffer
+ *
+ * @return Number of headers, -1 if a line is malformed or there are too many
+ */
+static int parse_headers(char *buffer, http_client_header_t *headers)
+{
+    int count = 0;
+    char *line = buffer;
+
+    while (*line) {
+        char *end = line + strcspn(line, "\r\n");
+        char *next = end + strspn(end, "\r\n");
+        *end = '\0';
+
+        if (*line) {
+            char *colon = strchr(line, ':');
+            if (!colon || colon == line || count == HTTP_DRIVER_MAX_HEADERS) {
+                return -1;
+            }
+            *colon = '\0';
+            char *value = colon + 1;
+            value += strspn(value, " \t");
+
+            headers[count].key = line;
+            headers[count].value = value;
+            count++;
+        }
+        line = next;
+    }
+    return count;
+}
+
+esp_err_t http_driver_init(const http_client_config_t *config)
+{
+    if (g_driver_state.initialized) {
+        return ESP_OK;
+    }
+
+    http_client_config_t defaults = HTTP_CLIENT_CONFIG_DEFAULT();
+    if (!config) {
+        config = &defaults;
+    }
+
+    esp_err_t ret = esp32_http_client_create(config, &g_driver_state.client);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create client: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    g_driver_state.initialized = true;
+    ESP_LOGI(TAG, "HTTP driver initialized (timeout %d ms)", config->timeout_ms);
+    return ESP_OK;
+}
+
+esp_err_t http_driver_send_request(const http_request_t *request, http_response_t *response)
+{
+    if (!request || !request->url || !response) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_driver_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    char header_copy[HTTP_DRIVER_HEADERS_MAX_LEN];
+    http_client_header_t headers[HTTP_DRIVER_MAX_HEADERS];
+    int header_count = 0;
+    if (request->headers && request->headers[0]) {
+        size_t len = strlen(request->headers);
+        if (len >= sizeof(header_copy)) {
+            ESP_LOGE(TAG, "Headers longer than %d bytes", HTTP_DRIVER_HEADERS_MAX_LEN - 1);
+            return ESP_ERR_INVALID_ARG;
+        }
+        memcpy(header_copy, request->headers, len + 1);
+        header_count = parse_headers(header_copy, headers);
+        if (header_count < 0) {
+            ESP_LOGE(TAG, "Malformed headers or more than %d", HTTP_DRIVER_MAX_HEADERS);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    http_client_request_t client_request = {
+        .method = convert_method(request->method),
+        .content_type = request->content_type,
+        .body = request->body,
+        .body_length = request->body_length,
+        .headers = header_count > 0 ? headers : NULL,
+        .header_count = header_count,
+        .timeout_ms = request->timeout_ms,
+    };
+
+    http_client_response_t client_response;
+    esp_err_t ret = esp32_http_client_request_url(g_driver_state.client, request->url,
+                                                  &client_request, &client_response);
+
+    // Same layout, but the types are kept apart so the driver API stands alone
+    response->status_code = client_response.status_code;
+    response->body = client_response.body;
+    response->body_length = client_response.body_length;
+    response->content_length = client_response.content_length;
+    memcpy(response->content_type, client_response.content_type, sizeof(response->content_type));
+    return ret;
+}
+
+esp_err_t http_driver_get(const char *url, http_response_t *response)
+{
+    http_request_t request = {
+        .method = HTTP_DRIVER_METHOD_GET,
+        .url = url,
+    };
+    return http_driver_send_request(&request, response);
+}
+
+esp_err_t http_driver_post(const char *url, const char *content_type, const char *body, http_response_t *response)
+{
+    http_request_t request = {
+        .method = HTTP_DRIVER_METHOD_POST,
+        .url = url,
+        .content_type = content_type,
+        .body = body,
+    };
+    return http_driver_send_request(&request, response);
+}
+
+void http_driver_free_response(http_response_t *response)
+{
+    if (!response || !response->body) {
+        return;
+    }
+
+    http_client_response_t client_response = {
+        .body = response->body,
+        .body_length = response->body_length,
+    };
+    esp32_http_client_free_response(&client_response);
+    response->body = NULL;
+    response->body_length = 0;
+}
+
+esp_err_t http_driver_get_stats(http_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_driver_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    http_client_stats_t client_stats;
+    esp_err_t ret = esp32_http_client_handle_get_stats(g_driver_state.client, &client_stats);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    stats->requests_sent = client_stats.requests_sent;
+    stats->requests_failed = client_stats.requests_failed;
+    stats->bytes_sent = (uint32_t)client_stats.total_bytes_sent;
+    stats->bytes_received = (uint32_t)client_stats.total_bytes_received;
+    stats->last_request_time_ms = (uint32_t)client_stats.last_request_time_ms;
+    stats->last_status_code = client_stats.last_status_code;
+    return ESP_OK;
+}
+
+esp_err_t http_driver_reset_stats(void)
+{
+    if (!g_driver_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    return esp32_http_client_handle_reset_stats(g_driver_state.client);
+}
+
+esp_err_t http_driver_deinit(void)
+{
+    if (!g_driver_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp32_http_client_destroy(g_driver_state.client);
+    memset(&g_driver_state, 0, sizeof(g_driver_state));
+    ESP_LOGI(TAG, "HTTP driver deinitialized");
+    return ESP_OK;
+}
@@ -1,10 +1,16 @@
 /**
  * @file http_driver.h
  * @brief HTTP Client Driver Interface
- * 
+ *
  * This driver provides a clean interface for HTTP operations
  * without any FreeRTOS tasks. It handles HTTP requests and
  * responses in a synchronous manner.
+ *
+ * It is a thin layer over one esp32_http_client handle: requests go
+ * through the shared keep-alive connection pool, the DNS cache and the
+ * retry policy, and the driver itself allocates nothing. Response
+ * bodies come from the buffer arena when one is set up (http_arena.h).
+ * Requests may be sent from any task.
  */
 
 #ifndef HTTP_DRIVER_H
@@ -13,32 +19,41 @@
 #include "esp_err.h"
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include "esp32_http_client.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define HTTP_DRIVER_MAX_HEADERS 8       /**< Lines accepted in http_request_t.headers */
+#define HTTP_DRIVER_HEADERS_MAX_LEN 256 /**< Length of http_request_t.headers */
+
 /**
  * @brief HTTP method enumeration
+ *
+ * Prefixed so it does not clash with esp_http_client's HTTP_METHOD_*.
  */
 typedef enum {
-    HTTP_METHOD_GET = 0,
-    HTTP_METHOD_POST,
-    HTTP_METHOD_PUT,
-    HTTP_METHOD_DELETE,
-    HTTP_METHOD_PATCH
-} http_method_t;
+    HTTP_DRIVER_METHOD_GET = 0,
+    HTTP_DRIVER_METHOD_POST,
+    HTTP_DRIVER_METHOD_PUT,
+    HTTP_DRIVER_METHOD_DELETE,
+    HTTP_DRIVER_METHOD_PATCH,
+    HTTP_DRIVER_METHOD_HEAD
+} http_driver_method_t;
 
 /**
  * @brief HTTP request structure
  */
 typedef struct {
-    http_method_t method;
-    char *url;                  /**< Full URL (http://host:port/path) */
-    char *headers;              /**< Additional headers (optional) */
-    char *body;                 /**< Request body (for POST/PUT) */
+    http_driver_method_t method;
+    const char *url;            /**< Full URL (http[s]://host[:port]/path) */
+    const char *headers;        /**< Additional headers, "Key: Value" lines separated by CRLF (optional) */
+    const char *content_type;   /**< Content-Type header (optional) */
+    const char *body;           /**< Request body (for POST/PUT) */
     size_t body_length;         /**< Body length (0 = auto-calculate) */
-    int timeout_ms;             /**< Request timeout */
+    int timeout_ms;             /**< Request timeout (0 = driver default) */
 } http_request_t;
 
 /**
@@ -46,7 +61,7 @@ typedef struct {
  */
 typedef struct {
     int status_code;            /**< HTTP status code */
-    char *body;                 /**< Response body (caller must free) */
+    char *body;                 /**< Response body (release with http_driver_free_response()) */
     size_t body_length;         /**< Response body length */
     size_t content_length;      /**< Content-Length header value */
     char content_type[128];     /**< Content-Type header */
@@ -66,28 +81,30 @@ typedef struct {
 
 /**
  * @brief Initialize HTTP driver
- * 
- * Sets up HTTP client subsystem.
- * 
+ *
+ * Creates the client handle the driver sends through. host, port and
+ * path of the configuration are unused, every request names its URL.
+ *
+ * @param config Client configuration (NULL = defaults)
  * @return ESP_OK on success, ESP_ERR_* on failure
  */
-esp_err_t http_driver_init(void);
+esp_err_t http_driver_init(const http_client_config_t *config);
 
 /**
  * @brief Send HTTP request
- * 
+ *
  * Sends an HTTP request and returns the response.
  * This is a blocking operation.
- * 
+ *
  * @param request Pointer to request structure
  * @param response Pointer to response structure (will be filled)
- * @return ESP_OK on success, ESP_ERR_* on failure
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for malformed headers, ESP_ERR_* on failure
  */
 esp_err_t http_driver_send_request(const http_request_t *request, http_response_t *response);
 
 /**
  * @brief Send simple GET request
- * 
+ *
  * @param url Full URL
  * @param response Pointer to response structure
  * @return ESP_OK on success, ESP_ERR_* on failure
@@ -96,7 +113,7 @@ esp_err_t http_driver_get(const char *url, http_response_t *response);
 
 /**
  * @brief Send simple POST request
- * 
+ *
  * @param url Full URL
  * @param content_type Content-Type header
  * @param body Request body
@@ -107,16 +124,16 @@ esp_err_t http_driver_post(const char *url, const char *content_type, const char
 
 /**
  * @brief Free response resources
- * 
- * Call this to free memory allocated in response->body
- * 
+ *
+ * Call this to release response->body
+ *
  * @param response Pointer to response structure
  */
 void http_driver_free_response(http_response_t *response);
 
 /**
  * @brief Get HTTP statistics
- * 
+ *
  * @param stats Pointer to statistics structure
  * @return ESP_OK on success
  */
@@ -124,14 +141,14 @@ esp_err_t http_driver_get_stats(http_stats_t *stats);
 
 /**
  * @brief Reset HTTP statistics
- * 
+ *
  * @return ESP_OK on success
  */
 esp_err_t http_driver_reset_stats(void);
 
 /**
  * @brief Deinitialize HTTP driver
- * 
+ *
  * @return ESP_OK on success
  */
 esp_err_t http_driver_deinit(void);
@@ -140,4 +157,4 @@ esp_err_t http_driver_deinit(void);
 }
 #endif
 
-#endif // HTTP_DRIVER_H
\ No newline at end of file
+#endif // HTTP_DRIVER_H
@@ -0,0 +1,684 @@
+/**
+ * @file wifi_driver.c
+ * @brief WiFi Driver Implementation
+ */
+
+#include "wifi_driver.h"
+#include <string.h>
+#include <stdio.h>
+#include "esp_log.h"
+#include "esp_netif.h"
+#include "nvs.h"
+#include "boot_trace.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+
+static const char *TAG = "WIFI_DRIVER";
+
+#define CONNECTED_BIT BIT0
+
+#define NVS_NAMESPACE "wifi_drv"
+#define NVS_KEY_AP    "ap"
+#define NVS_KEY_LEASE "lease"
+
+/**
+ * @brief Access point remembered for the next connect
+ */
+typedef struct {
+    char ssid[33];
+    uint8_t bssid[6];
+    uint8_t channel;
+} cached_ap_t;
+
+/**
+ * @brief DHCP lease remembered for reuse without DHCP
+ */
+typedef struct {
+    char ssid[33];
+    esp_netif_ip_info_t ip_info;
+    esp_ip4_addr_t dns;
+} cached_lease_t;
+
+/**
+ * @brief Global driver state
+ */
+static struct {
+    esp_netif_t *netif;
+    EventGroupHandle_t events;
+    esp_event_handler_instance_t wifi_handler;
+    esp_event_handler_instance_t ip_handler;
+    wifi_event_callback_t callback;
+    wifi_status_t status;
+    wifi_info_t info;
+    char ssid[33];
+    char password[65];
+    cached_ap_t ap;                     /**< Valid if ap.channel != 0 */
+    bool using_cache;                   /**< Current attempt targets the cached access point */
+    bool own_disconnect;                /**< Next disconnect event was asked for by us */
+    bool reconnect_pending;             /**< Start an attempt once that event arrived */
+    bool use_static_ip;
+    bool reuse_lease;                   /**< Remember DHCP leases and apply the last one statically */
+    bool power_save_set;                /**< power_save chosen by the app (else the library default) */
+    wifi_ps_type_t power_save;
+    uint16_t listen_interval;           /**< Beacon intervals between wakes in max modem sleep (0 = default) */
+    bool radio_awake;                   /**< Power save suspended by wifi_driver_set_radio_awake() */
+    bool reusing_lease;                 /**< Static IP currently comes from a saved lease */
+    esp_netif_ip_info_t static_ip;
+    esp_ip4_addr_t static_dns;
+    bool started;
+    bool initialized;
+} g_wifi_state = {0};
+
+static portMUX_TYPE s_wifi_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Load the cached access point from NVS
+ */
+static void load_cached_ap(void)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return;
+    }
+
+    size_t size = sizeof(cached_ap_t);
+    if (nvs_get_blob(nvs, NVS_KEY_AP, &g_wifi_state.ap, &size) != ESP_OK || size != sizeof(cached_ap_t)) {
+        memset(&g_wifi_state.ap, 0, sizeof(cached_ap_t));
+    }
+    g_wifi_state.ap.ssid[sizeof(g_wifi_state.ap.ssid) - 1] = '\0';
+    nvs_close(nvs);
+}
+
+/**
+ * @brief Write the cached access point to NVS (empty = erase)
+ */
+static void store_cached_ap(void)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) {
+        return;
+    }
+
+    if (g_wifi_state.ap.channel) {
+        nvs_set_blob(nvs, NVS_KEY_AP, &g_wifi_state.ap, sizeof(cached_ap_t));
+    } else {
+        nvs_erase_key(nvs, NVS_KEY_AP);
+    }
+    nvs_commit(nvs);
+    nvs_close(nvs);
+}
+
+/**
+ * @brief Remember a DHCP lease for the next boot (written only if it changed)
+ */
+static void store_lease(const esp_netif_ip_info_t *ip_info)
+{
+    cached_lease_t lease = { 0 };
+    strncpy(lease.ssid, g_wifi_state.ssid, sizeof(lease.ssid) - 1);
+    lease.ip_info = *ip_info;
+
+    esp_netif_dns_info_t dns;
+    if (esp_netif_get_dns_info(g_wifi_state.netif, ESP_NETIF_DNS_MAIN, &dns) == ESP_OK) {
+        lease.dns = dns.ip.u_addr.ip4;
+    }
+
+    nvs_handle_t nvs;
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) {
+        return;
+    }
+
+    cached_lease_t stored = { 0 };
+    size_t size = sizeof(stored);
+    if (nvs_get_blob(nvs, NVS_KEY_LEASE, &stored, &size) != ESP_OK || memcmp(&stored, &lease, sizeof(lease)) != 0) {
+        nvs_set_blob(nvs, NVS_KEY_LEASE, &lease, sizeof(lease));
+        nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+}
+
+/**
+ * @brief Load the saved lease for the current network as a static IP
+ */
+static bool load_lease(void)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return false;
+    }
+
+    cached_lease_t lease = { 0 };
+    size_t size = sizeof(lease);
+    bool found = nvs_get_blob(nvs, NVS_KEY_LEASE, &lease, &size) == ESP_OK && size == sizeof(lease);
+    nvs_close(nvs);
+
+    lease.ssid[sizeof(lease.ssid) - 1] = '\0';
+    if (!found || lease.ip_info.ip.addr == 0 || strcmp(lease.ssid, g_wifi_state.ssid) != 0) {
+        return false;
+    }
+
+    g_wifi_state.static_ip = lease.ip_info;
+    g_wifi_state.static_dns = lease.dns.addr ? lease.dns : lease.ip_info.gw;
+    return true;
+}
+
+/**
+ * @brief Forget the saved lease and go back to DHCP
+ */
+static void drop_saved_lease(void)
+{
+    g_wifi_state.reusing_lease = false;
+    esp_netif_dhcpc_start(g_wifi_state.netif);
+
+    nvs_handle_t nvs;
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs) == ESP_OK) {
+        nvs_erase_key(nvs, NVS_KEY_LEASE);
+        nvs_commit(nvs);
+        nvs_close(nvs);
+    }
+}
+
+/**
+ * @brief Update status and info, then tell the callback
+ */
+static void set_status(wifi_status_t status)
+{
+    wifi_info_t info;
+
+    taskENTER_CRITICAL(&s_wifi_lock);
+    bool changed = g_wifi_state.status != status;
+    g_wifi_state.status = status;
+    g_wifi_state.info.is_connected = (status == WIFI_STATUS_CONNECTED);
+    if (!g_wifi_state.info.is_connected) {
+        g_wifi_state.info.ip_address[0] = '\0';
+        g_wifi_state.info.rssi = 0;
+    }
+    memcpy(&info, &g_wifi_state.info, sizeof(wifi_info_t));
+    taskEXIT_CRITICAL(&s_wifi_lock);
+
+    if (status == WIFI_STATUS_CONNECTED) {
+        xEventGroupSetBits(g_wifi_state.events, CONNECTED_BIT);
+    } else {
+        xEventGroupClearBits(g_wifi_state.events, CONNECTED_BIT);
+    }
+
+    if (changed && g_wifi_state.callback) {
+        g_wifi_state.callback(status, &info);
+    }
+}
+
+/**
+ * @brief Build the station configuration for the next attempt
+ */
+static esp_err_t apply_config(void)
+{
+    wifi_config_t wifi_config = {
+        .sta = {
+            .threshold.authmode = WIFI_AUTH_WPA2_PSK,
+            .sae_pwe_h2e = WPA3_SAE_PWE_BOTH,
+            .scan_method = WIFI_FAST_SCAN,
+        },
+    };
+    wifi_config.sta.listen_interval = g_wifi_state.listen_interval;
+    strncpy((char *)wifi_config.sta.ssid, g_wifi_state.ssid, sizeof(wifi_config.sta.ssid));
+    strncpy((char *)wifi_config.sta.password, g_wifi_state.password, sizeof(wifi_config.sta.password));
+    if (strlen(g_wifi_state.password) == 0) {
+        wifi_config.sta.threshold.authmode = WIFI_AUTH_OPEN;
+    }
+
+    g_wifi_state.using_cache = g_wifi_state.ap.channel != 0 &&
+                               strcmp(g_wifi_state.ap.ssid, g_wifi_state.ssid) == 0;
+    if (g_wifi_state.using_cache) {
+        // Probe only the channel and access point that worked last time
+        wifi_config.sta.bssid_set = true;
+        memcpy(wifi_config.sta.bssid, g_wifi_state.ap.bssid, sizeof(wifi_config.sta.bssid));
+        wifi_config.sta.channel = g_wifi_state.ap.channel;
+    }
+
+    // Setting the config again costs a flash write and recomputing the PMK; skip it if nothing changed
+    wifi_config_t current;
+    if (esp_wifi_get_config(WIFI_IF_STA, &current) == ESP_OK &&
+        memcmp(current.sta.ssid, wifi_config.sta.ssid, sizeof(current.sta.ssid)) == 0 &&
+        memcmp(current.sta.password, wifi_config.sta.password, sizeof(current.sta.password)) == 0 &&
+        current.sta.bssid_set == wifi_config.sta.bssid_set &&
+        memcmp(current.sta.bssid, wifi_config.sta.bssid, sizeof(current.sta.bssid)) == 0 &&
+        current.sta.channel == wifi_config.sta.channel &&
+        current.sta.listen_interval == wifi_config.sta.listen_interval &&
+        current.sta.threshold.authmode == wifi_config.sta.threshold.authmode) {
+        return ESP_OK;
+    }
+
+    return esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+}
+
+/**
+ * @brief Apply the power save mode in effect (WiFi started)
+ */
+static esp_err_t apply_power_save(void)
+{
+    if (!g_wifi_state.power_save_set) {
+        return ESP_OK;
+    }
+    return esp_wifi_set_ps(g_wifi_state.radio_awake ? WIFI_PS_NONE : g_wifi_state.power_save);
+}
+
+/**
+ * @brief Start an attempt with the stored credentials
+ */
+static esp_err_t start_attempt(void)
+{
+    esp_err_t ret = apply_config();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set WiFi config: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    set_status(WIFI_STATUS_CONNECTING);
+
+    if (!g_wifi_state.started) {
+        ret = esp_wifi_start();
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to start WiFi: %s", esp_err_to_name(ret));
+            set_status(WIFI_STATUS_FAILED);
+            return ret;
+        }
+        g_wifi_state.started = true;
+        apply_power_save();
+    }
+    boot_trace_mark(BOOT_PHASE_WIFI_STARTED);
+
+    ret = esp_wifi_connect();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to connect: %s", esp_err_to_name(ret));
+        set_status(WIFI_STATUS_FAILED);
+        return ret;
+    }
+
+    if (g_wifi_state.using_cache) {
+        ESP_LOGI(TAG, "Connecting to %s (cached AP on channel %d)", g_wifi_state.ssid, g_wifi_state.ap.channel);
+    } else {
+        ESP_LOGI(TAG, "Connecting to %s (scanning)", g_wifi_state.ssid);
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Put the static IP on the interface (DHCP client stopped)
+ */
+static void apply_static_ip(void)
+{
+    esp_err_t ret = esp_netif_dhcpc_stop(g_wifi_state.netif);
+    if (ret != ESP_OK && ret != ESP_ERR_ESP_NETIF_DHCP_ALREADY_STOPPED) {
+        ESP_LOGE(TAG, "Failed to stop DHCP client: %s", esp_err_to_name(ret));
+        return;
+    }
+
+    ret = esp_netif_set_ip_info(g_wifi_state.netif, &g_wifi_state.static_ip);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set static IP: %s", esp_err_to_name(ret));
+        return;
+    }
+
+    esp_netif_dns_info_t dns = { 0 };
+    dns.ip.type = ESP_IPADDR_TYPE_V4;
+    dns.ip.u_addr.ip4 = g_wifi_state.static_dns;
+    esp_netif_set_dns_info(g_wifi_state.netif, ESP_NETIF_DNS_MAIN, &dns);
+}
+
+/**
+ * @brief WiFi and IP event handler
+ */
+static void event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data)
+{
+    if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_CONNECTED) {
+        wifi_event_sta_connected_t *event = (wifi_event_sta_connected_t *)event_data;
+
+        taskENTER_CRITICAL(&s_wifi_lock);
+        size_t len = event->ssid_len < sizeof(g_wifi_state.info.ssid) ? event->ssid_len : sizeof(g_wifi_state.info.ssid) - 1;
+        memcpy(g_wifi_state.info.ssid, event->ssid, len);
+        g_wifi_state.info.ssid[len] = '\0';
+        g_wifi_state.info.channel = event->channel;
+        g_wifi_state.info.auth_mode = event->authmode;
+        taskEXIT_CRITICAL(&s_wifi_lock);
+
+        // Stored once the connection proves usable (got an IP)
+        memset(&g_wifi_state.ap, 0, sizeof(cached_ap_t));
+        strncpy(g_wifi_state.ap.ssid, g_wifi_state.ssid, sizeof(g_wifi_state.ap.ssid) - 1);
+        memcpy(g_wifi_state.ap.bssid, event->bssid, sizeof(g_wifi_state.ap.bssid));
+        g_wifi_state.ap.channel = event->channel;
+        g_wifi_state.using_cache = false;
+
+        ESP_LOGI(TAG, "Associated with " MACSTR " on channel %d", MAC2STR(event->bssid), event->channel);
+        boot_trace_mark(BOOT_PHASE_WIFI_ASSOCIATED);
+        if (g_wifi_state.use_static_ip || g_wifi_state.reusing_lease) {
+            apply_static_ip();
+        }
+
+    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
+        wifi_event_sta_disconnected_t *event = (wifi_event_sta_disconnected_t *)event_data;
+        bool was_connected = g_wifi_state.status == WIFI_STATUS_CONNECTED;
+
+        if (g_wifi_state.own_disconnect) {
+            g_wifi_state.own_disconnect = false;
+            if (g_wifi_state.reconnect_pending) {
+                g_wifi_state.reconnect_pending = false;
+                start_attempt();
+            }
+            return;
+        }
+
+        if (g_wifi_state.using_cache) {
+            // Cached access point not reachable: scan on the next attempt
+            ESP_LOGW(TAG, "Cached AP not reachable (reason %d), next attempt scans", event->reason);
+            memset(&g_wifi_state.ap, 0, sizeof(cached_ap_t));
+            g_wifi_state.using_cache = false;
+        } else {
+            ESP_LOGW(TAG, "Disconnected (reason %d)", event->reason);
+        }
+        if (g_wifi_state.reusing_lease && !was_connected) {
+            // The saved lease may be what is wrong; ask DHCP next time
+            ESP_LOGW(TAG, "Dropping saved lease, next attempt uses DHCP");
+            drop_saved_lease();
+        }
+        set_status(was_connected ? WIFI_STATUS_DISCONNECTED : WIFI_STATUS_FAILED);
+
+    } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
+        ip_event_got_ip_t *event = (ip_event_got_ip_t *)event_data;
+
+        taskENTER_CRITICAL(&s_wifi_lock);
+        snprintf(g_wifi_state.info.ip_address, sizeof(g_wifi_state.info.ip_address),
+                 IPSTR, IP2STR(&event->ip_info.ip));
+        taskEXIT_CRITICAL(&s_wifi_lock);
+        ESP_LOGI(TAG, "Got IP: " IPSTR "%s", IP2STR(&event->ip_info.ip),
+                 g_wifi_state.reusing_lease ? " (saved lease)" : "");
+        boot_trace_mark(BOOT_PHASE_GOT_IP);
+        if (g_wifi_state.reuse_lease && !g_wifi_state.use_static_ip) {
+            store_lease(&event->ip_info);
+        }
+
+        // Only write flash when the access point actually changed
+        cached_ap_t stored = { 0 };
+        nvs_handle_t nvs;
+        if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs) == ESP_OK) {
+            size_t size = sizeof(stored);
+            nvs_get_blob(nvs, NVS_KEY_AP, &stored, &size);
+            nvs_close(nvs);
+        }
+        if (memcmp(&stored, &g_wifi_state.ap, sizeof(cached_ap_t)) != 0) {
+            store_cached_ap();
+        }
+
+        set_status(WIFI_STATUS_CONNECTED);
+
+    } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_LOST_IP) {
+        // Still associated; DHCP keeps trying, but nothing can be sent meanwhile
+        ESP_LOGW(TAG, "Lost IP address");
+        if (g_wifi_state.status == WIFI_STATUS_CONNECTED) {
+            set_status(WIFI_STATUS_CONNECTING);
+        }
+    }
+}
+
+esp_err_t wifi_driver_init(void)
+{
+    if (g_wifi_state.initialized) {
+        ESP_LOGW(TAG, "WiFi driver already initialized");
+        return ESP_OK;
+    }
+
+    g_wifi_state.events = xEventGroupCreate();
+    if (!g_wifi_state.events) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    g_wifi_state.netif = esp_netif_create_default_wifi_sta();
+    if (!g_wifi_state.netif) {
+        ESP_LOGE(TAG, "Failed to create WiFi station interface");
+        vEventGroupDelete(g_wifi_state.events);
+        return ESP_FAIL;
+    }
+
+    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+    esp_err_t ret = esp_wifi_init(&cfg);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize WiFi: %s", esp_err_to_name(ret));
+        goto fail;
+    }
+
+    ret = esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &event_handler,
+                                              NULL, &g_wifi_state.wifi_handler);
+    if (ret == ESP_OK) {
+        ret = esp_event_handler_instance_register(IP_EVENT, ESP_EVENT_ANY_ID, &event_handler,
+                                                  NULL, &g_wifi_state.ip_handler);
+    }
+    if (ret == ESP_OK) {
+        ret = esp_wifi_set_mode(WIFI_MODE_STA);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set up WiFi: %s", esp_err_to_name(ret));
+        esp_wifi_deinit();
+        goto fail;
+    }
+
+    load_cached_ap();
+    g_wifi_state.status = WIFI_STATUS_DISCONNECTED;
+    g_wifi_state.initialized = true;
+
+    if (g_wifi_state.ap.channel) {
+        ESP_LOGI(TAG, "WiFi driver initialized (cached AP for %s on channel %d)",
+                 g_wifi_state.ap.ssid, g_wifi_state.ap.channel);
+    } else {
+        ESP_LOGI(TAG, "WiFi driver initialized");
+    }
+    return ESP_OK;
+
+fail:
+    if (g_wifi_state.wifi_handler) {
+        esp_event_handler_instance_unregister(WIFI_EVENT, ESP_EVENT_ANY_ID, g_wifi_state.wifi_handler);
+    }
+    if (g_wifi_state.ip_handler) {
+        esp_event_handler_instance_unregister(IP_EVENT, ESP_EVENT_ANY_ID, g_wifi_state.ip_handler);
+    }
+    esp_netif_destroy_default_wifi(g_wifi_state.netif);
+    vEventGroupDelete(g_wifi_state.events);
+    memset(&g_wifi_state, 0, sizeof(g_wifi_state));
+    return ret;
+}
+
+esp_err_t wifi_driver_connect(const char *ssid, const char *password, wifi_event_callback_t callback)
+{
+    if (!g_wifi_state.initialized) {
+        ESP_LOGE(TAG, "WiFi driver not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (!ssid || strlen(ssid) == 0 || strlen(ssid) >= sizeof(g_wifi_state.ssid) ||
+        (password && strlen(password) >= sizeof(g_wifi_state.password))) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    strcpy(g_wifi_state.ssid, ssid);
+    strcpy(g_wifi_state.password, password ? password : "");
+    g_wifi_state.callback = callback;
+
+    if (g_wifi_state.reuse_lease && !g_wifi_state.use_static_ip) {
+        g_wifi_state.reusing_lease = load_lease();
+    }
+
+    return start_attempt();
+}
+
+esp_err_t wifi_driver_reconnect(void)
+{
+    if (!g_wifi_state.initialized || strlen(g_wifi_state.ssid) == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (g_wifi_state.status == WIFI_STATUS_CONNECTED || g_wifi_state.status == WIFI_STATUS_CONNECTING) {
+        // Leave the current access point first; the attempt starts when that is done
+        g_wifi_state.own_disconnect = true;
+        g_wifi_state.reconnect_pending = true;
+        return esp_wifi_disconnect();
+    }
+    return start_attempt();
+}
+
+esp_err_t wifi_driver_set_static_ip(const char *ip, const char *gateway, const char *netmask, const char *dns)
+{
+    if (!ip) {
+        g_wifi_state.use_static_ip = false;
+        if (g_wifi_state.netif) {
+            esp_netif_dhcpc_start(g_wifi_state.netif);
+        }
+        ESP_LOGI(TAG, "Using DHCP");
+        return ESP_OK;
+    }
+
+    esp_netif_ip_info_t ip_info = { 0 };
+    esp_ip4_addr_t dns_addr = { 0 };
+    if (!gateway || !netmask ||
+        esp_netif_str_to_ip4(ip, &ip_info.ip) != ESP_OK ||
+        esp_netif_str_to_ip4(gateway, &ip_info.gw) != ESP_OK ||
+        esp_netif_str_to_ip4(netmask, &ip_info.netmask) != ESP_OK ||
+        esp_netif_str_to_ip4(dns ? dns : gateway, &dns_addr) != ESP_OK) {
+        ESP_LOGE(TAG, "Invalid static IP configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    g_wifi_state.static_ip = ip_info;
+    g_wifi_state.static_dns = dns_addr;
+    g_wifi_state.use_static_ip = true;
+
+    ESP_LOGI(TAG, "Using static IP %s (gateway %s)", ip, gateway);
+    return ESP_OK;
+}
+
+esp_err_t wifi_driver_set_lease_reuse(bool enable)
+{
+    g_wifi_state.reuse_lease = enable;
+    if (!enable && g_wifi_state.reusing_lease) {
+        drop_saved_lease();
+    }
+    return ESP_OK;
+}
+
+esp_err_t wifi_driver_set_power_save(wifi_ps_type_t mode, uint16_t listen_interval)
+{
+    g_wifi_state.power_save = mode;
+    g_wifi_state.listen_interval = listen_interval;
+    g_wifi_state.power_save_set = true;
+
+    const char *names[] = { "off", "min modem", "max modem" };
+    if (mode == WIFI_PS_MAX_MODEM) {
+        ESP_LOGI(TAG, "Power save: max modem, listen interval %u", listen_interval ? listen_interval : 3);
+    } else {
+        ESP_LOGI(TAG, "Power save: %s", names[mode]);
+    }
+
+    if (!g_wifi_state.started) {
+        return ESP_OK;
+    }
+    return apply_power_save();
+}
+
+esp_err_t wifi_driver_set_radio_awake(bool awake)
+{
+    if (!g_wifi_state.started) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    g_wifi_state.radio_awake = awake;
+    return apply_power_save();
+}
+
+esp_err_t wifi_driver_forget_ap(void)
+{
+    if (!g_wifi_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (g_wifi_state.ap.channel) {
+        ESP_LOGI(TAG, "Forgetting cached AP");
+        memset(&g_wifi_state.ap, 0, sizeof(cached_ap_t));
+        store_cached_ap();
+    }
+    return ESP_OK;
+}
+
+esp_err_t wifi_driver_disconnect(void)
+{
+    if (!g_wifi_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (g_wifi_state.status != WIFI_STATUS_CONNECTED && g_wifi_state.status != WIFI_STATUS_CONNECTING) {
+        return ESP_OK;
+    }
+
+    g_wifi_state.own_disconnect = true;
+    g_wifi_state.reconnect_pending = false;
+    esp_err_t ret = esp_wifi_disconnect();
+    set_status(WIFI_STATUS_DISCONNECTED);
+    return ret;
+}
+
+wifi_status_t wifi_driver_get_status(void)
+{
+    return g_wifi_state.status;
+}
+
+esp_err_t wifi_driver_get_info(wifi_info_t *info)
+{
+    if (!info) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_wifi_state.initialized || g_wifi_state.status != WIFI_STATUS_CONNECTED) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    taskENTER_CRITICAL(&s_wifi_lock);
+    memcpy(info, &g_wifi_state.info, sizeof(wifi_info_t));
+    taskEXIT_CRITICAL(&s_wifi_lock);
+
+    wifi_ap_record_t ap_info;
+    if (esp_wifi_sta_get_ap_info(&ap_info) == ESP_OK) {
+        info->rssi = ap_info.rssi;
+    }
+    return ESP_OK;
+}
+
+bool wifi_driver_is_connected(void)
+{
+    return g_wifi_state.status == WIFI_STATUS_CONNECTED;
+}
+
+esp_err_t wifi_driver_wait_connected(uint32_t timeout_ms)
+{
+    if (!g_wifi_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    EventBits_t bits = xEventGroupWaitBits(g_wifi_state.events, CONNECTED_BIT, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(timeout_ms));
+    return (bits & CONNECTED_BIT) ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+esp_err_t wifi_driver_deinit(void)
+{
+    if (!g_wifi_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_event_handler_instance_unregister(WIFI_EVENT, ESP_EVENT_ANY_ID, g_wifi_state.wifi_handler);
+    esp_event_handler_instance_unregister(IP_EVENT, ESP_EVENT_ANY_ID, g_wifi_state.ip_handler);
+    if (g_wifi_state.started) {
+        esp_wifi_stop();
+    }
+    esp_wifi_deinit();
+    esp_netif_destroy_default_wifi(g_wifi_state.netif);
+    vEventGroupDelete(g_wifi_state.events);
+
+    memset(&g_wifi_state, 0, sizeof(g_wifi_state));
+    ESP_LOGI(TAG, "WiFi driver deinitialized");
+    return ESP_OK;
+}
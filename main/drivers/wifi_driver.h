@@ -5,6 +5,27 @@
  * This driver provides a clean interface for WiFi operations
  * without any FreeRTOS tasks. It handles low-level WiFi setup
  * and connection management.
+ *
+ * Reconnects are kept short:
+ * - The BSSID and channel of the last access point that gave us an IP
+ *   are kept in NVS, so the next connect scans one channel instead of
+ *   all of them. If that access point is gone, the cache is dropped and
+ *   the following attempt scans normally.
+ * - With a static IP (wifi_driver_set_static_ip()) DHCP is skipped
+ *   entirely; otherwise CONFIG_LWIP_DHCP_RESTORE_LAST_IP lets DHCP ask
+ *   for the previous lease instead of starting with a discover.
+ * - With lease reuse (wifi_driver_set_lease_reuse()) the last DHCP lease
+ *   is applied as a static IP on the next boot, skipping DHCP as well.
+ * - Credentials and the AP are stored by the WiFi library in NVS and
+ *   only rewritten when they change, so the PMK is not recomputed.
+ *
+ * Power save: wifi_driver_set_power_save() picks the modem sleep mode.
+ * In max modem sleep the radio only wakes every listen_interval beacons,
+ * which costs latency on every packet, so wifi_driver_set_radio_awake()
+ * lifts power save for a burst of traffic and puts it back afterwards
+ * (see http_link_set_radio_control()).
+ *
+ * The driver never reconnects on its own; that is the WiFi task's job.
  */
 
 #ifndef WIFI_DRIVER_H
@@ -22,10 +43,10 @@ extern "C" {
  * @brief WiFi connection status
  */
 typedef enum {
-    WIFI_STATUS_DISCONNECTED = 0,
-    WIFI_STATUS_CONNECTING,
-    WIFI_STATUS_CONNECTED,
-    WIFI_STATUS_FAILED
+    WIFI_STATUS_DISCONNECTED = 0,   /**< Was connected, lost the access point */
+    WIFI_STATUS_CONNECTING,         /**< Attempt in progress, or associated and waiting for an IP */
+    WIFI_STATUS_CONNECTED,          /**< Associated and has an IP address */
+    WIFI_STATUS_FAILED              /**< Attempt ended before an IP was obtained */
 } wifi_status_t;
 
 /**
@@ -42,6 +63,8 @@ typedef struct {
 
 /**
  * @brief WiFi event callback function type
+ *
+ * Called from the event loop task on every status change; keep it short.
  */
 typedef void (*wifi_event_callback_t)(wifi_status_t status, const wifi_info_t *info);
 
@@ -49,7 +72,8 @@ typedef void (*wifi_event_callback_t)(wifi_status_t status, const wifi_info_t *i
  * @brief Initialize WiFi driver
  * 
  * Sets up WiFi hardware and registers event handlers.
- * Does not start connection process.
+ * Does not start connection process. NVS, esp_netif and the default
+ * event loop must be initialized before.
  * 
  * @return ESP_OK on success, ESP_ERR_* on failure
  */
@@ -68,6 +92,80 @@ esp_err_t wifi_driver_init(void);
  */
 esp_err_t wifi_driver_connect(const char *ssid, const char *password, wifi_event_callback_t callback);
 
+/**
+ * @brief Start another connection attempt with the last credentials
+ *
+ * Non-blocking, like wifi_driver_connect().
+ *
+ * @return ESP_OK if the attempt started, ESP_ERR_INVALID_STATE if never connected
+ */
+esp_err_t wifi_driver_reconnect(void);
+
+/**
+ * @brief Use a static IP instead of DHCP
+ *
+ * Takes effect from the next connection. Pass NULL as ip to go back to
+ * DHCP.
+ *
+ * @param ip Address, e.g. "192.168.1.50" (NULL = DHCP)
+ * @param gateway Gateway address
+ * @param netmask Network mask
+ * @param dns DNS server (NULL = gateway)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for malformed addresses
+ */
+esp_err_t wifi_driver_set_static_ip(const char *ip, const char *gateway, const char *netmask, const char *dns);
+
+/**
+ * @brief Reuse the last DHCP lease without asking DHCP
+ *
+ * The lease of the last boot on the same network is put on the
+ * interface as soon as it associates. If that attempt does not get
+ * connected, the lease is dropped and DHCP is used again. The lease is
+ * not renewed while in use, so only enable this where the address is
+ * reserved for the device or leases outlive its uptime.
+ *
+ * Call before wifi_driver_connect().
+ *
+ * @param enable true to reuse leases
+ * @return ESP_OK on success
+ */
+esp_err_t wifi_driver_set_lease_reuse(bool enable);
+
+/**
+ * @brief Choose the modem sleep mode
+ *
+ * Applied at once if WiFi is started. The listen interval takes effect
+ * from the next association. Without this call the library default
+ * (min modem sleep) is used.
+ *
+ * @param mode WIFI_PS_NONE, WIFI_PS_MIN_MODEM or WIFI_PS_MAX_MODEM
+ * @param listen_interval Beacon intervals between wakes in max modem sleep (0 = default of 3)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t wifi_driver_set_power_save(wifi_ps_type_t mode, uint16_t listen_interval);
+
+/**
+ * @brief Keep the radio awake, or let it sleep again
+ *
+ * While awake, power save is off; afterwards the mode chosen with
+ * wifi_driver_set_power_save() is restored. Does nothing without a
+ * chosen mode.
+ *
+ * @param awake true to suspend power save
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if WiFi is not started
+ */
+esp_err_t wifi_driver_set_radio_awake(bool awake);
+
+/**
+ * @brief Forget the cached access point
+ *
+ * The next attempt scans all channels. Use after repeated failures, or
+ * when the access point is known to have changed.
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t wifi_driver_forget_ap(void);
+
 /**
  * @brief Disconnect from WiFi
  * 
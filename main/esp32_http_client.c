@@ -3,40 +3,120 @@
  * @brief Generic ESP32 HTTP Client Implementation
  */
 
+// Before any include: levels above CONFIG_HTTP_CLIENT_LOG_LEVEL are compiled out
+#include "sdkconfig.h"
+#define LOG_LOCAL_LEVEL CONFIG_HTTP_CLIENT_LOG_LEVEL
+
 #include "esp32_http_client.h"
+#include "http_conn_pool.h"
+#include "http_deflate.h"
+#include "http_dns_cache.h"
+#include "http_retry.h"
+#include "http_link.h"
+#include "boot_trace.h"
+#include "metrics.h"
+#include "log_ring.h"
+#include "http_arena.h"
+#include "http_cache.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <strings.h>
 #include "esp_log.h"
 #include "esp_http_client.h"
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE
+#include "esp_crt_bundle.h"
+#endif
 
 static const char *TAG = "ESP32_HTTP_CLIENT";
 
 #define MAX_HEADERS 10
 #define MAX_HEADER_SIZE 256
+#define MAX_RESPONSE_BODY (64 * 1024)
+#define CHUNKED_BODY_INITIAL 512
+#define PRODUCER_BUFFER_SIZE 512
+#define HEADER_BLOCK_SIZE 512
+#define RETRY_AFTER_MAX_S 3600
 
 /**
- * @brief Custom header structure
+ * @brief Headers sent with every request of a handle, compiled once
+ *
+ * Keys and values are stored back to back as NUL-terminated strings,
+ * User-Agent first. Every change gets a new tag. Pooled connections keep
+ * the headers set between requests and remember the tag, so a request
+ * on a connection that already carries the current tag sets nothing.
  */
 typedef struct {
-    char key[64];
-    char value[192];
-} custom_header_t;
+    char data[HEADER_BLOCK_SIZE];       /**< key\0value\0 pairs */
+    size_t used;                        /**< Bytes of data in use */
+    size_t keys_size;                   /**< Size of the key list stored with a connection */
+    int count;                          /**< Entries, including the User-Agent */
+    uint32_t tag;                       /**< Identifies this version of the block */
+} header_block_t;
 
 /**
- * @brief Global client state
+ * @brief State of a request body compressed on the way out
  */
-static struct {
+typedef struct {
+    const http_client_request_t *source;    /**< Request carrying the original body */
+    size_t source_len;                      /**< Original body length (0 = until the producer ends) */
+    size_t offset;                          /**< Original body bytes consumed */
+    int64_t time_us;                        /**< Time spent compressing */
+} compress_ctx_t;
+
+/**
+ * @brief Client handle state
+ *
+ * Everything a request touches lives here, so handles owned by different
+ * tasks never share mutable state. Only the statistics and latency
+ * histograms can be read from other tasks and are guarded by a spinlock.
+ */
+struct esp32_http_client {
     http_client_config_t config;
     http_client_stats_t stats;
+    http_histogram_t latency[HTTP_PHASE_COUNT];
+    portMUX_TYPE stats_lock;
+    header_block_t headers;
+};
+
+/**
+ * @brief Global state for the legacy (handle-less) API
+ */
+static struct {
+    esp32_http_client_handle_t default_client;
     bool initialized;
-    custom_header_t custom_headers[MAX_HEADERS];
-    int header_count;
 } g_client_state = {0};
 
+/* Live handles; the connection pool is released with the last one */
+static int s_client_count = 0;
+static portMUX_TYPE s_count_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/* Last header block tag handed out; tags are never reused */
+static uint32_t s_header_tag = 0;
+
+/* Process-wide metrics, summed over every handle */
+static struct {
+    metrics_counter_t requests;
+    metrics_counter_t attempts_failed;
+    metrics_counter_t retries;
+    metrics_counter_t bytes_sent;
+    metrics_counter_t bytes_received;
+    metrics_counter_t connections_opened;
+    metrics_histogram_t duration;
+} g_client_metrics = {
+    .requests = METRICS_COUNTER_INIT("http_client_requests_total", "Requests that got a response"),
+    .attempts_failed = METRICS_COUNTER_INIT("http_client_attempts_failed_total",
+                                            "Attempts that failed, retried ones included"),
+    .retries = METRICS_COUNTER_INIT("http_client_retries_total", "Attempts repeated by the retry policy"),
+    .bytes_sent = METRICS_COUNTER_INIT("http_client_bytes_total{direction=\"sent\"}", "Bytes transferred"),
+    .bytes_received = METRICS_COUNTER_INIT("http_client_bytes_total{direction=\"received\"}", "Bytes transferred"),
+    .connections_opened = METRICS_COUNTER_INIT("http_client_connections_opened_total", "New connections"),
+    .duration = METRICS_HISTOGRAM_INIT("http_client_request_duration_seconds", "Whole request time"),
+};
+
 /**
  * @brief Convert method enum to ESP-IDF method
  */
@@ -53,49 +133,128 @@ static esp_http_client_method_t convert_method(http_client_method_t method)
     }
 }
 
+/**
+ * @brief Method name for log lines (static string)
+ */
+static const char *method_name(http_client_method_t method)
+{
+    static const char *const names[] = { "GET", "POST", "PUT", "DELETE", "HEAD", "PATCH" };
+    return (unsigned)method < sizeof(names) / sizeof(names[0]) ? names[method] : "REQUEST";
+}
+
+/**
+ * @brief Pass a slice of the response body to the request's sink
+ *
+ * The slice points into esp_http_client's receive buffer and is only
+ * valid for this call. After the sink fails the rest of the body is
+ * drained without being delivered.
+ */
+static void deliver_to_sink(http_client_stream_t *stream, const char *data, size_t len)
+{
+    if (stream->sink_err != ESP_OK) {
+        return;
+    }
+
+    stream->bytes_read += len;
+    stream->delta.total_bytes_received += len;
+    if (len > stream->peak_buffered) {
+        stream->peak_buffered = len;
+    }
+
+    stream->sink_err = stream->sink(data, len, stream->sink_ctx);
+}
+
 /**
  * @brief HTTP event handler
  */
 static esp_err_t http_event_handler(esp_http_client_event_t *evt)
 {
+    http_client_stream_t *ctx = (http_client_stream_t *)evt->user_data;
+    // Constant false unless debug output is compiled in, so every check below folds away
+    bool logging = LOG_LOCAL_LEVEL >= ESP_LOG_DEBUG && ctx && ctx->owner->config.enable_logging;
+
     switch(evt->event_id) {
         case HTTP_EVENT_ERROR:
-            if (g_client_state.config.enable_logging) {
+            if (logging) {
                 ESP_LOGD(TAG, "HTTP_EVENT_ERROR");
             }
             break;
         case HTTP_EVENT_ON_CONNECTED:
-            if (g_client_state.config.enable_logging) {
+            if (ctx) {
+                ctx->connected = true;
+                ctx->connected_us = esp_timer_get_time();
+            }
+            if (logging) {
                 ESP_LOGD(TAG, "HTTP_EVENT_ON_CONNECTED");
             }
             break;
         case HTTP_EVENT_HEADER_SENT:
-            if (g_client_state.config.enable_logging) {
+            if (logging) {
                 ESP_LOGD(TAG, "HTTP_EVENT_HEADER_SENT");
             }
             break;
         case HTTP_EVENT_ON_HEADER:
-            if (g_client_state.config.enable_logging) {
+            if (ctx) {
+                if (ctx->first_header_us == 0) {
+                    ctx->first_header_us = esp_timer_get_time();
+                }
+                // Response headers are only visible here; get_header() reads request headers
+                if (strcasecmp(evt->header_key, "Connection") == 0 &&
+                    strcasecmp(evt->header_value, "close") == 0) {
+                    ctx->server_close = true;
+                } else if (strcasecmp(evt->header_key, "Content-Length") == 0 ||
+                           strcasecmp(evt->header_key, "Transfer-Encoding") == 0) {
+                    ctx->framed = true;
+                } else if (strcasecmp(evt->header_key, "Retry-After") == 0) {
+                    // Only the delay-seconds form; an HTTP date leaves the backoff alone
+                    char *end;
+                    long seconds = strtol(evt->header_value, &end, 10);
+                    if (end != evt->header_value && seconds >= 0) {
+                        ctx->retry_after_ms = (seconds < RETRY_AFTER_MAX_S ? seconds : RETRY_AFTER_MAX_S) * 1000;
+                    }
+                } else if (strcasecmp(evt->header_key, "Content-Type") == 0 && ctx->response) {
+                    strncpy(ctx->response->content_type, evt->header_value, sizeof(ctx->response->content_type) - 1);
+                    ctx->response->content_type[sizeof(ctx->response->content_type) - 1] = '\0';
+                } else if (strcasecmp(evt->header_key, "ETag") == 0 && ctx->response) {
+                    // A truncated validator would never match; too long means none
+                    if (strlen(evt->header_value) < sizeof(ctx->response->etag)) {
+                        strcpy(ctx->response->etag, evt->header_value);
+                    }
+                } else if (strcasecmp(evt->header_key, "Last-Modified") == 0 && ctx->response) {
+                    if (strlen(evt->header_value) < sizeof(ctx->response->last_modified)) {
+                        strcpy(ctx->response->last_modified, evt->header_value);
+                    }
+                } else if (strcasecmp(evt->header_key, "Cache-Control") == 0 && ctx->response) {
+                    // Directives are case-insensitive but sent in lower case in practice
+                    if (strstr(evt->header_value, "no-store")) {
+                        ctx->response->no_store = true;
+                    }
+                }
+            }
+            if (logging) {
                 ESP_LOGD(TAG, "HTTP_EVENT_ON_HEADER, key=%s, value=%s", evt->header_key, evt->header_value);
             }
             break;
         case HTTP_EVENT_ON_DATA:
-            if (g_client_state.config.enable_logging) {
+            if (ctx && ctx->sink) {
+                deliver_to_sink(ctx, (const char *)evt->data, evt->data_len);
+            }
+            if (logging) {
                 ESP_LOGD(TAG, "HTTP_EVENT_ON_DATA, len=%d", evt->data_len);
             }
             break;
         case HTTP_EVENT_ON_FINISH:
-            if (g_client_state.config.enable_logging) {
+            if (logging) {
                 ESP_LOGD(TAG, "HTTP_EVENT_ON_FINISH");
             }
             break;
         case HTTP_EVENT_DISCONNECTED:
-            if (g_client_state.config.enable_logging) {
+            if (logging) {
                 ESP_LOGD(TAG, "HTTP_EVENT_DISCONNECTED");
             }
             break;
         case HTTP_EVENT_REDIRECT:
-            if (g_client_state.config.enable_logging) {
+            if (logging) {
                 ESP_LOGD(TAG, "HTTP_EVENT_REDIRECT");
             }
             break;
@@ -103,7 +262,10 @@ static esp_err_t http_event_handler(esp_http_client_event_t *evt)
     return ESP_OK;
 }
 
-esp_err_t esp32_http_client_init(const http_client_config_t *config)
+/**
+ * @brief Validate a client configuration
+ */
+static esp_err_t validate_config(const http_client_config_t *config)
 {
     if (!config) {
         ESP_LOGE(TAG, "Configuration cannot be NULL");
@@ -120,320 +282,1849 @@ esp_err_t esp32_http_client_init(const http_client_config_t *config)
         return ESP_ERR_INVALID_ARG;
     }
 
-    // Copy configuration
-    memcpy(&g_client_state.config, config, sizeof(http_client_config_t));
-    
-    // Initialize statistics
-    memset(&g_client_state.stats, 0, sizeof(http_client_stats_t));
-    
-    // Initialize headers
-    memset(g_client_state.custom_headers, 0, sizeof(g_client_state.custom_headers));
-    g_client_state.header_count = 0;
-    
-    g_client_state.initialized = true;
+    if (config->retry.max_retries < 0 || config->retry.base_delay_ms < 0 || config->retry.max_delay_ms < 0) {
+        ESP_LOGE(TAG, "Invalid retry policy");
+        return ESP_ERR_INVALID_ARG;
+    }
 
-    ESP_LOGI(TAG, "HTTP Client initialized");
-    ESP_LOGI(TAG, "Target: %s:%d", config->host, config->port);
-    ESP_LOGI(TAG, "Default path: %s", config->path);
-    ESP_LOGI(TAG, "Timeout: %d ms", config->timeout_ms);
+    if (config->use_tls && !config->cert_pem) {
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE
+        if (!config->use_crt_bundle) {
+            ESP_LOGE(TAG, "HTTPS needs cert_pem or use_crt_bundle");
+            return ESP_ERR_INVALID_ARG;
+        }
+#else
+        ESP_LOGE(TAG, "HTTPS needs cert_pem (certificate bundle not enabled)");
+        return ESP_ERR_INVALID_ARG;
+#endif
+    }
 
     return ESP_OK;
 }
 
-esp_err_t esp32_http_client_send_request(const http_client_request_t *request, http_client_response_t *response)
+/**
+ * @brief Check whether connections of a handle save their TLS session
+ */
+static bool tls_resume_enabled(const http_client_config_t *config)
 {
-    if (!g_client_state.initialized) {
-        ESP_LOGE(TAG, "Client not initialized");
-        return ESP_ERR_INVALID_STATE;
-    }
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+    return config->tls_resume;
+#else
+    return false;
+#endif
+}
 
-    if (!request || !response) {
-        ESP_LOGE(TAG, "Request and response cannot be NULL");
-        return ESP_ERR_INVALID_ARG;
+/**
+ * @brief Add a handle's TLS settings to the template of a pooled handle
+ */
+static void apply_tls_config(const http_client_config_t *config, esp_http_client_config_t *client_config)
+{
+    if (config->cert_pem) {
+        client_config->cert_pem = config->cert_pem;
+    } else if (config->use_crt_bundle) {
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE
+        client_config->crt_bundle_attach = esp_crt_bundle_attach;
+#endif
     }
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+    // The transport keeps the session from the last handshake and offers it on the next connect
+    client_config->save_client_session = config->tls_resume;
+#endif
+}
 
-    // Initialize response
-    memset(response, 0, sizeof(http_client_response_t));
-
-    // Configure HTTP client
-    esp_http_client_config_t client_config = {
-        .host = g_client_state.config.host,
-        .port = g_client_state.config.port,
-        .path = g_client_state.config.path,
-        .method = convert_method(request->method),
-        .timeout_ms = g_client_state.config.timeout_ms,
-        .event_handler = http_event_handler,
-    };
-    
-    esp_http_client_handle_t client = esp_http_client_init(&client_config);
-    if (!client) {
-        ESP_LOGE(TAG, "Failed to initialize HTTP client");
-        g_client_state.stats.requests_failed++;
-        return ESP_FAIL;
-    }
+/**
+ * @brief Work out how long each phase of a finished request took
+ *
+ * @return Bit mask of the phases that were measured
+ */
+static uint32_t measure_phases(const http_client_stream_t *stream, uint32_t phase_us[HTTP_PHASE_COUNT])
+{
+    uint32_t measured = 0;
+    int64_t now = esp_timer_get_time();
+    int64_t send_start = stream->connected_us ? stream->connected_us : stream->attempt_us;
+    int64_t first_byte = stream->first_header_us ? stream->first_header_us : stream->headers_us;
 
-    // Set headers
-    esp_http_client_set_header(client, "User-Agent", g_client_state.config.user_agent);
-    
-    if (request->content_type) {
-        esp_http_client_set_header(client, "Content-Type", request->content_type);
+    if (stream->connected_us) {
+        phase_us[HTTP_PHASE_CONNECT] = stream->connected_us - stream->attempt_us;
+        measured |= 1 << HTTP_PHASE_CONNECT;
     }
+    phase_us[HTTP_PHASE_SEND] = stream->sent_us - send_start;
+    phase_us[HTTP_PHASE_TTFB] = first_byte - stream->sent_us;
+    measured |= (1 << HTTP_PHASE_SEND) | (1 << HTTP_PHASE_TTFB);
 
-    // Add custom headers
-    for (int i = 0; i < g_client_state.header_count; i++) {
-        esp_http_client_set_header(client, 
-                                   g_client_state.custom_headers[i].key,
-                                   g_client_state.custom_headers[i].value);
+    // A body left unread says nothing about transfer time
+    if (stream->complete) {
+        phase_us[HTTP_PHASE_BODY] = now - stream->headers_us;
+        phase_us[HTTP_PHASE_TOTAL] = now - stream->started_us;
+        measured |= (1 << HTTP_PHASE_BODY) | (1 << HTTP_PHASE_TOTAL);
     }
+    return measured;
+}
 
-    // Set body for POST/PUT methods
-    if (request->body && (request->method == HTTP_CLIENT_METHOD_POST || 
-                         request->method == HTTP_CLIENT_METHOD_PUT ||
-                         request->method == HTTP_CLIENT_METHOD_PATCH)) {
-        size_t body_len = request->body_length > 0 ? request->body_length : strlen(request->body);
-        esp_http_client_set_post_field(client, request->body, body_len);
-        g_client_state.stats.total_bytes_sent += body_len;
+/**
+ * @brief Add one request's counters and timings to the handle statistics
+ */
+static void commit_stats(struct esp32_http_client *client, const http_client_stream_t *stream, bool success)
+{
+    const http_client_stats_t *delta = &stream->delta;
+    uint32_t phase_us[HTTP_PHASE_COUNT];
+    uint32_t measured = 0;
+    if (success && stream->headers_us) {
+        measured = measure_phases(stream, phase_us);
     }
 
-    // Perform HTTP request
-    uint64_t start_time = esp_timer_get_time() / 1000;
-    esp_err_t err = esp_http_client_perform(client);
-    
-    if (err == ESP_OK) {
-        response->status_code = esp_http_client_get_status_code(client);
-        response->content_length = esp_http_client_get_content_length(client);
-        
-        // Get content type
-        char *content_type = NULL;
-        esp_err_t header_err = esp_http_client_get_header(client, "Content-Type", &content_type);
-        if (header_err == ESP_OK && content_type) {
-            strncpy(response->content_type, content_type, sizeof(response->content_type) - 1);
-            response->content_type[sizeof(response->content_type) - 1] = '\0';
-        }
-
-        // Read response body if available
-        if (response->content_length > 0 && response->content_length < 64*1024) { // Limit to 64KB
-            response->body = malloc(response->content_length + 1);
-            if (response->body) {
-                int data_read = esp_http_client_read_response(client, response->body, response->content_length);
-                if (data_read >= 0) {
-                    response->body[data_read] = '\0';
-                    response->body_length = data_read;
-                    g_client_state.stats.total_bytes_received += data_read;
-                } else {
-                    free(response->body);
-                    response->body = NULL;
-                    response->body_length = 0;
-                }
-            }
-        }
-        
-        // Update statistics
-        g_client_state.stats.requests_sent++;
-        g_client_state.stats.last_status_code = response->status_code;
-        g_client_state.stats.last_request_time_ms = start_time;
-        
-        if (g_client_state.config.enable_logging) {
-            ESP_LOGI(TAG, "✅ HTTP %s successful - Status: %d, Content-Length: %zu", 
-                    (request->method == HTTP_CLIENT_METHOD_GET) ? "GET" :
-                    (request->method == HTTP_CLIENT_METHOD_POST) ? "POST" :
-                    (request->method == HTTP_CLIENT_METHOD_PUT) ? "PUT" :
-                    (request->method == HTTP_CLIENT_METHOD_DELETE) ? "DELETE" : "REQUEST",
-                    response->status_code, response->content_length);
+    taskENTER_CRITICAL(&client->stats_lock);
+    for (int i = 0; i < HTTP_PHASE_COUNT; i++) {
+        if (measured & (1 << i)) {
+            http_histogram_record(&client->latency[i], phase_us[i]);
         }
+    }
+    if (success) {
+        client->stats.requests_sent++;
+        client->stats.last_status_code = delta->last_status_code;
+        client->stats.last_request_time_ms = delta->last_request_time_ms;
     } else {
-        ESP_LOGE(TAG, "❌ HTTP request failed: %s", esp_err_to_name(err));
-        g_client_state.stats.requests_failed++;
+        client->stats.requests_failed++;
+    }
+    client->stats.total_bytes_sent += delta->total_bytes_sent;
+    client->stats.total_bytes_received += delta->total_bytes_received;
+    client->stats.connections_opened += delta->connections_opened;
+    client->stats.connections_reused += delta->connections_reused;
+    client->stats.reconnects += delta->reconnects;
+    client->stats.tls_handshakes += delta->tls_handshakes;
+    client->stats.tls_resumed += delta->tls_resumed;
+    client->stats.tls_handshake_time_us += delta->tls_handshake_time_us;
+    client->stats.tls_resume_time_us += delta->tls_resume_time_us;
+    client->stats.dns_cache_hits += delta->dns_cache_hits;
+    client->stats.dns_cache_misses += delta->dns_cache_misses;
+    if (delta->requests_compressed > 0) {
+        client->stats.requests_compressed += delta->requests_compressed;
+        client->stats.compress_bytes_in += delta->compress_bytes_in;
+        client->stats.compress_bytes_out += delta->compress_bytes_out;
+        client->stats.compress_time_us += delta->compress_time_us;
+        client->stats.last_compress_ratio_pct = delta->last_compress_ratio_pct;
+    }
+    if (delta->peak_bytes_buffered > client->stats.peak_bytes_buffered) {
+        client->stats.peak_bytes_buffered = delta->peak_bytes_buffered;
+    }
+    taskEXIT_CRITICAL(&client->stats_lock);
+
+    metrics_counter_inc(success ? &g_client_metrics.requests : &g_client_metrics.attempts_failed);
+    metrics_counter_add(&g_client_metrics.bytes_sent, delta->total_bytes_sent);
+    metrics_counter_add(&g_client_metrics.bytes_received, delta->total_bytes_received);
+    metrics_counter_add(&g_client_metrics.connections_opened, delta->connections_opened);
+    if (measured & (1 << HTTP_PHASE_TOTAL)) {
+        metrics_histogram_observe(&g_client_metrics.duration, phase_us[HTTP_PHASE_TOTAL]);
     }
-    
-    esp_http_client_cleanup(client);
-    return err;
 }
 
-esp_err_t esp32_http_client_get(const char *path, http_client_response_t *response)
+/**
+ * @brief Register the process-wide metrics (first handle only has any effect)
+ */
+static void register_metrics(void)
 {
-    if (!path) {
-        path = g_client_state.config.path;
-    }
+    metrics_register_counter(&g_client_metrics.requests);
+    metrics_register_counter(&g_client_metrics.attempts_failed);
+    metrics_register_counter(&g_client_metrics.retries);
+    metrics_register_counter(&g_client_metrics.bytes_sent);
+    metrics_register_counter(&g_client_metrics.bytes_received);
+    metrics_register_counter(&g_client_metrics.connections_opened);
+    metrics_register_histogram(&g_client_metrics.duration);
+}
 
-    // Temporarily update path if different
-    char original_path[128];
-    bool path_changed = false;
-    if (strcmp(path, g_client_state.config.path) != 0) {
-        strcpy(original_path, g_client_state.config.path);
-        strncpy(g_client_state.config.path, path, sizeof(g_client_state.config.path) - 1);
-        g_client_state.config.path[sizeof(g_client_state.config.path) - 1] = '\0';
-        path_changed = true;
+/**
+ * @brief Give a header block a new tag after a change
+ */
+static void header_block_retag(header_block_t *block)
+{
+    taskENTER_CRITICAL(&s_count_lock);
+    if (++s_header_tag == 0) {
+        s_header_tag = 1;
     }
+    block->tag = s_header_tag;
+    taskEXIT_CRITICAL(&s_count_lock);
+}
 
-    http_client_request_t request = {
-        .method = HTTP_CLIENT_METHOD_GET,
-        .content_type = NULL,
-        .body = NULL,
-        .body_length = 0,
-        .custom_headers = NULL
-    };
-
-    esp_err_t ret = esp32_http_client_send_request(&request, response);
+/**
+ * @brief Append an entry to a header block
+ */
+static esp_err_t header_block_append(header_block_t *block, const char *key, const char *value)
+{
+    size_t key_len = strlen(key) + 1;
+    size_t value_len = strlen(value) + 1;
 
-    // Restore original path if changed
-    if (path_changed) {
-        strcpy(g_client_state.config.path, original_path);
+    if (block->count > MAX_HEADERS) {
+        ESP_LOGE(TAG, "Maximum headers (%d) reached", MAX_HEADERS);
+        return ESP_ERR_NO_MEM;
+    }
+    // The key list must also fit the record kept with pooled connections
+    if (block->used + key_len + value_len > sizeof(block->data) ||
+        block->keys_size + key_len > HTTP_CONN_POOL_HEADER_KEYS_SIZE) {
+        ESP_LOGE(TAG, "Header %s does not fit the %d byte header block", key, HEADER_BLOCK_SIZE);
+        return ESP_ERR_NO_MEM;
     }
 
-    return ret;
+    memcpy(block->data + block->used, key, key_len);
+    memcpy(block->data + block->used + key_len, value, value_len);
+    block->used += key_len + value_len;
+    block->keys_size += key_len;
+    block->count++;
+    header_block_retag(block);
+    return ESP_OK;
 }
 
-esp_err_t esp32_http_client_post(const char *path, const char *content_type, const char *body, http_client_response_t *response)
+/**
+ * @brief Reset a header block to just the User-Agent
+ */
+static esp_err_t header_block_reset(header_block_t *block, const char *user_agent)
 {
-    if (!path || !body) {
-        return ESP_ERR_INVALID_ARG;
+    block->used = 0;
+    block->keys_size = 1;   // Terminating empty name
+    block->count = 0;
+    return header_block_append(block, "User-Agent", user_agent);
+}
+
+/**
+ * @brief Check whether a header block has an entry
+ */
+static bool header_block_has(const header_block_t *block, const char *key)
+{
+    const char *entry = block->data;
+    for (int i = 0; i < block->count; i++) {
+        if (strcasecmp(entry, key) == 0) {
+            return true;
+        }
+        entry += strlen(entry) + 1;
+        entry += strlen(entry) + 1;
     }
+    return false;
+}
 
-    // Temporarily update path if different
-    char original_path[128];
-    bool path_changed = false;
-    if (strcmp(path, g_client_state.config.path) != 0) {
-        strcpy(original_path, g_client_state.config.path);
-        strncpy(g_client_state.config.path, path, sizeof(g_client_state.config.path) - 1);
-        g_client_state.config.path[sizeof(g_client_state.config.path) - 1] = '\0';
-        path_changed = true;
+/**
+ * @brief Make sure a pooled handle carries the owner's persistent headers
+ *
+ * Free when the connection was last used by the same handle and nothing
+ * changed since. Otherwise the headers the previous user left are
+ * removed and the block is set once, for this and later requests.
+ */
+static void apply_static_headers(struct esp32_http_client *owner, esp_http_client_handle_t client,
+                                 http_conn_headers_t *applied)
+{
+    const header_block_t *block = &owner->headers;
+    if (applied->tag == block->tag) {
+        return;
     }
 
-    http_client_request_t request = {
-        .method = HTTP_CLIENT_METHOD_POST,
-        .content_type = content_type ? content_type : "text/plain",
-        .body = body,
-        .body_length = 0, // Auto-calculate
-        .custom_headers = NULL
-    };
+    for (const char *key = applied->keys; applied->tag != 0 && *key; key += strlen(key) + 1) {
+        esp_http_client_delete_header(client, key);
+    }
 
-    esp_err_t ret = esp32_http_client_send_request(&request, response);
+    char *keys = applied->keys;
+    const char *entry = block->data;
+    for (int i = 0; i < block->count; i++) {
+        const char *value = entry + strlen(entry) + 1;
+        esp_http_client_set_header(client, entry, value);
 
-    // Restore original path if changed
-    if (path_changed) {
-        strcpy(g_client_state.config.path, original_path);
+        size_t key_len = value - entry;
+        memcpy(keys, entry, key_len);
+        keys += key_len;
+        entry = value + strlen(value) + 1;
     }
-
-    return ret;
+    *keys = '\0';
+    applied->tag = block->tag;
 }
 
-esp_err_t esp32_http_client_add_header(const char *key, const char *value)
+/**
+ * @brief Apply the headers of a request to the handle
+ */
+static void apply_request(struct esp32_http_client *owner, http_conn_t conn, const http_client_request_t *request)
 {
-    if (!g_client_state.initialized) {
-        return ESP_ERR_INVALID_STATE;
-    }
+    esp_http_client_handle_t client = http_conn_pool_client(conn);
 
-    if (!key || !value) {
-        return ESP_ERR_INVALID_ARG;
-    }
+    apply_static_headers(owner, client, http_conn_pool_headers(conn));
 
-    if (g_client_state.header_count >= MAX_HEADERS) {
-        ESP_LOGE(TAG, "Maximum headers (%d) reached", MAX_HEADERS);
-        return ESP_ERR_NO_MEM;
+    if (request->content_type) {
+        esp_http_client_set_header(client, "Content-Type", request->content_type);
+    } else {
+        esp_http_client_delete_header(client, "Content-Type");
     }
 
-    strncpy(g_client_state.custom_headers[g_client_state.header_count].key, key, 63);
-    g_client_state.custom_headers[g_client_state.header_count].key[63] = '\0';
-    
-    strncpy(g_client_state.custom_headers[g_client_state.header_count].value, value, 191);
-    g_client_state.custom_headers[g_client_state.header_count].value[191] = '\0';
-    
-    g_client_state.header_count++;
-
-    if (g_client_state.config.enable_logging) {
-        ESP_LOGD(TAG, "Added header: %s: %s", key, value);
+    // Headers passed with this request only
+    for (int i = 0; i < request->header_count; i++) {
+        esp_http_client_set_header(client, request->headers[i].key, request->headers[i].value);
     }
+}
 
-    return ESP_OK;
+/**
+ * @brief Check whether a request method carries a body
+ */
+static bool method_has_body(http_client_method_t method)
+{
+    return method == HTTP_CLIENT_METHOD_POST ||
+           method == HTTP_CLIENT_METHOD_PUT ||
+           method == HTTP_CLIENT_METHOD_PATCH;
 }
 
-esp_err_t esp32_http_client_clear_headers(void)
+/**
+ * @brief Check whether a request body is sent with chunked transfer encoding
+ */
+static bool request_is_chunked(const http_client_request_t *request)
 {
-    if (!g_client_state.initialized) {
-        return ESP_ERR_INVALID_STATE;
+    return method_has_body(request->method) && request->body_producer && request->body_length == 0;
+}
+
+/**
+ * @brief Get the body length of a request (0 for methods without a body)
+ */
+static size_t request_body_length(const http_client_request_t *request)
+{
+    if (!method_has_body(request->method)) {
+        return 0;
     }
 
-    memset(g_client_state.custom_headers, 0, sizeof(g_client_state.custom_headers));
-    g_client_state.header_count = 0;
+    if (request->body_iov) {
+        size_t total = 0;
+        for (int i = 0; i < request->body_iov_count; i++) {
+            total += request->body_iov[i].len;
+        }
+        return total;
+    }
 
-    if (g_client_state.config.enable_logging) {
-        ESP_LOGD(TAG, "Cleared all custom headers");
+    if (request->body_producer) {
+        return request->body_length;
     }
 
-    return ESP_OK;
+    if (request->body) {
+        return request->body_length > 0 ? request->body_length : strlen(request->body);
+    }
+    return 0;
 }
 
-esp_err_t esp32_http_client_get_stats(http_client_stats_t *stats)
+/**
+ * @brief Remove per-request state before a handle goes back to the pool
+ *
+ * Headers persist on an esp_http_client handle, so the headers of this
+ * request must not leak into the next user of the connection. The
+ * owner's persistent headers stay; apply_static_headers() swaps them
+ * when another handle picks the connection up.
+ */
+static void strip_request(struct esp32_http_client *owner, http_conn_t conn, const http_client_request_t *request)
 {
-    if (!stats) {
-        return ESP_ERR_INVALID_ARG;
+    esp_http_client_handle_t client = http_conn_pool_client(conn);
+
+    for (int i = 0; i < request->header_count; i++) {
+        esp_http_client_delete_header(client, request->headers[i].key);
+        if (header_block_has(&owner->headers, request->headers[i].key)) {
+            // That deleted a persistent header as well; set the block again next time
+            http_conn_pool_headers(conn)->tag = 0;
+        }
     }
-    
-    if (!g_client_state.initialized) {
-        return ESP_ERR_INVALID_STATE;
+    // Set by esp_http_client_open() for chunked bodies, and for compressed ones
+    esp_http_client_delete_header(client, "Transfer-Encoding");
+    esp_http_client_delete_header(client, "Content-Encoding");
+    esp_http_client_set_user_data(client, NULL);
+}
+
+/**
+ * @brief Write a buffer to the connection
+ */
+static esp_err_t write_all(esp_http_client_handle_t client, const char *data, size_t len)
+{
+    size_t sent = 0;
+    while (sent < len) {
+        int written = esp_http_client_write(client, data + sent, len - sent);
+        if (written <= 0) {
+            return ESP_FAIL;
+        }
+        sent += written;
     }
-    
-    memcpy(stats, &g_client_state.stats, sizeof(http_client_stats_t));
     return ESP_OK;
 }
 
-esp_err_t esp32_http_client_reset_stats(void)
+/**
+ * @brief Write one chunk of a chunked request body (len 0 = last chunk)
+ */
+static esp_err_t write_chunk(esp_http_client_handle_t client, const char *data, size_t len)
 {
-    if (!g_client_state.initialized) {
-        return ESP_ERR_INVALID_STATE;
+    char size_line[12];
+    int size_len = snprintf(size_line, sizeof(size_line), "%x\r\n", (unsigned int)len);
+
+    esp_err_t err = write_all(client, size_line, size_len);
+    if (err == ESP_OK && len > 0) {
+        err = write_all(client, data, len);
     }
-    
-    memset(&g_client_state.stats, 0, sizeof(http_client_stats_t));
-    ESP_LOGI(TAG, "Statistics reset");
-    return ESP_OK;
+    if (err == ESP_OK) {
+        err = write_all(client, "\r\n", 2);
+    }
+    return err;
 }
 
-esp_err_t esp32_http_client_update_config(const http_client_config_t *config)
+/**
+ * @brief Pull a request body from its producer and write it out
+ */
+static esp_err_t write_produced_body(esp_http_client_handle_t client, const http_client_request_t *request,
+                                     bool chunked, size_t body_len, size_t *sent)
 {
-    if (!config) {
-        return ESP_ERR_INVALID_ARG;
+    char buffer[PRODUCER_BUFFER_SIZE];
+
+    while (chunked || *sent < body_len) {
+        size_t want = sizeof(buffer);
+        if (!chunked && body_len - *sent < want) {
+            want = body_len - *sent;
+        }
+
+        int produced = request->body_producer(buffer, want, *sent, request->producer_ctx);
+        if (produced < 0) {
+            ESP_LOGE(TAG, "Body producer failed at offset %zu", *sent);
+            return ESP_FAIL;
+        }
+        if (produced == 0) {
+            break;
+        }
+
+        esp_err_t err = chunked ? write_chunk(client, buffer, produced) : write_all(client, buffer, produced);
+        if (err != ESP_OK) {
+            return err;
+        }
+        *sent += produced;
     }
-    
-    if (!g_client_state.initialized) {
-        return ESP_ERR_INVALID_STATE;
+
+    if (chunked) {
+        return write_chunk(client, NULL, 0);
+    }
+
+    if (*sent != body_len) {
+        ESP_LOGE(TAG, "Body producer ended after %zu of %zu bytes", *sent, body_len);
+        return ESP_ERR_INVALID_SIZE;
     }
-    
-    memcpy(&g_client_state.config, config, sizeof(http_client_config_t));
-    ESP_LOGI(TAG, "Configuration updated");
     return ESP_OK;
 }
 
-esp_err_t esp32_http_client_get_config(http_client_config_t *config)
+/**
+ * @brief Check whether a request may reach the server twice without harm
+ */
+static bool method_is_idempotent(http_client_method_t method)
 {
-    if (!config) {
-        return ESP_ERR_INVALID_ARG;
+    return method == HTTP_CLIENT_METHOD_GET || method == HTTP_CLIENT_METHOD_HEAD ||
+           method == HTTP_CLIENT_METHOD_PUT || method == HTTP_CLIENT_METHOD_DELETE;
+}
+
+/**
+ * @brief Write the request line, headers and body, then wait for the response headers
+ *
+ * Every request goes through esp_http_client_open()/read() rather than
+ * perform(), so a pooled handle is always in the same state machine no
+ * matter whether the last user streamed or buffered its response. The
+ * body is written straight from the caller's fragments or producer.
+ *
+ * @param written Set once the whole request is written and only the
+ *        response is outstanding
+ */
+static esp_err_t transmit_request(http_client_stream_t *stream, esp_http_client_handle_t client,
+                                  const http_client_request_t *request, size_t *sent, bool *written)
+{
+    bool chunked = request_is_chunked(request);
+    size_t body_len = request_body_length(request);
+
+    *sent = 0;
+    *written = false;
+    stream->attempt_us = esp_timer_get_time();
+    boot_trace_mark(BOOT_PHASE_FIRST_REQUEST);
+    stream->connected_us = 0;
+    stream->first_header_us = 0;
+    if (chunked) {
+        // esp_http_client_open(-1) adds Transfer-Encoding but keeps any stale Content-Length
+        esp_http_client_delete_header(client, "Content-Length");
     }
-    
-    if (!g_client_state.initialized) {
-        return ESP_ERR_INVALID_STATE;
+
+    esp_err_t err = esp_http_client_open(client, chunked ? -1 : (int)body_len);
+    if (err != ESP_OK) {
+        return err;
     }
-    
-    memcpy(config, &g_client_state.config, sizeof(http_client_config_t));
+
+    if (chunked || (request->body_producer && body_len > 0)) {
+        err = write_produced_body(client, request, chunked, body_len, sent);
+    } else if (request->body_iov && body_len > 0) {
+        for (int i = 0; i < request->body_iov_count && err == ESP_OK; i++) {
+            err = write_all(client, request->body_iov[i].data, request->body_iov[i].len);
+        }
+        *sent = body_len;
+    } else if (body_len > 0) {
+        err = write_all(client, request->body, body_len);
+        *sent = body_len;
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+    stream->sent_us = esp_timer_get_time();
+    *written = true;
+
+    if (esp_http_client_fetch_headers(client) < 0) {
+        return ESP_FAIL;
+    }
+    stream->headers_us = esp_timer_get_time();
+    boot_trace_mark(BOOT_PHASE_FIRST_RESPONSE);
     return ESP_OK;
 }
 
-void esp32_http_client_free_response(http_client_response_t *response)
+/**
+ * @brief Check whether a header is set on the handle or the request
+ */
+static bool has_header(const struct esp32_http_client *owner, const http_client_request_t *request, const char *key)
 {
-    if (response && response->body) {
-        free(response->body);
-        response->body = NULL;
-        response->body_length = 0;
+    if (header_block_has(&owner->headers, key)) {
+        return true;
+    }
+    for (int i = 0; i < request->header_count; i++) {
+        if (strcasecmp(request->headers[i].key, key) == 0) {
+            return true;
+        }
     }
+    return false;
 }
 
-esp_err_t esp32_http_client_deinit(void)
+/**
+ * @brief Check whether a request body should be sent compressed
+ *
+ * Only POST bodies qualify: a compressed body is sent chunked, and
+ * esp_http_client_open() turns every chunked request into a POST.
+ */
+static bool should_compress(const struct esp32_http_client *owner, const http_client_request_t *request)
 {
-    if (!g_client_state.initialized) {
-        return ESP_ERR_INVALID_STATE;
+    if (!owner->config.compress || request->method != HTTP_CLIENT_METHOD_POST) {
+        return false;
     }
-    
-    memset(&g_client_state, 0, sizeof(g_client_state));
-    ESP_LOGI(TAG, "HTTP Client deinitialized");
-    return ESP_OK;
-}
\ No newline at end of file
+
+    // Already encoded by the caller
+    if (has_header(owner, request, "Content-Encoding")) {
+        return false;
+    }
+
+    // A chunked body has no length to compare; compress it
+    if (request_is_chunked(request)) {
+        return true;
+    }
+
+    size_t body_len = request_body_length(request);
+    return body_len > 0 && body_len >= owner->config.compress_threshold;
+}
+
+/**
+ * @brief Compressor input: the original body, in order
+ */
+static int read_source(uint8_t *buffer, size_t len, void *user_ctx)
+{
+    compress_ctx_t *ctx = (compress_ctx_t *)user_ctx;
+    const http_client_request_t *request = ctx->source;
+
+    if (ctx->source_len > 0) {
+        if (ctx->offset >= ctx->source_len) {
+            return 0;
+        }
+        if (len > ctx->source_len - ctx->offset) {
+            len = ctx->source_len - ctx->offset;
+        }
+    }
+
+    int got;
+    if (request->body_iov) {
+        // Copy from the fragment holding the current offset
+        size_t skip = ctx->offset;
+        int i = 0;
+        while (i < request->body_iov_count && skip >= request->body_iov[i].len) {
+            skip -= request->body_iov[i].len;
+            i++;
+        }
+        if (i == request->body_iov_count) {
+            return 0;
+        }
+        got = request->body_iov[i].len - skip < len ? request->body_iov[i].len - skip : len;
+        memcpy(buffer, (const uint8_t *)request->body_iov[i].data + skip, got);
+    } else if (request->body_producer) {
+        got = request->body_producer((char *)buffer, len, ctx->offset, request->producer_ctx);
+        if (got == 0 && ctx->offset < ctx->source_len) {
+            ESP_LOGE(TAG, "Body producer ended after %zu of %zu bytes", ctx->offset, ctx->source_len);
+            return -1;
+        }
+    } else {
+        memcpy(buffer, request->body + ctx->offset, len);
+        got = len;
+    }
+
+    if (got > 0) {
+        ctx->offset += got;
+    }
+    return got;
+}
+
+/**
+ * @brief Body producer that sends the original body gzip-compressed
+ */
+static int compressed_producer(char *buffer, size_t len, size_t offset, void *user_ctx)
+{
+    compress_ctx_t *ctx = (compress_ctx_t *)user_ctx;
+    int64_t start = esp_timer_get_time();
+
+    // Resending on a fresh connection restarts the stream
+    if (offset == 0) {
+        ctx->offset = 0;
+        http_deflate_start(read_source, ctx);
+    }
+
+    int produced = http_deflate_read(buffer, len);
+    ctx->time_us += esp_timer_get_time() - start;
+    return produced;
+}
+
+/**
+ * @brief Send a request to an explicit origin and read up to the response body
+ */
+static esp_err_t stream_begin(struct esp32_http_client *owner, const http_origin_t *origin, const char *path,
+                              const http_client_request_t *request, http_client_stream_t *stream,
+                              http_client_response_t *response)
+{
+    if (!owner) {
+        ESP_LOGE(TAG, "Client not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (!request || !response || !stream) {
+        ESP_LOGE(TAG, "Request and response cannot be NULL");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if ((request->header_count > 0 && !request->headers) ||
+        (request->body_iov_count > 0 && !request->body_iov)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Initialize response
+    memset(response, 0, sizeof(http_client_response_t));
+    memset(stream, 0, sizeof(http_client_stream_t));
+    stream->owner = owner;
+    stream->request = request;
+    stream->response = response;
+    stream->sink = request->body_sink;
+    stream->sink_ctx = request->sink_ctx;
+    stream->started_us = esp_timer_get_time();
+
+    int timeout_ms = request->timeout_ms > 0 ? request->timeout_ms : owner->config.timeout_ms;
+
+    // With no network there is nothing to connect to; wait for it rather than time out in connect
+    if (http_link_wait_up(timeout_ms) != ESP_OK) {
+        ESP_LOGW(TAG, "Network down, request to %s not sent", origin->host);
+        commit_stats(owner, stream, false);
+        return ESP_ERR_HTTP_CONNECT;
+    }
+
+    // Resolve before taking a slot, so a slow lookup does not hold one
+    const char *connect_host = origin->host;
+    char address[sizeof(origin->host)];
+    http_dns_result_t dns = HTTP_DNS_LITERAL;
+    if (owner->config.dns_cache) {
+        esp_err_t err = http_dns_cache_resolve(origin->host, address, sizeof(address), &dns);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to resolve %s: %s", origin->host, esp_err_to_name(err));
+            stream->delta.dns_cache_misses = 1;
+            commit_stats(owner, stream, false);
+            return err;
+        }
+        if (dns != HTTP_DNS_LITERAL) {
+            connect_host = address;
+            if (dns == HTTP_DNS_HIT) {
+                stream->delta.dns_cache_hits = 1;
+            } else {
+                stream->delta.dns_cache_misses = 1;
+            }
+        }
+    }
+
+    esp_http_client_config_t client_config = {
+        .method = convert_method(request->method),
+        .timeout_ms = timeout_ms,
+        .event_handler = http_event_handler,
+        .keep_alive_enable = owner->config.keep_alive,
+    };
+    if (origin->secure) {
+        apply_tls_config(&owner->config, &client_config);
+    }
+
+    http_conn_t conn;
+    esp_err_t err = http_conn_pool_acquire(origin, &client_config, &conn);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to get connection to %s:%d: %s", origin->host, origin->port, esp_err_to_name(err));
+        commit_stats(owner, stream, false);
+        return err;
+    }
+    esp_http_client_handle_t client = http_conn_pool_client(conn);
+
+    char url[256];
+    snprintf(url, sizeof(url), "%s://%s:%d%s", origin->secure ? "https" : "http",
+             connect_host, origin->port, path ? path : "/");
+    esp_http_client_set_url(client, url);
+    if (connect_host != origin->host) {
+        // set_url() put the address in the Host header; the server wants the name
+        char host_header[sizeof(origin->host) + 8];
+        if (origin->port == (origin->secure ? 443 : 80)) {
+            snprintf(host_header, sizeof(host_header), "%s", origin->host);
+        } else {
+            snprintf(host_header, sizeof(host_header), "%s:%d", origin->host, origin->port);
+        }
+        esp_http_client_set_header(client, "Host", host_header);
+    }
+    esp_http_client_set_method(client, convert_method(request->method));
+    esp_http_client_set_timeout_ms(client, timeout_ms);
+    esp_http_client_set_user_data(client, stream);
+
+    apply_request(owner, conn, request);
+
+    // The compressor is shared; if another request holds it, send as is
+    const http_client_request_t *wire = request;
+    http_client_request_t compressed;
+    compress_ctx_t compress_ctx = {0};
+    bool compressing = should_compress(owner, request) && http_deflate_acquire();
+    if (compressing) {
+        compress_ctx.source = request;
+        compress_ctx.source_len = request_body_length(request);
+        compressed = *request;
+        compressed.body_iov = NULL;
+        compressed.body_iov_count = 0;
+        compressed.body_producer = compressed_producer;
+        compressed.producer_ctx = &compress_ctx;
+        compressed.body_length = 0;
+        wire = &compressed;
+        esp_http_client_set_header(client, "Content-Encoding", "gzip");
+    }
+
+    size_t sent;
+    bool written;
+    err = transmit_request(stream, client, wire, &sent, &written);
+
+    if (!stream->connected && http_conn_pool_is_reused(conn)) {
+        // Writing to a kept-alive socket the server dropped while idle fails
+        // before any response arrives. Send once more on a new connection,
+        // unless the server may already have acted on the request: a request
+        // that failed later, or a non-idempotent body that went partly out,
+        // is left to the retry policy
+        bool replay = err != ESP_OK && !written &&
+                      (sent == 0 || (method_is_idempotent(request->method) && !wire->body_producer));
+        if (replay) {
+            ESP_LOGD(TAG, "Kept-alive connection closed by server, reconnecting");
+            esp_http_client_close(client);
+            stream->delta.reconnects++;
+            err = transmit_request(stream, client, wire, &sent, &written);
+        } else if (err == ESP_OK) {
+            stream->delta.connections_reused++;
+        }
+    }
+    if (stream->connected) {
+        stream->delta.connections_opened++;
+
+        // A handle that connected before holds the session of that handshake
+        bool resumed = http_conn_pool_mark_connected(conn) && tls_resume_enabled(&owner->config);
+        if (origin->secure) {
+            uint64_t connect_us = stream->connected_us - stream->attempt_us;
+            if (resumed) {
+                stream->delta.tls_resumed++;
+                stream->delta.tls_resume_time_us += connect_us;
+            } else {
+                stream->delta.tls_handshakes++;
+                stream->delta.tls_handshake_time_us += connect_us;
+            }
+        }
+    }
+    stream->delta.total_bytes_sent = sent;
+
+    if (compressing) {
+        size_t bytes_in, bytes_out;
+        http_deflate_totals(&bytes_in, &bytes_out);
+        http_deflate_release();
+
+        stream->delta.requests_compressed = 1;
+        stream->delta.compress_bytes_in = bytes_in;
+        stream->delta.compress_bytes_out = bytes_out;
+        stream->delta.compress_time_us = compress_ctx.time_us;
+        stream->delta.last_compress_ratio_pct = bytes_in > 0 ? (int)(bytes_out * 100 / bytes_in) : 100;
+        if (owner->config.enable_logging) {
+            LOG_RING_D(TAG, "Compressed body %u -> %u bytes in %lu us", (unsigned)bytes_in, (unsigned)bytes_out,
+                       (unsigned long)compress_ctx.time_us);
+        }
+    }
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "❌ HTTP request failed: %s", esp_err_to_name(err));
+        if (err == ESP_ERR_HTTP_CONNECT && (dns == HTTP_DNS_HIT || dns == HTTP_DNS_STALE)) {
+            // The cached address may be the reason; look the name up again next time
+            http_dns_cache_invalidate(origin->host);
+        }
+        commit_stats(owner, stream, false);
+        strip_request(owner, conn, request);
+        http_conn_pool_release(conn, false);
+        return err;
+    }
+
+    stream->conn = conn;
+    stream->client = client;
+
+    response->status_code = esp_http_client_get_status_code(client);
+    int64_t content_length = esp_http_client_get_content_length(client);
+    bool chunked = esp_http_client_is_chunked_response(client);
+    response->content_length = (!chunked && content_length > 0) ? (size_t)content_length : 0;
+
+    // No body follows a HEAD response or an explicit zero length
+    if (request->method == HTTP_CLIENT_METHOD_HEAD || (!chunked && content_length == 0)) {
+        stream->complete = true;
+    }
+
+    stream->delta.last_status_code = response->status_code;
+    stream->delta.last_request_time_ms = stream->started_us / 1000;
+
+    if (owner->config.enable_logging) {
+        LOG_RING_I(TAG, "✅ HTTP %s successful - Status: %d, Content-Length: %u%s", method_name(request->method),
+                   response->status_code, (unsigned)response->content_length, chunked ? " (chunked)" : "");
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Read the next piece of the response body
+ */
+static int stream_read(http_client_stream_t *stream, char *buffer, size_t len)
+{
+    if (stream->failed) {
+        return -1;
+    }
+    if (stream->complete || len == 0) {
+        return 0;
+    }
+
+    int data_read = esp_http_client_read(stream->client, buffer, len);
+    if (data_read < 0) {
+        stream->failed = true;
+        return -1;
+    }
+
+    if (data_read == 0) {
+        // A body without length ends when the server closes the socket
+        if (!esp_http_client_is_complete_data_received(stream->client)) {
+            stream->server_close = true;
+        }
+        stream->complete = true;
+        return 0;
+    }
+
+    // With a sink the bytes were already counted as HTTP_EVENT_ON_DATA delivered them
+    if (!stream->sink) {
+        stream->bytes_read += data_read;
+        stream->delta.total_bytes_received += data_read;
+        if ((size_t)data_read > stream->peak_buffered) {
+            stream->peak_buffered = data_read;
+        }
+    }
+
+    // Saves a blocking read just to learn that the body is over
+    if (esp_http_client_is_complete_data_received(stream->client)) {
+        stream->complete = true;
+    }
+    return data_read;
+}
+
+/**
+ * @brief Commit statistics and hand the connection back to the pool
+ */
+static void stream_end(http_client_stream_t *stream)
+{
+    struct esp32_http_client *owner = stream->owner;
+    bool reusable = stream->complete && !stream->failed && !stream->server_close && owner->config.keep_alive;
+
+    if (!stream->complete && !stream->failed && owner->config.enable_logging) {
+        ESP_LOGD(TAG, "Response body not read to the end, closing connection");
+    }
+
+    stream->delta.peak_bytes_buffered = stream->peak_buffered;
+    commit_stats(owner, stream, !stream->failed);
+
+    strip_request(owner, stream->conn, stream->request);
+    http_conn_pool_release(stream->conn, reusable);
+    stream->conn = NULL;
+    stream->client = NULL;
+    stream->response = NULL;
+}
+
+/**
+ * @brief Read a whole response body into an arena slot or heap buffer
+ *
+ * A body that cannot be buffered leaves response->body NULL and sets
+ * response->body_discarded, so it is not mistaken for an empty one.
+ */
+static void read_body(http_client_stream_t *stream, http_client_response_t *response)
+{
+    if (stream->complete) {
+        return;
+    }
+
+    response->body_discarded = true;
+    size_t capacity;
+    if (response->content_length > 0) {
+        if (response->content_length >= MAX_RESPONSE_BODY) { // Limit to 64KB
+            return;
+        }
+        capacity = response->content_length;
+    } else {
+        // A whole slot costs nothing extra and usually saves growing
+        size_t slot_size = http_arena_slot_size();
+        capacity = slot_size > CHUNKED_BODY_INITIAL + 1 ? slot_size - 1 : CHUNKED_BODY_INITIAL;
+    }
+
+    char *body = http_arena_alloc(capacity + 1);
+    if (!body) {
+        return;
+    }
+
+    size_t length = 0;
+    while (true) {
+        if (length == capacity) {
+            // Length unknown up front: grow until the end or the limit
+            if (response->content_length > 0 || capacity * 2 > MAX_RESPONSE_BODY) {
+                break;
+            }
+            char *grown = http_arena_alloc(capacity * 2 + 1);
+            if (!grown) {
+                break;
+            }
+            memcpy(grown, body, length);
+            http_arena_free(body);
+            body = grown;
+            capacity *= 2;
+        }
+
+        int data_read = stream_read(stream, body + length, capacity - length);
+        if (data_read <= 0) {
+            break;
+        }
+        length += data_read;
+    }
+
+    if (stream->failed || !stream->complete) {
+        if (!stream->complete) {
+            ESP_LOGW(TAG, "Response body exceeds %d bytes, discarded", MAX_RESPONSE_BODY);
+        }
+        http_arena_free(body);
+        return;
+    }
+
+    body[length] = '\0';
+    response->body = body;
+    response->body_length = length;
+    response->body_discarded = false;
+    stream->peak_buffered = capacity;
+}
+
+/**
+ * @brief Drain a response body through the request's sink
+ *
+ * esp_http_client_flush_response() parses straight out of the client's
+ * receive buffer and raises HTTP_EVENT_ON_DATA for every slice, so the
+ * body reaches the sink without being copied. It relies on the body
+ * having a length or chunked framing; a body that only ends at socket
+ * close is pulled through a small scratch buffer instead, which still
+ * raises the same events.
+ */
+static void sink_body(http_client_stream_t *stream, http_client_response_t *response)
+{
+    if (!stream->complete) {
+        if (stream->framed) {
+            if (esp_http_client_flush_response(stream->client, NULL) == ESP_OK) {
+                stream->complete = true;
+            } else {
+                stream->failed = true;
+            }
+        } else {
+            char scratch[128];
+            while (stream_read(stream, scratch, sizeof(scratch)) > 0) {
+            }
+        }
+    }
+
+    response->body_length = stream->bytes_read;
+}
+
+/**
+ * @brief Check whether the outcome of an attempt is worth retrying
+ *
+ * @param err Result of the attempt
+ * @param status Response status when err is ESP_OK
+ */
+static bool attempt_retryable(const http_client_request_t *request, const http_retry_policy_t *policy,
+                              esp_err_t err, int status)
+{
+    bool replayable = method_is_idempotent(request->method) || policy->retry_non_idempotent;
+
+    switch (err) {
+        case ESP_OK:
+            return policy->retry_on_status && replayable &&
+                   (status == 429 || status == 502 || status == 503 || status == 504);
+        case ESP_ERR_HTTP_CONNECT:
+        case ESP_ERR_NOT_FOUND:
+            // No connection or no address: nothing was sent
+            return true;
+        case ESP_FAIL:
+        case ESP_ERR_TIMEOUT:
+        case ESP_ERR_HTTP_WRITE_DATA:
+        case ESP_ERR_HTTP_FETCH_HEADER:
+        case ESP_ERR_HTTP_EAGAIN:
+            return replayable;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Decide whether to retry an attempt, and count the decision
+ *
+ * A failed attempt that is retried moves from requests_failed to
+ * retries, so requests_failed only counts requests that stayed failed.
+ *
+ * @param attempt Attempts made so far, minus one
+ */
+static bool take_retry(struct esp32_http_client *owner, const http_client_request_t *request,
+                       const http_retry_policy_t *policy, int attempt, esp_err_t err, int status)
+{
+    if (policy->max_retries <= 0 || !attempt_retryable(request, policy, err, status)) {
+        return false;
+    }
+
+    bool retry = attempt < policy->max_retries;
+    bool denied = retry && !http_retry_budget_acquire();
+
+    taskENTER_CRITICAL(&owner->stats_lock);
+    if (retry && !denied) {
+        owner->stats.retries++;
+        if (err != ESP_OK) {
+            owner->stats.requests_failed--;
+        }
+    } else {
+        owner->stats.retry_giveups++;
+        if (denied) {
+            owner->stats.retry_budget_denied++;
+        }
+    }
+    taskEXIT_CRITICAL(&owner->stats_lock);
+
+    if (retry && !denied) {
+        metrics_counter_inc(&g_client_metrics.retries);
+    }
+    if (denied) {
+        ESP_LOGW(TAG, "Retry budget exhausted, giving up");
+    }
+    return retry && !denied;
+}
+
+/**
+ * @brief Sleep before a retry
+ */
+static void retry_wait(const http_retry_policy_t *policy, int retry, uint32_t retry_after_ms,
+                       esp_err_t err, int status)
+{
+    uint32_t delay_ms = http_retry_backoff_ms(policy, retry, retry_after_ms);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Retry %d/%d in %lu ms after %s", retry, policy->max_retries,
+                 (unsigned long)delay_ms, esp_err_to_name(err));
+    } else {
+        ESP_LOGW(TAG, "Retry %d/%d in %lu ms after status %d", retry, policy->max_retries,
+                 (unsigned long)delay_ms, status);
+    }
+    vTaskDelay(pdMS_TO_TICKS(delay_ms));
+}
+
+/**
+ * @brief Send a request to an explicit origin and buffer the response
+ */
+static esp_err_t send_buffered(struct esp32_http_client *owner, const http_origin_t *origin, const char *path,
+                                const http_client_request_t *request, http_client_response_t *response)
+{
+    if (!owner || !request) {
+        // stream_begin() reports the error
+        http_client_stream_t stream;
+        return stream_begin(owner, origin, path, request, &stream, response);
+    }
+
+    const http_retry_policy_t *policy = request->retry ? request->retry : &owner->config.retry;
+    http_retry_budget_deposit();
+
+    for (int attempt = 0; ; attempt++) {
+        http_client_stream_t stream;
+        esp_err_t err = stream_begin(owner, origin, path, request, &stream, response);
+        if (err != ESP_OK) {
+            if (take_retry(owner, request, policy, attempt, err, 0)) {
+                retry_wait(policy, attempt + 1, 0, err, 0);
+                continue;
+            }
+            return err;
+        }
+
+        int status = response->status_code;
+        if (take_retry(owner, request, policy, attempt, ESP_OK, status)) {
+            // Drain the refused response without handing it to the sink
+            stream.sink = NULL;
+            read_body(&stream, response);
+            stream_end(&stream);
+            esp32_http_client_free_response(response);
+            retry_wait(policy, attempt + 1, stream.retry_after_ms, ESP_OK, status);
+            continue;
+        }
+
+        if (stream.sink) {
+            sink_body(&stream, response);
+        } else {
+            read_body(&stream, response);
+        }
+        if (stream.failed) {
+            ESP_LOGE(TAG, "❌ Failed to read response body");
+            err = ESP_FAIL;
+        }
+
+        stream_end(&stream);
+
+        if (err != ESP_OK && stream.sink_err == ESP_OK && take_retry(owner, request, policy, attempt, err, 0)) {
+            esp32_http_client_free_response(response);
+            retry_wait(policy, attempt + 1, 0, err, 0);
+            continue;
+        }
+
+        if (err == ESP_OK && stream.sink_err != ESP_OK) {
+            ESP_LOGW(TAG, "Response sink failed: %s", esp_err_to_name(stream.sink_err));
+            err = stream.sink_err;
+        }
+        return err;
+    }
+}
+
+/**
+ * @brief Send a request and buffer the response, revalidating GETs against the response cache
+ */
+static esp_err_t send_to_origin(struct esp32_http_client *owner, const http_origin_t *origin, const char *path,
+                                const http_client_request_t *request, http_client_response_t *response)
+{
+    if (!owner || !request || !owner->config.response_cache || request->method != HTTP_CLIENT_METHOD_GET ||
+        request->body_sink || !http_cache_is_running()) {
+        return send_buffered(owner, origin, path, request, response);
+    }
+
+    char key[HTTP_CACHE_KEY_SIZE];
+    int key_len = snprintf(key, sizeof(key), "%s://%s:%d%s", origin->secure ? "https" : "http",
+                           origin->host, origin->port, path ? path : "/");
+    if (key_len < 0 || key_len >= (int)sizeof(key)) {
+        return send_buffered(owner, origin, path, request, response);
+    }
+
+    // The validators go after the request's own headers; a caller that sets them itself wins
+    http_client_header_t headers[MAX_HEADERS + 2];
+    http_client_request_t conditional;
+    http_cache_validators_t validators;
+    bool revalidating = false;
+    if (request->header_count <= MAX_HEADERS &&
+        !has_header(owner, request, "If-None-Match") && !has_header(owner, request, "If-Modified-Since") &&
+        http_cache_lookup(key, &validators)) {
+        int count = request->header_count;
+        if (count > 0) {
+            memcpy(headers, request->headers, count * sizeof(http_client_header_t));
+        }
+        if (validators.etag[0]) {
+            headers[count++] = (http_client_header_t){ .key = "If-None-Match", .value = validators.etag };
+        }
+        if (validators.last_modified[0]) {
+            headers[count++] = (http_client_header_t){ .key = "If-Modified-Since", .value = validators.last_modified };
+        }
+        conditional = *request;
+        conditional.headers = headers;
+        conditional.header_count = count;
+        request = &conditional;
+        revalidating = true;
+    }
+
+    esp_err_t err = send_buffered(owner, origin, path, request, response);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    if (response->status_code == 304 && revalidating) {
+        int status;
+        char *body;
+        size_t body_length;
+        // If the entry was evicted meanwhile the caller gets the bare 304
+        if (http_cache_load(key, &status, response->content_type, sizeof(response->content_type),
+                            &body, &body_length) == ESP_OK) {
+            esp32_http_client_free_response(response);
+            response->status_code = status;
+            response->body = body;
+            response->body_length = body_length;
+            response->content_length = body_length;
+            response->from_cache = true;
+
+            taskENTER_CRITICAL(&owner->stats_lock);
+            owner->stats.cache_revalidated++;
+            taskEXIT_CRITICAL(&owner->stats_lock);
+        }
+    } else if (response->status_code == 200) {
+        if (response->no_store || response->body_discarded) {
+            // Not to be kept, or too large to be buffered at all
+            http_cache_invalidate(key);
+        } else {
+            // Without a validator this drops the entry
+            http_cache_validators_t fresh;
+            strcpy(fresh.etag, response->etag);
+            strcpy(fresh.last_modified, response->last_modified);
+            http_cache_store(key, &fresh, response->status_code, response->content_type,
+                             response->body, response->body_length);
+        }
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Resolve a path or full URL against a handle's origin
+ */
+static esp_err_t resolve_target(esp32_http_client_handle_t handle, const char *target,
+                                http_origin_t *origin, char *path, size_t path_size)
+{
+    if (target && (strncmp(target, "http://", 7) == 0 || strncmp(target, "https://", 8) == 0)) {
+        return http_conn_pool_parse_url(target, origin, path, path_size);
+    }
+
+    memset(origin, 0, sizeof(http_origin_t));
+    origin->port = handle->config.port;
+    origin->secure = handle->config.use_tls;
+    strncpy(origin->host, handle->config.host, sizeof(origin->host) - 1);
+
+    const char *resolved = target ? target : handle->config.path;
+    if (strlen(resolved) >= path_size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    strcpy(path, resolved);
+    return ESP_OK;
+}
+
+esp_err_t esp32_http_client_create(const http_client_config_t *config, esp32_http_client_handle_t *handle)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = validate_config(config);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Connections are shared through the pool; keep an existing pool warm
+    ret = http_conn_pool_init(NULL);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize connection pool: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = http_dns_cache_init(NULL);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ret = http_retry_budget_init(NULL);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    struct esp32_http_client *client = calloc(1, sizeof(struct esp32_http_client));
+    if (!client) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (config->compress) {
+        // Allocated once and shared by every handle
+        ret = http_deflate_init();
+        if (ret != ESP_OK) {
+            free(client);
+            return ret;
+        }
+    }
+
+    if (config->response_cache) {
+        // Shared by every handle; call http_cache_init() first for other limits
+        ret = http_cache_init(NULL);
+        if (ret != ESP_OK) {
+            free(client);
+            return ret;
+        }
+    }
+
+    memcpy(&client->config, config, sizeof(http_client_config_t));
+    portMUX_INITIALIZE(&client->stats_lock);
+    header_block_reset(&client->headers, config->user_agent);
+    register_metrics();
+
+    taskENTER_CRITICAL(&s_count_lock);
+    s_client_count++;
+    taskEXIT_CRITICAL(&s_count_lock);
+
+    if (config->enable_logging) {
+        ESP_LOGI(TAG, "HTTP Client created");
+        ESP_LOGI(TAG, "Target: %s:%d", config->host, config->port);
+        ESP_LOGI(TAG, "Default path: %s", config->path);
+        ESP_LOGI(TAG, "Timeout: %d ms", config->timeout_ms);
+        ESP_LOGI(TAG, "Keep-alive: %s", config->keep_alive ? "enabled" : "disabled");
+        if (config->retry.max_retries > 0) {
+            ESP_LOGI(TAG, "Retries: up to %d, backoff %d..%d ms", config->retry.max_retries,
+                     config->retry.base_delay_ms, config->retry.max_delay_ms);
+        }
+        if (config->use_tls) {
+            ESP_LOGI(TAG, "HTTPS: %s, session resumption %s",
+                     config->cert_pem ? "root certificate" : "certificate bundle",
+                     tls_resume_enabled(config) ? "enabled" : "disabled");
+        }
+        if (config->compress) {
+            ESP_LOGI(TAG, "Compression: gzip for bodies of %zu bytes and more", config->compress_threshold);
+        }
+        if (config->response_cache) {
+            ESP_LOGI(TAG, "Response cache: conditional GETs");
+        }
+    }
+
+    *handle = client;
+    return ESP_OK;
+}
+
+esp_err_t esp32_http_client_destroy(esp32_http_client_handle_t handle)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    free(handle);
+
+    taskENTER_CRITICAL(&s_count_lock);
+    bool last = (--s_client_count == 0);
+    taskEXIT_CRITICAL(&s_count_lock);
+
+    if (last) {
+        http_conn_pool_deinit();
+        http_dns_cache_deinit();
+        http_retry_budget_deinit();
+        http_deflate_deinit();
+        http_cache_deinit();
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp32_http_client_request(esp32_http_client_handle_t handle, const char *path,
+                                    const http_client_request_t *request, http_client_response_t *response)
+{
+    http_origin_t origin;
+    char resolved[128];
+
+    if (response) {
+        memset(response, 0, sizeof(http_client_response_t));
+    }
+
+    if (!handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = resolve_target(handle, path, &origin, resolved, sizeof(resolved));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    return send_to_origin(handle, &origin, resolved, request, response);
+}
+
+esp_err_t esp32_http_client_request_to(esp32_http_client_handle_t handle, const http_origin_t *origin, const char *path,
+                                       const http_client_request_t *request, http_client_response_t *response)
+{
+    if (!handle || !origin) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return send_to_origin(handle, origin, path, request, response);
+}
+
+esp_err_t esp32_http_client_request_url(esp32_http_client_handle_t handle, const char *url,
+                                        const http_client_request_t *request, http_client_response_t *response)
+{
+    http_origin_t origin;
+    char path[128];
+
+    if (response) {
+        memset(response, 0, sizeof(http_client_response_t));
+    }
+
+    if (!handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = http_conn_pool_parse_url(url, &origin, path, sizeof(path));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    return send_to_origin(handle, &origin, path, request, response);
+}
+
+esp_err_t esp32_http_client_stream_open(esp32_http_client_handle_t handle, const char *target,
+                                        const http_client_request_t *request,
+                                        http_client_stream_t *stream, http_client_response_t *response)
+{
+    http_origin_t origin;
+    char path[128];
+
+    if (!handle || !stream || (request && request->body_sink)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = resolve_target(handle, target, &origin, path, sizeof(path));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    return stream_begin(handle, &origin, path, request, stream, response);
+}
+
+int esp32_http_client_stream_read(http_client_stream_t *stream, char *buffer, size_t len)
+{
+    if (!stream || !stream->conn || !buffer) {
+        return -1;
+    }
+
+    return stream_read(stream, buffer, len);
+}
+
+esp_err_t esp32_http_client_stream_close(http_client_stream_t *stream)
+{
+    if (!stream) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!stream->conn) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    stream_end(stream);
+    return ESP_OK;
+}
+
+esp_err_t esp32_http_client_request_stream(esp32_http_client_handle_t handle, const char *target,
+                                           const http_client_request_t *request,
+                                           char *buffer, size_t buffer_size,
+                                           http_client_data_cb_t on_data, void *user_ctx,
+                                           http_client_response_t *response)
+{
+    if (!buffer || buffer_size == 0 || !on_data) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    http_client_stream_t stream;
+    esp_err_t ret = esp32_http_client_stream_open(handle, target, request, &stream, response);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    while (true) {
+        int data_read = stream_read(&stream, buffer, buffer_size);
+        if (data_read < 0) {
+            ESP_LOGE(TAG, "❌ Failed to read response body");
+            ret = ESP_FAIL;
+            break;
+        }
+        if (data_read == 0) {
+            break;
+        }
+
+        ret = on_data(buffer, data_read, user_ctx);
+        if (ret != ESP_OK) {
+            stream.failed = true;
+            break;
+        }
+    }
+
+    stream_end(&stream);
+    return ret;
+}
+
+esp_err_t esp32_http_client_handle_get(esp32_http_client_handle_t handle, const char *path, http_client_response_t *response)
+{
+    http_client_request_t request = {
+        .method = HTTP_CLIENT_METHOD_GET,
+        .content_type = NULL,
+        .body = NULL,
+        .body_length = 0,
+        .custom_headers = NULL
+    };
+
+    return esp32_http_client_request(handle, path, &request, response);
+}
+
+esp_err_t esp32_http_client_handle_post(esp32_http_client_handle_t handle, const char *path,
+                                        const char *content_type, const char *body, http_client_response_t *response)
+{
+    if (!path || !body) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    http_client_request_t request = {
+        .method = HTTP_CLIENT_METHOD_POST,
+        .content_type = content_type ? content_type : "text/plain",
+        .body = body,
+        .body_length = 0, // Auto-calculate
+        .custom_headers = NULL
+    };
+
+    return esp32_http_client_request(handle, path, &request, response);
+}
+
+esp_err_t esp32_http_client_handle_post_iov(esp32_http_client_handle_t handle, const char *path,
+                                            const char *content_type, const http_client_iovec_t *iov, int iov_count,
+                                            http_client_response_t *response)
+{
+    if (!path || !iov || iov_count <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    http_client_request_t request = {
+        .method = HTTP_CLIENT_METHOD_POST,
+        .content_type = content_type ? content_type : "application/octet-stream",
+        .body_iov = iov,
+        .body_iov_count = iov_count,
+    };
+
+    return esp32_http_client_request(handle, path, &request, response);
+}
+
+esp_err_t esp32_http_client_handle_add_header(esp32_http_client_handle_t handle, const char *key, const char *value)
+{
+    if (!handle || !key || !value) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = header_block_append(&handle->headers, key, value);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    if (handle->config.enable_logging) {
+        ESP_LOGD(TAG, "Added header: %s: %s", key, value);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t esp32_http_client_handle_clear_headers(esp32_http_client_handle_t handle)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    header_block_reset(&handle->headers, handle->config.user_agent);
+
+    if (handle->config.enable_logging) {
+        ESP_LOGD(TAG, "Cleared all custom headers");
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t esp32_http_client_handle_get_stats(esp32_http_client_handle_t handle, http_client_stats_t *stats)
+{
+    if (!handle || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    taskENTER_CRITICAL(&handle->stats_lock);
+    memcpy(stats, &handle->stats, sizeof(http_client_stats_t));
+    taskEXIT_CRITICAL(&handle->stats_lock);
+
+    // Percentiles are worked out on a copy, outside the spinlock
+    for (int i = 0; i < HTTP_PHASE_COUNT; i++) {
+        http_histogram_t histogram;
+        esp32_http_client_handle_get_histogram(handle, i, &histogram);
+
+        http_client_latency_t *latency = &stats->latency[i];
+        latency->count = histogram.count;
+        latency->p50_us = http_histogram_percentile(&histogram, 50);
+        latency->p95_us = http_histogram_percentile(&histogram, 95);
+        latency->p99_us = http_histogram_percentile(&histogram, 99);
+        latency->max_us = histogram.max_us;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp32_http_client_handle_get_histogram(esp32_http_client_handle_t handle, http_client_phase_t phase,
+                                                 http_histogram_t *histogram)
+{
+    if (!handle || !histogram || phase < 0 || phase >= HTTP_PHASE_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    taskENTER_CRITICAL(&handle->stats_lock);
+    memcpy(histogram, &handle->latency[phase], sizeof(http_histogram_t));
+    taskEXIT_CRITICAL(&handle->stats_lock);
+    return ESP_OK;
+}
+
+esp_err_t esp32_http_client_handle_reset_stats(esp32_http_client_handle_t handle)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    taskENTER_CRITICAL(&handle->stats_lock);
+    memset(&handle->stats, 0, sizeof(http_client_stats_t));
+    memset(handle->latency, 0, sizeof(handle->latency));
+    taskEXIT_CRITICAL(&handle->stats_lock);
+    return ESP_OK;
+}
+
+esp_err_t esp32_http_client_handle_update_config(esp32_http_client_handle_t handle, const http_client_config_t *config)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = validate_config(config);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    if (config->compress) {
+        ret = http_deflate_init();
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+
+    if (config->response_cache) {
+        ret = http_cache_init(NULL);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+
+    // The User-Agent is part of the compiled header block; rebuild it around the other entries
+    if (strcmp(handle->config.user_agent, config->user_agent) != 0) {
+        header_block_t previous = handle->headers;
+        header_block_reset(&handle->headers, config->user_agent);
+
+        const char *entry = previous.data;
+        for (int i = 0; i < previous.count; i++) {
+            const char *value = entry + strlen(entry) + 1;
+            if (i > 0) {
+                header_block_append(&handle->headers, entry, value);
+            }
+            entry = value + strlen(value) + 1;
+        }
+    }
+
+    memcpy(&handle->config, config, sizeof(http_client_config_t));
+    return ESP_OK;
+}
+
+esp_err_t esp32_http_client_handle_get_config(esp32_http_client_handle_t handle, http_client_config_t *config)
+{
+    if (!handle || !config) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memcpy(config, &handle->config, sizeof(http_client_config_t));
+    return ESP_OK;
+}
+
+esp_err_t esp32_http_client_init(const http_client_config_t *config)
+{
+    esp_err_t ret = validate_config(config);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    if (g_client_state.initialized) {
+        esp32_http_client_destroy(g_client_state.default_client);
+        g_client_state.default_client = NULL;
+        g_client_state.initialized = false;
+    }
+
+    ret = esp32_http_client_create(config, &g_client_state.default_client);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    g_client_state.initialized = true;
+
+    ESP_LOGI(TAG, "HTTP Client initialized");
+    return ESP_OK;
+}
+
+esp_err_t esp32_http_client_send_request(const http_client_request_t *request, http_client_response_t *response)
+{
+    if (!g_client_state.initialized) {
+        ESP_LOGE(TAG, "Client not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    return esp32_http_client_request(g_client_state.default_client, NULL, request, response);
+}
+
+esp_err_t esp32_http_client_send_request_to(const http_origin_t *origin, const char *path,
+                                            const http_client_request_t *request, http_client_response_t *response)
+{
+    if (!g_client_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    return esp32_http_client_request_to(g_client_state.default_client, origin, path, request, response);
+}
+
+esp_err_t esp32_http_client_send_request_url(const char *url, const http_client_request_t *request, http_client_response_t *response)
+{
+    if (!g_client_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    return esp32_http_client_request_url(g_client_state.default_client, url, request, response);
+}
+
+esp_err_t esp32_http_client_get(const char *path, http_client_response_t *response)
+{
+    if (!g_client_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    return esp32_http_client_handle_get(g_client_state.default_client, path, response);
+}
+
+esp_err_t esp32_http_client_post(const char *path, const char *content_type, const char *body, http_client_response_t *response)
+{
+    if (!g_client_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    return esp32_http_client_handle_post(g_client_state.default_client, path, content_type, body, response);
+}
+
+esp_err_t esp32_http_client_get_url(const char *url, http_client_response_t *response)
+{
+    http_client_request_t request = {
+        .method = HTTP_CLIENT_METHOD_GET,
+        .content_type = NULL,
+        .body = NULL,
+        .body_length = 0,
+        .custom_headers = NULL
+    };
+
+    return esp32_http_client_send_request_url(url, &request, response);
+}
+
+esp_err_t esp32_http_client_post_url(const char *url, const char *content_type, const char *body, http_client_response_t *response)
+{
+    if (!url || !body) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    http_client_request_t request = {
+        .method = HTTP_CLIENT_METHOD_POST,
+        .content_type = content_type ? content_type : "text/plain",
+        .body = body,
+        .body_length = 0, // Auto-calculate
+        .custom_headers = NULL
+    };
+
+    return esp32_http_client_send_request_url(url, &request, response);
+}
+
+esp_err_t esp32_http_client_add_header(const char *key, const char *value)
+{
+    if (!g_client_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    return esp32_http_client_handle_add_header(g_client_state.default_client, key, value);
+}
+
+esp_err_t esp32_http_client_clear_headers(void)
+{
+    if (!g_client_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    return esp32_http_client_handle_clear_headers(g_client_state.default_client);
+}
+
+esp_err_t esp32_http_client_get_stats(http_client_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_client_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    return esp32_http_client_handle_get_stats(g_client_state.default_client, stats);
+}
+
+esp_err_t esp32_http_client_reset_stats(void)
+{
+    if (!g_client_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp32_http_client_handle_reset_stats(g_client_state.default_client);
+    ESP_LOGI(TAG, "Statistics reset");
+    return ESP_OK;
+}
+
+esp_err_t esp32_http_client_update_config(const http_client_config_t *config)
+{
+    if (!config) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_client_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = esp32_http_client_handle_update_config(g_client_state.default_client, config);
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "Configuration updated");
+    }
+    return ret;
+}
+
+esp_err_t esp32_http_client_get_config(http_client_config_t *config)
+{
+    if (!config) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_client_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    return esp32_http_client_handle_get_config(g_client_state.default_client, config);
+}
+
+void esp32_http_client_free_response(http_client_response_t *response)
+{
+    if (response && response->body) {
+        http_arena_free(response->body);
+        response->body = NULL;
+        response->body_length = 0;
+    }
+}
+
+esp_err_t esp32_http_client_deinit(void)
+{
+    if (!g_client_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp32_http_client_destroy(g_client_state.default_client);
+    memset(&g_client_state, 0, sizeof(g_client_state));
+    ESP_LOGI(TAG, "HTTP Client deinitialized");
+    return ESP_OK;
+}
@@ -12,6 +12,22 @@
  * - Error handling and logging
  * - Statistics tracking
  * - Timeout management
+ * - Persistent keep-alive connection reuse
+ * - Multi-origin connection pool (see http_conn_pool.h)
+ * - Reentrant handles: one esp32_http_client_handle_t per task
+ * - Streaming responses into caller-owned buffers (callback or pull)
+ * - Scatter-gather and producer request bodies, no concatenation needed
+ * - Optional gzip request body compression (see http_deflate.h)
+ * - Per-phase latency histograms with percentile queries
+ * - HTTPS with a root certificate or the certificate bundle, resuming
+ *   TLS sessions on reconnect
+ * - Hostname resolution cache with prefetch (see http_dns_cache.h)
+ * - Retries with exponential backoff, jitter and a shared retry budget
+ *   (see http_retry.h)
+ * - Requests wait for the network instead of failing in connect while
+ *   the link is down (see http_link.h)
+ * - Conditional GETs answered from a response cache on 304 Not Modified
+ *   (see http_cache.h)
  */
 
 #ifndef ESP32_HTTP_CLIENT_H
@@ -21,6 +37,11 @@
 #include <stdbool.h>
 #include "esp_err.h"
 #include "esp_http_client.h"
+#include "http_conn_pool.h"
+#include "http_histogram.h"
+#include "http_dns_cache.h"
+#include "http_retry.h"
+#include "http_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -48,17 +69,98 @@ typedef struct {
     int timeout_ms;             /**< Request timeout in milliseconds */
     char user_agent[64];        /**< User-Agent header */
     bool enable_logging;        /**< Enable detailed logging */
+    bool keep_alive;            /**< Keep connections open in the pool across requests */
+    bool compress;              /**< Send request bodies gzip-compressed (Content-Encoding: gzip) */
+    size_t compress_threshold;  /**< Bodies shorter than this are sent uncompressed */
+    bool use_tls;               /**< Connect to host over HTTPS (set port, usually 443) */
+    const char *cert_pem;       /**< Server root certificate, PEM; must outlive the handle (NULL = bundle) */
+    bool use_crt_bundle;        /**< Verify servers with the certificate bundle when cert_pem is NULL */
+    bool tls_resume;            /**< Resume saved TLS sessions on reconnect (CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS) */
+    bool dns_cache;             /**< Resolve hostnames through the shared DNS cache */
+    bool response_cache;        /**< Revalidate buffered GETs against the shared response cache */
+    http_retry_policy_t retry;  /**< Retry policy of requests without their own */
 } http_client_config_t;
 
+/**
+ * @brief Single request header
+ */
+typedef struct {
+    const char *key;            /**< Header name */
+    const char *value;          /**< Header value */
+} http_client_header_t;
+
+/**
+ * @brief Streamed body callback
+ * 
+ * Called with consecutive pieces of the (de-chunked) response body.
+ * 
+ * @param data Body data, valid only during the call
+ * @param len Number of bytes in data
+ * @param user_ctx Context passed with the request
+ * @return ESP_OK to continue, any other value stops delivery of the rest of the body
+ */
+typedef esp_err_t (*http_client_data_cb_t)(const char *data, size_t len, void *user_ctx);
+
+/**
+ * @brief One fragment of a scatter-gather request body
+ */
+typedef struct {
+    const void *data;           /**< Fragment data */
+    size_t len;                 /**< Fragment length in bytes */
+} http_client_iovec_t;
+
+/**
+ * @brief Request body producer
+ * 
+ * Fills buffer with the body bytes starting at offset. If the request is
+ * resent on a fresh connection (the kept-alive one was closed by the
+ * server) the producer is asked for offset 0 again; return -1 if the body
+ * cannot be replayed. Chunked bodies are always sent as POST, because
+ * esp_http_client_open() forces the method for them.
+ * 
+ * @param buffer Buffer to fill
+ * @param len Maximum number of bytes to produce
+ * @param offset Body offset of the first byte to produce
+ * @param user_ctx Context passed with the request
+ * @return Bytes produced, 0 at the end of the body, -1 on error
+ */
+typedef int (*http_client_body_producer_t)(char *buffer, size_t len, size_t offset, void *user_ctx);
+
 /**
  * @brief HTTP request structure
+ * 
+ * The body comes from body_iov if set, else body_producer, else body.
+ * 
+ * Buffered requests (esp32_http_client_request() and the calls built on
+ * it) are retried under the retry policy, the request's own if set, else
+ * the handle's. A connect failure is retried for every method, since
+ * nothing was sent. Other transport errors, and 429, 502, 503 and 504
+ * responses, are retried for GET, HEAD, PUT and DELETE only, unless the
+ * policy allows more. The backoff sleeps in the calling task. Streamed
+ * requests are not retried.
+ * 
+ * With response_cache set on the handle, a buffered GET without a
+ * body_sink carries the validators of its cached copy (unless the
+ * request sets If-None-Match or If-Modified-Since itself). A 304 answer
+ * then comes back as the cached response with from_cache set, and a 200
+ * answer with a validator replaces the cached copy.
  */
 typedef struct {
     http_client_method_t method;    /**< HTTP method */
     const char *content_type;       /**< Content-Type header */
     const char *body;               /**< Request body (for POST/PUT) */
-    size_t body_length;             /**< Body length (0 = auto-calculate) */
+    size_t body_length;             /**< Body length (0 = auto-calculate; with body_producer 0 = chunked) */
     void *custom_headers;           /**< Custom headers (implementation specific) */
+    const http_client_header_t *headers; /**< Headers for this request only (optional) */
+    int header_count;               /**< Number of entries in headers */
+    const http_client_iovec_t *body_iov; /**< Body fragments written back to back (optional) */
+    int body_iov_count;             /**< Number of entries in body_iov */
+    http_client_body_producer_t body_producer; /**< Body produced on the fly (optional) */
+    void *producer_ctx;             /**< Context passed to body_producer */
+    http_client_data_cb_t body_sink; /**< Receive the response body here instead of response->body (optional) */
+    void *sink_ctx;                 /**< Context passed to body_sink */
+    const http_retry_policy_t *retry; /**< Retry policy for this request (NULL = handle's) */
+    int timeout_ms;                 /**< Network timeout for this request (0 = handle's) */
 } http_client_request_t;
 
 /**
@@ -66,14 +168,53 @@ typedef struct {
  */
 typedef struct {
     int status_code;            /**< HTTP status code */
-    char *body;                 /**< Response body (allocated, caller must free) */
+    char *body;                 /**< Response body (release with esp32_http_client_free_response()) */
     size_t body_length;         /**< Response body length */
     size_t content_length;      /**< Content-Length header value */
     char content_type[128];     /**< Content-Type header value */
+    char etag[HTTP_CACHE_ETAG_SIZE]; /**< ETag header value (empty = none or too long) */
+    char last_modified[HTTP_CACHE_DATE_SIZE]; /**< Last-Modified header value (empty = none) */
+    bool no_store;              /**< Cache-Control: no-store */
+    bool from_cache;            /**< Body is the cached copy, the server answered 304 */
+    bool body_discarded;        /**< A body was sent but not buffered (over 64 KB or out of memory) */
 } http_client_response_t;
 
+/**
+ * @brief Request phases timed into latency histograms
+ *
+ * esp_http_client resolves the host, connects and runs the TLS handshake
+ * inside one call, so HTTP_PHASE_CONNECT covers all three. With the DNS
+ * cache the lookup is done beforehand and only HTTP_PHASE_TOTAL includes
+ * it. HTTP_PHASE_CONNECT is only recorded for requests that opened a new
+ * connection. Phases are recorded for successful requests only.
+ */
+typedef enum {
+    HTTP_PHASE_CONNECT = 0,     /**< DNS lookup (uncached), TCP connect and TLS handshake */
+    HTTP_PHASE_SEND,            /**< Request line, headers and body written */
+    HTTP_PHASE_TTFB,            /**< Request written until the first response header */
+    HTTP_PHASE_BODY,            /**< Response headers read until the body is read to the end */
+    HTTP_PHASE_TOTAL,           /**< Whole request, including a reconnect */
+    HTTP_PHASE_COUNT
+} http_client_phase_t;
+
+/**
+ * @brief Latency summary of one phase
+ */
+typedef struct {
+    uint32_t count;             /**< Samples recorded */
+    uint32_t p50_us;            /**< Median */
+    uint32_t p95_us;            /**< 95th percentile */
+    uint32_t p99_us;            /**< 99th percentile */
+    uint32_t max_us;            /**< Slowest sample */
+} http_client_latency_t;
+
 /**
  * @brief HTTP client statistics
+ *
+ * esp_http_client does not report whether the server accepted a saved
+ * TLS session. tls_resumed counts connections that offered one; a server
+ * that falls back to a full handshake shows up as a mean resume time
+ * (tls_resume_time_us / tls_resumed) close to the full handshake time.
  */
 typedef struct {
     int requests_sent;          /**< Total requests sent */
@@ -82,8 +223,72 @@ typedef struct {
     uint64_t last_request_time_ms; /**< Timestamp of last request */
     uint64_t total_bytes_sent;  /**< Total bytes sent */
     uint64_t total_bytes_received; /**< Total bytes received */
+    int connections_opened;     /**< TCP connections established */
+    int connections_reused;     /**< Requests served over an already open connection */
+    int reconnects;             /**< Requests retried after the server closed a kept-alive socket */
+    size_t peak_bytes_buffered; /**< Largest response body chunk held in memory at once */
+    int requests_compressed;    /**< Requests sent with a gzip body */
+    uint64_t compress_bytes_in; /**< Body bytes before compression */
+    uint64_t compress_bytes_out; /**< Body bytes after compression */
+    uint64_t compress_time_us;  /**< CPU time spent compressing */
+    int last_compress_ratio_pct; /**< Compressed size of the last compressed body, in % of the original */
+    int tls_handshakes;         /**< TLS connections opened with a full handshake */
+    int tls_resumed;            /**< TLS connections opened offering a saved session */
+    uint64_t tls_handshake_time_us; /**< Connect time of full handshakes (DNS + TCP + TLS) */
+    uint64_t tls_resume_time_us; /**< Connect time of connections offering a saved session */
+    int dns_cache_hits;         /**< Hostnames answered by the DNS cache */
+    int dns_cache_misses;       /**< Hostnames that needed a DNS lookup (or fell back to an expired address) */
+    int retries;                /**< Attempts after the first; a retried failure is not in requests_failed */
+    int retry_giveups;          /**< Requests that failed with a retryable error and no retry left */
+    int retry_budget_denied;    /**< Retries refused by the shared retry budget */
+    int cache_revalidated;      /**< GETs answered 304 and served from the response cache */
+    http_client_latency_t latency[HTTP_PHASE_COUNT]; /**< Per-phase latency, filled in by get_stats */
 } http_client_stats_t;
 
+/**
+ * @brief Client handle (opaque)
+ * 
+ * A handle carries its own configuration, headers and statistics. Give
+ * each task its own handle; handles share warm connections through the
+ * connection pool but no other mutable state. Statistics of a handle may
+ * be read from any task.
+ */
+typedef struct esp32_http_client *esp32_http_client_handle_t;
+
+/**
+ * @brief Streamed response
+ * 
+ * Allocated by the caller (usually on the stack) and filled by
+ * esp32_http_client_stream_open(). The structure is registered with the
+ * underlying connection, so it must not be copied or moved while open.
+ * Only bytes_read and peak_buffered are meant to be read by the caller.
+ */
+typedef struct {
+    struct esp32_http_client *owner;        /**< Handle the stream belongs to */
+    http_conn_t conn;                       /**< Pooled connection (NULL when closed) */
+    esp_http_client_handle_t client;        /**< Connection's esp_http_client handle */
+    const http_client_request_t *request;   /**< Request, kept until close */
+    http_client_stats_t delta;              /**< Counters committed on close */
+    bool connected;                         /**< A new TCP connection was opened */
+    bool server_close;                      /**< Server sent Connection: close */
+    bool complete;                          /**< Whole body received */
+    bool failed;                            /**< Read error or aborted transfer */
+    bool framed;                            /**< Response has Content-Length or Transfer-Encoding */
+    http_client_response_t *response;       /**< Response being filled */
+    http_client_data_cb_t sink;             /**< Body sink of the request */
+    void *sink_ctx;                         /**< Context of the sink */
+    esp_err_t sink_err;                     /**< First error returned by the sink */
+    size_t bytes_read;                      /**< Body bytes delivered so far */
+    size_t peak_buffered;                   /**< Largest chunk delivered by a single read */
+    int64_t started_us;                     /**< First send attempt began */
+    int64_t attempt_us;                     /**< Current send attempt began */
+    int64_t connected_us;                   /**< HTTP_EVENT_ON_CONNECTED (0 = reused connection) */
+    int64_t sent_us;                        /**< Request fully written */
+    int64_t first_header_us;                /**< First HTTP_EVENT_ON_HEADER */
+    int64_t headers_us;                     /**< Response headers read */
+    uint32_t retry_after_ms;                /**< Retry-After of the response (0 = none) */
+} http_client_stream_t;
+
 /**
  * @brief Default configuration initializer
  */
@@ -93,12 +298,269 @@ typedef struct {
     .path = "/",                                    \
     .timeout_ms = 5000,                             \
     .user_agent = "ESP32-HTTP-Client/1.0",          \
-    .enable_logging = true                          \
+    .enable_logging = true,                         \
+    .keep_alive = true,                             \
+    .compress = false,                              \
+    .compress_threshold = 512,                      \
+    .use_tls = false,                               \
+    .cert_pem = NULL,                               \
+    .use_crt_bundle = true,                         \
+    .tls_resume = true,                             \
+    .dns_cache = true,                              \
+    .response_cache = false,                        \
+    .retry = HTTP_RETRY_POLICY_DEFAULT()            \
 }
 
+/**
+ * @brief Create a client handle
+ * 
+ * @param config Pointer to configuration structure
+ * @param handle Created handle (output)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_create(const http_client_config_t *config, esp32_http_client_handle_t *handle);
+
+/**
+ * @brief Destroy a client handle
+ * 
+ * @param handle Client handle
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_destroy(esp32_http_client_handle_t handle);
+
+/**
+ * @brief Send an HTTP request with a client handle
+ * 
+ * If request->body_sink is set, the response body is handed to the sink
+ * slice by slice from HTTP_EVENT_ON_DATA, straight out of the client's
+ * receive buffer, and response->body stays NULL (body_length counts the
+ * delivered bytes). The sink sees the body of any status code. If it
+ * fails, the rest of the body is drained and its error is returned.
+ * 
+ * @param handle Client handle
+ * @param path HTTP path, or a full http:// or https:// URL (NULL = configured path)
+ * @param request Pointer to request structure
+ * @param response Pointer to response structure (will be filled)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_request(esp32_http_client_handle_t handle, const char *path,
+                                    const http_client_request_t *request, http_client_response_t *response);
+
+/**
+ * @brief Send an HTTP request to an explicit origin with a client handle
+ * 
+ * @param handle Client handle
+ * @param origin Target origin
+ * @param path HTTP path (NULL = "/")
+ * @param request Pointer to request structure
+ * @param response Pointer to response structure (will be filled)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_request_to(esp32_http_client_handle_t handle, const http_origin_t *origin, const char *path,
+                                       const http_client_request_t *request, http_client_response_t *response);
+
+/**
+ * @brief Send an HTTP request to a full URL with a client handle
+ * 
+ * @param handle Client handle
+ * @param url Full URL (http://host[:port]/path)
+ * @param request Pointer to request structure
+ * @param response Pointer to response structure (will be filled)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_request_url(esp32_http_client_handle_t handle, const char *url,
+                                        const http_client_request_t *request, http_client_response_t *response);
+
+/**
+ * @brief Send a request and stream the response body through a callback
+ * 
+ * The body is read into the caller's buffer piece by piece and handed to
+ * the callback, so nothing is allocated regardless of the body size.
+ * Chunked transfer encoding is decoded before the callback sees the data.
+ * 
+ * @param handle Client handle
+ * @param target HTTP path, or a full http:// or https:// URL (NULL = configured path)
+ * @param request Pointer to request structure
+ * @param buffer Caller-owned read buffer
+ * @param buffer_size Size of buffer
+ * @param on_data Body callback
+ * @param user_ctx Context passed to the callback
+ * @param response Status and headers (body stays NULL)
+ * @return ESP_OK on success, the callback's error if it aborted, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_request_stream(esp32_http_client_handle_t handle, const char *target,
+                                           const http_client_request_t *request,
+                                           char *buffer, size_t buffer_size,
+                                           http_client_data_cb_t on_data, void *user_ctx,
+                                           http_client_response_t *response);
+
+/**
+ * @brief Send a request and open its response body for reading
+ * 
+ * Returns once the response headers are in. The body is then pulled with
+ * esp32_http_client_stream_read(). The request must stay valid until
+ * esp32_http_client_stream_close(). Requests with a body_sink are
+ * rejected; the pull interface replaces the sink.
+ * 
+ * @param handle Client handle
+ * @param target HTTP path, or a full http:// or https:// URL (NULL = configured path)
+ * @param request Pointer to request structure
+ * @param stream Caller-allocated stream state
+ * @param response Status and headers (body stays NULL; content_length is 0 when chunked)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_stream_open(esp32_http_client_handle_t handle, const char *target,
+                                        const http_client_request_t *request,
+                                        http_client_stream_t *stream, http_client_response_t *response);
+
+/**
+ * @brief Read the next piece of a streamed response body
+ * 
+ * @param stream Open stream
+ * @param buffer Caller-owned buffer
+ * @param len Size of buffer
+ * @return Bytes read, 0 at the end of the body, -1 on error
+ */
+int esp32_http_client_stream_read(http_client_stream_t *stream, char *buffer, size_t len);
+
+/**
+ * @brief Close a streamed response
+ * 
+ * The connection goes back to the pool if the body was read to the end,
+ * otherwise it is closed.
+ * 
+ * @param stream Open stream
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_stream_close(http_client_stream_t *stream);
+
+/**
+ * @brief Send a simple GET request with a client handle
+ * 
+ * @param handle Client handle
+ * @param path HTTP path (NULL = configured path)
+ * @param response Pointer to response structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_handle_get(esp32_http_client_handle_t handle, const char *path, http_client_response_t *response);
+
+/**
+ * @brief Send a simple POST request with a client handle
+ * 
+ * @param handle Client handle
+ * @param path HTTP path
+ * @param content_type Content-Type header
+ * @param body Request body
+ * @param response Pointer to response structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_handle_post(esp32_http_client_handle_t handle, const char *path,
+                                        const char *content_type, const char *body, http_client_response_t *response);
+
+/**
+ * @brief Send a POST request whose body is a list of fragments
+ * 
+ * The fragments are written to the connection one after another with a
+ * Content-Length of their total size; nothing is concatenated.
+ * 
+ * @param handle Client handle
+ * @param path HTTP path
+ * @param content_type Content-Type header (NULL = application/octet-stream)
+ * @param iov Body fragments (must stay valid for the call)
+ * @param iov_count Number of fragments
+ * @param response Pointer to response structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_handle_post_iov(esp32_http_client_handle_t handle, const char *path,
+                                            const char *content_type, const http_client_iovec_t *iov, int iov_count,
+                                            http_client_response_t *response);
+
+/**
+ * @brief Add a header sent with every request of a handle
+ * 
+ * Handle headers (and the User-Agent) are compiled into one block and
+ * stay set on pooled connections, so they cost nothing per request.
+ * Put values that change per request in http_client_request_t.headers.
+ * 
+ * @param handle Client handle
+ * @param key Header name
+ * @param value Header value
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_handle_add_header(esp32_http_client_handle_t handle, const char *key, const char *value);
+
+/**
+ * @brief Clear all custom headers of a handle
+ * 
+ * @param handle Client handle
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_handle_clear_headers(esp32_http_client_handle_t handle);
+
+/**
+ * @brief Get a consistent snapshot of a handle's statistics
+ * 
+ * Safe to call from any task.
+ * 
+ * @param handle Client handle
+ * @param stats Pointer to statistics structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_handle_get_stats(esp32_http_client_handle_t handle, http_client_stats_t *stats);
+
+/**
+ * @brief Copy the latency histogram of one request phase
+ * 
+ * For percentiles other than those in http_client_stats_t, or to
+ * export the distribution. Safe to call from any task.
+ * 
+ * @param handle Client handle
+ * @param phase Request phase
+ * @param histogram Histogram snapshot (output)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_handle_get_histogram(esp32_http_client_handle_t handle, http_client_phase_t phase,
+                                                 http_histogram_t *histogram);
+
+/**
+ * @brief Reset a handle's statistics
+ * 
+ * @param handle Client handle
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_handle_reset_stats(esp32_http_client_handle_t handle);
+
+/**
+ * @brief Update a handle's configuration
+ * 
+ * @param handle Client handle
+ * @param config Pointer to new configuration
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_handle_update_config(esp32_http_client_handle_t handle, const http_client_config_t *config);
+
+/**
+ * @brief Get a handle's configuration
+ * 
+ * @param handle Client handle
+ * @param config Pointer to configuration structure to fill
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_handle_get_config(esp32_http_client_handle_t handle, http_client_config_t *config);
+
+/*
+ * Legacy single-client API
+ *
+ * The functions below operate on a default handle created by
+ * esp32_http_client_init(). They are kept for existing callers and must
+ * not be used from several tasks at once.
+ */
+
 /**
  * @brief Initialize the HTTP client
  * 
+ * Creates the default handle used by the legacy API below.
+ * 
  * @param config Pointer to configuration structure
  * @return ESP_OK on success, ESP_ERR_* on failure
  */
@@ -113,6 +575,31 @@ esp_err_t esp32_http_client_init(const http_client_config_t *config);
  */
 esp_err_t esp32_http_client_send_request(const http_client_request_t *request, http_client_response_t *response);
 
+/**
+ * @brief Send an HTTP request to an explicit origin
+ * 
+ * Uses a pooled keep-alive connection for the origin, independent of the
+ * host/port in the client configuration.
+ * 
+ * @param origin Target origin
+ * @param path HTTP path (NULL = "/")
+ * @param request Pointer to request structure
+ * @param response Pointer to response structure (will be filled)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_send_request_to(const http_origin_t *origin, const char *path,
+                                            const http_client_request_t *request, http_client_response_t *response);
+
+/**
+ * @brief Send an HTTP request to a full URL
+ * 
+ * @param url Full URL (http://host[:port]/path)
+ * @param request Pointer to request structure
+ * @param response Pointer to response structure (will be filled)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_send_request_url(const char *url, const http_client_request_t *request, http_client_response_t *response);
+
 /**
  * @brief Send a simple GET request
  * 
@@ -133,6 +620,26 @@ esp_err_t esp32_http_client_get(const char *path, http_client_response_t *respon
  */
 esp_err_t esp32_http_client_post(const char *path, const char *content_type, const char *body, http_client_response_t *response);
 
+/**
+ * @brief Send a simple GET request to a full URL
+ * 
+ * @param url Full URL (http://host[:port]/path)
+ * @param response Pointer to response structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_get_url(const char *url, http_client_response_t *response);
+
+/**
+ * @brief Send a simple POST request to a full URL
+ * 
+ * @param url Full URL (http://host[:port]/path)
+ * @param content_type Content-Type header
+ * @param body Request body
+ * @param response Pointer to response structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_client_post_url(const char *url, const char *content_type, const char *body, http_client_response_t *response);
+
 /**
  * @brief Add a custom header for next request
  * 
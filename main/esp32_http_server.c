@@ -0,0 +1,610 @@
+/**
+ * @file esp32_http_server.c
+ * @brief On-Device HTTP Server Implementation
+ *
+ * The esp_http_server task parses requests and hands them to the
+ * workers with httpd_req_async_handler_begin(), which keeps the socket
+ * reserved until the worker completes the request. The queue in front
+ * of the workers is as deep as there are workers; requests beyond that
+ * are answered 503 right away.
+ */
+
+#include "esp32_http_server.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "lwip/sockets.h"
+#include "http_histogram.h"
+#include "metrics.h"
+
+static const char *TAG = "HTTP_SERVER";
+
+#define HTTP_SERVER_MAX_WORKERS 8
+#define ROUTE_URI_MAX 48
+
+/**
+ * @brief Registered route
+ */
+typedef struct {
+    char uri[ROUTE_URI_MAX];
+    http_server_handler_t handler;
+    void *ctx;
+} server_route_t;
+
+/**
+ * @brief Request handed to a worker (req == NULL stops the worker)
+ */
+typedef struct {
+    httpd_req_t *req;
+    const server_route_t *route;
+    int64_t dispatched_us;
+} server_job_t;
+
+/**
+ * @brief Global server state
+ */
+static struct {
+    http_server_config_t config;
+    httpd_handle_t server;
+    QueueHandle_t jobs;                 /**< NULL when handlers run in the server task */
+    char *buffers;                      /**< One response buffer per worker plus one for the server task */
+    server_route_t routes[HTTP_SERVER_MAX_ROUTES];
+    int route_count;
+    http_server_stats_t stats;
+    http_histogram_t latency;
+    int64_t window_start_ms;            /**< Start of the second being counted */
+    uint32_t window_count;              /**< Requests handled in that second */
+    int workers_alive;
+    bool stopping;
+    bool running;
+} g_server_state = {0};
+
+static portMUX_TYPE s_server_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Move the request rate window up to now (lock held)
+ */
+static void roll_window(int64_t now_ms)
+{
+    int64_t second = now_ms / 1000 * 1000;
+    if (second == g_server_state.window_start_ms) {
+        return;
+    }
+
+    // The rate is the last full second; a gap without requests means zero
+    bool previous = (second - g_server_state.window_start_ms == 1000);
+    g_server_state.stats.requests_per_sec = previous ? g_server_state.window_count : 0;
+    g_server_state.window_start_ms = second;
+    g_server_state.window_count = 0;
+}
+
+/**
+ * @brief Count one finished request
+ */
+static void commit_stats(const http_server_request_t *request, bool success, int64_t dispatched_us)
+{
+    int64_t now_us = esp_timer_get_time();
+    size_t body = request->sent + (success ? request->len : 0);
+
+    taskENTER_CRITICAL(&s_server_lock);
+    if (success) {
+        g_server_state.stats.requests_handled++;
+        g_server_state.stats.last_request_time_ms = now_us / 1000;
+        http_histogram_record(&g_server_state.latency, (uint32_t)(now_us - dispatched_us));
+    } else {
+        g_server_state.stats.requests_failed++;
+    }
+    g_server_state.stats.total_bytes_sent += body;
+    if (body > g_server_state.stats.peak_response_bytes) {
+        g_server_state.stats.peak_response_bytes = body;
+    }
+    roll_window(now_us / 1000);
+    g_server_state.window_count++;
+    taskEXIT_CRITICAL(&s_server_lock);
+}
+
+/**
+ * @brief Send what is in the buffer as one chunk
+ */
+static esp_err_t flush(http_server_request_t *request)
+{
+    if (request->error != ESP_OK || request->len == 0) {
+        return request->error;
+    }
+
+    request->error = httpd_resp_send_chunk(request->req, request->buffer, request->len);
+    if (request->error == ESP_OK) {
+        request->sent += request->len;
+    }
+    request->len = 0;
+    return request->error;
+}
+
+/**
+ * @brief Send the rest of the response after the handler returned
+ */
+static esp_err_t finish(http_server_request_t *request)
+{
+    if (request->error != ESP_OK) {
+        return request->error;
+    }
+
+    if (request->sent == 0) {
+        // Everything fit: one send with Content-Length
+        request->error = httpd_resp_send(request->req, request->buffer, request->len);
+        return request->error;
+    }
+
+    flush(request);
+    if (request->error == ESP_OK) {
+        request->error = httpd_resp_send_chunk(request->req, NULL, 0);
+    }
+    return request->error;
+}
+
+/**
+ * @brief Run a route handler and complete its response
+ */
+static esp_err_t run_handler(httpd_req_t *req, const server_route_t *route, char *buffer, int64_t dispatched_us)
+{
+    http_server_request_t request = {
+        .req = req,
+        .ctx = route->ctx,
+        .buffer = buffer,
+        .size = g_server_state.config.response_buffer_size,
+    };
+
+    esp_err_t ret = route->handler(&request);
+    if (ret == ESP_OK) {
+        ret = finish(&request);
+    } else if (request.sent == 0 && request.error == ESP_OK) {
+        ESP_LOGW(TAG, "Handler for %s failed: %s", route->uri, esp_err_to_name(ret));
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, NULL);
+    }
+
+    commit_stats(&request, ret == ESP_OK, dispatched_us);
+    return ret;
+}
+
+/**
+ * @brief Worker task: run queued requests
+ */
+static void worker_task(void *pvParameters)
+{
+    char *buffer = (char *)pvParameters;
+    server_job_t job;
+
+    while (xQueueReceive(g_server_state.jobs, &job, portMAX_DELAY) == pdTRUE) {
+        if (!job.req) {
+            break;
+        }
+
+        esp_err_t ret = run_handler(job.req, job.route, buffer, job.dispatched_us);
+        if (ret != ESP_OK) {
+            // A half-sent response cannot be recovered on this connection
+            httpd_sess_trigger_close(g_server_state.server, httpd_req_to_sockfd(job.req));
+        }
+        httpd_req_async_handler_complete(job.req);
+    }
+
+    taskENTER_CRITICAL(&s_server_lock);
+    g_server_state.workers_alive--;
+    taskEXIT_CRITICAL(&s_server_lock);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Answer 503 without involving a worker
+ */
+static esp_err_t reject_busy(httpd_req_t *req)
+{
+    taskENTER_CRITICAL(&s_server_lock);
+    g_server_state.stats.requests_rejected++;
+    taskEXIT_CRITICAL(&s_server_lock);
+
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    httpd_resp_set_hdr(req, "Retry-After", "1");
+    return httpd_resp_send(req, "Busy\n", HTTPD_RESP_USE_STRLEN);
+}
+
+/**
+ * @brief esp_http_server handler of every route (server task)
+ */
+static esp_err_t dispatch(httpd_req_t *req)
+{
+    const server_route_t *route = (const server_route_t *)req->user_ctx;
+    int64_t dispatched_us = esp_timer_get_time();
+
+    if (!g_server_state.jobs) {
+        char *buffer = g_server_state.buffers;
+        return run_handler(req, route, buffer, dispatched_us) == ESP_OK ? ESP_OK : ESP_FAIL;
+    }
+
+    // Only this task adds jobs, so free space seen here is still free below
+    if (g_server_state.stopping || uxQueueSpacesAvailable(g_server_state.jobs) == 0) {
+        return reject_busy(req);
+    }
+
+    server_job_t job = { .route = route, .dispatched_us = dispatched_us };
+    esp_err_t ret = httpd_req_async_handler_begin(req, &job.req);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to hand request to a worker: %s", esp_err_to_name(ret));
+        return ESP_FAIL;
+    }
+    xQueueSend(g_server_state.jobs, &job, 0);
+    return ESP_OK;
+}
+
+/**
+ * @brief 404 handler, counted
+ */
+static esp_err_t not_found(httpd_req_t *req, httpd_err_code_t error)
+{
+    taskENTER_CRITICAL(&s_server_lock);
+    g_server_state.stats.requests_not_found++;
+    taskEXIT_CRITICAL(&s_server_lock);
+
+    httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, NULL);
+    return ESP_OK;
+}
+
+/**
+ * @brief Socket accepted
+ */
+static esp_err_t on_open(httpd_handle_t server, int sockfd)
+{
+    taskENTER_CRITICAL(&s_server_lock);
+    g_server_state.stats.connections_opened++;
+    g_server_state.stats.connections_open++;
+    taskEXIT_CRITICAL(&s_server_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Socket closed (the close function owns closing it)
+ */
+static void on_close(httpd_handle_t server, int sockfd)
+{
+    taskENTER_CRITICAL(&s_server_lock);
+    g_server_state.stats.connections_open--;
+    taskEXIT_CRITICAL(&s_server_lock);
+    close(sockfd);
+}
+
+/**
+ * @brief GET /status
+ */
+static esp_err_t status_handler(http_server_request_t *request)
+{
+    http_server_stats_t stats;
+    esp32_http_server_get_stats(&stats);
+
+    httpd_resp_set_type(request->req, "application/json");
+    return esp32_http_server_printf(request,
+        "{\"uptime_ms\":%llu,\"free_heap\":%lu,\"min_free_heap\":%lu,"
+        "\"requests\":%d,\"requests_per_sec\":%lu,\"connections_open\":%d,"
+        "\"latency_p50_us\":%lu,\"latency_p99_us\":%lu}\n",
+        (unsigned long long)(esp_timer_get_time() / 1000),
+        (unsigned long)esp_get_free_heap_size(), (unsigned long)esp_get_minimum_free_heap_size(),
+        stats.requests_handled, (unsigned long)stats.requests_per_sec, stats.connections_open,
+        (unsigned long)stats.latency.p50_us, (unsigned long)stats.latency.p99_us);
+}
+
+/**
+ * @brief Metrics sink writing into the response
+ */
+static esp_err_t emit_response(const char *text, size_t len, void *ctx)
+{
+    return esp32_http_server_write((http_server_request_t *)ctx, text, len);
+}
+
+/**
+ * @brief GET /metrics (Prometheus text format)
+ */
+static esp_err_t metrics_handler(http_server_request_t *request)
+{
+    httpd_resp_set_type(request->req, "text/plain; version=0.0.4");
+    return metrics_export(emit_response, request);
+}
+
+/**
+ * @brief Metrics collector: server statistics
+ */
+static void collect_metrics(metrics_writer_t *writer, void *ctx)
+{
+    if (!g_server_state.running) {
+        return;
+    }
+
+    http_server_stats_t stats;
+    http_histogram_t latency;
+
+    taskENTER_CRITICAL(&s_server_lock);
+    memcpy(&stats, &g_server_state.stats, sizeof(http_server_stats_t));
+    memcpy(&latency, &g_server_state.latency, sizeof(http_histogram_t));
+    taskEXIT_CRITICAL(&s_server_lock);
+
+    metrics_write_counter(writer, "http_server_requests_total{result=\"ok\"}", "Requests by outcome",
+                          stats.requests_handled);
+    metrics_write_counter(writer, "http_server_requests_total{result=\"failed\"}", NULL, stats.requests_failed);
+    metrics_write_counter(writer, "http_server_requests_total{result=\"rejected\"}", NULL, stats.requests_rejected);
+    metrics_write_counter(writer, "http_server_requests_total{result=\"not_found\"}", NULL,
+                          stats.requests_not_found);
+    metrics_write_counter(writer, "http_server_bytes_sent_total", "Response body bytes", stats.total_bytes_sent);
+    metrics_write_counter(writer, "http_server_connections_opened_total", "Sockets accepted",
+                          stats.connections_opened);
+    metrics_write_gauge(writer, "http_server_connections_open", "Sockets open now", stats.connections_open);
+    metrics_write_histogram(writer, "http_server_request_duration_seconds",
+                            "Dispatch to response complete", &latency);
+}
+
+esp_err_t esp32_http_server_start(const http_server_config_t *config)
+{
+    if (g_server_state.running) {
+        ESP_LOGW(TAG, "HTTP server already running");
+        return ESP_OK;
+    }
+
+    http_server_config_t defaults = HTTP_SERVER_CONFIG_DEFAULT();
+    if (!config) {
+        config = &defaults;
+    }
+
+    if (config->port == 0 || config->max_open_sockets <= 0 ||
+        config->worker_count < 0 || config->worker_count > HTTP_SERVER_MAX_WORKERS ||
+        config->response_buffer_size < 64 || config->worker_stack_size <= 0 || config->server_stack_size <= 0) {
+        ESP_LOGE(TAG, "Invalid HTTP server configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memcpy(&g_server_state.config, config, sizeof(http_server_config_t));
+    g_server_state.window_start_ms = esp_timer_get_time() / 1000 / 1000 * 1000;
+
+    // All response buffers in one allocation, made once
+    g_server_state.buffers = malloc(config->response_buffer_size * (config->worker_count + 1));
+    if (!g_server_state.buffers) {
+        memset(&g_server_state, 0, sizeof(g_server_state));
+        return ESP_ERR_NO_MEM;
+    }
+
+    httpd_config_t httpd_config = HTTPD_DEFAULT_CONFIG();
+    httpd_config.server_port = config->port;
+    httpd_config.max_open_sockets = config->max_open_sockets;
+    httpd_config.max_uri_handlers = HTTP_SERVER_MAX_ROUTES;
+    httpd_config.stack_size = config->server_stack_size;
+    httpd_config.task_priority = config->server_priority;
+    httpd_config.recv_wait_timeout = config->recv_timeout_ms > 1000 ? config->recv_timeout_ms / 1000 : 1;
+    httpd_config.send_wait_timeout = config->send_timeout_ms > 1000 ? config->send_timeout_ms / 1000 : 1;
+    httpd_config.lru_purge_enable = true;
+    httpd_config.keep_alive_enable = config->keep_alive;
+    httpd_config.uri_match_fn = httpd_uri_match_wildcard;
+    httpd_config.open_fn = on_open;
+    httpd_config.close_fn = on_close;
+
+    esp_err_t ret = httpd_start(&g_server_state.server, &httpd_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start server on port %d: %s", config->port, esp_err_to_name(ret));
+        free(g_server_state.buffers);
+        memset(&g_server_state, 0, sizeof(g_server_state));
+        return ret;
+    }
+    httpd_register_err_handler(g_server_state.server, HTTPD_404_NOT_FOUND, not_found);
+
+    if (config->worker_count > 0) {
+        g_server_state.jobs = xQueueCreate(config->worker_count, sizeof(server_job_t));
+        if (!g_server_state.jobs) {
+            ret = ESP_ERR_NO_MEM;
+            goto fail;
+        }
+
+        for (int i = 0; i < config->worker_count; i++) {
+            char *buffer = g_server_state.buffers + config->response_buffer_size * (i + 1);
+            if (xTaskCreate(worker_task, "http_srv_wrk", config->worker_stack_size, buffer,
+                            config->worker_priority, NULL) != pdPASS) {
+                ESP_LOGE(TAG, "Failed to create worker %d", i);
+                ret = ESP_FAIL;
+                goto fail;
+            }
+            taskENTER_CRITICAL(&s_server_lock);
+            g_server_state.workers_alive++;
+            taskEXIT_CRITICAL(&s_server_lock);
+        }
+    }
+
+    g_server_state.running = true;
+
+    if (config->enable_status_route) {
+        esp32_http_server_register("/status", HTTP_GET, status_handler, NULL);
+    }
+
+    if (config->enable_metrics_route) {
+        esp32_http_server_register("/metrics", HTTP_GET, metrics_handler, NULL);
+    }
+
+    // Collectors cannot be removed: register once and skip while stopped
+    static bool collector_registered = false;
+    if (!collector_registered && metrics_register_collector(collect_metrics, NULL) == ESP_OK) {
+        collector_registered = true;
+    }
+
+    ESP_LOGI(TAG, "HTTP server started on port %d (%d workers, %d sockets, %u byte buffers)",
+             config->port, config->worker_count, config->max_open_sockets,
+             (unsigned)config->response_buffer_size);
+    return ESP_OK;
+
+fail:
+    g_server_state.running = true;
+    esp32_http_server_stop();
+    return ret;
+}
+
+esp_err_t esp32_http_server_register(const char *uri, httpd_method_t method,
+                                     http_server_handler_t handler, void *ctx)
+{
+    if (!g_server_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (!uri || !handler || strlen(uri) >= ROUTE_URI_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (g_server_state.route_count >= HTTP_SERVER_MAX_ROUTES) {
+        ESP_LOGE(TAG, "Route table full, %s not registered", uri);
+        return ESP_ERR_NO_MEM;
+    }
+
+    server_route_t *route = &g_server_state.routes[g_server_state.route_count];
+    strcpy(route->uri, uri);
+    route->handler = handler;
+    route->ctx = ctx;
+
+    httpd_uri_t httpd_uri = {
+        .uri = route->uri,
+        .method = method,
+        .handler = dispatch,
+        .user_ctx = route,
+    };
+    esp_err_t ret = httpd_register_uri_handler(g_server_state.server, &httpd_uri);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to register %s: %s", uri, esp_err_to_name(ret));
+        return ret;
+    }
+
+    g_server_state.route_count++;
+    ESP_LOGI(TAG, "Route %s registered", uri);
+    return ESP_OK;
+}
+
+esp_err_t esp32_http_server_write(http_server_request_t *request, const void *data, size_t len)
+{
+    if (!request || (!data && len > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const char *bytes = (const char *)data;
+    while (len > 0 && request->error == ESP_OK) {
+        if (request->len == request->size) {
+            flush(request);
+            continue;
+        }
+
+        size_t room = request->size - request->len;
+        size_t take = len < room ? len : room;
+        memcpy(request->buffer + request->len, bytes, take);
+        request->len += take;
+        bytes += take;
+        len -= take;
+    }
+    return request->error;
+}
+
+esp_err_t esp32_http_server_printf(http_server_request_t *request, const char *format, ...)
+{
+    if (!request || !format) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (request->error != ESP_OK) {
+        return request->error;
+    }
+
+    va_list args;
+    va_start(args, format);
+    size_t room = request->size - request->len;
+    int written = vsnprintf(request->buffer + request->len, room, format, args);
+    va_end(args);
+
+    if (written < 0) {
+        return ESP_FAIL;
+    }
+    if ((size_t)written < room) {
+        request->len += written;
+        return ESP_OK;
+    }
+
+    // Did not fit behind what is buffered: send that and format again at the start
+    if (flush(request) != ESP_OK) {
+        return request->error;
+    }
+    va_start(args, format);
+    written = vsnprintf(request->buffer, request->size, format, args);
+    va_end(args);
+
+    if (written < 0 || (size_t)written >= request->size) {
+        ESP_LOGE(TAG, "Formatted text of %d bytes does not fit the response buffer", written);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    request->len = written;
+    return ESP_OK;
+}
+
+esp_err_t esp32_http_server_get_stats(http_server_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_server_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    http_histogram_t latency;
+
+    taskENTER_CRITICAL(&s_server_lock);
+    roll_window(esp_timer_get_time() / 1000);
+    memcpy(stats, &g_server_state.stats, sizeof(http_server_stats_t));
+    memcpy(&latency, &g_server_state.latency, sizeof(http_histogram_t));
+    taskEXIT_CRITICAL(&s_server_lock);
+
+    // Percentiles are computed outside the lock
+    stats->latency.count = latency.count;
+    stats->latency.p50_us = http_histogram_percentile(&latency, 50);
+    stats->latency.p95_us = http_histogram_percentile(&latency, 95);
+    stats->latency.p99_us = http_histogram_percentile(&latency, 99);
+    stats->latency.max_us = latency.max_us;
+    return ESP_OK;
+}
+
+esp_err_t esp32_http_server_stop(void)
+{
+    if (!g_server_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    g_server_state.stopping = true;
+
+    if (g_server_state.jobs) {
+        // Stop markers queue up behind requests already handed over
+        server_job_t stop = { 0 };
+        int workers = g_server_state.workers_alive;
+        for (int i = 0; i < workers; i++) {
+            xQueueSend(g_server_state.jobs, &stop, portMAX_DELAY);
+        }
+        while (g_server_state.workers_alive > 0) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
+
+    httpd_stop(g_server_state.server);
+    if (g_server_state.jobs) {
+        vQueueDelete(g_server_state.jobs);
+    }
+    free(g_server_state.buffers);
+
+    memset(&g_server_state, 0, sizeof(g_server_state));
+    ESP_LOGI(TAG, "HTTP server stopped");
+    return ESP_OK;
+}
+
+bool esp32_http_server_is_running(void)
+{
+    return g_server_state.running;
+}
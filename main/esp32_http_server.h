@@ -0,0 +1,204 @@
+/**
+ * @file esp32_http_server.h
+ * @brief On-Device HTTP Server
+ *
+ * Small wrapper around esp_http_server for local scrapes (status,
+ * metrics, config):
+ * - URI routing, with a trailing '*' matching any suffix
+ * - A bounded pool of worker tasks runs the handlers, so a slow handler
+ *   does not stall the server task; when every worker is busy and as
+ *   many requests already wait for one, the next is answered 503 at
+ *   once instead of queueing without limit
+ * - HTTP keep-alive, TCP keep-alive for idle sockets, and the least
+ *   recently used socket is closed when all are in use
+ * - Handlers write into a response buffer allocated once per worker;
+ *   a response that fits goes out with Content-Length, a longer one is
+ *   flushed as chunks whenever the buffer fills up. Nothing is built on
+ *   the heap per request.
+ * - Request rate and handler latency statistics, in the same style as
+ *   http_client_stats_t
+ *
+ * There is one server per device.
+ */
+
+#ifndef ESP32_HTTP_SERVER_H
+#define ESP32_HTTP_SERVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_SERVER_MAX_ROUTES 16       /**< Routes that can be registered */
+
+/**
+ * @brief HTTP server configuration
+ */
+typedef struct {
+    uint16_t port;              /**< TCP port */
+    int max_open_sockets;       /**< Connections kept at once (LWIP_MAX_SOCKETS minus 3 at most) */
+    int worker_count;           /**< Handler tasks (0 = run handlers in the server task) */
+    int worker_stack_size;      /**< Stack of each worker */
+    int worker_priority;        /**< Priority of the workers */
+    int server_stack_size;      /**< Stack of the esp_http_server task */
+    int server_priority;        /**< Priority of the esp_http_server task */
+    size_t response_buffer_size; /**< Response buffer per worker */
+    int recv_timeout_ms;        /**< Socket receive timeout */
+    int send_timeout_ms;        /**< Socket send timeout */
+    bool keep_alive;            /**< TCP keep-alive probes on idle sockets */
+    bool enable_status_route;   /**< Serve GET /status (uptime, heap, server stats) */
+    bool enable_metrics_route;  /**< Serve GET /metrics (every registered metric, Prometheus text) */
+} http_server_config_t;
+
+/**
+ * @brief Default server configuration
+ */
+#define HTTP_SERVER_CONFIG_DEFAULT() {              \
+    .port = 80,                                     \
+    .max_open_sockets = 4,                          \
+    .worker_count = 2,                              \
+    .worker_stack_size = 4096,                      \
+    .worker_priority = 5,                           \
+    .server_stack_size = 4096,                      \
+    .server_priority = 5,                           \
+    .response_buffer_size = 1024,                   \
+    .recv_timeout_ms = 5000,                        \
+    .send_timeout_ms = 5000,                        \
+    .keep_alive = true,                             \
+    .enable_status_route = true,                    \
+    .enable_metrics_route = true                    \
+}
+
+/**
+ * @brief Request being handled
+ *
+ * Passed to handlers. Read the request through req with the usual
+ * httpd_req_* functions; set status, type and headers on req before the
+ * first write that overflows the buffer (or at any time for responses
+ * that fit). Write the body with esp32_http_server_write() and
+ * esp32_http_server_printf(); the response is completed when the
+ * handler returns.
+ */
+typedef struct {
+    httpd_req_t *req;           /**< Underlying request */
+    void *ctx;                  /**< Context given at registration */
+    char *buffer;               /**< Response buffer of this worker */
+    size_t size;                /**< Buffer size */
+    size_t len;                 /**< Bytes waiting in the buffer */
+    size_t sent;                /**< Body bytes already sent as chunks */
+    esp_err_t error;            /**< First send error, later writes are dropped */
+} http_server_request_t;
+
+/**
+ * @brief Route handler
+ *
+ * @param request Request being handled
+ * @return ESP_OK to send the response; anything else answers 500 if
+ *         nothing was sent yet, else closes the connection
+ */
+typedef esp_err_t (*http_server_handler_t)(http_server_request_t *request);
+
+/**
+ * @brief Latency summary
+ */
+typedef struct {
+    uint32_t count;             /**< Samples recorded */
+    uint32_t p50_us;            /**< Median */
+    uint32_t p95_us;            /**< 95th percentile */
+    uint32_t p99_us;            /**< 99th percentile */
+    uint32_t max_us;            /**< Slowest sample */
+} http_server_latency_t;
+
+/**
+ * @brief HTTP server statistics
+ */
+typedef struct {
+    int requests_handled;       /**< Requests a handler completed */
+    int requests_failed;        /**< Handler errors and failed sends */
+    int requests_rejected;      /**< Answered 503 because the workers were saturated */
+    int requests_not_found;     /**< Answered 404 */
+    uint32_t requests_per_sec;  /**< Handled in the last full second */
+    uint64_t last_request_time_ms; /**< Timestamp of the last handled request */
+    uint64_t total_bytes_sent;  /**< Response body bytes sent */
+    int connections_opened;     /**< Sockets accepted */
+    int connections_open;       /**< Sockets open now */
+    size_t peak_response_bytes; /**< Largest response body */
+    http_server_latency_t latency; /**< Time from dispatch to response complete, waiting for a worker included */
+} http_server_stats_t;
+
+/**
+ * @brief Start the server
+ *
+ * @param config Server configuration (NULL = defaults)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_server_start(const http_server_config_t *config);
+
+/**
+ * @brief Add a route
+ *
+ * @param uri URI, may end in '*' to match any suffix
+ * @param method HTTP method
+ * @param handler Handler
+ * @param ctx Passed to the handler as request->ctx
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the route table is full
+ */
+esp_err_t esp32_http_server_register(const char *uri, httpd_method_t method,
+                                     http_server_handler_t handler, void *ctx);
+
+/**
+ * @brief Append bytes to the response
+ *
+ * @param request Request being handled
+ * @param data Data
+ * @param len Length
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_server_write(http_server_request_t *request, const void *data, size_t len);
+
+/**
+ * @brief Append formatted text to the response
+ *
+ * One call must fit into the response buffer.
+ *
+ * @param request Request being handled
+ * @param format printf format
+ * @return ESP_OK on success, ESP_ERR_INVALID_SIZE if the text does not fit
+ */
+esp_err_t esp32_http_server_printf(http_server_request_t *request, const char *format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Get server statistics
+ *
+ * @param stats Pointer to statistics structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t esp32_http_server_get_stats(http_server_stats_t *stats);
+
+/**
+ * @brief Stop the server
+ *
+ * Requests already handed to a worker are completed first.
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t esp32_http_server_stop(void);
+
+/**
+ * @brief Check if the server is running
+ *
+ * @return true if running
+ */
+bool esp32_http_server_is_running(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ESP32_HTTP_SERVER_H
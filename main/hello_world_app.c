@@ -3,8 +3,22 @@
  * @brief Hello World Application Implementation
  */
 
+// Before any include: levels above CONFIG_HELLO_APP_LOG_LEVEL are compiled out
+#include "sdkconfig.h"
+#define LOG_LOCAL_LEVEL CONFIG_HELLO_APP_LOG_LEVEL
+
 #include "hello_world_app.h"
 #include "esp32_http_client.h"
+#include "http_async.h"
+#include "http_batch.h"
+#include "http_pipeline.h"
+#include "http_spool.h"
+#include "hello_world_record.h"
+#include "metrics.h"
+#include "log_ring.h"
+#include "http_arena.h"
+#include "scheduler.h"
+#include "boot_trace.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -24,60 +38,155 @@ static struct {
     hello_world_stats_t stats;
     bool initialized;
     int message_counter;
-    TaskHandle_t auto_task_handle;
+    scheduler_job_id_t auto_job;
     bool auto_mode_running;
+    esp32_http_client_handle_t client;
+    esp32_http_client_handle_t batch_client;    /**< Used by the batch flush task only */
+    esp32_http_client_handle_t spool_client;    /**< Used by the spool replay task only */
+    esp32_http_client_handle_t pipeline_client; /**< Used by the pipeline transmitter only */
 } g_app_state = {0};
 
+/* Guards message_counter and stats; messages may be sent from several tasks */
+static portMUX_TYPE s_app_lock = portMUX_INITIALIZER_UNLOCKED;
+
+#define HELLO_WORLD_MESSAGE_HEADERS 2
+#define HELLO_WORLD_MAX_FRAGMENTS 8
+#define HELLO_WORLD_MAX_RECORD 192
+
+/* Fixed parts of the message, sent from flash as they are */
+static const char s_banner[] =
+    "🎉 Hello World from ESP32! 🎉\n"
+    "═══════════════════════════════════════\n";
+
+static const char s_custom_title[] = "💬 Custom Message:\n";
+static const char s_custom_end[] = "\n\n";
+
+static const char s_footer[] =
+    "🌐 Network Information:\n"
+    "   📡 ESP32 connected to WiFi\n"
+    "   🏠 Local network communication\n"
+    "   📨 HTTP POST request\n"
+    "\n"
+    "✨ Generated at runtime by ESP32!\n"
+    "═══════════════════════════════════════";
+
 /**
- * @brief Generate Hello World message content
+ * @brief A message ready to send
+ *
+ * Holds everything the request points to, so it can outlive the caller
+ * when the message is sent asynchronously. The body goes out as a list
+ * of fragments: the static parts point into flash and only the changing
+ * blocks are formatted into their own small buffers.
  */
-static esp_err_t generate_hello_world_content(char *buffer, size_t buffer_size, const char *custom_message)
+typedef struct {
+    int message_number;
+    uint32_t uptime_ms;
+    char counter_header[16];
+    char uptime_header[16];
+    http_client_header_t headers[HELLO_WORLD_MESSAGE_HEADERS];
+    http_client_request_t request;
+    http_client_iovec_t fragments[HELLO_WORLD_MAX_FRAGMENTS];
+    char info_block[320];
+    char system_block[320];
+    char random_block[256];
+    char custom_text[256];
+    uint8_t record_header[HELLO_WORLD_RECORD_HEADER_SIZE];
+} hello_world_message_t;
+
+/**
+ * @brief Append a body fragment to a message
+ */
+static void add_fragment(hello_world_message_t *msg, const char *data, size_t len)
 {
-    if (!buffer || buffer_size == 0) {
-        return ESP_ERR_INVALID_ARG;
+    if (len > 0 && msg->request.body_iov_count < HELLO_WORLD_MAX_FRAGMENTS) {
+        msg->fragments[msg->request.body_iov_count++] = (http_client_iovec_t){ data, len };
     }
+}
 
-    // Get system information
-    uint32_t uptime_ms = esp_timer_get_time() / 1000;
-    uint32_t uptime_seconds = uptime_ms / 1000;
-    uint32_t free_heap = esp_get_free_heap_size();
-    uint32_t min_free_heap = esp_get_minimum_free_heap_size();
-    
-    // Generate some changing calculations for verification
-    int calculation_result = 1;
-    for(int i = 0; i < g_app_state.message_counter; i++) {
-        calculation_result = calculation_result * 2;
-        if(calculation_result > 10000) calculation_result = 1;  // Reset if too big
+/**
+ * @brief Length of a formatted block, 0 if snprintf failed or truncated it
+ */
+static size_t block_length(int written, size_t buffer_size)
+{
+    if (written < 0 || (size_t)written >= buffer_size) {
+        return 0;
     }
-    
+    return written;
+}
+
+/**
+ * @brief Collect the values carried by one message
+ */
+static void collect_values(hello_world_record_t *values, int message_number, const char *custom_text)
+{
+    memset(values, 0, sizeof(hello_world_record_t));
+
+    values->message_number = message_number;
+    values->uptime_ms = esp_timer_get_time() / 1000;
+
+    // Doubling from 1 and restarting once past 10000 cycles through 2^0..2^13
+    values->verification = message_number > 0 ? 1 << (message_number % 14) : 1;
+    values->hash = message_number * values->uptime_ms;  // Simple hash
+
+    if (g_app_state.config.include_system_info) {
+        values->flags |= HELLO_WORLD_RECORD_FLAG_SYSTEM_INFO;
+        values->free_heap = esp_get_free_heap_size();
+        values->min_free_heap = esp_get_minimum_free_heap_size();
+        values->target_port = g_app_state.config.target_port;
+    }
+
+    if (g_app_state.config.include_random_data) {
+        values->flags |= HELLO_WORLD_RECORD_FLAG_RANDOM_DATA;
+        values->random_value = esp_random() % 1000;
+        values->counter_squared = message_number * message_number;
+        values->sum_formula = (message_number * (message_number + 1) / 2) % 1000;
+    }
+
+    if (custom_text && custom_text[0] != '\0') {
+        values->flags |= HELLO_WORLD_RECORD_FLAG_CUSTOM_TEXT;
+        values->custom_length = strlen(custom_text);
+    }
+}
+
+/**
+ * @brief Build the text report as body fragments
+ */
+static esp_err_t generate_text_content(hello_world_message_t *msg, const hello_world_record_t *values)
+{
+    uint32_t uptime_ms = values->uptime_ms;
+    uint32_t uptime_seconds = uptime_ms / 1000;
+
+    add_fragment(msg, s_banner, sizeof(s_banner) - 1);
+
     // Build the main message
-    int written = snprintf(buffer, buffer_size,
-        "🎉 Hello World from ESP32! 🎉\n"
-        "═══════════════════════════════════════\n"
+    size_t len = block_length(
+        snprintf(msg->info_block, sizeof(msg->info_block),
         "📊 Message Information:\n"
         "   📋 Message Number: %d\n"
         "   ⏰ ESP32 Uptime: %lu.%03lu seconds (%lu ms total)\n"
         "   🧮 Verification Value: %d (calc: 2^%d)\n"
         "   🆔 Message Hash: %lu\n"
         "\n",
-        g_app_state.message_counter,
+        (int)values->message_number,
         (unsigned long)uptime_seconds, 
         (unsigned long)(uptime_ms % 1000), 
         (unsigned long)uptime_ms,
-        calculation_result, 
-        g_app_state.message_counter,
-        (unsigned long)(g_app_state.message_counter * uptime_ms)  // Simple hash
-    );
+        (int)values->verification, 
+        (int)values->message_number,
+        (unsigned long)values->hash
+    ), sizeof(msg->info_block));
 
-    if (written < 0 || written >= buffer_size) {
+    if (len == 0) {
         ESP_LOGE(TAG, "Message buffer too small");
         return ESP_ERR_NO_MEM;
     }
+    add_fragment(msg, msg->info_block, len);
 
     // Add system information if enabled
-    if (g_app_state.config.include_system_info) {
-        int remaining = buffer_size - written;
-        int sys_written = snprintf(buffer + written, remaining,
+    if (values->flags & HELLO_WORLD_RECORD_FLAG_SYSTEM_INFO) {
+        uint32_t free_heap = values->free_heap;
+        len = block_length(
+            snprintf(msg->system_block, sizeof(msg->system_block),
             "💾 ESP32 System Information:\n"
             "   🔧 Free Heap Memory: %lu bytes\n"
             "   📉 Minimum Free Heap: %lu bytes\n"
@@ -85,90 +194,167 @@ static esp_err_t generate_hello_world_content(char *buffer, size_t buffer_size,
             "   🏭 Target Server: %s:%d%s\n"
             "\n",
             (unsigned long)free_heap,
-            (unsigned long)min_free_heap,
+            (unsigned long)values->min_free_heap,
             100.0 - ((float)free_heap / (free_heap + (256*1024 - free_heap)) * 100.0),
             g_app_state.config.target_host,
             g_app_state.config.target_port,
             g_app_state.config.target_path
-        );
-        
-        if (sys_written > 0 && sys_written < remaining) {
-            written += sys_written;
-        }
+        ), sizeof(msg->system_block));
+        add_fragment(msg, msg->system_block, len);
     }
 
     // Add random data if enabled
-    if (g_app_state.config.include_random_data) {
-        int remaining = buffer_size - written;
-        int rand_written = snprintf(buffer + written, remaining,
+    if (values->flags & HELLO_WORLD_RECORD_FLAG_RANDOM_DATA) {
+        len = block_length(
+            snprintf(msg->random_block, sizeof(msg->random_block),
             "🔢 Verification Data (changes each message):\n"
             "   🎲 Random Value: %lu\n"
             "   📈 Counter Squared: %d\n"
             "   📊 Sum Formula: %d\n"
             "\n",
-            esp_random() % 1000,
-            g_app_state.message_counter * g_app_state.message_counter,
-            (g_app_state.message_counter * (g_app_state.message_counter + 1) / 2) % 1000
-        );
-        
-        if (rand_written > 0 && rand_written < remaining) {
-            written += rand_written;
-        }
+            (unsigned long)values->random_value,
+            (int)values->counter_squared,
+            (int)values->sum_formula
+        ), sizeof(msg->random_block));
+        add_fragment(msg, msg->random_block, len);
     }
 
     // Add custom message if provided
-    if (custom_message && strlen(custom_message) > 0) {
-        int remaining = buffer_size - written;
-        int custom_written = snprintf(buffer + written, remaining,
-            "💬 Custom Message:\n"
-            "%s\n"
-            "\n",
-            custom_message
-        );
-        
-        if (custom_written > 0 && custom_written < remaining) {
-            written += custom_written;
-        }
+    if (values->flags & HELLO_WORLD_RECORD_FLAG_CUSTOM_TEXT) {
+        add_fragment(msg, s_custom_title, sizeof(s_custom_title) - 1);
+        add_fragment(msg, msg->custom_text, values->custom_length);
+        add_fragment(msg, s_custom_end, sizeof(s_custom_end) - 1);
     }
 
     // Add network info and footer
-    int remaining = buffer_size - written;
-    if (remaining > 100) {
-        snprintf(buffer + written, remaining,
-            "🌐 Network Information:\n"
-            "   📡 ESP32 connected to WiFi\n"
-            "   🏠 Local network communication\n"
-            "   📨 HTTP POST request\n"
-            "\n"
-            "✨ Generated at runtime by ESP32!\n"
-            "═══════════════════════════════════════"
-        );
-    }
+    add_fragment(msg, s_footer, sizeof(s_footer) - 1);
 
     return ESP_OK;
 }
 
 /**
- * @brief Background task for auto mode
+ * @brief Build the compact record of a message, as batched or spooled
+ *
+ * @return Record length, or -1 on failure
  */
-static void auto_message_task(void *pvParameters)
+static int build_record(char *record, size_t size, int message_number, uint32_t uptime_ms, const char *custom_message)
 {
-    ESP_LOGI(TAG, "🤖 Auto mode started - sending messages every %d ms", 
-             g_app_state.config.message_interval_ms);
+    if (custom_message && custom_message[0] == '\0') {
+        custom_message = NULL;
+    }
 
-    while (g_app_state.auto_mode_running) {
-        esp_err_t ret = hello_world_app_send_message();
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to send auto message: %s", esp_err_to_name(ret));
+    int len;
+    if (g_app_state.config.encoding == HELLO_WORLD_ENCODING_BINARY) {
+        size_t text_len = custom_message ? strlen(custom_message) : 0;
+        if (text_len > size - HELLO_WORLD_RECORD_HEADER_SIZE) {
+            text_len = size - HELLO_WORLD_RECORD_HEADER_SIZE;
+        }
+
+        hello_world_record_t values;
+        collect_values(&values, message_number, NULL);
+        values.uptime_ms = uptime_ms;
+        if (text_len > 0) {
+            values.flags |= HELLO_WORLD_RECORD_FLAG_CUSTOM_TEXT;
+            values.custom_length = text_len;
+        }
+        len = hello_world_record_encode(&values, (uint8_t *)record, size);
+        if (text_len > 0) {
+            memcpy(record + len, custom_message, text_len);
+            len += text_len;
+        }
+    } else {
+        len = snprintf(record, size, "#%d uptime_ms=%lu free_heap=%lu%s%s",
+                       message_number,
+                       (unsigned long)uptime_ms,
+                       (unsigned long)esp_get_free_heap_size(),
+                       custom_message ? " " : "",
+                       custom_message ? custom_message : "");
+        if (len < 0) {
+            return -1;
+        }
+        if ((size_t)len >= size) {
+            len = size - 1;
         }
-        
-        // Wait for the specified interval
-        vTaskDelay(pdMS_TO_TICKS(g_app_state.config.message_interval_ms));
     }
+    return len;
+}
 
-    ESP_LOGI(TAG, "🛑 Auto mode stopped");
-    g_app_state.auto_task_handle = NULL;
-    vTaskDelete(NULL);
+/**
+ * @brief Generate Hello World message content as body fragments
+ */
+static esp_err_t generate_hello_world_content(hello_world_message_t *msg, int message_number, const char *custom_message)
+{
+    if (!msg) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    msg->custom_text[0] = '\0';
+    if (custom_message) {
+        strncpy(msg->custom_text, custom_message, sizeof(msg->custom_text) - 1);
+        msg->custom_text[sizeof(msg->custom_text) - 1] = '\0';
+    }
+
+    hello_world_record_t values;
+    collect_values(&values, message_number, msg->custom_text);
+
+    msg->request.body_iov = msg->fragments;
+    msg->request.body_iov_count = 0;
+
+    if (g_app_state.config.encoding == HELLO_WORLD_ENCODING_TEXT) {
+        msg->request.content_type = "text/plain; charset=utf-8";
+        return generate_text_content(msg, &values);
+    }
+
+    // Binary: fixed header, then the custom text straight from the message
+    msg->request.content_type = HELLO_WORLD_RECORD_CONTENT_TYPE;
+    size_t len = hello_world_record_encode(&values, msg->record_header, sizeof(msg->record_header));
+    add_fragment(msg, (const char *)msg->record_header, len);
+    add_fragment(msg, msg->custom_text, values.custom_length);
+    return ESP_OK;
+}
+
+/**
+ * @brief Scheduler job for auto mode
+ */
+static void auto_message_job(void *ctx)
+{
+    // Batched when batching runs (it decides when the radio wakes), else queued when
+    // possible, so a slow server does not hold up the scheduler
+    esp_err_t ret;
+    if (http_batch_is_running()) {
+        ret = hello_world_app_batch_message(NULL);
+    } else if (http_async_is_running()) {
+        ret = hello_world_app_send_custom_message_async(NULL);
+    } else {
+        ret = hello_world_app_send_message();
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to send auto message: %s", esp_err_to_name(ret));
+    }
+}
+
+/**
+ * @brief Metrics collector: message statistics
+ */
+static void collect_metrics(metrics_writer_t *writer, void *ctx)
+{
+    if (!g_app_state.initialized) {
+        return;
+    }
+
+    taskENTER_CRITICAL(&s_app_lock);
+    hello_world_stats_t stats = g_app_state.stats;
+    taskEXIT_CRITICAL(&s_app_lock);
+
+    metrics_write_counter(writer, "hello_world_messages_total{result=\"sent\"}", "Messages by outcome",
+                          stats.messages_sent);
+    metrics_write_counter(writer, "hello_world_messages_total{result=\"failed\"}", NULL, stats.messages_failed);
+    metrics_write_counter(writer, "hello_world_messages_total{result=\"spooled\"}", NULL,
+                          stats.messages_spooled);
+    if (http_spool_is_running()) {
+        metrics_write_gauge(writer, "hello_world_spool_pending", "Messages waiting in flash for replay",
+                            http_spool_pending());
+    }
 }
 
 esp_err_t hello_world_app_init(const hello_world_config_t *config)
@@ -191,22 +377,35 @@ esp_err_t hello_world_app_init(const hello_world_config_t *config)
     g_app_state.message_counter = 0;
     g_app_state.initialized = true;
     g_app_state.auto_mode_running = false;
-    g_app_state.auto_task_handle = NULL;
+    g_app_state.auto_job = SCHEDULER_JOB_NONE;
 
-    // Initialize the generic HTTP client
+    // The app owns its client handle, independent of other HTTP users
     http_client_config_t http_config = HTTP_CLIENT_CONFIG_DEFAULT();
     strcpy(http_config.host, config->target_host);
     http_config.port = config->target_port;
     strcpy(http_config.path, config->target_path);
     strcpy(http_config.user_agent, "ESP32-HelloWorld-App/1.0");
     http_config.enable_logging = true;
+    http_config.compress = config->compress;
+    // Messages are POSTs, so only connect failures are retried unless the policy says otherwise
+    http_config.retry.max_retries = config->max_retries;
 
-    esp_err_t ret = esp32_http_client_init(&http_config);
+    esp_err_t ret = esp32_http_client_create(&http_config, &g_app_state.client);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize HTTP client: %s", esp_err_to_name(ret));
+        g_app_state.initialized = false;
         return ret;
     }
 
+    // Constant on every message, so it is part of the handle's compiled headers
+    esp32_http_client_handle_add_header(g_app_state.client, "X-ESP32-App", "HelloWorld");
+
+    // Collectors cannot be removed: register once and skip while uninitialized
+    static bool collector_registered = false;
+    if (!collector_registered && metrics_register_collector(collect_metrics, NULL) == ESP_OK) {
+        collector_registered = true;
+    }
+
     ESP_LOGI(TAG, "Hello World App initialized");
     ESP_LOGI(TAG, "Target: %s:%d%s", config->target_host, config->target_port, config->target_path);
     ESP_LOGI(TAG, "System info: %s, Random data: %s", 
@@ -221,65 +420,126 @@ esp_err_t hello_world_app_send_message(void)
     return hello_world_app_send_custom_message(NULL);
 }
 
-esp_err_t hello_world_app_send_custom_message(const char *custom_message)
+/**
+ * @brief Prepare a message: number, body, headers and request
+ */
+static esp_err_t prepare_message(hello_world_message_t *msg, const char *custom_message)
 {
-    if (!g_app_state.initialized) {
-        ESP_LOGE(TAG, "App not initialized. Call hello_world_app_init() first.");
-        return ESP_ERR_INVALID_STATE;
-    }
+    taskENTER_CRITICAL(&s_app_lock);
+    msg->message_number = ++g_app_state.message_counter;
+    taskEXIT_CRITICAL(&s_app_lock);
 
-    g_app_state.message_counter++;
-    
-    ESP_LOGI(TAG, "📤 Sending Hello World message #%d", g_app_state.message_counter);
+    msg->request = (http_client_request_t){
+        .method = HTTP_CLIENT_METHOD_POST,
+        .headers = msg->headers,
+        .header_count = HELLO_WORLD_MESSAGE_HEADERS,
+    };
 
     // Generate message content
-    char message_buffer[1024];
-    esp_err_t ret = generate_hello_world_content(message_buffer, sizeof(message_buffer), custom_message);
+    esp_err_t ret = generate_hello_world_content(msg, msg->message_number, custom_message);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to generate message content");
+        taskENTER_CRITICAL(&s_app_lock);
         g_app_state.stats.messages_failed++;
+        taskEXIT_CRITICAL(&s_app_lock);
         return ret;
     }
 
     // Add custom headers with ESP32 information
-    char counter_header[32];
-    char uptime_header[32];
-    uint32_t uptime_ms = esp_timer_get_time() / 1000;
-    
-    snprintf(counter_header, sizeof(counter_header), "%d", g_app_state.message_counter);
-    snprintf(uptime_header, sizeof(uptime_header), "%lu", (unsigned long)uptime_ms);
-    
-    esp32_http_client_clear_headers();
-    esp32_http_client_add_header("X-ESP32-Message-Counter", counter_header);
-    esp32_http_client_add_header("X-ESP32-Uptime-MS", uptime_header);
-    esp32_http_client_add_header("X-ESP32-App", "HelloWorld");
+    msg->uptime_ms = esp_timer_get_time() / 1000;
+    snprintf(msg->counter_header, sizeof(msg->counter_header), "%d", msg->message_number);
+    snprintf(msg->uptime_header, sizeof(msg->uptime_header), "%lu", (unsigned long)msg->uptime_ms);
 
-    // Send the HTTP POST request
-    http_client_response_t response;
-    ret = esp32_http_client_post(g_app_state.config.target_path, "text/plain; charset=utf-8", message_buffer, &response);
-    
+    // Headers travel with the request, so concurrent senders cannot clobber them
+    msg->headers[0] = (http_client_header_t){ "X-ESP32-Message-Counter", msg->counter_header };
+    msg->headers[1] = (http_client_header_t){ "X-ESP32-Uptime-MS", msg->uptime_header };
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Record the outcome of a sent message in stats and the log
+ */
+static void record_result(const hello_world_message_t *msg, esp_err_t ret, const http_client_response_t *response)
+{
     if (ret == ESP_OK) {
+        bool delivered = (response->status_code == 200);
+
+        taskENTER_CRITICAL(&s_app_lock);
         g_app_state.stats.last_message_time = esp_timer_get_time() / 1000;
-        g_app_state.stats.uptime_at_last_message = uptime_ms;
-        
-        if (response.status_code == 200) {
-            ESP_LOGI(TAG, "✅ Hello World message #%d sent successfully!", g_app_state.message_counter);
-            ESP_LOGI(TAG, "📊 Response: %d, Uptime: %lu.%03lu seconds", 
-                    response.status_code, uptime_ms / 1000, uptime_ms % 1000);
+        g_app_state.stats.uptime_at_last_message = msg->uptime_ms;
+        g_app_state.stats.last_response_code = response->status_code;
+        if (delivered) {
             g_app_state.stats.messages_sent++;
         } else {
-            ESP_LOGW(TAG, "⚠️ Received response code: %d for message #%d", response.status_code, g_app_state.message_counter);
             g_app_state.stats.messages_failed++;
         }
+        taskEXIT_CRITICAL(&s_app_lock);
+        
+        if (delivered) {
+            static bool first_delivered = false;
+            if (!first_delivered) {
+                // Completes the boot trace: reset to first message on the server
+                first_delivered = true;
+                boot_trace_log();
+            }
+            LOG_RING_I(TAG, "✅ Hello World message #%d sent successfully!", msg->message_number);
+            LOG_RING_I(TAG, "📊 Response: %d, Uptime: %lu.%03lu seconds",
+                       response->status_code, msg->uptime_ms / 1000, msg->uptime_ms % 1000);
+        } else {
+            LOG_RING_W(TAG, "⚠️ Received response code: %d for message #%d", response->status_code, msg->message_number);
+        }
 
-        // Log response if available
-        if (response.body && response.body_length > 0) {
-            ESP_LOGI(TAG, "📥 Server response: %.*s", (int)response.body_length, response.body);
+        // The body lives in the response, so it cannot be deferred: debug builds only
+        if (response->body && response->body_length > 0) {
+            ESP_LOGD(TAG, "📥 Server response: %.*s", (int)response->body_length, response->body);
         }
     } else {
-        ESP_LOGE(TAG, "❌ Failed to send Hello World message #%d: %s", g_app_state.message_counter, esp_err_to_name(ret));
+        ESP_LOGE(TAG, "❌ Failed to send Hello World message #%d: %s", msg->message_number, esp_err_to_name(ret));
+        taskENTER_CRITICAL(&s_app_lock);
         g_app_state.stats.messages_failed++;
+        taskEXIT_CRITICAL(&s_app_lock);
+    }
+
+    if (!http_spool_is_running()) {
+        return;
+    }
+
+    if (ret != ESP_OK) {
+        // The server was not reached; keep the message for replay
+        char record[HELLO_WORLD_MAX_RECORD];
+        int len = build_record(record, sizeof(record), msg->message_number, msg->uptime_ms, msg->custom_text);
+        if (len > 0 && http_spool_append(record, len) == ESP_OK) {
+            taskENTER_CRITICAL(&s_app_lock);
+            g_app_state.stats.messages_spooled++;
+            taskEXIT_CRITICAL(&s_app_lock);
+            LOG_RING_I(TAG, "💾 Message #%d spooled to flash", msg->message_number);
+        }
+    } else if (http_spool_pending() > 0) {
+        // The server is back; no need to wait for the replay retry
+        http_spool_kick();
+    }
+}
+
+esp_err_t hello_world_app_send_custom_message(const char *custom_message)
+{
+    if (!g_app_state.initialized) {
+        ESP_LOGE(TAG, "App not initialized. Call hello_world_app_init() first.");
+        return ESP_ERR_INVALID_STATE;
     }
+
+    hello_world_message_t msg;
+    esp_err_t ret = prepare_message(&msg, custom_message);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    LOG_RING_I(TAG, "📤 Sending Hello World message #%d", msg.message_number);
+
+    // Send the HTTP POST request
+    http_client_response_t response;
+    ret = esp32_http_client_request(g_app_state.client, g_app_state.config.target_path, &msg.request, &response);
+    record_result(&msg, ret, &response);
     
     // Clean up response
     esp32_http_client_free_response(&response);
@@ -287,18 +547,259 @@ esp_err_t hello_world_app_send_custom_message(const char *custom_message)
     return ret;
 }
 
-esp_err_t hello_world_app_send_demo_sequence(int count, int base_delay_ms)
+/**
+ * @brief Completion callback for messages sent through http_async
+ */
+static void async_message_done(esp_err_t result, http_client_response_t *response, void *user_ctx)
+{
+    hello_world_message_t *msg = (hello_world_message_t *)user_ctx;
+    record_result(msg, result, response);
+    http_arena_free(msg);
+}
+
+esp_err_t hello_world_app_send_custom_message_async(const char *custom_message)
+{
+    if (!g_app_state.initialized) {
+        ESP_LOGE(TAG, "App not initialized. Call hello_world_app_init() first.");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (!http_async_is_running()) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Owned by the request until async_message_done() runs; an arena slot when one is free
+    hello_world_message_t *msg = http_arena_alloc(sizeof(hello_world_message_t));
+    if (!msg) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret = prepare_message(msg, custom_message);
+    if (ret != ESP_OK) {
+        http_arena_free(msg);
+        return ret;
+    }
+
+    LOG_RING_I(TAG, "📤 Queueing Hello World message #%d", msg->message_number);
+
+    // Dropped requests still complete through the callback, which frees msg
+    return http_async_submit(g_app_state.client, g_app_state.config.target_path,
+                             &msg->request, async_message_done, msg);
+}
+
+esp_err_t hello_world_app_start_batching(const http_batch_config_t *config)
+{
+    if (!g_app_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (g_app_state.batch_client) {
+        ESP_LOGW(TAG, "Batching already running");
+        return ESP_OK;
+    }
+
+    // The flush task gets its own handle so it never shares one with senders
+    http_client_config_t http_config;
+    esp32_http_client_handle_get_config(g_app_state.client, &http_config);
+    http_config.enable_logging = false;
+    // The batch task backs off on its own
+    http_config.retry.max_retries = 0;
+
+    esp_err_t ret = esp32_http_client_create(&http_config, &g_app_state.batch_client);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ret = http_batch_init(g_app_state.batch_client, config);
+    if (ret != ESP_OK) {
+        esp32_http_client_destroy(g_app_state.batch_client);
+        g_app_state.batch_client = NULL;
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "📦 Batching started");
+    return ESP_OK;
+}
+
+esp_err_t hello_world_app_stop_batching(void)
+{
+    if (!g_app_state.batch_client) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    http_batch_stats_t batch_stats;
+    if (http_batch_get_stats(&batch_stats) == ESP_OK) {
+        ESP_LOGI(TAG, "📦 Batching stopped: %lu records in %lu batches, %lu wakes, radio %lu ms/KiB",
+                 (unsigned long)batch_stats.records_sent, (unsigned long)batch_stats.batches_sent,
+                 (unsigned long)batch_stats.radio_wakes, (unsigned long)batch_stats.radio_ms_per_kb);
+    }
+
+    http_batch_deinit();
+    esp32_http_client_destroy(g_app_state.batch_client);
+    g_app_state.batch_client = NULL;
+    return ESP_OK;
+}
+
+/**
+ * @brief Pipeline producer: sample and encode one record into the ring slot
+ */
+static size_t produce_pipeline_record(uint8_t *buffer, size_t size, void *ctx)
+{
+    taskENTER_CRITICAL(&s_app_lock);
+    int message_number = ++g_app_state.message_counter;
+    taskEXIT_CRITICAL(&s_app_lock);
+
+    int len = build_record((char *)buffer, size, message_number, esp_timer_get_time() / 1000, NULL);
+    return len > 0 ? (size_t)len : 0;
+}
+
+esp_err_t hello_world_app_start_pipeline(const http_pipeline_config_t *config)
+{
+    if (!g_app_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (g_app_state.pipeline_client) {
+        ESP_LOGW(TAG, "Pipeline already running");
+        return ESP_OK;
+    }
+
+    // The transmitter gets its own handle, like the batch flush task
+    http_client_config_t http_config;
+    esp32_http_client_handle_get_config(g_app_state.client, &http_config);
+    http_config.enable_logging = false;
+    // The transmitter backs off on its own
+    http_config.retry.max_retries = 0;
+
+    esp_err_t ret = esp32_http_client_create(&http_config, &g_app_state.pipeline_client);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ret = http_pipeline_init(g_app_state.pipeline_client, config, produce_pipeline_record, NULL);
+    if (ret != ESP_OK) {
+        esp32_http_client_destroy(g_app_state.pipeline_client);
+        g_app_state.pipeline_client = NULL;
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "🏭 Pipeline started");
+    return ESP_OK;
+}
+
+esp_err_t hello_world_app_stop_pipeline(void)
+{
+    if (!g_app_state.pipeline_client) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    http_pipeline_stats_t pipeline_stats;
+    if (http_pipeline_get_stats(&pipeline_stats) == ESP_OK) {
+        ESP_LOGI(TAG, "🏭 Pipeline stopped: %lu records in %lu batches, %lu dropped, ring high water %d/%d",
+                 (unsigned long)pipeline_stats.records_sent, (unsigned long)pipeline_stats.batches_sent,
+                 (unsigned long)pipeline_stats.records_dropped, pipeline_stats.ring_high_water,
+                 pipeline_stats.ring_depth);
+    }
+
+    http_pipeline_deinit();
+    esp32_http_client_destroy(g_app_state.pipeline_client);
+    g_app_state.pipeline_client = NULL;
+    return ESP_OK;
+}
+
+esp_err_t hello_world_app_start_spool(const http_spool_config_t *config)
+{
+    if (!g_app_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (g_app_state.spool_client) {
+        ESP_LOGW(TAG, "Spool already running");
+        return ESP_OK;
+    }
+
+    // Replay runs on its own handle, like the batch flush task
+    http_client_config_t http_config;
+    esp32_http_client_handle_get_config(g_app_state.client, &http_config);
+    http_config.enable_logging = false;
+    // The replay task backs off on its own
+    http_config.retry.max_retries = 0;
+
+    esp_err_t ret = esp32_http_client_create(&http_config, &g_app_state.spool_client);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ret = http_spool_init(g_app_state.spool_client, config);
+    if (ret != ESP_OK) {
+        esp32_http_client_destroy(g_app_state.spool_client);
+        g_app_state.spool_client = NULL;
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "💾 Spool started, %d messages waiting for replay", http_spool_pending());
+    return ESP_OK;
+}
+
+esp_err_t hello_world_app_stop_spool(void)
+{
+    if (!g_app_state.spool_client) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    http_spool_stats_t spool_stats;
+    if (http_spool_get_stats(&spool_stats) == ESP_OK) {
+        ESP_LOGI(TAG, "💾 Spool stopped: %lu replayed, %lu still pending",
+                 (unsigned long)spool_stats.records_replayed, (unsigned long)spool_stats.records_pending);
+    }
+
+    http_spool_deinit();
+    esp32_http_client_destroy(g_app_state.spool_client);
+    g_app_state.spool_client = NULL;
+    return ESP_OK;
+}
+
+esp_err_t hello_world_app_batch_message(const char *custom_message)
+{
+    if (!g_app_state.initialized || !http_batch_is_running()) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    taskENTER_CRITICAL(&s_app_lock);
+    int message_number = ++g_app_state.message_counter;
+    taskEXIT_CRITICAL(&s_app_lock);
+
+    char record[HELLO_WORLD_MAX_RECORD];
+    int len = build_record(record, sizeof(record), message_number, esp_timer_get_time() / 1000, custom_message);
+    if (len < 0) {
+        return ESP_FAIL;
+    }
+
+    // Delivery is counted in the batch statistics; only rejected records show up here
+    esp_err_t ret = http_batch_append(record, len);
+    if (ret != ESP_OK) {
+        taskENTER_CRITICAL(&s_app_lock);
+        g_app_state.stats.messages_failed++;
+        taskEXIT_CRITICAL(&s_app_lock);
+    }
+    return ret;
+}
+
+esp_err_t hello_world_app_send_demo_sequence(int count, int interval_ms)
 {
     if (!g_app_state.initialized) {
         return ESP_ERR_INVALID_STATE;
     }
     
-    if (count <= 0 || base_delay_ms < 0) {
+    if (count <= 0 || interval_ms < 0) {
         return ESP_ERR_INVALID_ARG;
     }
     
     ESP_LOGI(TAG, "🚀 Starting Hello World demo: %d messages", count);
     
+    // xTaskDelayUntil() asserts on a zero increment: sub-tick intervals wait one tick
+    TickType_t period = pdMS_TO_TICKS(interval_ms) > 0 ? pdMS_TO_TICKS(interval_ms) : 1;
+    TickType_t last_start = xTaskGetTickCount();
     for (int i = 0; i < count; i++) {
         char demo_message[128];
         snprintf(demo_message, sizeof(demo_message), "Demo sequence message %d of %d", i + 1, count);
@@ -309,11 +810,9 @@ esp_err_t hello_world_app_send_demo_sequence(int count, int base_delay_ms)
             return ret;
         }
         
-        // Wait before next message (except for last message)
+        // Next message interval_ms after the start of this one, not after its end
         if (i < count - 1) {
-            int delay_ms = base_delay_ms + (i * 1000);  // Increasing delay
-            ESP_LOGI(TAG, "⏳ Waiting %d ms before next message...", delay_ms);
-            vTaskDelay(pdMS_TO_TICKS(delay_ms));
+            xTaskDelayUntil(&last_start, period);
         }
     }
     
@@ -331,7 +830,30 @@ esp_err_t hello_world_app_get_stats(hello_world_stats_t *stats)
         return ESP_ERR_INVALID_STATE;
     }
     
+    taskENTER_CRITICAL(&s_app_lock);
     memcpy(stats, &g_app_state.stats, sizeof(hello_world_stats_t));
+    taskEXIT_CRITICAL(&s_app_lock);
+
+    http_client_stats_t client_stats;
+    if (esp32_http_client_handle_get_stats(g_app_state.client, &client_stats) == ESP_OK) {
+        stats->latency = client_stats.latency[HTTP_PHASE_TOTAL];
+    }
+    return ESP_OK;
+}
+
+esp_err_t hello_world_app_reset_stats(void)
+{
+    if (!g_app_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    taskENTER_CRITICAL(&s_app_lock);
+    memset(&g_app_state.stats, 0, sizeof(hello_world_stats_t));
+    g_app_state.message_counter = 0;
+    taskEXIT_CRITICAL(&s_app_lock);
+    esp32_http_client_handle_reset_stats(g_app_state.client);
+
+    ESP_LOGI(TAG, "Statistics reset");
     return ESP_OK;
 }
 
@@ -349,11 +871,19 @@ esp_err_t hello_world_app_update_config(const hello_world_config_t *config)
     
     // Update HTTP client config too
     http_client_config_t http_config;
-    esp32_http_client_get_config(&http_config);
+    esp32_http_client_handle_get_config(g_app_state.client, &http_config);
     strcpy(http_config.host, config->target_host);
     http_config.port = config->target_port;
     strcpy(http_config.path, config->target_path);
-    esp32_http_client_update_config(&http_config);
+    http_config.compress = config->compress;
+    http_config.retry.max_retries = config->max_retries;
+    esp32_http_client_handle_update_config(g_app_state.client, &http_config);
+
+    // A new interval or jitter takes effect on a fresh grid
+    if (g_app_state.auto_mode_running) {
+        hello_world_app_stop_auto_mode();
+        hello_world_app_start_auto_mode();
+    }
     
     ESP_LOGI(TAG, "Configuration updated");
     return ESP_OK;
@@ -370,15 +900,25 @@ esp_err_t hello_world_app_start_auto_mode(void)
         return ESP_OK;
     }
     
-    g_app_state.auto_mode_running = true;
-    
-    BaseType_t result = xTaskCreate(auto_message_task, "hello_auto", 4096, NULL, 5, &g_app_state.auto_task_handle);
-    if (result != pdPASS) {
-        g_app_state.auto_mode_running = false;
-        ESP_LOGE(TAG, "Failed to create auto mode task");
-        return ESP_FAIL;
+    esp_err_t ret = scheduler_init(NULL);
+    if (ret != ESP_OK) {
+        return ret;
     }
-    
+
+    scheduler_job_config_t job = {
+        .name = "hello_auto",
+        .period_ms = g_app_state.config.message_interval_ms,
+        .jitter_ms = g_app_state.config.message_jitter_ms,
+        .callback = auto_message_job,
+    };
+    ret = scheduler_add_job(&job, &g_app_state.auto_job);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to schedule auto mode: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    g_app_state.auto_mode_running = true;
+    ESP_LOGI(TAG, "🤖 Auto mode started - sending messages every %d ms", g_app_state.config.message_interval_ms);
     return ESP_OK;
 }
 
@@ -393,14 +933,17 @@ esp_err_t hello_world_app_stop_auto_mode(void)
         return ESP_OK;
     }
     
-    g_app_state.auto_mode_running = false;
-    
-    // Wait for task to finish
-    if (g_app_state.auto_task_handle) {
-        // Task will delete itself
-        g_app_state.auto_task_handle = NULL;
+    scheduler_job_stats_t job_stats;
+    if (scheduler_get_job_stats(g_app_state.auto_job, &job_stats) == ESP_OK) {
+        ESP_LOGI(TAG, "🛑 Auto mode stopped: %lu runs, %lu missed, max lateness %lu us",
+                 (unsigned long)job_stats.runs, (unsigned long)job_stats.missed,
+                 (unsigned long)job_stats.max_lateness_us);
     }
-    
+
+    // Returns once a run in progress has finished
+    scheduler_remove_job(g_app_state.auto_job);
+    g_app_state.auto_job = SCHEDULER_JOB_NONE;
+    g_app_state.auto_mode_running = false;
     return ESP_OK;
 }
 
@@ -417,9 +960,21 @@ esp_err_t hello_world_app_deinit(void)
     
     // Stop auto mode if running
     hello_world_app_stop_auto_mode();
+
+    if (g_app_state.batch_client) {
+        hello_world_app_stop_batching();
+    }
+
+    if (g_app_state.spool_client) {
+        hello_world_app_stop_spool();
+    }
+
+    if (g_app_state.pipeline_client) {
+        hello_world_app_stop_pipeline();
+    }
     
-    // Deinitialize HTTP client
-    esp32_http_client_deinit();
+    // Release the HTTP client handle
+    esp32_http_client_destroy(g_app_state.client);
     
     // Clear state
     memset(&g_app_state, 0, sizeof(g_app_state));
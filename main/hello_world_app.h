@@ -11,11 +11,23 @@
 
 #include "esp_err.h"
 #include <stdbool.h>
+#include "http_batch.h"
+#include "http_pipeline.h"
+#include "http_spool.h"
+#include "esp32_http_client.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Message body encoding
+ */
+typedef enum {
+    HELLO_WORLD_ENCODING_TEXT = 0,      /**< Human-readable text report */
+    HELLO_WORLD_ENCODING_BINARY         /**< Compact little-endian record, see hello_world_record.h */
+} hello_world_encoding_t;
+
 /**
  * @brief Hello World application configuration
  */
@@ -26,6 +38,10 @@ typedef struct {
     bool include_system_info;   /**< Include ESP32 system information */
     bool include_random_data;   /**< Include random data for verification */
     int message_interval_ms;    /**< Interval between messages (for auto mode) */
+    int message_jitter_ms;      /**< Random delay of each auto message after its slot (0 = exact cadence) */
+    hello_world_encoding_t encoding; /**< Body encoding of messages and batch records */
+    bool compress;              /**< gzip-compress message and batch bodies */
+    int max_retries;            /**< Retries of a message that could not be delivered (see http_retry.h) */
 } hello_world_config_t;
 
 /**
@@ -36,6 +52,9 @@ typedef struct {
     int messages_failed;        /**< Failed messages */
     uint64_t last_message_time; /**< Timestamp of last message */
     uint32_t uptime_at_last_message; /**< ESP32 uptime when last message was sent */
+    int last_response_code;     /**< HTTP status of the last completed message */
+    int messages_spooled;       /**< Failed messages kept in flash for replay */
+    http_client_latency_t latency; /**< End-to-end latency of sent messages */
 } hello_world_stats_t;
 
 /**
@@ -47,7 +66,11 @@ typedef struct {
     .target_path = "/hello",                       \
     .include_system_info = true,                   \
     .include_random_data = true,                   \
-    .message_interval_ms = 5000                    \
+    .message_interval_ms = 5000,                   \
+    .message_jitter_ms = 0,                        \
+    .encoding = HELLO_WORLD_ENCODING_TEXT,         \
+    .compress = false,                             \
+    .max_retries = 3                               \
 }
 
 /**
@@ -75,14 +98,98 @@ esp_err_t hello_world_app_send_message(void);
  */
 esp_err_t hello_world_app_send_custom_message(const char *custom_message);
 
+/**
+ * @brief Queue a Hello World message with custom content
+ * 
+ * Returns as soon as the message is queued; the request runs on the
+ * http_async worker and the statistics are updated when it completes.
+ * Requires http_async_init().
+ * 
+ * @param custom_message Additional custom content to include (optional)
+ * @return ESP_OK if queued, ESP_ERR_* on failure
+ */
+esp_err_t hello_world_app_send_custom_message_async(const char *custom_message);
+
+/**
+ * @brief Start batching messages over a dedicated client handle
+ * 
+ * After this, hello_world_app_batch_message() appends compact records
+ * that are sent to the target host in batches (see http_batch.h).
+ * 
+ * @param config Batching configuration (NULL = defaults)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t hello_world_app_start_batching(const http_batch_config_t *config);
+
+/**
+ * @brief Flush pending records and stop batching
+ * 
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t hello_world_app_stop_batching(void);
+
+/**
+ * @brief Start sampling records into the producer/transmitter pipeline
+ * 
+ * A producer task encodes a compact record every sample interval and a
+ * transmitter task on a dedicated client handle sends them in batches
+ * (see http_pipeline.h), so sampling never waits on the network.
+ * 
+ * @param config Pipeline configuration (NULL = defaults)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t hello_world_app_start_pipeline(const http_pipeline_config_t *config);
+
+/**
+ * @brief Stop sampling and send what is left in the pipeline
+ * 
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t hello_world_app_stop_pipeline(void);
+
+/**
+ * @brief Start spooling undeliverable messages to flash
+ * 
+ * After this, a message that fails because the server cannot be reached
+ * is stored as a compact record and replayed later over a dedicated
+ * client handle (see http_spool.h). Messages kept from before a reboot
+ * are replayed too.
+ * 
+ * @param config Spool configuration (NULL = defaults)
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if there is no spool partition, ESP_ERR_* on failure
+ */
+esp_err_t hello_world_app_start_spool(const http_spool_config_t *config);
+
+/**
+ * @brief Stop spooling
+ * 
+ * Messages not yet replayed stay in flash.
+ * 
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t hello_world_app_stop_spool(void);
+
+/**
+ * @brief Append a Hello World record to the current batch
+ * 
+ * Cheap enough to call at sampling rate: the record is a single short
+ * line and the HTTP request happens later on the batch flush task.
+ * 
+ * @param custom_message Additional custom content to include (optional)
+ * @return ESP_OK if appended, ESP_ERR_TIMEOUT if the batch buffer stayed full, ESP_ERR_* on failure
+ */
+esp_err_t hello_world_app_batch_message(const char *custom_message);
+
 /**
  * @brief Send a sequence of Hello World messages for demonstration
  * 
+ * Messages start interval_ms apart, however long each one takes.
+ * 
  * @param count Number of messages to send
- * @param base_delay_ms Base delay between messages (will increase progressively)
+ * @param interval_ms Time between the starts of two messages (at least one tick)
  * @return ESP_OK on success, ESP_ERR_* on failure
  */
-esp_err_t hello_world_app_send_demo_sequence(int count, int base_delay_ms);
+esp_err_t hello_world_app_send_demo_sequence(int count, int interval_ms);
 
 /**
  * @brief Get Hello World application statistics
@@ -92,6 +199,13 @@ esp_err_t hello_world_app_send_demo_sequence(int count, int base_delay_ms);
  */
 esp_err_t hello_world_app_get_stats(hello_world_stats_t *stats);
 
+/**
+ * @brief Reset statistics and the message counter
+ * 
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t hello_world_app_reset_stats(void);
+
 /**
  * @brief Update application configuration
  * 
@@ -101,9 +215,13 @@ esp_err_t hello_world_app_get_stats(hello_world_stats_t *stats);
 esp_err_t hello_world_app_update_config(const hello_world_config_t *config);
 
 /**
- * @brief Start automatic message sending (runs in background task)
+ * @brief Start automatic message sending (runs as a scheduler job)
  * 
- * Sends messages at configured intervals until stopped.
+ * Sends a message every message_interval_ms on a fixed cadence (see
+ * scheduler.h), moved by up to message_jitter_ms, until stopped.
+ * Messages are appended to the batch while batching runs, go through
+ * http_async when its worker is running, and are otherwise sent on the
+ * scheduler task.
  * 
  * @return ESP_OK on success, ESP_ERR_* on failure
  */
@@ -0,0 +1,60 @@
+/**
+ * @file hello_world_record.c
+ * @brief Compact Binary Encoding Implementation
+ */
+
+#include "hello_world_record.h"
+#include <stdbool.h>
+
+/**
+ * @brief Store a 16-bit value little-endian
+ */
+static uint8_t *put_u16(uint8_t *p, uint16_t value)
+{
+    p[0] = value & 0xFF;
+    p[1] = value >> 8;
+    return p + 2;
+}
+
+/**
+ * @brief Store a 32-bit value little-endian
+ */
+static uint8_t *put_u32(uint8_t *p, uint32_t value)
+{
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+    p[2] = (value >> 16) & 0xFF;
+    p[3] = value >> 24;
+    return p + 4;
+}
+
+size_t hello_world_record_encode(const hello_world_record_t *record, uint8_t *buffer, size_t size)
+{
+    if (!record || !buffer || size < HELLO_WORLD_RECORD_HEADER_SIZE) {
+        return 0;
+    }
+
+    uint8_t *p = buffer;
+    *p++ = 'H';
+    *p++ = 'W';
+    *p++ = HELLO_WORLD_RECORD_VERSION;
+    *p++ = record->flags;
+    p = put_u32(p, record->message_number);
+    p = put_u32(p, record->uptime_ms);
+    p = put_u32(p, record->verification);
+    p = put_u32(p, record->hash);
+
+    bool system_info = record->flags & HELLO_WORLD_RECORD_FLAG_SYSTEM_INFO;
+    p = put_u32(p, system_info ? record->free_heap : 0);
+    p = put_u32(p, system_info ? record->min_free_heap : 0);
+    p = put_u16(p, system_info ? record->target_port : 0);
+
+    bool random_data = record->flags & HELLO_WORLD_RECORD_FLAG_RANDOM_DATA;
+    p = put_u32(p, random_data ? record->random_value : 0);
+    p = put_u32(p, random_data ? record->counter_squared : 0);
+    p = put_u16(p, random_data ? record->sum_formula : 0);
+
+    p = put_u16(p, (record->flags & HELLO_WORLD_RECORD_FLAG_CUSTOM_TEXT) ? record->custom_length : 0);
+
+    return p - buffer;
+}
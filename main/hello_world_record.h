@@ -0,0 +1,83 @@
+/**
+ * @file hello_world_record.h
+ * @brief Compact Binary Encoding of Hello World Messages
+ *
+ * A fixed little-endian layout carrying the same values as the text
+ * report, without formatting. Decoded by simple_server.py.
+ *
+ * Layout (version 1, HELLO_WORLD_RECORD_HEADER_SIZE bytes, then the text):
+ *
+ *   offset  size  field
+ *        0     2  magic "HW"
+ *        2     1  version (1)
+ *        3     1  flags (HELLO_WORLD_RECORD_FLAG_*)
+ *        4     4  message number
+ *        8     4  uptime in ms
+ *       12     4  verification value (2^n, wrapped)
+ *       16     4  message hash
+ *       20     4  free heap in bytes           (system info)
+ *       24     4  minimum free heap in bytes   (system info)
+ *       28     2  target port                  (system info)
+ *       30     4  random value                 (random data)
+ *       34     4  counter squared              (random data)
+ *       38     2  sum formula                  (random data)
+ *       40     2  custom text length n
+ *       42     n  custom text, UTF-8, not terminated
+ *
+ * Fields of a group whose flag is clear are sent as zero. New versions
+ * may only append fields; decoders skip what they do not know.
+ */
+
+#ifndef HELLO_WORLD_RECORD_H
+#define HELLO_WORLD_RECORD_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HELLO_WORLD_RECORD_VERSION      1
+#define HELLO_WORLD_RECORD_HEADER_SIZE  42
+#define HELLO_WORLD_RECORD_CONTENT_TYPE "application/x-esp32-hello"
+
+#define HELLO_WORLD_RECORD_FLAG_SYSTEM_INFO (1 << 0)   /**< Heap and port fields are valid */
+#define HELLO_WORLD_RECORD_FLAG_RANDOM_DATA (1 << 1)   /**< Verification data fields are valid */
+#define HELLO_WORLD_RECORD_FLAG_CUSTOM_TEXT (1 << 2)   /**< Custom text follows */
+
+/**
+ * @brief Values of one Hello World message
+ */
+typedef struct {
+    uint8_t flags;              /**< HELLO_WORLD_RECORD_FLAG_* */
+    uint32_t message_number;
+    uint32_t uptime_ms;
+    uint32_t verification;
+    uint32_t hash;
+    uint32_t free_heap;
+    uint32_t min_free_heap;
+    uint16_t target_port;
+    uint32_t random_value;
+    uint32_t counter_squared;
+    uint16_t sum_formula;
+    uint16_t custom_length;     /**< Length of the text sent after the header */
+} hello_world_record_t;
+
+/**
+ * @brief Encode the fixed part of a record
+ *
+ * The custom text is not copied; send it right after the header.
+ *
+ * @param record Values to encode
+ * @param buffer Output buffer, at least HELLO_WORLD_RECORD_HEADER_SIZE bytes
+ * @param size Size of buffer
+ * @return Bytes written, 0 if the buffer is too small
+ */
+size_t hello_world_record_encode(const hello_world_record_t *record, uint8_t *buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HELLO_WORLD_RECORD_H
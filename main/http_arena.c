@@ -0,0 +1,193 @@
+/**
+ * @file http_arena.c
+ * @brief Preallocated Request/Response Buffer Slots Implementation
+ *
+ * One block of slot_count * slot_size bytes and a bitmap of free slots;
+ * taking or returning a slot is a few instructions under a spinlock.
+ */
+
+#include "http_arena.h"
+#include <string.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "metrics.h"
+
+static const char *TAG = "HTTP_ARENA";
+
+/**
+ * @brief Arena state
+ */
+static struct {
+    http_arena_config_t config;
+    uint8_t *base;                      /**< First slot */
+    uint32_t free_mask;                 /**< Bit i set = slot i free */
+    http_arena_stats_t stats;
+    bool initialized;
+} g_arena_state = {0};
+
+static portMUX_TYPE s_arena_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Slot index of a pointer, -1 if it is not a slot
+ */
+static int slot_index(const void *ptr)
+{
+    if (!g_arena_state.base) {
+        return -1;
+    }
+
+    const uint8_t *p = (const uint8_t *)ptr;
+    size_t total = g_arena_state.config.slot_count * g_arena_state.config.slot_size;
+    if (p < g_arena_state.base || p >= g_arena_state.base + total) {
+        return -1;
+    }
+    return (int)((p - g_arena_state.base) / g_arena_state.config.slot_size);
+}
+
+/**
+ * @brief Metrics collector: slot usage
+ */
+static void collect_metrics(metrics_writer_t *writer, void *ctx)
+{
+    http_arena_stats_t stats;
+    if (http_arena_get_stats(&stats) != ESP_OK) {
+        return;
+    }
+
+    metrics_write_gauge(writer, "http_arena_slots_in_use", "Buffer slots handed out", stats.slots_in_use);
+    metrics_write_counter(writer, "http_arena_allocs_total{from=\"slot\"}", "Buffer allocations by source",
+                          stats.slot_allocs);
+    metrics_write_counter(writer, "http_arena_allocs_total{from=\"heap\"}", NULL, stats.heap_fallbacks);
+}
+
+esp_err_t http_arena_init(const http_arena_config_t *config)
+{
+    if (g_arena_state.initialized) {
+        return ESP_OK;
+    }
+
+    http_arena_config_t defaults = HTTP_ARENA_CONFIG_DEFAULT();
+    if (!config) {
+        config = &defaults;
+    }
+
+    if (config->slot_count <= 0 || config->slot_count > HTTP_ARENA_MAX_SLOTS || config->slot_size < 64) {
+        ESP_LOGE(TAG, "Invalid arena configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Slots stay word aligned
+    size_t slot_size = (config->slot_size + 3) & ~(size_t)3;
+    uint8_t *base = heap_caps_malloc(slot_size * config->slot_count, config->caps);
+    if (!base) {
+        ESP_LOGE(TAG, "Failed to allocate %d slots of %u bytes", config->slot_count, (unsigned)slot_size);
+        return ESP_ERR_NO_MEM;
+    }
+
+    taskENTER_CRITICAL(&s_arena_lock);
+    memcpy(&g_arena_state.config, config, sizeof(http_arena_config_t));
+    g_arena_state.config.slot_size = slot_size;
+    g_arena_state.base = base;
+    g_arena_state.free_mask = (config->slot_count == 32) ? UINT32_MAX : ((1u << config->slot_count) - 1);
+    memset(&g_arena_state.stats, 0, sizeof(http_arena_stats_t));
+    g_arena_state.stats.slot_count = config->slot_count;
+    g_arena_state.stats.slot_size = slot_size;
+    g_arena_state.initialized = true;
+    taskEXIT_CRITICAL(&s_arena_lock);
+
+    static bool collector_registered = false;
+    if (!collector_registered && metrics_register_collector(collect_metrics, NULL) == ESP_OK) {
+        collector_registered = true;
+    }
+
+    ESP_LOGI(TAG, "Arena ready: %d slots of %u bytes%s", config->slot_count, (unsigned)slot_size,
+             (config->caps & MALLOC_CAP_SPIRAM) ? " in PSRAM" : "");
+    return ESP_OK;
+}
+
+void *http_arena_alloc(size_t size)
+{
+    void *slot = NULL;
+
+    taskENTER_CRITICAL(&s_arena_lock);
+    if (g_arena_state.initialized && size <= g_arena_state.config.slot_size && g_arena_state.free_mask) {
+        int index = __builtin_ctz(g_arena_state.free_mask);
+        g_arena_state.free_mask &= ~(1u << index);
+        slot = g_arena_state.base + index * g_arena_state.config.slot_size;
+
+        g_arena_state.stats.slot_allocs++;
+        g_arena_state.stats.slots_in_use++;
+        if (g_arena_state.stats.slots_in_use > g_arena_state.stats.peak_slots_in_use) {
+            g_arena_state.stats.peak_slots_in_use = g_arena_state.stats.slots_in_use;
+        }
+    } else if (g_arena_state.initialized) {
+        g_arena_state.stats.heap_fallbacks++;
+    }
+    taskEXIT_CRITICAL(&s_arena_lock);
+
+    return slot ? slot : malloc(size);
+}
+
+void http_arena_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+
+    taskENTER_CRITICAL(&s_arena_lock);
+    int index = slot_index(ptr);
+    if (index >= 0) {
+        g_arena_state.free_mask |= 1u << index;
+        g_arena_state.stats.slots_in_use--;
+    }
+    taskEXIT_CRITICAL(&s_arena_lock);
+
+    if (index < 0) {
+        free(ptr);
+    }
+}
+
+size_t http_arena_slot_size(void)
+{
+    return g_arena_state.initialized ? g_arena_state.config.slot_size : 0;
+}
+
+esp_err_t http_arena_get_stats(http_arena_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_arena_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    taskENTER_CRITICAL(&s_arena_lock);
+    memcpy(stats, &g_arena_state.stats, sizeof(http_arena_stats_t));
+    taskEXIT_CRITICAL(&s_arena_lock);
+    return ESP_OK;
+}
+
+esp_err_t http_arena_deinit(void)
+{
+    if (!g_arena_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    taskENTER_CRITICAL(&s_arena_lock);
+    bool busy = g_arena_state.stats.slots_in_use > 0;
+    uint8_t *base = g_arena_state.base;
+    if (!busy) {
+        memset(&g_arena_state, 0, sizeof(g_arena_state));
+    }
+    taskEXIT_CRITICAL(&s_arena_lock);
+
+    if (busy) {
+        ESP_LOGW(TAG, "Arena still in use, not freed");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    heap_caps_free(base);
+    return ESP_OK;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file http_arena.h
+ * @brief Preallocated Request/Response Buffer Slots
+ *
+ * Buffers that live for one request (response bodies, queued messages)
+ * come from a fixed set of equal slots allocated once at init, so a
+ * device that runs for days does not keep cutting the heap into ever
+ * smaller pieces. The slots can be placed in internal RAM or PSRAM.
+ *
+ * http_arena_alloc() hands out a free slot when the size fits and falls
+ * back to the heap otherwise (too large, all slots in use, or the arena
+ * not initialized); http_arena_free() returns either kind. The fallbacks
+ * are counted, so heap_fallbacks staying flat means requests run
+ * without heap allocations.
+ *
+ * The arena is shared by every client handle.
+ */
+
+#ifndef HTTP_ARENA_H
+#define HTTP_ARENA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_ARENA_MAX_SLOTS 32
+
+/**
+ * @brief Arena configuration
+ */
+typedef struct {
+    int slot_count;             /**< Slots (1..HTTP_ARENA_MAX_SLOTS) */
+    size_t slot_size;           /**< Bytes per slot */
+    uint32_t caps;              /**< heap_caps_malloc() capabilities, e.g. MALLOC_CAP_SPIRAM */
+} http_arena_config_t;
+
+/**
+ * @brief Default arena configuration
+ */
+#define HTTP_ARENA_CONFIG_DEFAULT() {                   \
+    .slot_count = 4,                                    \
+    .slot_size = 2048,                                  \
+    .caps = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT       \
+}
+
+/**
+ * @brief Arena statistics
+ */
+typedef struct {
+    int slot_count;             /**< Slots */
+    size_t slot_size;           /**< Bytes per slot */
+    int slots_in_use;           /**< Slots handed out now */
+    int peak_slots_in_use;      /**< Most slots handed out at once */
+    uint32_t slot_allocs;       /**< Allocations served from a slot */
+    uint32_t heap_fallbacks;    /**< Allocations served from the heap */
+} http_arena_stats_t;
+
+/**
+ * @brief Allocate the slots
+ *
+ * @param config Arena configuration (NULL = defaults)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_arena_init(const http_arena_config_t *config);
+
+/**
+ * @brief Get a buffer
+ *
+ * @param size Bytes needed
+ * @return Buffer, or NULL if the heap fallback failed too
+ */
+void *http_arena_alloc(size_t size);
+
+/**
+ * @brief Release a buffer from http_arena_alloc()
+ *
+ * @param ptr Buffer (NULL is ignored)
+ */
+void http_arena_free(void *ptr);
+
+/**
+ * @brief Size of one slot
+ *
+ * @return Slot size, 0 if the arena is not initialized
+ */
+size_t http_arena_slot_size(void);
+
+/**
+ * @brief Get arena statistics
+ *
+ * @param stats Pointer to statistics structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_arena_get_stats(http_arena_stats_t *stats);
+
+/**
+ * @brief Free the slots
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if a slot is still in use
+ */
+esp_err_t http_arena_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_ARENA_H
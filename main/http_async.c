@@ -0,0 +1,553 @@
+/**
+ * @file http_async.c
+ * @brief Asynchronous Request Queue Implementation
+ *
+ * With one worker requests run strictly one after another. With more,
+ * each worker takes the next job, waits for room under its origin's
+ * in-flight limit and sends it over its own pooled connection. Jobs are
+ * numbered as they leave the queue, and with ordered_completion a
+ * worker whose response came early waits for the earlier callbacks
+ * before running its own.
+ */
+
+#include "http_async.h"
+#include "http_link.h"
+#include "http_conn_pool.h"
+#include <string.h>
+#include <stdio.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "HTTP_ASYNC";
+
+#define LINK_POLL_MS 1000               /**< How often a worker held by a link outage checks for deinit */
+
+/**
+ * @brief Queued request
+ */
+typedef struct {
+    esp32_http_client_handle_t client;  /**< NULL marks the stop request */
+    char target[160];
+    bool has_target;
+    http_client_request_t request;
+    http_async_callback_t callback;
+    void *user_ctx;
+} http_async_job_t;
+
+/**
+ * @brief In-flight accounting of one host:port
+ *
+ * One entry per worker is enough: a worker looking for an entry is not
+ * in flight itself, so at most workers - 1 entries are busy.
+ */
+typedef struct {
+    char host[64];
+    int port;
+    int inflight;                       /**< Requests to this origin in flight */
+    int limit;                          /**< Current in-flight limit */
+    int64_t serial_until_ms;            /**< No step up before this after a fallback */
+    uint32_t waiters;                   /**< Workers waiting for room, one bit each */
+} http_async_origin_t;
+
+/**
+ * @brief Global async state
+ */
+static struct {
+    http_async_config_t config;
+    http_async_stats_t stats;
+    QueueHandle_t queue;
+    TaskHandle_t workers[HTTP_ASYNC_MAX_WORKERS];
+    SemaphoreHandle_t stopped;          /**< Given once by each worker on exit */
+    SemaphoreHandle_t dequeue_lock;     /**< Keeps job numbers in queue order */
+    http_async_origin_t origins[HTTP_ASYNC_MAX_WORKERS];
+    uint32_t next_seq;                  /**< Number of the next job taken from the queue */
+    uint32_t done_seq;                  /**< Job whose callback runs next (ordered completion) */
+    uint32_t order_waiters;             /**< Workers waiting for their turn, one bit each */
+    int inflight;
+    bool running;
+} g_async_state = {0};
+
+static portMUX_TYPE s_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/* Guards origins, inflight and the completion order */
+static portMUX_TYPE s_origin_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Complete a job without sending it
+ */
+static void complete_unsent(http_async_job_t *job, esp_err_t result)
+{
+    if (job->callback) {
+        http_client_response_t response = {0};
+        job->callback(result, &response, job->user_ctx);
+    }
+}
+
+/**
+ * @brief Wake the workers in a waiter mask
+ */
+static void wake_workers(uint32_t mask)
+{
+    for (int i = 0; mask; i++, mask >>= 1) {
+        if (mask & 1) {
+            xTaskNotifyGive(g_async_state.workers[i]);
+        }
+    }
+}
+
+/**
+ * @brief Host and port a job goes to
+ */
+static void job_origin(const http_async_job_t *job, char *host, size_t host_size, int *port)
+{
+    http_origin_t origin;
+    if (job->has_target && strncmp(job->target, "http", 4) == 0 &&
+        http_conn_pool_parse_url(job->target, &origin, NULL, 0) == ESP_OK) {
+        strncpy(host, origin.host, host_size - 1);
+        host[host_size - 1] = '\0';
+        *port = origin.port;
+        return;
+    }
+
+    http_client_config_t config;
+    esp32_http_client_handle_get_config(job->client, &config);
+    strncpy(host, config.host, host_size - 1);
+    host[host_size - 1] = '\0';
+    *port = config.port;
+}
+
+/**
+ * @brief Wait for room under the origin's in-flight limit and take it
+ *
+ * @return Origin entry, or NULL if the queue was deinitialized meanwhile
+ */
+static http_async_origin_t *origin_acquire(int worker, const char *host, int port, int *inflight_before)
+{
+    while (true) {
+        taskENTER_CRITICAL(&s_origin_lock);
+        http_async_origin_t *entry = NULL;
+        http_async_origin_t *idle = NULL;
+        for (int i = 0; i < g_async_state.config.workers; i++) {
+            http_async_origin_t *o = &g_async_state.origins[i];
+            if (o->limit > 0 && o->port == port && strcmp(o->host, host) == 0) {
+                entry = o;
+                break;
+            }
+            if (!idle && o->inflight == 0 && o->waiters == 0) {
+                idle = o;
+            }
+        }
+        if (!entry) {
+            // Idle entries are recycled; one that fell back forgets it, which costs one more probe
+            entry = idle;
+            strncpy(entry->host, host, sizeof(entry->host) - 1);
+            entry->host[sizeof(entry->host) - 1] = '\0';
+            entry->port = port;
+            entry->limit = g_async_state.config.max_inflight_per_origin;
+            entry->serial_until_ms = 0;
+        }
+
+        if (entry->inflight < entry->limit) {
+            *inflight_before = entry->inflight;
+            entry->inflight++;
+            g_async_state.inflight++;
+            uint32_t inflight = g_async_state.inflight;
+            taskEXIT_CRITICAL(&s_origin_lock);
+
+            taskENTER_CRITICAL(&s_stats_lock);
+            if (inflight > g_async_state.stats.inflight_high_water) {
+                g_async_state.stats.inflight_high_water = inflight;
+            }
+            taskEXIT_CRITICAL(&s_stats_lock);
+            return entry;
+        }
+        entry->waiters |= 1u << worker;
+        taskEXIT_CRITICAL(&s_origin_lock);
+
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LINK_POLL_MS));
+        if (!g_async_state.running) {
+            return NULL;
+        }
+    }
+}
+
+/**
+ * @brief Give back the room taken by origin_acquire() and adapt the limit
+ *
+ * @param cooperative false if the server refused or dropped a parallel request
+ */
+static void origin_release(http_async_origin_t *entry, bool cooperative, int inflight_before)
+{
+    bool fell_back = false;
+    int64_t now = esp_timer_get_time() / 1000;
+
+    taskENTER_CRITICAL(&s_origin_lock);
+    entry->inflight--;
+    g_async_state.inflight--;
+    if (!cooperative && entry->limit > 1) {
+        entry->limit = 1;
+        entry->serial_until_ms = now + HTTP_ASYNC_FALLBACK_MS;
+        fell_back = true;
+    } else if (cooperative && entry->limit < g_async_state.config.max_inflight_per_origin &&
+               now >= entry->serial_until_ms) {
+        // A success after the cool-down buys one more parallel request
+        entry->limit++;
+    }
+    uint32_t waiters = entry->waiters;
+    entry->waiters = 0;
+    taskEXIT_CRITICAL(&s_origin_lock);
+
+    if (fell_back) {
+        taskENTER_CRITICAL(&s_stats_lock);
+        g_async_state.stats.serial_fallbacks++;
+        taskEXIT_CRITICAL(&s_stats_lock);
+        ESP_LOGW(TAG, "%s:%d refused parallel requests (%d in flight), serial for %d s",
+                 entry->host, entry->port, inflight_before + 1, HTTP_ASYNC_FALLBACK_MS / 1000);
+    }
+    wake_workers(waiters);
+}
+
+/**
+ * @brief Wait until the jobs taken before this one have completed
+ */
+static void wait_turn(int worker, uint32_t seq)
+{
+    while (true) {
+        taskENTER_CRITICAL(&s_origin_lock);
+        if (g_async_state.done_seq == seq) {
+            taskEXIT_CRITICAL(&s_origin_lock);
+            return;
+        }
+        g_async_state.order_waiters |= 1u << worker;
+        taskEXIT_CRITICAL(&s_origin_lock);
+
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+/**
+ * @brief Let the next job complete
+ */
+static void end_turn(void)
+{
+    taskENTER_CRITICAL(&s_origin_lock);
+    g_async_state.done_seq++;
+    uint32_t waiters = g_async_state.order_waiters;
+    g_async_state.order_waiters = 0;
+    taskEXIT_CRITICAL(&s_origin_lock);
+
+    wake_workers(waiters);
+}
+
+/**
+ * @brief Worker task: runs queued requests
+ */
+static void http_async_worker(void *pvParameters)
+{
+    const int worker = (int)(intptr_t)pvParameters;
+    const bool parallel = g_async_state.config.workers > 1;
+    const bool ordered = parallel && g_async_state.config.ordered_completion;
+    http_async_job_t job;
+
+    ESP_LOGI(TAG, "Async HTTP worker %d started on core %d", worker, xPortGetCoreID());
+
+    while (true) {
+        uint32_t seq = 0;
+        if (parallel) {
+            xSemaphoreTake(g_async_state.dequeue_lock, portMAX_DELAY);
+        }
+        BaseType_t received = xQueueReceive(g_async_state.queue, &job, portMAX_DELAY);
+        if (received == pdTRUE) {
+            seq = g_async_state.next_seq++;
+        }
+        if (parallel) {
+            xSemaphoreGive(g_async_state.dequeue_lock);
+        }
+        if (received != pdTRUE) {
+            continue;
+        }
+
+        if (!job.client) {
+            if (ordered) {
+                // Later callbacks must not wait for the stop request
+                wait_turn(worker, seq);
+                end_turn();
+            }
+            break;
+        }
+
+        // Hold the queue while the network is down; it drains back to back once it is up
+        while (g_async_state.running && http_link_wait_up(LINK_POLL_MS) != ESP_OK) {
+        }
+
+        http_async_origin_t *origin = NULL;
+        int inflight_before = 0;
+        if (g_async_state.running && parallel) {
+            char host[64];
+            int port;
+            job_origin(&job, host, sizeof(host), &port);
+            origin = origin_acquire(worker, host, port, &inflight_before);
+        }
+
+        if (!g_async_state.running) {
+            if (ordered) {
+                wait_turn(worker, seq);
+            }
+            complete_unsent(&job, ESP_ERR_INVALID_STATE);
+            if (ordered) {
+                end_turn();
+            }
+            continue;
+        }
+
+        http_client_response_t response;
+        const char *target = job.has_target ? job.target : NULL;
+        esp_err_t ret = esp32_http_client_request(job.client, target, &job.request, &response);
+
+        if (origin) {
+            // Alone on the origin, a failure says nothing about parallel requests
+            bool refused = (ret == ESP_OK && (response.status_code == 429 || response.status_code == 503)) ||
+                           (ret != ESP_OK && inflight_before > 0);
+            origin_release(origin, !refused, inflight_before);
+        }
+
+        taskENTER_CRITICAL(&s_stats_lock);
+        if (!parallel) {
+            g_async_state.stats.inflight_high_water = 1;
+        }
+        if (ret == ESP_OK) {
+            g_async_state.stats.completed++;
+        } else {
+            g_async_state.stats.failed++;
+        }
+        taskEXIT_CRITICAL(&s_stats_lock);
+
+        if (ordered) {
+            wait_turn(worker, seq);
+        }
+        if (job.callback) {
+            job.callback(ret, &response, job.user_ctx);
+        }
+        esp32_http_client_free_response(&response);
+        if (ordered) {
+            end_turn();
+        }
+    }
+
+    ESP_LOGI(TAG, "Async HTTP worker %d stopped", worker);
+    xSemaphoreGive(g_async_state.stopped);
+    vTaskDelete(NULL);
+}
+
+esp_err_t http_async_init(const http_async_config_t *config)
+{
+    if (g_async_state.running) {
+        ESP_LOGW(TAG, "Async worker already running");
+        return ESP_OK;
+    }
+
+    http_async_config_t defaults = HTTP_ASYNC_CONFIG_DEFAULT();
+    if (!config) {
+        config = &defaults;
+    }
+
+    if (config->queue_depth <= 0 || config->worker_stack_size <= 0 ||
+        config->workers < 1 || config->workers > HTTP_ASYNC_MAX_WORKERS ||
+        config->max_inflight_per_origin < 1) {
+        ESP_LOGE(TAG, "Invalid async configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memcpy(&g_async_state.config, config, sizeof(http_async_config_t));
+    memset(&g_async_state.stats, 0, sizeof(http_async_stats_t));
+
+    g_async_state.queue = xQueueCreate(config->queue_depth, sizeof(http_async_job_t));
+    g_async_state.stopped = xSemaphoreCreateCounting(config->workers, 0);
+    g_async_state.dequeue_lock = xSemaphoreCreateMutex();
+    if (!g_async_state.queue || !g_async_state.stopped || !g_async_state.dequeue_lock) {
+        ESP_LOGE(TAG, "Failed to allocate async queue");
+        if (g_async_state.queue) {
+            vQueueDelete(g_async_state.queue);
+        }
+        if (g_async_state.stopped) {
+            vSemaphoreDelete(g_async_state.stopped);
+        }
+        if (g_async_state.dequeue_lock) {
+            vSemaphoreDelete(g_async_state.dequeue_lock);
+        }
+        memset(&g_async_state, 0, sizeof(g_async_state));
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Workers test running as soon as they start
+    g_async_state.running = true;
+
+    int created = 0;
+    for (; created < config->workers; created++) {
+        BaseType_t result = xTaskCreatePinnedToCore(http_async_worker, "http_async",
+                                                    config->worker_stack_size, (void *)(intptr_t)created,
+                                                    config->worker_priority, &g_async_state.workers[created],
+                                                    config->worker_core);
+        if (result != pdPASS) {
+            break;
+        }
+    }
+
+    if (created < config->workers) {
+        ESP_LOGE(TAG, "Failed to create async worker task");
+        g_async_state.running = false;
+        http_async_job_t stop = {0};
+        for (int i = 0; i < created; i++) {
+            xQueueSend(g_async_state.queue, &stop, portMAX_DELAY);
+        }
+        for (int i = 0; i < created; i++) {
+            xSemaphoreTake(g_async_state.stopped, portMAX_DELAY);
+        }
+        vQueueDelete(g_async_state.queue);
+        vSemaphoreDelete(g_async_state.stopped);
+        vSemaphoreDelete(g_async_state.dequeue_lock);
+        memset(&g_async_state, 0, sizeof(g_async_state));
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "Async HTTP queue initialized: depth %d, priority %d, %d worker(s), %d per origin",
+             config->queue_depth, config->worker_priority, config->workers,
+             config->workers > 1 ? config->max_inflight_per_origin : 1);
+    return ESP_OK;
+}
+
+esp_err_t http_async_submit(esp32_http_client_handle_t client, const char *target,
+                            const http_client_request_t *request,
+                            http_async_callback_t callback, void *user_ctx)
+{
+    if (!g_async_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (!client || !request) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    http_async_job_t job = {
+        .client = client,
+        .request = *request,
+        .callback = callback,
+        .user_ctx = user_ctx,
+    };
+    if (target) {
+        if (strlen(target) >= sizeof(job.target)) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        strcpy(job.target, target);
+        job.has_target = true;
+    }
+
+    TickType_t wait = 0;
+    if (g_async_state.config.drop_policy == HTTP_ASYNC_BLOCK) {
+        wait = pdMS_TO_TICKS(g_async_state.config.submit_timeout_ms);
+    }
+
+    BaseType_t queued = xQueueSend(g_async_state.queue, &job, wait);
+    if (queued != pdTRUE && g_async_state.config.drop_policy == HTTP_ASYNC_DROP_OLDEST) {
+        http_async_job_t oldest;
+        if (xQueueReceive(g_async_state.queue, &oldest, 0) == pdTRUE) {
+            if (oldest.client) {
+                taskENTER_CRITICAL(&s_stats_lock);
+                g_async_state.stats.dropped++;
+                taskEXIT_CRITICAL(&s_stats_lock);
+                complete_unsent(&oldest, ESP_ERR_NO_MEM);
+            } else {
+                // Never drop the stop request
+                xQueueSendToBack(g_async_state.queue, &oldest, 0);
+            }
+        }
+        queued = xQueueSend(g_async_state.queue, &job, 0);
+    }
+
+    if (queued != pdTRUE) {
+        taskENTER_CRITICAL(&s_stats_lock);
+        g_async_state.stats.dropped++;
+        taskEXIT_CRITICAL(&s_stats_lock);
+        ESP_LOGW(TAG, "Async queue full, request dropped");
+        return ESP_ERR_NO_MEM;
+    }
+
+    uint32_t depth = uxQueueMessagesWaiting(g_async_state.queue);
+    taskENTER_CRITICAL(&s_stats_lock);
+    g_async_state.stats.submitted++;
+    if (depth > g_async_state.stats.queue_high_water) {
+        g_async_state.stats.queue_high_water = depth;
+    }
+    taskEXIT_CRITICAL(&s_stats_lock);
+
+    return ESP_OK;
+}
+
+int http_async_pending(void)
+{
+    if (!g_async_state.running) {
+        return 0;
+    }
+    return (int)uxQueueMessagesWaiting(g_async_state.queue);
+}
+
+esp_err_t http_async_get_stats(http_async_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_async_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    taskENTER_CRITICAL(&s_stats_lock);
+    memcpy(stats, &g_async_state.stats, sizeof(http_async_stats_t));
+    taskEXIT_CRITICAL(&s_stats_lock);
+    return ESP_OK;
+}
+
+bool http_async_is_running(void)
+{
+    return g_async_state.running;
+}
+
+esp_err_t http_async_deinit(void)
+{
+    if (!g_async_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    g_async_state.running = false;
+
+    // Fail everything still queued, then let the workers exit
+    http_async_job_t job;
+    while (xQueueReceive(g_async_state.queue, &job, 0) == pdTRUE) {
+        complete_unsent(&job, ESP_ERR_INVALID_STATE);
+    }
+
+    // Wake workers waiting for room under an origin limit
+    for (int i = 0; i < g_async_state.config.workers; i++) {
+        xTaskNotifyGive(g_async_state.workers[i]);
+    }
+
+    http_async_job_t stop = {0};
+    for (int i = 0; i < g_async_state.config.workers; i++) {
+        xQueueSend(g_async_state.queue, &stop, portMAX_DELAY);
+    }
+    for (int i = 0; i < g_async_state.config.workers; i++) {
+        xSemaphoreTake(g_async_state.stopped, portMAX_DELAY);
+    }
+
+    vQueueDelete(g_async_state.queue);
+    vSemaphoreDelete(g_async_state.stopped);
+    vSemaphoreDelete(g_async_state.dequeue_lock);
+    memset(&g_async_state, 0, sizeof(g_async_state));
+
+    ESP_LOGI(TAG, "Async HTTP queue deinitialized");
+    return ESP_OK;
+}
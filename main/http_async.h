@@ -0,0 +1,177 @@
+/**
+ * @file http_async.h
+ * @brief Asynchronous Request Queue for the ESP32 HTTP Client
+ *
+ * Callers enqueue requests with a completion callback and return
+ * immediately; a dedicated worker task drains a FreeRTOS queue and runs
+ * the requests over esp32_http_client handles.
+ *
+ * Features:
+ * - Configurable queue depth and drop policy
+ * - Worker priority, stack size and core affinity
+ * - Completion callback per request
+ * - Queue statistics (high-water mark, drops)
+ * - Requests are held while the network is down (see http_link.h) and
+ *   sent as soon as it is back
+ * - Optional parallel workers for high-RTT links (see below)
+ *
+ * Parallel workers: with workers > 1, up to that many requests are in
+ * flight at once, each over its own pooled keep-alive connection
+ * (esp_http_client cannot pipeline several requests on one socket).
+ * max_inflight_per_origin caps the requests to one host:port, and with
+ * ordered_completion the callbacks still run in submission order. If the
+ * server does not cooperate - a parallel request fails, or it answers
+ * 429 or 503 - that origin falls back to one request at a time and
+ * climbs back one step per success after HTTP_ASYNC_FALLBACK_MS. Size
+ * the connection pool (http_conn_pool.h) for the extra connections.
+ * Workers may send requests of the same handle concurrently; a request
+ * only reads its handle and updates the statistics under its lock.
+ */
+
+#ifndef HTTP_ASYNC_H
+#define HTTP_ASYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "esp32_http_client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_ASYNC_MAX_WORKERS 4
+#define HTTP_ASYNC_FALLBACK_MS 30000    /**< Time an origin stays serial after it refused parallel requests */
+
+/**
+ * @brief What to do when a request is submitted to a full queue
+ */
+typedef enum {
+    HTTP_ASYNC_DROP_NEWEST = 0,     /**< Reject the new request */
+    HTTP_ASYNC_DROP_OLDEST,         /**< Discard the oldest queued request to make room */
+    HTTP_ASYNC_BLOCK                /**< Wait up to submit_timeout_ms for room */
+} http_async_drop_policy_t;
+
+/**
+ * @brief Async worker configuration
+ */
+typedef struct {
+    int queue_depth;                        /**< Max queued requests */
+    http_async_drop_policy_t drop_policy;   /**< Full-queue behaviour */
+    int submit_timeout_ms;                  /**< Wait for room (HTTP_ASYNC_BLOCK only) */
+    int worker_priority;                    /**< Worker task priority */
+    int worker_stack_size;                  /**< Worker task stack size */
+    int worker_core;                        /**< Core to pin the worker to (tskNO_AFFINITY = any) */
+    int workers;                            /**< Requests in flight at once (1..HTTP_ASYNC_MAX_WORKERS) */
+    int max_inflight_per_origin;            /**< Requests in flight to one host:port (workers > 1 only) */
+    bool ordered_completion;                /**< Run callbacks in submission order (workers > 1 only) */
+} http_async_config_t;
+
+/**
+ * @brief Async queue statistics
+ */
+typedef struct {
+    uint32_t submitted;         /**< Requests accepted into the queue */
+    uint32_t completed;         /**< Requests that finished with ESP_OK */
+    uint32_t failed;            /**< Requests that finished with an error */
+    uint32_t dropped;           /**< Requests dropped by the drop policy */
+    uint32_t queue_high_water;  /**< Highest observed queue depth */
+    uint32_t inflight_high_water; /**< Most requests in flight at once */
+    uint32_t serial_fallbacks;  /**< Times an origin fell back to one request at a time */
+} http_async_stats_t;
+
+/**
+ * @brief Completion callback
+ *
+ * Runs in a worker task. With several workers and no ordered_completion,
+ * callbacks of different requests may run at the same time. The response
+ * is freed when the callback returns; copy the body if it is needed
+ * later. Dropped requests are completed with ESP_ERR_NO_MEM and an empty
+ * response, so the callback is always the place to release request
+ * resources.
+ *
+ * @param result ESP_OK or the error of the request
+ * @param response Response of the request
+ * @param user_ctx Context passed to http_async_submit()
+ */
+typedef void (*http_async_callback_t)(esp_err_t result, http_client_response_t *response, void *user_ctx);
+
+/**
+ * @brief Default async worker configuration
+ */
+#define HTTP_ASYNC_CONFIG_DEFAULT() {               \
+    .queue_depth = 8,                               \
+    .drop_policy = HTTP_ASYNC_DROP_NEWEST,          \
+    .submit_timeout_ms = 100,                       \
+    .worker_priority = 4,                           \
+    .worker_stack_size = 6144,                      \
+    .worker_core = tskNO_AFFINITY,                  \
+    .workers = 1,                                   \
+    .max_inflight_per_origin = 2,                   \
+    .ordered_completion = true                      \
+}
+
+/**
+ * @brief Initialize the async queue and start the worker tasks
+ *
+ * @param config Worker configuration (NULL = defaults)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_async_init(const http_async_config_t *config);
+
+/**
+ * @brief Queue a request for the worker task
+ *
+ * Everything the request points to (body, content type, headers) must
+ * stay valid until the callback runs. The client handle is used by the
+ * worker; do not change its headers or configuration while requests are
+ * pending.
+ *
+ * @param client Client handle to send the request with
+ * @param target HTTP path on the handle's host, or a full http:// or https:// URL (NULL = configured path)
+ * @param request Request to send (copied; pointed-to data is not)
+ * @param callback Completion callback (optional)
+ * @param user_ctx Context passed to the callback
+ * @return ESP_OK if queued, ESP_ERR_NO_MEM if dropped, ESP_ERR_* on failure
+ */
+esp_err_t http_async_submit(esp32_http_client_handle_t client, const char *target,
+                            const http_client_request_t *request,
+                            http_async_callback_t callback, void *user_ctx);
+
+/**
+ * @brief Get number of requests waiting in the queue
+ *
+ * @return Queued request count
+ */
+int http_async_pending(void);
+
+/**
+ * @brief Get async queue statistics
+ *
+ * @param stats Pointer to statistics structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_async_get_stats(http_async_stats_t *stats);
+
+/**
+ * @brief Check if the async worker is running
+ *
+ * @return true if initialized, false otherwise
+ */
+bool http_async_is_running(void);
+
+/**
+ * @brief Stop the worker and drop queued requests
+ *
+ * Queued requests are completed with ESP_ERR_INVALID_STATE.
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t http_async_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_ASYNC_H
@@ -0,0 +1,492 @@
+/**
+ * @file http_batch.c
+ * @brief Request Batching Implementation
+ *
+ * The ring buffer holds framed records between tail and head. A flush
+ * takes a snapshot of everything buffered and sends it straight out of
+ * the ring (one or two fragments when it wraps) while appends continue
+ * into the free space behind it. The tail only moves once the batch has
+ * been delivered, so a failed batch is simply sent again.
+ */
+
+#include "http_batch.h"
+#include "http_link.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "HTTP_BATCH";
+
+#define RECORD_HEADER_SIZE 2
+#define NO_FLUSH_DUE INT64_MAX
+#define WAKE_MAX_BATCHES 8              /**< Batches sent in one wake at most, so a flood cannot keep the radio up */
+
+/**
+ * @brief Global batching state
+ */
+static struct {
+    http_batch_config_t config;
+    http_batch_stats_t stats;
+    esp32_http_client_handle_t client;
+    uint8_t *ring;
+    size_t head;                    /**< Next byte to write */
+    size_t tail;                    /**< Oldest unsent byte */
+    size_t used;                    /**< Buffered bytes, including the batch in flight */
+    int records;                    /**< Buffered records, including the batch in flight */
+    uint32_t first_record;          /**< Sequence number of the record at the tail */
+    uint32_t batch_sequence;        /**< Number of the last batch attempt */
+    int64_t oldest_ms;              /**< Append time of the record at the tail */
+    int64_t next_oldest_ms;         /**< Append time of the first record behind the batch in flight */
+    int64_t retry_after_ms;         /**< No new attempt before this after a failure */
+    int64_t start_ms;               /**< Origin of the wake slot grid */
+    int inflight_records;           /**< Records of the batch being sent (0 = none) */
+    bool flush_requested;
+    bool stopping;
+    bool running;
+    SemaphoreHandle_t lock;
+    SemaphoreHandle_t space;        /**< Given when a flush frees buffer space */
+    SemaphoreHandle_t stopped;
+    TaskHandle_t task;
+} g_batch_state = {0};
+
+/**
+ * @brief Get current time in milliseconds
+ */
+static int64_t now_ms(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+/**
+ * @brief Copy bytes into the ring at head, wrapping around the end
+ */
+static void ring_write(const void *data, size_t len)
+{
+    size_t size = g_batch_state.config.buffer_size;
+    size_t first = size - g_batch_state.head;
+    if (first > len) {
+        first = len;
+    }
+
+    memcpy(g_batch_state.ring + g_batch_state.head, data, first);
+    memcpy(g_batch_state.ring, (const uint8_t *)data + first, len - first);
+    g_batch_state.head = (g_batch_state.head + len) % size;
+}
+
+/**
+ * @brief Time at which the next flush is due (lock held)
+ */
+static int64_t flush_due_ms(void)
+{
+    if (g_batch_state.records == 0) {
+        return NO_FLUSH_DUE;
+    }
+
+    if (g_batch_state.stopping) {
+        return 0;
+    }
+
+    int64_t due = g_batch_state.oldest_ms + g_batch_state.config.max_latency_ms;
+    if (g_batch_state.flush_requested ||
+        g_batch_state.used >= g_batch_state.config.flush_bytes ||
+        g_batch_state.records >= g_batch_state.config.flush_records) {
+        due = 0;
+    }
+
+    int interval = g_batch_state.config.wake_interval_ms;
+    if (interval > 0 && !g_batch_state.flush_requested &&
+        g_batch_state.used < g_batch_state.config.flush_bytes) {
+        // First wake slot at or after the oldest record; the grid starts one interval after init
+        int64_t since = g_batch_state.oldest_ms - g_batch_state.start_ms;
+        int64_t slots = since <= interval ? 1 : (since + interval - 1) / interval;
+        due = g_batch_state.start_ms + slots * interval;
+    }
+
+    // After a failure wait out the retry delay whatever triggered the flush
+    if (due < g_batch_state.retry_after_ms) {
+        due = g_batch_state.retry_after_ms;
+    }
+    return due;
+}
+
+/**
+ * @brief Send everything buffered as one request
+ *
+ * @return true if the batch was delivered
+ */
+static bool send_batch(void)
+{
+    xSemaphoreTake(g_batch_state.lock, portMAX_DELAY);
+    size_t tail = g_batch_state.tail;
+    size_t bytes = g_batch_state.used;
+    int records = g_batch_state.records;
+    uint32_t first_record = g_batch_state.first_record;
+    uint32_t sequence = ++g_batch_state.batch_sequence;
+    g_batch_state.inflight_records = records;
+    g_batch_state.flush_requested = false;
+    xSemaphoreGive(g_batch_state.lock);
+
+    // The batch in flight is never overwritten, so it is sent from the ring as is
+    size_t size = g_batch_state.config.buffer_size;
+    size_t first_len = size - tail;
+    if (first_len > bytes) {
+        first_len = bytes;
+    }
+    http_client_iovec_t fragments[2] = {
+        { g_batch_state.ring + tail, first_len },
+        { g_batch_state.ring, bytes - first_len },
+    };
+
+    char sequence_value[12];
+    char first_value[12];
+    char records_value[12];
+    snprintf(sequence_value, sizeof(sequence_value), "%lu", (unsigned long)sequence);
+    snprintf(first_value, sizeof(first_value), "%lu", (unsigned long)first_record);
+    snprintf(records_value, sizeof(records_value), "%d", records);
+
+    http_client_header_t headers[] = {
+        { "X-ESP32-Batch-Sequence", sequence_value },
+        { "X-ESP32-Batch-First-Record", first_value },
+        { "X-ESP32-Batch-Records", records_value },
+    };
+
+    http_client_request_t request = {
+        .method = HTTP_CLIENT_METHOD_POST,
+        .content_type = HTTP_BATCH_CONTENT_TYPE,
+        .headers = headers,
+        .header_count = sizeof(headers) / sizeof(headers[0]),
+        .body_iov = fragments,
+        .body_iov_count = fragments[1].len > 0 ? 2 : 1,
+    };
+
+    http_client_response_t response;
+    esp_err_t ret = esp32_http_client_request(g_batch_state.client, g_batch_state.config.path, &request, &response);
+
+    bool delivered = (ret == ESP_OK && response.status_code >= 200 && response.status_code < 300);
+    esp32_http_client_free_response(&response);
+
+    xSemaphoreTake(g_batch_state.lock, portMAX_DELAY);
+    g_batch_state.inflight_records = 0;
+    g_batch_state.stats.last_status_code = response.status_code;
+    if (delivered) {
+        g_batch_state.tail = (tail + bytes) % size;
+        g_batch_state.used -= bytes;
+        g_batch_state.records -= records;
+        g_batch_state.first_record += records;
+        g_batch_state.oldest_ms = g_batch_state.next_oldest_ms;
+        g_batch_state.retry_after_ms = 0;
+        g_batch_state.stats.batches_sent++;
+        g_batch_state.stats.records_sent += records;
+        g_batch_state.stats.bytes_sent += bytes;
+    } else {
+        g_batch_state.retry_after_ms = now_ms() + g_batch_state.config.max_latency_ms;
+        g_batch_state.stats.batches_failed++;
+    }
+    xSemaphoreGive(g_batch_state.lock);
+
+    if (delivered) {
+        xSemaphoreGive(g_batch_state.space);
+        ESP_LOGD(TAG, "Batch %lu delivered: %d records, %zu bytes", (unsigned long)sequence, records, bytes);
+    } else {
+        ESP_LOGW(TAG, "Batch %lu failed (%s, status %d), %d records kept",
+                 (unsigned long)sequence, esp_err_to_name(ret), response.status_code, records);
+    }
+    return delivered;
+}
+
+/**
+ * @brief Flush task: sends a batch whenever a trigger fires
+ */
+static void http_batch_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "Batch flush task started on core %d", xPortGetCoreID());
+
+    while (true) {
+        xSemaphoreTake(g_batch_state.lock, portMAX_DELAY);
+        int64_t due = flush_due_ms();
+        bool stopping = g_batch_state.stopping;
+        xSemaphoreGive(g_batch_state.lock);
+
+        int64_t now = now_ms();
+        if (due <= now && g_batch_state.config.wake_interval_ms > 0) {
+            // One wake: empty the buffer back to back over the warm connection, then sleep
+            http_link_radio_wake();
+            bool delivered = false;
+            for (int i = 0; i < WAKE_MAX_BATCHES; i++) {
+                delivered = send_batch();
+                if (!delivered || http_batch_pending() == 0) {
+                    break;
+                }
+            }
+            http_link_radio_sleep();
+
+            xSemaphoreTake(g_batch_state.lock, portMAX_DELAY);
+            g_batch_state.stats.radio_wakes++;
+            g_batch_state.stats.radio_awake_ms += now_ms() - now;
+            xSemaphoreGive(g_batch_state.lock);
+
+            if (stopping && !delivered) {
+                ESP_LOGW(TAG, "Discarding %d undelivered records", http_batch_pending());
+                break;
+            }
+            continue;
+        }
+
+        if (due <= now) {
+            int64_t started = now;
+            bool delivered = send_batch();
+
+            xSemaphoreTake(g_batch_state.lock, portMAX_DELAY);
+            g_batch_state.stats.radio_awake_ms += now_ms() - started;
+            xSemaphoreGive(g_batch_state.lock);
+
+            if (stopping && !delivered) {
+                ESP_LOGW(TAG, "Discarding %d undelivered records", http_batch_pending());
+                break;
+            }
+            continue;
+        }
+
+        if (stopping) {
+            break;
+        }
+
+        TickType_t wait = portMAX_DELAY;
+        if (due != NO_FLUSH_DUE) {
+            wait = pdMS_TO_TICKS(due - now) + 1;
+        }
+        ulTaskNotifyTake(pdTRUE, wait);
+    }
+
+    ESP_LOGI(TAG, "Batch flush task stopped");
+    xSemaphoreGive(g_batch_state.stopped);
+    vTaskDelete(NULL);
+}
+
+esp_err_t http_batch_init(esp32_http_client_handle_t client, const http_batch_config_t *config)
+{
+    if (g_batch_state.running) {
+        ESP_LOGW(TAG, "Batching already running");
+        return ESP_OK;
+    }
+
+    if (!client) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    http_batch_config_t defaults = HTTP_BATCH_CONFIG_DEFAULT();
+    if (!config) {
+        config = &defaults;
+    }
+
+    if (config->buffer_size <= RECORD_HEADER_SIZE || config->flush_records <= 0 ||
+        config->max_latency_ms <= 0 || config->task_stack_size <= 0 || config->wake_interval_ms < 0) {
+        ESP_LOGE(TAG, "Invalid batching configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(&g_batch_state, 0, sizeof(g_batch_state));
+    memcpy(&g_batch_state.config, config, sizeof(http_batch_config_t));
+    if (g_batch_state.config.flush_bytes == 0 || g_batch_state.config.flush_bytes > config->buffer_size) {
+        g_batch_state.config.flush_bytes = config->buffer_size;
+    }
+    g_batch_state.client = client;
+    g_batch_state.start_ms = now_ms();
+
+    g_batch_state.ring = malloc(config->buffer_size);
+    g_batch_state.lock = xSemaphoreCreateMutex();
+    g_batch_state.space = xSemaphoreCreateBinary();
+    g_batch_state.stopped = xSemaphoreCreateBinary();
+    if (!g_batch_state.ring || !g_batch_state.lock || !g_batch_state.space || !g_batch_state.stopped) {
+        ESP_LOGE(TAG, "Failed to allocate batch buffer");
+        goto fail;
+    }
+
+    g_batch_state.running = true;
+
+    BaseType_t result = xTaskCreatePinnedToCore(http_batch_task, "http_batch",
+                                                config->task_stack_size, NULL,
+                                                config->task_priority, &g_batch_state.task,
+                                                config->task_core);
+    if (result != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create batch flush task");
+        goto fail;
+    }
+
+    if (config->wake_interval_ms > 0) {
+        ESP_LOGI(TAG, "Batching initialized: %zu byte buffer, power-aware flush every %d ms (or at %zu bytes)",
+                 config->buffer_size, config->wake_interval_ms, g_batch_state.config.flush_bytes);
+    } else {
+        ESP_LOGI(TAG, "Batching initialized: %zu byte buffer, flush at %zu bytes / %d records / %d ms",
+                 config->buffer_size, g_batch_state.config.flush_bytes,
+                 config->flush_records, config->max_latency_ms);
+    }
+    return ESP_OK;
+
+fail:
+    free(g_batch_state.ring);
+    if (g_batch_state.lock) {
+        vSemaphoreDelete(g_batch_state.lock);
+    }
+    if (g_batch_state.space) {
+        vSemaphoreDelete(g_batch_state.space);
+    }
+    if (g_batch_state.stopped) {
+        vSemaphoreDelete(g_batch_state.stopped);
+    }
+    memset(&g_batch_state, 0, sizeof(g_batch_state));
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t http_batch_append(const void *data, size_t len)
+{
+    if (!g_batch_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (!data || len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t framed = len + RECORD_HEADER_SIZE;
+    if (len > HTTP_BATCH_MAX_RECORD || framed > g_batch_state.config.buffer_size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    TickType_t start = xTaskGetTickCount();
+    TickType_t timeout = pdMS_TO_TICKS(g_batch_state.config.append_timeout_ms);
+    bool waited = false;
+
+    xSemaphoreTake(g_batch_state.lock, portMAX_DELAY);
+    while (g_batch_state.config.buffer_size - g_batch_state.used < framed) {
+        g_batch_state.flush_requested = true;
+        xSemaphoreGive(g_batch_state.lock);
+        xTaskNotifyGive(g_batch_state.task);
+
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (elapsed >= timeout || xSemaphoreTake(g_batch_state.space, timeout - elapsed) != pdTRUE) {
+            xSemaphoreTake(g_batch_state.lock, portMAX_DELAY);
+            g_batch_state.stats.records_rejected++;
+            xSemaphoreGive(g_batch_state.lock);
+            return ESP_ERR_TIMEOUT;
+        }
+        waited = true;
+        xSemaphoreTake(g_batch_state.lock, portMAX_DELAY);
+    }
+
+    uint8_t header[RECORD_HEADER_SIZE] = { len & 0xFF, (len >> 8) & 0xFF };
+    ring_write(header, sizeof(header));
+    ring_write(data, len);
+
+    int64_t now = now_ms();
+    if (g_batch_state.records == 0) {
+        g_batch_state.oldest_ms = now;
+    }
+    if (g_batch_state.records == g_batch_state.inflight_records) {
+        g_batch_state.next_oldest_ms = now;
+    }
+    g_batch_state.used += framed;
+    g_batch_state.records++;
+    g_batch_state.stats.records_appended++;
+    if (g_batch_state.used > g_batch_state.stats.buffer_high_water) {
+        g_batch_state.stats.buffer_high_water = g_batch_state.used;
+    }
+
+    // Wake the task for the first record (to arm the latency timer) and on thresholds
+    bool notify = g_batch_state.records == 1 ||
+                  g_batch_state.used >= g_batch_state.config.flush_bytes ||
+                  g_batch_state.records >= g_batch_state.config.flush_records;
+    bool room_left = g_batch_state.config.buffer_size - g_batch_state.used > RECORD_HEADER_SIZE;
+    xSemaphoreGive(g_batch_state.lock);
+
+    if (waited && room_left) {
+        // Pass the wake-up on to the next blocked appender
+        xSemaphoreGive(g_batch_state.space);
+    }
+    if (notify) {
+        xTaskNotifyGive(g_batch_state.task);
+    }
+    return ESP_OK;
+}
+
+esp_err_t http_batch_flush(void)
+{
+    if (!g_batch_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(g_batch_state.lock, portMAX_DELAY);
+    g_batch_state.flush_requested = true;
+    xSemaphoreGive(g_batch_state.lock);
+
+    xTaskNotifyGive(g_batch_state.task);
+    return ESP_OK;
+}
+
+int http_batch_pending(void)
+{
+    if (!g_batch_state.running) {
+        return 0;
+    }
+
+    xSemaphoreTake(g_batch_state.lock, portMAX_DELAY);
+    int records = g_batch_state.records;
+    xSemaphoreGive(g_batch_state.lock);
+    return records;
+}
+
+esp_err_t http_batch_get_stats(http_batch_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_batch_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(g_batch_state.lock, portMAX_DELAY);
+    memcpy(stats, &g_batch_state.stats, sizeof(http_batch_stats_t));
+    xSemaphoreGive(g_batch_state.lock);
+
+    stats->radio_ms_per_kb = 0;
+    if (stats->bytes_sent > 0) {
+        stats->radio_ms_per_kb = (uint32_t)(stats->radio_awake_ms * 1024 / stats->bytes_sent);
+    }
+    return ESP_OK;
+}
+
+bool http_batch_is_running(void)
+{
+    return g_batch_state.running;
+}
+
+esp_err_t http_batch_deinit(void)
+{
+    if (!g_batch_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(g_batch_state.lock, portMAX_DELAY);
+    g_batch_state.stopping = true;
+    xSemaphoreGive(g_batch_state.lock);
+
+    // The task makes one last delivery attempt before it exits
+    xTaskNotifyGive(g_batch_state.task);
+    xSemaphoreTake(g_batch_state.stopped, portMAX_DELAY);
+    g_batch_state.running = false;
+
+    free(g_batch_state.ring);
+    vSemaphoreDelete(g_batch_state.lock);
+    vSemaphoreDelete(g_batch_state.space);
+    vSemaphoreDelete(g_batch_state.stopped);
+    memset(&g_batch_state, 0, sizeof(g_batch_state));
+
+    ESP_LOGI(TAG, "Batching deinitialized");
+    return ESP_OK;
+}
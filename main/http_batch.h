@@ -0,0 +1,176 @@
+/**
+ * @file http_batch.h
+ * @brief Request Batching for the ESP32 HTTP Client
+ *
+ * Coalesces many small records into one POST. Records are appended to a
+ * ring buffer and a flush task sends everything buffered as one request
+ * when a size threshold, a record count or the maximum latency is
+ * reached. Appending blocks (up to a timeout) while the buffer is full.
+ *
+ * Body format: each record is a 2-byte little-endian length followed by
+ * the record bytes. The batch is described by headers:
+ * - X-ESP32-Batch-Sequence: number of the batch attempt
+ * - X-ESP32-Batch-First-Record: sequence number of the first record
+ *   (unchanged when a failed batch is resent, so duplicates can be spotted)
+ * - X-ESP32-Batch-Records: number of records in the body
+ *
+ * Features:
+ * - Size, count and latency flush triggers
+ * - Backpressure with configurable append timeout
+ * - Zero-copy flush straight out of the ring buffer
+ * - Failed batches are kept and resent
+ * - Power-aware mode for battery nodes (see below)
+ *
+ * Power-aware mode (wake_interval_ms > 0): flushes happen only on a
+ * fixed grid of wake slots, wake_interval_ms apart, instead of on the
+ * record count and latency triggers; only a buffer reaching flush_bytes
+ * or http_batch_flush() sends earlier. Each flush wakes the radio with
+ * http_link_radio_wake(), sends batches back to back over the same
+ * keep-alive connection until the buffer is empty, and lets the radio
+ * sleep again, so in between it stays in modem sleep. Pair it with
+ * WIFI_PS_MAX_MODEM (wifi_driver_set_power_save()) and a wake interval
+ * well below the server's keep-alive timeout if the connection should
+ * stay warm across wakes. The time the radio is held awake per kilobyte
+ * delivered is reported as an energy proxy.
+ */
+
+#ifndef HTTP_BATCH_H
+#define HTTP_BATCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "esp32_http_client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Content-Type of batch bodies
+ */
+#define HTTP_BATCH_CONTENT_TYPE "application/x-esp32-batch"
+
+/**
+ * @brief Largest single record
+ */
+#define HTTP_BATCH_MAX_RECORD 0xFFFF
+
+/**
+ * @brief Batching configuration
+ */
+typedef struct {
+    char path[128];             /**< Target path on the client's host, or a full http:// or https:// URL */
+    size_t buffer_size;         /**< Ring buffer size in bytes (upper bound of one batch) */
+    size_t flush_bytes;         /**< Flush once this many bytes are buffered */
+    int flush_records;          /**< Flush once this many records are buffered */
+    int max_latency_ms;         /**< Flush once the oldest record is this old; also the retry delay */
+    int append_timeout_ms;      /**< Wait for room when the buffer is full (0 = fail at once) */
+    int task_priority;          /**< Flush task priority */
+    int task_stack_size;        /**< Flush task stack size */
+    int task_core;              /**< Core to pin the flush task to (tskNO_AFFINITY = any) */
+    int wake_interval_ms;       /**< Power-aware mode: flush only at wake slots this far apart (0 = off) */
+} http_batch_config_t;
+
+/**
+ * @brief Batching statistics
+ */
+typedef struct {
+    uint32_t records_appended;  /**< Records accepted into the buffer */
+    uint32_t records_sent;      /**< Records delivered in a successful batch */
+    uint32_t records_rejected;  /**< Appends that timed out on a full buffer */
+    uint32_t batches_sent;      /**< Batches delivered */
+    uint32_t batches_failed;    /**< Batch attempts that failed (records kept) */
+    uint64_t bytes_sent;        /**< Body bytes of delivered batches */
+    size_t buffer_high_water;   /**< Highest observed buffer fill in bytes */
+    int last_status_code;       /**< HTTP status of the last batch attempt */
+    uint32_t radio_wakes;       /**< Wake slots that sent something (power-aware mode) */
+    uint64_t radio_awake_ms;    /**< Time spent sending batches (radio held awake for it in power-aware mode) */
+    uint32_t radio_ms_per_kb;   /**< radio_awake_ms per KiB delivered (filled in by get_stats) */
+} http_batch_stats_t;
+
+/**
+ * @brief Default batching configuration
+ */
+#define HTTP_BATCH_CONFIG_DEFAULT() {               \
+    .path = "/batch",                               \
+    .buffer_size = 4096,                            \
+    .flush_bytes = 2048,                            \
+    .flush_records = 32,                            \
+    .max_latency_ms = 1000,                         \
+    .append_timeout_ms = 100,                       \
+    .task_priority = 4,                             \
+    .task_stack_size = 4096,                        \
+    .task_core = tskNO_AFFINITY,                    \
+    .wake_interval_ms = 0                           \
+}
+
+/**
+ * @brief Initialize batching and start the flush task
+ *
+ * The flush task sends every batch with the given handle. Give batching
+ * its own handle; handles are not meant to be shared between tasks.
+ *
+ * @param client Client handle used for the batch requests
+ * @param config Batching configuration (NULL = defaults)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_batch_init(esp32_http_client_handle_t client, const http_batch_config_t *config);
+
+/**
+ * @brief Append one record
+ *
+ * The record is copied into the ring buffer. If the buffer is full this
+ * waits up to append_timeout_ms for a flush to make room.
+ *
+ * @param data Record bytes
+ * @param len Record length (1..HTTP_BATCH_MAX_RECORD)
+ * @return ESP_OK on success, ESP_ERR_TIMEOUT if the buffer stayed full, ESP_ERR_* on failure
+ */
+esp_err_t http_batch_append(const void *data, size_t len);
+
+/**
+ * @brief Ask the flush task to send what is buffered now
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not initialized
+ */
+esp_err_t http_batch_flush(void);
+
+/**
+ * @brief Get number of records waiting to be sent
+ *
+ * @return Buffered record count
+ */
+int http_batch_pending(void);
+
+/**
+ * @brief Get batching statistics
+ *
+ * @param stats Pointer to statistics structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_batch_get_stats(http_batch_stats_t *stats);
+
+/**
+ * @brief Check if batching is running
+ *
+ * @return true if initialized, false otherwise
+ */
+bool http_batch_is_running(void);
+
+/**
+ * @brief Send what is buffered, then stop the flush task
+ *
+ * Records that still cannot be delivered are discarded.
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t http_batch_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_BATCH_H
@@ -0,0 +1,340 @@
+/**
+ * @file http_bench.c
+ * @brief On-Device HTTP Load Generator Implementation
+ */
+
+#include "http_bench.h"
+#include "http_histogram.h"
+#include "http_conn_pool.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "HTTP_BENCH";
+
+#define START_DELAY_US 20000        /**< Lets every worker be created before the clock starts */
+
+/**
+ * @brief State of one worker task
+ *
+ * Workers only write their own slot; the results are summed after all
+ * of them have finished, so the hot path shares nothing.
+ */
+typedef struct {
+    const http_bench_config_t *config;
+    const char *body;
+    esp32_http_client_handle_t client;
+    SemaphoreHandle_t done;
+    int index;
+    int64_t start_us;
+    int64_t end_us;
+    http_histogram_t latency;
+    uint32_t requests;
+    uint32_t errors;
+    uint32_t late;
+    uint64_t bytes_sent;
+    uint64_t bytes_received;
+    uint32_t heap_min_free;
+} bench_worker_t;
+
+/**
+ * @brief Response body sink; counts and drops the bytes
+ */
+static esp_err_t count_response(const char *data, size_t len, void *user_ctx)
+{
+    bench_worker_t *worker = (bench_worker_t *)user_ctx;
+    worker->bytes_received += len;
+    return ESP_OK;
+}
+
+/**
+ * @brief Sleep until a point in time, rounded up to the next tick
+ */
+static void sleep_until(int64_t when_us)
+{
+    int64_t wait_us = when_us - esp_timer_get_time();
+    if (wait_us <= 0) {
+        return;
+    }
+
+    TickType_t ticks = pdMS_TO_TICKS((wait_us + 999) / 1000);
+    vTaskDelay(ticks > 0 ? ticks : 1);
+}
+
+/**
+ * @brief Worker task: send requests until the run ends
+ */
+static void bench_worker_task(void *pvParameters)
+{
+    bench_worker_t *worker = (bench_worker_t *)pvParameters;
+    const http_bench_config_t *config = worker->config;
+    bool open_loop = config->mode == HTTP_BENCH_OPEN_LOOP;
+
+    // Open loop: worker i owns every concurrency-th slot of the schedule
+    int64_t interval_us = open_loop ? (int64_t)config->concurrency * 1000000 / config->rate_per_sec : 0;
+    int64_t next_us = worker->start_us + (open_loop ? (int64_t)worker->index * 1000000 / config->rate_per_sec : 0);
+
+    http_client_request_t request = {
+        .method = config->body_size > 0 ? HTTP_CLIENT_METHOD_POST : HTTP_CLIENT_METHOD_GET,
+        .content_type = config->body_size > 0 ? "application/octet-stream" : NULL,
+        .body = worker->body,
+        .body_length = config->body_size,
+        .body_sink = count_response,
+        .sink_ctx = worker,
+    };
+
+    worker->heap_min_free = UINT32_MAX;
+    sleep_until(worker->start_us);
+
+    while (true) {
+        int64_t issued_us;
+        if (open_loop) {
+            if (next_us >= worker->end_us) {
+                break;
+            }
+            sleep_until(next_us);
+            if (esp_timer_get_time() - next_us > interval_us) {
+                worker->late++;
+            }
+            issued_us = next_us;
+            next_us += interval_us;
+        } else {
+            issued_us = esp_timer_get_time();
+            if (issued_us >= worker->end_us) {
+                break;
+            }
+        }
+
+        http_client_response_t response;
+        esp_err_t err = esp32_http_client_request(worker->client, config->path, &request, &response);
+        int64_t latency_us = esp_timer_get_time() - issued_us;
+
+        if (err == ESP_OK && response.status_code >= 200 && response.status_code < 300) {
+            worker->requests++;
+            worker->bytes_sent += config->body_size;
+            http_histogram_record(&worker->latency, latency_us > UINT32_MAX ? UINT32_MAX : (uint32_t)latency_us);
+        } else {
+            worker->errors++;
+        }
+        esp32_http_client_free_response(&response);
+
+        uint32_t free_heap = esp_get_free_heap_size();
+        if (free_heap < worker->heap_min_free) {
+            worker->heap_min_free = free_heap;
+        }
+    }
+
+    xSemaphoreGive(worker->done);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Check a benchmark configuration
+ */
+static esp_err_t validate_config(const http_bench_config_t *config)
+{
+    if (!config || strlen(config->host) == 0 || config->duration_ms <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (config->concurrency < 1 || config->concurrency > HTTP_BENCH_MAX_WORKERS) {
+        ESP_LOGE(TAG, "Concurrency must be 1..%d", HTTP_BENCH_MAX_WORKERS);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (config->mode == HTTP_BENCH_OPEN_LOOP && config->rate_per_sec <= 0) {
+        ESP_LOGE(TAG, "Open loop needs a request rate");
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Release the workers of a run
+ */
+static void destroy_workers(bench_worker_t *workers, int count)
+{
+    for (int i = 0; i < count; i++) {
+        if (workers[i].client) {
+            esp32_http_client_destroy(workers[i].client);
+        }
+    }
+    free(workers);
+}
+
+/**
+ * @brief Print the result line of a run
+ */
+static void print_result(const http_bench_config_t *config, const http_bench_result_t *result)
+{
+    printf("BENCH mode=%s concurrency=%d rate=%d body=%u keepalive=%d duration_ms=%lu "
+           "requests=%lu errors=%lu late=%lu rps=%lu "
+           "p50_us=%lu p95_us=%lu p99_us=%lu max_us=%lu mean_us=%lu "
+           "tx_bytes_per_sec=%lu rx_bytes_per_sec=%lu heap_peak=%lu heap_min_free=%lu\n",
+           config->mode == HTTP_BENCH_OPEN_LOOP ? "open" : "closed",
+           config->concurrency,
+           config->mode == HTTP_BENCH_OPEN_LOOP ? config->rate_per_sec : 0,
+           (unsigned int)config->body_size, config->keep_alive ? 1 : 0,
+           (unsigned long)result->elapsed_ms,
+           (unsigned long)result->requests, (unsigned long)result->errors,
+           (unsigned long)result->late, (unsigned long)result->requests_per_sec,
+           (unsigned long)result->p50_us, (unsigned long)result->p95_us,
+           (unsigned long)result->p99_us, (unsigned long)result->max_us,
+           (unsigned long)result->mean_us,
+           (unsigned long)result->tx_bytes_per_sec, (unsigned long)result->rx_bytes_per_sec,
+           (unsigned long)result->heap_peak_bytes, (unsigned long)result->heap_min_free);
+}
+
+esp_err_t http_bench_run(const http_bench_config_t *config, http_bench_result_t *result)
+{
+    esp_err_t ret = validate_config(config);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    int count = config->concurrency;
+    bench_worker_t *workers = calloc(count, sizeof(bench_worker_t));
+    char *body = config->body_size > 0 ? malloc(config->body_size) : NULL;
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(count, 0);
+    if (!workers || (config->body_size > 0 && !body) || !done) {
+        free(workers);
+        free(body);
+        if (done) {
+            vSemaphoreDelete(done);
+        }
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (size_t i = 0; i < config->body_size; i++) {
+        body[i] = 'A' + i % 26;
+    }
+
+    http_client_config_t client_config = HTTP_CLIENT_CONFIG_DEFAULT();
+    strncpy(client_config.host, config->host, sizeof(client_config.host) - 1);
+    client_config.port = config->port;
+    strncpy(client_config.path, config->path, sizeof(client_config.path) - 1);
+    strcpy(client_config.user_agent, "ESP32-HTTP-Bench/1.0");
+    client_config.timeout_ms = config->timeout_ms;
+    client_config.keep_alive = config->keep_alive;
+    client_config.enable_logging = false;
+
+    for (int i = 0; i < count && ret == ESP_OK; i++) {
+        ret = esp32_http_client_create(&client_config, &workers[i].client);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create client handles: %s", esp_err_to_name(ret));
+        destroy_workers(workers, count);
+        free(body);
+        vSemaphoreDelete(done);
+        return ret;
+    }
+
+    // Runs start cold so keep-alive on and off are compared fairly
+    http_conn_pool_flush(NULL);
+
+    // Heap in use before the run; everything allocated for the run itself is already counted
+    uint32_t heap_start = esp_get_free_heap_size();
+    int64_t start_us = esp_timer_get_time() + START_DELAY_US;
+    int64_t end_us = start_us + (int64_t)config->duration_ms * 1000;
+
+    int started = 0;
+    for (int i = 0; i < count; i++) {
+        workers[i].config = config;
+        workers[i].body = body;
+        workers[i].done = done;
+        workers[i].index = i;
+        workers[i].start_us = start_us;
+        workers[i].end_us = end_us;
+
+        char name[16];
+        snprintf(name, sizeof(name), "http_bench_%d", i);
+        if (xTaskCreate(bench_worker_task, name, config->worker_stack_size, &workers[i],
+                        config->worker_priority, NULL) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create worker %d", i);
+            ret = ESP_ERR_NO_MEM;
+            break;
+        }
+        started++;
+    }
+
+    // Every request is bounded by its timeout, so the workers always finish
+    for (int i = 0; i < started; i++) {
+        xSemaphoreTake(done, portMAX_DELAY);
+    }
+    int64_t finished_us = esp_timer_get_time();
+
+    http_bench_result_t total = {0};
+    http_histogram_t latency = {0};
+    total.heap_min_free = heap_start;
+    for (int i = 0; i < started; i++) {
+        total.requests += workers[i].requests;
+        total.errors += workers[i].errors;
+        total.late += workers[i].late;
+        total.bytes_sent += workers[i].bytes_sent;
+        total.bytes_received += workers[i].bytes_received;
+        if (workers[i].heap_min_free < total.heap_min_free) {
+            total.heap_min_free = workers[i].heap_min_free;
+        }
+        http_histogram_merge(&latency, &workers[i].latency);
+    }
+
+    total.elapsed_ms = (finished_us - start_us) / 1000;
+    if (total.elapsed_ms > 0) {
+        total.requests_per_sec = (uint64_t)total.requests * 1000 / total.elapsed_ms;
+        total.tx_bytes_per_sec = total.bytes_sent * 1000 / total.elapsed_ms;
+        total.rx_bytes_per_sec = total.bytes_received * 1000 / total.elapsed_ms;
+    }
+    total.p50_us = http_histogram_percentile(&latency, 50);
+    total.p95_us = http_histogram_percentile(&latency, 95);
+    total.p99_us = http_histogram_percentile(&latency, 99);
+    total.max_us = latency.max_us;
+    total.mean_us = http_histogram_mean(&latency);
+    total.heap_peak_bytes = heap_start - total.heap_min_free;
+
+    destroy_workers(workers, count);
+    free(body);
+    vSemaphoreDelete(done);
+
+    if (ret == ESP_OK) {
+        print_result(config, &total);
+    }
+    if (result) {
+        *result = total;
+    }
+    return ret;
+}
+
+esp_err_t http_bench_sweep(const http_bench_config_t *config, const size_t *body_sizes, int size_count)
+{
+    if (!config || (size_count > 0 && !body_sizes)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ESP_LOGI(TAG, "Sweep: %d body sizes x keep-alive on/off, %d ms each against %s:%d%s",
+             size_count, config->duration_ms, config->host, config->port, config->path);
+
+    esp_err_t first_err = ESP_OK;
+    for (int i = 0; i < size_count; i++) {
+        for (int keep_alive = 1; keep_alive >= 0; keep_alive--) {
+            http_bench_config_t run = *config;
+            run.body_size = body_sizes[i];
+            run.keep_alive = keep_alive;
+
+            esp_err_t err = http_bench_run(&run, NULL);
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "Run failed (body %zu, keep-alive %d): %s",
+                         run.body_size, keep_alive, esp_err_to_name(err));
+                if (first_err == ESP_OK) {
+                    first_err = err;
+                }
+            }
+        }
+    }
+    return first_err;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file http_bench.h
+ * @brief On-Device HTTP Load Generator
+ *
+ * Drives requests against one target for a fixed duration and reports
+ * throughput, latency percentiles and heap usage. Each worker task owns
+ * its own esp32_http_client handle, so the run exercises the same code
+ * paths as the application.
+ *
+ * Modes:
+ * - Closed loop: every worker sends its next request as soon as the
+ *   previous one completes (throughput at a given concurrency)
+ * - Open loop: requests are scheduled at a fixed total rate; latency is
+ *   measured from the scheduled start, so a stalled server shows up as
+ *   latency instead of silently lowering the rate
+ *
+ * Results are printed as one line of key=value pairs starting with
+ * "BENCH ", for scripts to collect.
+ *
+ * Workers share the connection pool; concurrency above its
+ * max_connections makes workers wait for a slot.
+ */
+
+#ifndef HTTP_BENCH_H
+#define HTTP_BENCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp32_http_client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_BENCH_MAX_WORKERS 8
+
+/**
+ * @brief Load model
+ */
+typedef enum {
+    HTTP_BENCH_CLOSED_LOOP = 0,     /**< Fixed concurrency, back-to-back requests */
+    HTTP_BENCH_OPEN_LOOP            /**< Fixed request rate */
+} http_bench_mode_t;
+
+/**
+ * @brief Benchmark configuration
+ */
+typedef struct {
+    char host[64];              /**< Target server hostname or IP address */
+    int port;                   /**< Target server port */
+    char path[128];             /**< Target path */
+    http_bench_mode_t mode;     /**< Load model */
+    int concurrency;            /**< Worker tasks (1..HTTP_BENCH_MAX_WORKERS) */
+    int rate_per_sec;           /**< Total request rate (open loop only) */
+    int duration_ms;            /**< Length of the measured run */
+    size_t body_size;           /**< POST body size (0 = GET) */
+    bool keep_alive;            /**< Reuse connections between requests */
+    int timeout_ms;             /**< Per-request timeout */
+    int worker_priority;        /**< Worker task priority */
+    int worker_stack_size;      /**< Worker task stack size */
+} http_bench_config_t;
+
+/**
+ * @brief Results of one run
+ */
+typedef struct {
+    uint32_t requests;          /**< Requests completed with a 2xx status */
+    uint32_t errors;            /**< Failed requests and non-2xx responses */
+    uint32_t late;              /**< Open loop: requests started after their slot */
+    uint32_t elapsed_ms;        /**< Actual run time */
+    uint32_t requests_per_sec;  /**< Completed requests per second */
+    uint64_t bytes_sent;        /**< Request body bytes sent */
+    uint64_t bytes_received;    /**< Response body bytes received */
+    uint32_t tx_bytes_per_sec;  /**< Request body throughput */
+    uint32_t rx_bytes_per_sec;  /**< Response body throughput */
+    uint32_t p50_us;            /**< Median latency */
+    uint32_t p95_us;            /**< 95th percentile latency */
+    uint32_t p99_us;            /**< 99th percentile latency */
+    uint32_t max_us;            /**< Slowest request */
+    uint32_t mean_us;           /**< Mean latency */
+    uint32_t heap_peak_bytes;   /**< Most heap in use during the run, above the starting level */
+    uint32_t heap_min_free;     /**< Lowest free heap seen during the run */
+} http_bench_result_t;
+
+/**
+ * @brief Default benchmark configuration
+ */
+#define HTTP_BENCH_CONFIG_DEFAULT() {               \
+    .host = "192.168.1.100",                       \
+    .port = 8000,                                   \
+    .path = "/bench",                               \
+    .mode = HTTP_BENCH_CLOSED_LOOP,                 \
+    .concurrency = 1,                               \
+    .rate_per_sec = 10,                             \
+    .duration_ms = 10000,                           \
+    .body_size = 256,                               \
+    .keep_alive = true,                             \
+    .timeout_ms = 5000,                             \
+    .worker_priority = 5,                           \
+    .worker_stack_size = 4096                       \
+}
+
+/**
+ * @brief Run one benchmark and print its result line
+ *
+ * Blocks for the duration of the run.
+ *
+ * @param config Benchmark configuration
+ * @param result Results (optional)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_bench_run(const http_bench_config_t *config, http_bench_result_t *result);
+
+/**
+ * @brief Run a benchmark for every body size, with keep-alive on and off
+ *
+ * @param config Base configuration (body_size and keep_alive are overridden)
+ * @param body_sizes Body sizes to test
+ * @param size_count Number of entries in body_sizes
+ * @return ESP_OK if every run completed, otherwise the first error
+ */
+esp_err_t http_bench_sweep(const http_bench_config_t *config, const size_t *body_sizes, int size_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_BENCH_H
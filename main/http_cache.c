@@ -0,0 +1,454 @@
+/**
+ * @file http_cache.c
+ * @brief Conditional GET Response Cache Implementation
+ */
+
+#include "http_cache.h"
+#include "http_arena.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "HTTP_CACHE";
+
+#define NVS_NAMESPACE "http_cache"
+
+/**
+ * @brief Everything of an entry but the body, stored as one NVS blob
+ */
+typedef struct {
+    char key[HTTP_CACHE_KEY_SIZE];          /**< Empty when the entry is unused */
+    http_cache_validators_t validators;
+    char content_type[64];
+    int32_t status_code;
+    uint32_t body_length;
+} cache_meta_t;
+
+/**
+ * @brief Cached response
+ *
+ * Entry i keeps its NVS copy under "m<i>" (meta) and "b<i>" (body).
+ */
+typedef struct {
+    cache_meta_t meta;
+    char *body;                             /**< RAM body (NULL when the body is in NVS) */
+    bool in_flash;
+    uint64_t last_used_ms;
+} cache_entry_t;
+
+/**
+ * @brief Global cache state
+ */
+static struct {
+    http_cache_config_t config;
+    http_cache_stats_t stats;
+    cache_entry_t entries[HTTP_CACHE_MAX_ENTRIES];
+    SemaphoreHandle_t lock;                 /**< Held across NVS access, so not a spinlock */
+    nvs_handle_t nvs;
+    bool nvs_open;
+    bool initialized;
+} g_cache_state = {0};
+
+static uint64_t now_ms(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+static void nvs_keys(int index, char *meta_key, char *body_key)
+{
+    snprintf(meta_key, 8, "m%d", index);
+    snprintf(body_key, 8, "b%d", index);
+}
+
+/**
+ * @brief Find the entry of a URL (lock held)
+ */
+static cache_entry_t *find_entry(const char *key)
+{
+    for (int i = 0; i < g_cache_state.config.max_entries; i++) {
+        if (strcmp(g_cache_state.entries[i].meta.key, key) == 0) {
+            return &g_cache_state.entries[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Release an entry and its NVS copy (lock held)
+ */
+static void drop_entry(cache_entry_t *entry)
+{
+    if (entry->meta.key[0] == '\0') {
+        return;
+    }
+
+    if (entry->in_flash) {
+        char meta_key[8], body_key[8];
+        nvs_keys(entry - g_cache_state.entries, meta_key, body_key);
+        nvs_erase_key(g_cache_state.nvs, meta_key);
+        nvs_erase_key(g_cache_state.nvs, body_key);
+        nvs_commit(g_cache_state.nvs);
+        g_cache_state.stats.flash_entries--;
+    } else {
+        free(entry->body);
+        g_cache_state.stats.ram_bytes -= entry->meta.body_length;
+    }
+    g_cache_state.stats.entries--;
+    memset(entry, 0, sizeof(cache_entry_t));
+}
+
+/**
+ * @brief Least recently used entry, unused ones first (lock held)
+ *
+ * @param ram_only Only consider entries whose body is in RAM
+ * @param keep Entry never returned (may be NULL)
+ */
+static cache_entry_t *lru_entry(bool ram_only, const cache_entry_t *keep)
+{
+    cache_entry_t *victim = NULL;
+    for (int i = 0; i < g_cache_state.config.max_entries; i++) {
+        cache_entry_t *candidate = &g_cache_state.entries[i];
+        if (candidate == keep) {
+            continue;
+        }
+        if (candidate->meta.key[0] == '\0') {
+            if (ram_only) {
+                continue;
+            }
+            return candidate;
+        }
+        if (ram_only && candidate->in_flash) {
+            continue;
+        }
+        if (!victim || candidate->last_used_ms < victim->last_used_ms) {
+            victim = candidate;
+        }
+    }
+    return victim;
+}
+
+/**
+ * @brief Load the entries kept in NVS by an earlier boot
+ */
+static void load_flash_entries(void)
+{
+    for (int i = 0; i < g_cache_state.config.max_entries; i++) {
+        char meta_key[8], body_key[8];
+        nvs_keys(i, meta_key, body_key);
+
+        cache_entry_t *entry = &g_cache_state.entries[i];
+        size_t size = sizeof(cache_meta_t);
+        if (nvs_get_blob(g_cache_state.nvs, meta_key, &entry->meta, &size) != ESP_OK ||
+            size != sizeof(cache_meta_t) || entry->meta.body_length > g_cache_state.config.max_flash_body) {
+            // Missing, written by another layout, or over the new limit
+            memset(entry, 0, sizeof(cache_entry_t));
+            continue;
+        }
+        entry->meta.key[sizeof(entry->meta.key) - 1] = '\0';
+        entry->in_flash = true;
+        g_cache_state.stats.entries++;
+        g_cache_state.stats.flash_entries++;
+    }
+}
+
+esp_err_t http_cache_init(const http_cache_config_t *config)
+{
+    if (g_cache_state.initialized) {
+        return ESP_OK;
+    }
+
+    http_cache_config_t defaults = HTTP_CACHE_CONFIG_DEFAULT();
+    if (!config) {
+        config = &defaults;
+    }
+
+    if (config->max_entries <= 0 || config->max_ram_total < config->max_ram_body) {
+        ESP_LOGE(TAG, "Invalid cache configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(&g_cache_state, 0, sizeof(g_cache_state));
+    g_cache_state.config = *config;
+    if (g_cache_state.config.max_entries > HTTP_CACHE_MAX_ENTRIES) {
+        g_cache_state.config.max_entries = HTTP_CACHE_MAX_ENTRIES;
+    }
+
+    g_cache_state.lock = xSemaphoreCreateMutex();
+    if (!g_cache_state.lock) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (config->max_flash_body > 0) {
+        esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &g_cache_state.nvs);
+        if (ret == ESP_OK) {
+            g_cache_state.nvs_open = true;
+            load_flash_entries();
+        } else {
+            // Large bodies are then simply not cached
+            ESP_LOGW(TAG, "NVS not available (%s), caching in RAM only", esp_err_to_name(ret));
+            g_cache_state.config.max_flash_body = 0;
+        }
+    }
+
+    g_cache_state.initialized = true;
+
+    ESP_LOGI(TAG, "Response cache initialized: %d entries, RAM bodies up to %zu bytes (%zu total), NVS up to %zu",
+             g_cache_state.config.max_entries, config->max_ram_body, config->max_ram_total,
+             g_cache_state.config.max_flash_body);
+    if (g_cache_state.stats.flash_entries > 0) {
+        ESP_LOGI(TAG, "%d entries kept in NVS", g_cache_state.stats.flash_entries);
+    }
+    return ESP_OK;
+}
+
+bool http_cache_lookup(const char *key, http_cache_validators_t *validators)
+{
+    if (!g_cache_state.initialized || !key || !validators) {
+        return false;
+    }
+
+    xSemaphoreTake(g_cache_state.lock, portMAX_DELAY);
+    g_cache_state.stats.lookups++;
+    cache_entry_t *entry = find_entry(key);
+    if (entry) {
+        *validators = entry->meta.validators;
+        entry->last_used_ms = now_ms();
+        g_cache_state.stats.hits++;
+    }
+    xSemaphoreGive(g_cache_state.lock);
+
+    return entry != NULL;
+}
+
+esp_err_t http_cache_load(const char *key, int *status_code, char *content_type, size_t content_type_size,
+                          char **body, size_t *body_length)
+{
+    if (!key || !status_code || !content_type || content_type_size == 0 || !body || !body_length) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_cache_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(g_cache_state.lock, portMAX_DELAY);
+    cache_entry_t *entry = find_entry(key);
+    if (!entry) {
+        // Evicted while the request was in flight
+        xSemaphoreGive(g_cache_state.lock);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    size_t len = entry->meta.body_length;
+    char *copy = http_arena_alloc(len + 1);
+    if (!copy) {
+        xSemaphoreGive(g_cache_state.lock);
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret = ESP_OK;
+    if (entry->in_flash) {
+        char meta_key[8], body_key[8];
+        nvs_keys(entry - g_cache_state.entries, meta_key, body_key);
+        size_t size = len;
+        ret = nvs_get_blob(g_cache_state.nvs, body_key, copy, &size);
+        if (ret == ESP_OK && size != len) {
+            ret = ESP_ERR_INVALID_SIZE;
+        }
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to read cached body of %s: %s", key, esp_err_to_name(ret));
+            g_cache_state.stats.flash_errors++;
+            drop_entry(entry);
+        }
+    } else if (len > 0) {
+        memcpy(copy, entry->body, len);
+    }
+
+    if (ret == ESP_OK) {
+        copy[len] = '\0';
+        *status_code = entry->meta.status_code;
+        strncpy(content_type, entry->meta.content_type, content_type_size - 1);
+        content_type[content_type_size - 1] = '\0';
+        *body = copy;
+        *body_length = len;
+        entry->last_used_ms = now_ms();
+        g_cache_state.stats.not_modified++;
+    }
+    xSemaphoreGive(g_cache_state.lock);
+
+    if (ret != ESP_OK) {
+        http_arena_free(copy);
+    }
+    return ret;
+}
+
+esp_err_t http_cache_store(const char *key, const http_cache_validators_t *validators, int status_code,
+                           const char *content_type, const char *body, size_t body_length)
+{
+    if (!key || !validators || (body_length > 0 && !body)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_cache_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (strlen(key) >= HTTP_CACHE_KEY_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    if (validators->etag[0] == '\0' && validators->last_modified[0] == '\0') {
+        // Nothing to revalidate with; an older copy would only be served by mistake
+        http_cache_invalidate(key);
+        return ESP_OK;
+    }
+
+    bool in_ram = body_length <= g_cache_state.config.max_ram_body;
+    bool in_flash = !in_ram && body_length <= g_cache_state.config.max_flash_body;
+
+    // Copy before taking the lock
+    char *ram_body = NULL;
+    if (in_ram) {
+        ram_body = malloc(body_length > 0 ? body_length : 1);
+        if (!ram_body) {
+            return ESP_ERR_NO_MEM;
+        }
+        memcpy(ram_body, body, body_length);
+    }
+
+    xSemaphoreTake(g_cache_state.lock, portMAX_DELAY);
+
+    cache_entry_t *entry = find_entry(key);
+    if (entry) {
+        drop_entry(entry);
+    }
+
+    if (!in_ram && !in_flash) {
+        g_cache_state.stats.too_large++;
+        xSemaphoreGive(g_cache_state.lock);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    if (!entry) {
+        entry = lru_entry(false, NULL);
+        if (entry->meta.key[0] != '\0') {
+            drop_entry(entry);
+            g_cache_state.stats.evictions++;
+        }
+    }
+
+    if (in_ram) {
+        // Make room under the RAM total, oldest RAM bodies first
+        while (g_cache_state.stats.ram_bytes + body_length > g_cache_state.config.max_ram_total) {
+            cache_entry_t *victim = lru_entry(true, entry);
+            if (!victim) {
+                break;
+            }
+            drop_entry(victim);
+            g_cache_state.stats.evictions++;
+        }
+    }
+
+    strcpy(entry->meta.key, key);
+    entry->meta.validators = *validators;
+    entry->meta.validators.etag[sizeof(entry->meta.validators.etag) - 1] = '\0';
+    entry->meta.validators.last_modified[sizeof(entry->meta.validators.last_modified) - 1] = '\0';
+    strncpy(entry->meta.content_type, content_type ? content_type : "", sizeof(entry->meta.content_type) - 1);
+    entry->meta.status_code = status_code;
+    entry->meta.body_length = body_length;
+    entry->last_used_ms = now_ms();
+
+    esp_err_t ret = ESP_OK;
+    if (in_ram) {
+        entry->body = ram_body;
+        g_cache_state.stats.ram_bytes += body_length;
+    } else {
+        char meta_key[8], body_key[8];
+        nvs_keys(entry - g_cache_state.entries, meta_key, body_key);
+        ret = nvs_set_blob(g_cache_state.nvs, body_key, body, body_length);
+        if (ret == ESP_OK) {
+            ret = nvs_set_blob(g_cache_state.nvs, meta_key, &entry->meta, sizeof(cache_meta_t));
+        }
+        if (ret == ESP_OK) {
+            ret = nvs_commit(g_cache_state.nvs);
+        }
+        entry->in_flash = true;
+        g_cache_state.stats.flash_entries++;
+    }
+    g_cache_state.stats.entries++;
+    g_cache_state.stats.stores++;
+
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to store %s in NVS: %s", key, esp_err_to_name(ret));
+        g_cache_state.stats.flash_errors++;
+        drop_entry(entry);
+    }
+    xSemaphoreGive(g_cache_state.lock);
+
+    return ret;
+}
+
+void http_cache_invalidate(const char *key)
+{
+    if (!g_cache_state.initialized) {
+        return;
+    }
+
+    xSemaphoreTake(g_cache_state.lock, portMAX_DELAY);
+    for (int i = 0; i < g_cache_state.config.max_entries; i++) {
+        cache_entry_t *entry = &g_cache_state.entries[i];
+        if (!key || strcmp(entry->meta.key, key) == 0) {
+            drop_entry(entry);
+        }
+    }
+    xSemaphoreGive(g_cache_state.lock);
+}
+
+esp_err_t http_cache_get_stats(http_cache_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_cache_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(g_cache_state.lock, portMAX_DELAY);
+    memcpy(stats, &g_cache_state.stats, sizeof(http_cache_stats_t));
+    xSemaphoreGive(g_cache_state.lock);
+    return ESP_OK;
+}
+
+bool http_cache_is_running(void)
+{
+    return g_cache_state.initialized;
+}
+
+esp_err_t http_cache_deinit(void)
+{
+    if (!g_cache_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(g_cache_state.lock, portMAX_DELAY);
+    g_cache_state.initialized = false;
+    for (int i = 0; i < HTTP_CACHE_MAX_ENTRIES; i++) {
+        free(g_cache_state.entries[i].body);
+    }
+    if (g_cache_state.nvs_open) {
+        nvs_close(g_cache_state.nvs);
+    }
+    xSemaphoreGive(g_cache_state.lock);
+
+    vSemaphoreDelete(g_cache_state.lock);
+    memset(&g_cache_state, 0, sizeof(g_cache_state));
+
+    ESP_LOGI(TAG, "Response cache deinitialized");
+    return ESP_OK;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file http_cache.h
+ * @brief Conditional GET Response Cache for the ESP32 HTTP Client
+ *
+ * Keeps the last response of polled URLs together with its validators
+ * (ETag, Last-Modified). A handle with response_cache set sends them as
+ * If-None-Match / If-Modified-Since with every buffered GET, and a
+ * 304 Not Modified answer is handed to the caller as the cached 200
+ * response, so an unchanged resource costs a header exchange instead of
+ * a body transfer and a fresh allocation per poll.
+ *
+ * Features:
+ * - Fixed number of entries keyed by URL, LRU replacement
+ * - Small bodies in RAM, larger ones in NVS (survive a reboot, so the
+ *   first poll after boot can already be answered with a 304)
+ * - Per-entry and total RAM size limits
+ * - Only 200 responses with a validator and without
+ *   Cache-Control: no-store are stored
+ *
+ * The cache always revalidates: it never answers a request without
+ * asking the server, so max-age and Expires are not needed and Vary is
+ * not honoured. Streamed requests bypass the cache.
+ *
+ * The cache is shared by every handle. Entries in NVS are written only
+ * when a body changes, which suits config endpoints polled far more
+ * often than they change.
+ */
+
+#ifndef HTTP_CACHE_H
+#define HTTP_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_CACHE_MAX_ENTRIES 8
+#define HTTP_CACHE_KEY_SIZE 208         /**< "https://" + host + ":port" + path */
+#define HTTP_CACHE_ETAG_SIZE 64         /**< Longer ETags are not cached */
+#define HTTP_CACHE_DATE_SIZE 32         /**< IMF-fixdate is 29 characters */
+
+/**
+ * @brief Response cache configuration
+ */
+typedef struct {
+    int max_entries;            /**< Cached URLs (up to HTTP_CACHE_MAX_ENTRIES) */
+    size_t max_ram_body;        /**< Bodies up to this size are kept in RAM */
+    size_t max_ram_total;       /**< RAM used by all bodies together */
+    size_t max_flash_body;      /**< Larger bodies up to this size go to NVS (0 = RAM only) */
+} http_cache_config_t;
+
+/**
+ * @brief Response cache statistics
+ */
+typedef struct {
+    int lookups;                /**< Cacheable GETs seen */
+    int hits;                   /**< Lookups that found an entry and sent its validators */
+    int not_modified;           /**< 304 answers served from the cache */
+    int stores;                 /**< Bodies stored or replaced */
+    int evictions;              /**< Entries dropped to make room */
+    int too_large;              /**< Responses not stored because of a size limit */
+    int flash_errors;           /**< NVS reads or writes that failed */
+    int entries;                /**< URLs currently cached */
+    int flash_entries;          /**< Entries whose body is in NVS */
+    size_t ram_bytes;           /**< RAM used by cached bodies */
+} http_cache_stats_t;
+
+/**
+ * @brief Validators of a cached response
+ */
+typedef struct {
+    char etag[HTTP_CACHE_ETAG_SIZE];            /**< ETag (empty = none) */
+    char last_modified[HTTP_CACHE_DATE_SIZE];   /**< Last-Modified (empty = none) */
+} http_cache_validators_t;
+
+/**
+ * @brief Default response cache configuration
+ */
+#define HTTP_CACHE_CONFIG_DEFAULT() {               \
+    .max_entries = 4,                               \
+    .max_ram_body = 1024,                           \
+    .max_ram_total = 4096,                          \
+    .max_flash_body = 8192                          \
+}
+
+/**
+ * @brief Initialize the response cache
+ *
+ * Loads the entries kept in NVS, so NVS must be initialized first.
+ * Calling this again while the cache is initialized is a no-op.
+ *
+ * @param config Cache configuration (NULL = defaults)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_cache_init(const http_cache_config_t *config);
+
+/**
+ * @brief Get the validators of a cached URL
+ *
+ * @param key URL of the request
+ * @param validators Validators to send (output)
+ * @return true if the URL is cached
+ */
+bool http_cache_lookup(const char *key, http_cache_validators_t *validators);
+
+/**
+ * @brief Fill a response with the cached copy of a URL
+ *
+ * Used for a 304 answer. The body is allocated like a received one;
+ * release it with esp32_http_client_free_response().
+ *
+ * @param key URL of the request
+ * @param status_code Cached status (output)
+ * @param content_type Cached Content-Type (output)
+ * @param content_type_size Size of content_type
+ * @param body Cached body, NUL-terminated (output)
+ * @param body_length Body length (output)
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if the entry is gone, ESP_ERR_* on failure
+ */
+esp_err_t http_cache_load(const char *key, int *status_code, char *content_type, size_t content_type_size,
+                          char **body, size_t *body_length);
+
+/**
+ * @brief Store a response
+ *
+ * Replaces an existing entry of the URL. A response without validators
+ * drops the entry instead.
+ *
+ * @param key URL of the request
+ * @param validators Validators of the response
+ * @param status_code Response status
+ * @param content_type Response Content-Type
+ * @param body Response body
+ * @param body_length Body length
+ * @return ESP_OK on success, ESP_ERR_INVALID_SIZE if the body is over the limits, ESP_ERR_* on failure
+ */
+esp_err_t http_cache_store(const char *key, const http_cache_validators_t *validators, int status_code,
+                           const char *content_type, const char *body, size_t body_length);
+
+/**
+ * @brief Drop a URL from the cache
+ *
+ * @param key URL (NULL = every entry)
+ */
+void http_cache_invalidate(const char *key);
+
+/**
+ * @brief Get response cache statistics
+ *
+ * @param stats Pointer to statistics structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_cache_get_stats(http_cache_stats_t *stats);
+
+/**
+ * @brief Check if the response cache is initialized
+ *
+ * @return true if initialized, false otherwise
+ */
+bool http_cache_is_running(void);
+
+/**
+ * @brief Deinitialize the response cache
+ *
+ * Entries in NVS are kept for the next boot.
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t http_cache_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_CACHE_H
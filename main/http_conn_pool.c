@@ -0,0 +1,472 @@
+/**
+ * @file http_conn_pool.c
+ * @brief Keep-alive Connection Pool Implementation
+ */
+
+#include "http_conn_pool.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "HTTP_CONN_POOL";
+
+#define POOL_MAX_SLOTS 8
+
+/**
+ * @brief Pool slot
+ */
+struct http_pool_slot {
+    esp_http_client_handle_t client;    /**< NULL when the slot is empty */
+    http_origin_t origin;
+    bool in_use;
+    uint64_t last_used_ms;
+    http_conn_headers_t headers;        /**< Headers left set on client */
+    bool keep_session;                  /**< Keep client when closed, for TLS session resumption */
+    bool closed;                        /**< Idle with its socket closed */
+    bool has_connected;                 /**< client opened a connection before */
+    bool reused;                        /**< Checked out with its socket still open */
+};
+
+/**
+ * @brief Global pool state
+ */
+static struct {
+    http_conn_pool_config_t config;
+    http_conn_pool_stats_t stats;
+    struct http_pool_slot slots[POOL_MAX_SLOTS];
+    SemaphoreHandle_t lock;
+    SemaphoreHandle_t released;         /**< Signalled when a busy slot is returned */
+    bool initialized;
+} g_pool_state = {0};
+
+static uint64_t now_ms(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+static bool origin_equal(const http_origin_t *a, const http_origin_t *b)
+{
+    return a->port == b->port && a->secure == b->secure && strcmp(a->host, b->host) == 0;
+}
+
+/**
+ * @brief Close the handle of a slot and mark it empty (lock held)
+ */
+static void slot_close(struct http_pool_slot *slot)
+{
+    if (slot->client) {
+        esp_http_client_cleanup(slot->client);
+        slot->client = NULL;
+    }
+    if (slot->closed) {
+        g_pool_state.stats.sessions_kept--;
+        slot->closed = false;
+    }
+    slot->in_use = false;
+    memset(&slot->origin, 0, sizeof(slot->origin));
+}
+
+/**
+ * @brief Close idle handles that exceeded the idle timeout (lock held)
+ *
+ * Handles kept for their TLS session have no socket to go stale and
+ * only leave through eviction.
+ */
+static void expire_idle_slots(uint64_t now)
+{
+    for (int i = 0; i < g_pool_state.config.max_connections; i++) {
+        struct http_pool_slot *slot = &g_pool_state.slots[i];
+        if (slot->client && !slot->in_use && !slot->closed &&
+            now - slot->last_used_ms > (uint64_t)g_pool_state.config.idle_timeout_ms) {
+            slot_close(slot);
+            g_pool_state.stats.expired++;
+            g_pool_state.stats.idle--;
+        }
+    }
+}
+
+/**
+ * @brief Find the least recently used idle slot (lock held)
+ *
+ * @param origin Restrict to this origin (NULL = any origin)
+ */
+static struct http_pool_slot *find_lru_idle(const http_origin_t *origin)
+{
+    struct http_pool_slot *lru = NULL;
+    for (int i = 0; i < g_pool_state.config.max_connections; i++) {
+        struct http_pool_slot *slot = &g_pool_state.slots[i];
+        if (!slot->client || slot->in_use) {
+            continue;
+        }
+        if (origin && !origin_equal(&slot->origin, origin)) {
+            continue;
+        }
+        if (!lru || slot->last_used_ms < lru->last_used_ms) {
+            lru = slot;
+        }
+    }
+    return lru;
+}
+
+/**
+ * @brief Pick a slot for an origin (lock held)
+ *
+ * Prefers the most recently used idle handle of the origin, then an
+ * empty slot, then evicts the least recently used idle handle.
+ */
+static struct http_pool_slot *pick_slot(const http_origin_t *origin, bool *warm)
+{
+    struct http_pool_slot *mru = NULL;
+    struct http_pool_slot *empty = NULL;
+
+    for (int i = 0; i < g_pool_state.config.max_connections; i++) {
+        struct http_pool_slot *slot = &g_pool_state.slots[i];
+        if (!slot->client) {
+            if (!empty) {
+                empty = slot;
+            }
+        } else if (!slot->in_use && origin_equal(&slot->origin, origin)) {
+            if (!mru || slot->last_used_ms > mru->last_used_ms) {
+                mru = slot;
+            }
+        }
+    }
+
+    if (mru) {
+        *warm = true;
+        return mru;
+    }
+
+    *warm = false;
+    if (empty) {
+        return empty;
+    }
+
+    struct http_pool_slot *victim = find_lru_idle(NULL);
+    if (victim) {
+        ESP_LOGD(TAG, "Evicting idle connection to %s:%d", victim->origin.host, victim->origin.port);
+        slot_close(victim);
+        g_pool_state.stats.evictions++;
+        g_pool_state.stats.idle--;
+    }
+    return victim;
+}
+
+esp_err_t http_conn_pool_init(const http_conn_pool_config_t *config)
+{
+    if (g_pool_state.initialized) {
+        return ESP_OK;
+    }
+
+    http_conn_pool_config_t defaults = HTTP_CONN_POOL_CONFIG_DEFAULT();
+    if (!config) {
+        config = &defaults;
+    }
+
+    if (config->max_connections <= 0 || config->max_idle_per_origin <= 0) {
+        ESP_LOGE(TAG, "Invalid pool size");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memcpy(&g_pool_state.config, config, sizeof(http_conn_pool_config_t));
+    if (g_pool_state.config.max_connections > POOL_MAX_SLOTS) {
+        ESP_LOGW(TAG, "Pool size clamped to %d", POOL_MAX_SLOTS);
+        g_pool_state.config.max_connections = POOL_MAX_SLOTS;
+    }
+
+    memset(g_pool_state.slots, 0, sizeof(g_pool_state.slots));
+    memset(&g_pool_state.stats, 0, sizeof(http_conn_pool_stats_t));
+
+    g_pool_state.lock = xSemaphoreCreateMutex();
+    g_pool_state.released = xSemaphoreCreateBinary();
+    if (!g_pool_state.lock || !g_pool_state.released) {
+        if (g_pool_state.lock) {
+            vSemaphoreDelete(g_pool_state.lock);
+        }
+        if (g_pool_state.released) {
+            vSemaphoreDelete(g_pool_state.released);
+        }
+        return ESP_ERR_NO_MEM;
+    }
+
+    g_pool_state.initialized = true;
+
+    ESP_LOGI(TAG, "Connection pool initialized: %d slots, %d idle per origin",
+             g_pool_state.config.max_connections, g_pool_state.config.max_idle_per_origin);
+    return ESP_OK;
+}
+
+esp_err_t http_conn_pool_parse_url(const char *url, http_origin_t *origin, char *path, size_t path_size)
+{
+    if (!url || !origin) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    static const char plain[] = "http://";
+    static const char secure[] = "https://";
+    const char *host;
+    if (strncmp(url, plain, sizeof(plain) - 1) == 0) {
+        host = url + sizeof(plain) - 1;
+        origin->secure = false;
+    } else if (strncmp(url, secure, sizeof(secure) - 1) == 0) {
+        host = url + sizeof(secure) - 1;
+        origin->secure = true;
+    } else {
+        ESP_LOGE(TAG, "Unsupported URL scheme: %s", url);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const char *host_end = host + strcspn(host, ":/?");
+    size_t host_len = host_end - host;
+    if (host_len == 0 || host_len >= sizeof(origin->host)) {
+        ESP_LOGE(TAG, "Invalid host in URL: %s", url);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memcpy(origin->host, host, host_len);
+    origin->host[host_len] = '\0';
+    origin->port = origin->secure ? 443 : 80;
+
+    const char *rest = host_end;
+    if (*rest == ':') {
+        char *port_end;
+        long port = strtol(rest + 1, &port_end, 10);
+        if (port_end == rest + 1 || port <= 0 || port > 65535) {
+            ESP_LOGE(TAG, "Invalid port in URL: %s", url);
+            return ESP_ERR_INVALID_ARG;
+        }
+        origin->port = (int)port;
+        rest = port_end;
+    }
+
+    if (path && path_size > 0) {
+        const char *p = (*rest == '\0') ? "/" : rest;
+        if (strlen(p) >= path_size) {
+            ESP_LOGE(TAG, "URL path too long");
+            return ESP_ERR_INVALID_SIZE;
+        }
+        strcpy(path, p);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t http_conn_pool_acquire(const http_origin_t *origin, const esp_http_client_config_t *client_config, http_conn_t *conn)
+{
+    if (!g_pool_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (!origin || !client_config || !conn) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *conn = NULL;
+    uint64_t deadline = now_ms() + g_pool_state.config.acquire_timeout_ms;
+
+    while (true) {
+        xSemaphoreTake(g_pool_state.lock, portMAX_DELAY);
+
+        uint64_t now = now_ms();
+        expire_idle_slots(now);
+
+        bool warm = false;
+        struct http_pool_slot *slot = pick_slot(origin, &warm);
+        if (slot) {
+            if (warm) {
+                g_pool_state.stats.hits++;
+                g_pool_state.stats.idle--;
+                slot->reused = slot->has_connected && !slot->closed;
+                if (slot->closed) {
+                    g_pool_state.stats.sessions_kept--;
+                    slot->closed = false;
+                }
+            } else {
+                char url[160];
+                snprintf(url, sizeof(url), "%s://%s:%d/", origin->secure ? "https" : "http",
+                         origin->host, origin->port);
+
+                esp_http_client_config_t cfg = *client_config;
+                cfg.url = url;
+                cfg.host = NULL;
+                cfg.port = 0;
+                cfg.path = NULL;
+                if (origin->secure) {
+                    // The URL may name a cached address; verify and send SNI for the
+                    // hostname. Kept by pointer, so it must live in the slot
+                    cfg.common_name = slot->origin.host;
+                }
+
+                slot->origin = *origin;
+                slot->client = esp_http_client_init(&cfg);
+                if (!slot->client) {
+                    memset(&slot->origin, 0, sizeof(slot->origin));
+                    xSemaphoreGive(g_pool_state.lock);
+                    ESP_LOGE(TAG, "Failed to create client for %s:%d", origin->host, origin->port);
+                    return ESP_FAIL;
+                }
+                memset(&slot->headers, 0, sizeof(slot->headers));
+                slot->has_connected = false;
+                slot->reused = false;
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+                slot->keep_session = origin->secure && cfg.save_client_session;
+#else
+                slot->keep_session = false;
+#endif
+                g_pool_state.stats.misses++;
+            }
+
+            slot->in_use = true;
+            slot->last_used_ms = now;
+            g_pool_state.stats.in_use++;
+            xSemaphoreGive(g_pool_state.lock);
+
+            *conn = slot;
+            return ESP_OK;
+        }
+
+        xSemaphoreGive(g_pool_state.lock);
+
+        // Every slot is checked out; wait for one to come back
+        if (now >= deadline ||
+            xSemaphoreTake(g_pool_state.released, pdMS_TO_TICKS(deadline - now)) != pdTRUE) {
+            ESP_LOGW(TAG, "No free connection for %s:%d", origin->host, origin->port);
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+}
+
+esp_http_client_handle_t http_conn_pool_client(http_conn_t conn)
+{
+    return conn ? conn->client : NULL;
+}
+
+http_conn_headers_t *http_conn_pool_headers(http_conn_t conn)
+{
+    return conn ? &conn->headers : NULL;
+}
+
+bool http_conn_pool_mark_connected(http_conn_t conn)
+{
+    if (!conn) {
+        return false;
+    }
+
+    bool before = conn->has_connected;
+    conn->has_connected = true;
+    return before;
+}
+
+bool http_conn_pool_is_reused(http_conn_t conn)
+{
+    return conn ? conn->reused : false;
+}
+
+void http_conn_pool_release(http_conn_t conn, bool reusable)
+{
+    if (!conn || !g_pool_state.initialized) {
+        return;
+    }
+
+    xSemaphoreTake(g_pool_state.lock, portMAX_DELAY);
+
+    g_pool_state.stats.in_use--;
+    if (!reusable && !conn->keep_session) {
+        slot_close(conn);
+    } else {
+        if (!reusable) {
+            // Drops the socket; the transport keeps the saved TLS session
+            esp_http_client_close(conn->client);
+            conn->closed = true;
+            g_pool_state.stats.sessions_kept++;
+        }
+        conn->in_use = false;
+        conn->last_used_ms = now_ms();
+        g_pool_state.stats.idle++;
+
+        // Enforce the per-origin idle cap, dropping the oldest handles first
+        int idle_count = 0;
+        for (int i = 0; i < g_pool_state.config.max_connections; i++) {
+            struct http_pool_slot *slot = &g_pool_state.slots[i];
+            if (slot->client && !slot->in_use && origin_equal(&slot->origin, &conn->origin)) {
+                idle_count++;
+            }
+        }
+        while (idle_count > g_pool_state.config.max_idle_per_origin) {
+            struct http_pool_slot *victim = find_lru_idle(&conn->origin);
+            if (!victim) {
+                break;
+            }
+            slot_close(victim);
+            g_pool_state.stats.evictions++;
+            g_pool_state.stats.idle--;
+            idle_count--;
+        }
+    }
+
+    xSemaphoreGive(g_pool_state.lock);
+    xSemaphoreGive(g_pool_state.released);
+}
+
+esp_err_t http_conn_pool_flush(const http_origin_t *origin)
+{
+    if (!g_pool_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(g_pool_state.lock, portMAX_DELAY);
+    for (int i = 0; i < g_pool_state.config.max_connections; i++) {
+        struct http_pool_slot *slot = &g_pool_state.slots[i];
+        if (slot->client && !slot->in_use && (!origin || origin_equal(&slot->origin, origin))) {
+            slot_close(slot);
+            g_pool_state.stats.idle--;
+        }
+    }
+    xSemaphoreGive(g_pool_state.lock);
+
+    return ESP_OK;
+}
+
+esp_err_t http_conn_pool_get_stats(http_conn_pool_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_pool_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(g_pool_state.lock, portMAX_DELAY);
+    memcpy(stats, &g_pool_state.stats, sizeof(http_conn_pool_stats_t));
+    xSemaphoreGive(g_pool_state.lock);
+    return ESP_OK;
+}
+
+esp_err_t http_conn_pool_deinit(void)
+{
+    if (!g_pool_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(g_pool_state.lock, portMAX_DELAY);
+    for (int i = 0; i < POOL_MAX_SLOTS; i++) {
+        if (g_pool_state.slots[i].in_use) {
+            ESP_LOGW(TAG, "Closing connection still in use (%s:%d)",
+                     g_pool_state.slots[i].origin.host, g_pool_state.slots[i].origin.port);
+        }
+        slot_close(&g_pool_state.slots[i]);
+    }
+    xSemaphoreGive(g_pool_state.lock);
+
+    vSemaphoreDelete(g_pool_state.lock);
+    vSemaphoreDelete(g_pool_state.released);
+    memset(&g_pool_state, 0, sizeof(g_pool_state));
+
+    ESP_LOGI(TAG, "Connection pool deinitialized");
+    return ESP_OK;
+}
@@ -0,0 +1,210 @@
+/**
+ * @file http_conn_pool.h
+ * @brief Keep-alive Connection Pool for the ESP32 HTTP Client
+ *
+ * A small fixed-size pool of esp_http_client handles keyed by origin
+ * (host:port). Several application modules can talk to different
+ * backends and still reuse warm connections.
+ *
+ * Features:
+ * - Fixed number of slots, no allocation after a slot is warm
+ * - LRU eviction of idle handles when the pool is full
+ * - Per-origin cap on idle handles
+ * - Idle timeout so stale sockets are closed before reuse
+ * - Thread-safe acquire/release
+ * - HTTPS origins; closed TLS handles keep their session for resumption
+ */
+
+#ifndef HTTP_CONN_POOL_H
+#define HTTP_CONN_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_http_client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Origin a pooled connection is bound to
+ */
+typedef struct {
+    char host[64];              /**< Server hostname or IP address */
+    int port;                   /**< Server port */
+    bool secure;                /**< HTTPS */
+} http_origin_t;
+
+/**
+ * @brief Connection pool configuration
+ */
+typedef struct {
+    int max_connections;        /**< Total handles in the pool (idle + in use) */
+    int max_idle_per_origin;    /**< Idle handles kept per origin */
+    int idle_timeout_ms;        /**< Idle handles older than this are closed */
+    int acquire_timeout_ms;     /**< Max wait for a free slot when all are busy */
+} http_conn_pool_config_t;
+
+/**
+ * @brief Connection pool statistics
+ */
+typedef struct {
+    int hits;                   /**< Acquires served by an idle handle */
+    int misses;                 /**< Acquires that created a new handle */
+    int evictions;              /**< Idle handles evicted (LRU or per-origin cap) */
+    int expired;                /**< Idle handles closed by the idle timeout */
+    int in_use;                 /**< Handles currently checked out */
+    int idle;                   /**< Handles currently idle */
+    int sessions_kept;          /**< Closed TLS handles kept idle for session resumption */
+} http_conn_pool_stats_t;
+
+/**
+ * @brief Pooled connection (opaque)
+ */
+typedef struct http_pool_slot *http_conn_t;
+
+#define HTTP_CONN_POOL_HEADER_KEYS_SIZE 256
+
+/**
+ * @brief Persistent headers left set on a pooled handle between requests
+ *
+ * Belongs to whoever holds the connection. Cleared whenever the slot
+ * gets a fresh esp_http_client handle, so a tag only survives as long
+ * as the headers it stands for.
+ */
+typedef struct {
+    uint32_t tag;                                /**< Header set currently applied (0 = none) */
+    char keys[HTTP_CONN_POOL_HEADER_KEYS_SIZE];  /**< Its names, each NUL-terminated, then an empty name */
+} http_conn_headers_t;
+
+/**
+ * @brief Default pool configuration
+ */
+#define HTTP_CONN_POOL_CONFIG_DEFAULT() {           \
+    .max_connections = 4,                           \
+    .max_idle_per_origin = 2,                       \
+    .idle_timeout_ms = 30000,                       \
+    .acquire_timeout_ms = 5000                      \
+}
+
+/**
+ * @brief Initialize the connection pool
+ *
+ * Calling this again while the pool is initialized is a no-op.
+ *
+ * @param config Pool configuration (NULL = defaults)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_conn_pool_init(const http_conn_pool_config_t *config);
+
+/**
+ * @brief Split a URL into origin and path
+ *
+ * Accepts "http://host[:port][/path]" and "https://host[:port][/path]".
+ * The port defaults to 80 or 443 and the path to "/".
+ *
+ * @param url Full URL
+ * @param origin Origin to fill
+ * @param path Buffer for the path (may be NULL)
+ * @param path_size Size of the path buffer
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on malformed URL
+ */
+esp_err_t http_conn_pool_parse_url(const char *url, http_origin_t *origin, char *path, size_t path_size);
+
+/**
+ * @brief Check out a connection for an origin
+ *
+ * Returns a warm idle handle for the origin when there is one, otherwise
+ * creates a new handle from client_config, evicting the least recently
+ * used idle handle if the pool is full. Blocks up to acquire_timeout_ms
+ * when every slot is in use.
+ *
+ * @param origin Target origin
+ * @param client_config Template used when a new handle has to be created
+ *                      (url/host/port are taken from origin). A secure
+ *                      origin with save_client_session set keeps its
+ *                      handle, and so its TLS session, when released as
+ *                      not reusable.
+ * @param conn Pooled connection (output)
+ * @return ESP_OK on success, ESP_ERR_TIMEOUT if no slot became free
+ */
+esp_err_t http_conn_pool_acquire(const http_origin_t *origin, const esp_http_client_config_t *client_config, http_conn_t *conn);
+
+/**
+ * @brief Get the esp_http_client handle of a pooled connection
+ *
+ * @param conn Pooled connection
+ * @return Client handle
+ */
+esp_http_client_handle_t http_conn_pool_client(http_conn_t conn);
+
+/**
+ * @brief Get the persistent header record of a pooled connection
+ *
+ * @param conn Pooled connection (checked out)
+ * @return Header record of the connection's handle
+ */
+http_conn_headers_t *http_conn_pool_headers(http_conn_t conn);
+
+/**
+ * @brief Record that a pooled handle has just opened a connection
+ *
+ * @param conn Pooled connection (checked out)
+ * @return true if the handle had connected before, so a TLS handle can
+ *         offer its saved session to the server
+ */
+bool http_conn_pool_mark_connected(http_conn_t conn);
+
+/**
+ * @brief Check whether a connection was handed out with its socket still open
+ *
+ * Only such a connection can fail because the server closed it while it
+ * sat idle; a fresh or session-only handle connects anew.
+ *
+ * @param conn Pooled connection (checked out)
+ * @return true if the socket of an earlier request is reused
+ */
+bool http_conn_pool_is_reused(http_conn_t conn);
+
+/**
+ * @brief Return a connection to the pool
+ *
+ * A handle that keeps its TLS session is closed but stays in the pool,
+ * exempt from the idle timeout, to resume the session on its next
+ * connect. Others are cleaned up when not reusable.
+ *
+ * @param conn Pooled connection
+ * @param reusable false closes the connection instead of keeping it open
+ */
+void http_conn_pool_release(http_conn_t conn, bool reusable);
+
+/**
+ * @brief Close all idle handles of an origin
+ *
+ * @param origin Origin to flush (NULL = all origins)
+ * @return ESP_OK on success
+ */
+esp_err_t http_conn_pool_flush(const http_origin_t *origin);
+
+/**
+ * @brief Get pool statistics
+ *
+ * @param stats Pointer to statistics structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_conn_pool_get_stats(http_conn_pool_stats_t *stats);
+
+/**
+ * @brief Deinitialize the pool and close every handle
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t http_conn_pool_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_CONN_POOL_H
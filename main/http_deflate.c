@@ -0,0 +1,443 @@
+/**
+ * @file http_deflate.c
+ * @brief Small gzip Compressor Implementation
+ *
+ * The whole stream is one fixed-Huffman block followed by an empty final
+ * block, so nothing has to be known about the input up front. Input is
+ * staged in a history buffer twice the window size; when it fills up the
+ * upper half slides down and the hash positions are rebased.
+ */
+
+#include "http_deflate.h"
+#include <string.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "HTTP_DEFLATE";
+
+#define WINDOW_SIZE (1 << HTTP_DEFLATE_WINDOW_BITS)
+#define WINDOW_MASK (WINDOW_SIZE - 1)
+#define HASH_SIZE (1 << HTTP_DEFLATE_HASH_BITS)
+#define HASH_MASK (HASH_SIZE - 1)
+#define HISTORY_SIZE (2 * WINDOW_SIZE)
+#define OUTPUT_SIZE 1024
+#define OUTPUT_MARGIN 24            /**< Room for one symbol plus the stream trailer */
+#define MIN_MATCH 3
+#define MAX_MATCH 258
+#define LOOKAHEAD (MAX_MATCH + MIN_MATCH + 1)
+#define END_OF_BLOCK 256
+
+/**
+ * @brief Compressor buffers, allocated once
+ *
+ * Hash and chain entries hold history position + 1; 0 means empty.
+ */
+typedef struct {
+    uint8_t history[HISTORY_SIZE];
+    uint16_t head[HASH_SIZE];
+    uint16_t prev[WINDOW_SIZE];
+    uint8_t output[OUTPUT_SIZE];
+} deflate_buffers_t;
+
+/**
+ * @brief Compressor state
+ */
+static struct {
+    deflate_buffers_t *buf;
+    SemaphoreHandle_t lock;
+    http_deflate_input_t input;
+    void *user_ctx;
+    size_t pos;                 /**< Next history byte to encode */
+    size_t end;                 /**< End of staged input in history */
+    bool started;
+    bool input_done;
+    bool finished;
+    bool failed;
+    uint32_t bit_buffer;
+    int bit_count;
+    size_t out_len;             /**< Staged output bytes */
+    size_t out_read;            /**< Staged output bytes already returned */
+    uint32_t crc;
+    size_t total_in;
+    size_t total_out;
+} g_deflate_state = {0};
+
+/* Deflate length and distance code tables (RFC 1951, 3.2.5) */
+static const uint16_t s_length_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t s_length_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t s_dist_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t s_dist_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+/**
+ * @brief Append bits to the output, least significant bit first
+ */
+static void put_bits(uint32_t value, int count)
+{
+    g_deflate_state.bit_buffer |= value << g_deflate_state.bit_count;
+    g_deflate_state.bit_count += count;
+    while (g_deflate_state.bit_count >= 8) {
+        g_deflate_state.buf->output[g_deflate_state.out_len++] = g_deflate_state.bit_buffer & 0xFF;
+        g_deflate_state.bit_buffer >>= 8;
+        g_deflate_state.bit_count -= 8;
+    }
+}
+
+/**
+ * @brief Append a Huffman code; codes are stored most significant bit first
+ */
+static void put_code(uint32_t code, int count)
+{
+    uint32_t reversed = 0;
+    for (int i = 0; i < count; i++) {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+    put_bits(reversed, count);
+}
+
+/**
+ * @brief Append a literal/length symbol with the fixed code
+ */
+static void put_symbol(int symbol)
+{
+    if (symbol < 144) {
+        put_code(0x30 + symbol, 8);
+    } else if (symbol < 256) {
+        put_code(0x190 + symbol - 144, 9);
+    } else if (symbol < 280) {
+        put_code(symbol - 256, 7);
+    } else {
+        put_code(0xC0 + symbol - 280, 8);
+    }
+}
+
+/**
+ * @brief Append a byte-aligned value, little-endian
+ */
+static void put_le32(uint32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        g_deflate_state.buf->output[g_deflate_state.out_len++] = (value >> (8 * i)) & 0xFF;
+    }
+}
+
+/**
+ * @brief Append a match
+ */
+static void put_match(int length, int distance)
+{
+    int code = 28;
+    while (s_length_base[code] > length) {
+        code--;
+    }
+    put_symbol(257 + code);
+    put_bits(length - s_length_base[code], s_length_extra[code]);
+
+    code = 29;
+    while (s_dist_base[code] > distance) {
+        code--;
+    }
+    put_code(code, 5);
+    put_bits(distance - s_dist_base[code], s_dist_extra[code]);
+}
+
+/**
+ * @brief Hash the three bytes at a history position
+ */
+static uint32_t hash_at(size_t pos)
+{
+    const uint8_t *p = g_deflate_state.buf->history + pos;
+    return ((p[0] << 10) ^ (p[1] << 5) ^ p[2]) & HASH_MASK;
+}
+
+/**
+ * @brief Enter a position into its hash chain
+ *
+ * @return Previous head of the chain (position + 1, 0 = none)
+ */
+static uint16_t insert_hash(size_t pos)
+{
+    deflate_buffers_t *buf = g_deflate_state.buf;
+    uint32_t hash = hash_at(pos);
+    uint16_t previous = buf->head[hash];
+    buf->prev[pos & WINDOW_MASK] = previous;
+    buf->head[hash] = pos + 1;
+    return previous;
+}
+
+/**
+ * @brief Move the upper half of the history down to make room for input
+ */
+static void slide_window(void)
+{
+    deflate_buffers_t *buf = g_deflate_state.buf;
+
+    memmove(buf->history, buf->history + WINDOW_SIZE, WINDOW_SIZE);
+    g_deflate_state.pos -= WINDOW_SIZE;
+    g_deflate_state.end -= WINDOW_SIZE;
+
+    for (int i = 0; i < HASH_SIZE; i++) {
+        buf->head[i] = buf->head[i] > WINDOW_SIZE ? buf->head[i] - WINDOW_SIZE : 0;
+    }
+    for (int i = 0; i < WINDOW_SIZE; i++) {
+        buf->prev[i] = buf->prev[i] > WINDOW_SIZE ? buf->prev[i] - WINDOW_SIZE : 0;
+    }
+}
+
+/**
+ * @brief Stage input until a full match can be looked ahead
+ */
+static void fill_input(void)
+{
+    while (!g_deflate_state.input_done && g_deflate_state.end - g_deflate_state.pos < LOOKAHEAD) {
+        if (g_deflate_state.end == HISTORY_SIZE) {
+            slide_window();
+        }
+
+        uint8_t *dest = g_deflate_state.buf->history + g_deflate_state.end;
+        int got = g_deflate_state.input(dest, HISTORY_SIZE - g_deflate_state.end, g_deflate_state.user_ctx);
+        if (got < 0) {
+            g_deflate_state.failed = true;
+            return;
+        }
+        if (got == 0) {
+            g_deflate_state.input_done = true;
+            return;
+        }
+
+        g_deflate_state.crc = esp_rom_crc32_le(g_deflate_state.crc, dest, got);
+        g_deflate_state.total_in += got;
+        g_deflate_state.end += got;
+    }
+}
+
+/**
+ * @brief Find the longest match for the current position
+ */
+static int longest_match(uint16_t candidate, int *distance)
+{
+    const uint8_t *history = g_deflate_state.buf->history;
+    size_t pos = g_deflate_state.pos;
+    size_t max_len = g_deflate_state.end - pos;
+    if (max_len > MAX_MATCH) {
+        max_len = MAX_MATCH;
+    }
+
+    int best = 0;
+    for (int chain = 0; chain < HTTP_DEFLATE_MAX_CHAIN && candidate != 0; chain++) {
+        size_t match = candidate - 1;
+        if (match >= pos || pos - match >= WINDOW_SIZE) {
+            break;
+        }
+
+        if (history[match + best] == history[pos + best]) {
+            size_t len = 0;
+            while (len < max_len && history[match + len] == history[pos + len]) {
+                len++;
+            }
+            if ((int)len > best) {
+                best = len;
+                *distance = pos - match;
+                if (len == max_len) {
+                    break;
+                }
+            }
+        }
+
+        uint16_t next = g_deflate_state.buf->prev[match & WINDOW_MASK];
+        if (next >= candidate) {
+            break;  // Chain entry was reused by a newer position
+        }
+        candidate = next;
+    }
+    return best;
+}
+
+/**
+ * @brief Close the stream: end of block, empty final block, gzip trailer
+ */
+static void finish_stream(void)
+{
+    put_symbol(END_OF_BLOCK);
+    put_bits(1, 1);             // BFINAL
+    put_bits(1, 2);             // BTYPE = fixed Huffman
+    put_symbol(END_OF_BLOCK);
+    if (g_deflate_state.bit_count > 0) {
+        put_bits(0, 8 - g_deflate_state.bit_count);
+    }
+
+    put_le32(g_deflate_state.crc);
+    put_le32(g_deflate_state.total_in);
+    g_deflate_state.finished = true;
+}
+
+/**
+ * @brief Compress input until the output staging buffer is nearly full
+ */
+static void compress_step(void)
+{
+    deflate_buffers_t *buf = g_deflate_state.buf;
+
+    if (!g_deflate_state.started) {
+        static const uint8_t gzip_header[10] = { 0x1f, 0x8b, 0x08, 0, 0, 0, 0, 0, 0, 0xff };
+        memcpy(buf->output, gzip_header, sizeof(gzip_header));
+        g_deflate_state.out_len = sizeof(gzip_header);
+        put_bits(0, 1);         // BFINAL
+        put_bits(1, 2);         // BTYPE = fixed Huffman
+        g_deflate_state.started = true;
+    }
+
+    while (g_deflate_state.out_len + OUTPUT_MARGIN < OUTPUT_SIZE) {
+        fill_input();
+        if (g_deflate_state.failed) {
+            return;
+        }
+
+        size_t pos = g_deflate_state.pos;
+        size_t avail = g_deflate_state.end - pos;
+        if (avail == 0) {
+            finish_stream();
+            return;
+        }
+
+        int length = 0;
+        int distance = 0;
+        if (avail >= MIN_MATCH) {
+            length = longest_match(insert_hash(pos), &distance);
+        }
+
+        if (length >= MIN_MATCH) {
+            put_match(length, distance);
+            for (int i = 1; i < length; i++) {
+                if (pos + i + MIN_MATCH <= g_deflate_state.end) {
+                    insert_hash(pos + i);
+                }
+            }
+            g_deflate_state.pos += length;
+        } else {
+            put_symbol(buf->history[pos]);
+            g_deflate_state.pos++;
+        }
+    }
+}
+
+esp_err_t http_deflate_init(void)
+{
+    if (g_deflate_state.buf) {
+        return ESP_OK;
+    }
+
+    g_deflate_state.buf = malloc(sizeof(deflate_buffers_t));
+    g_deflate_state.lock = xSemaphoreCreateMutex();
+    if (!g_deflate_state.buf || !g_deflate_state.lock) {
+        ESP_LOGE(TAG, "Failed to allocate compressor (%zu bytes)", sizeof(deflate_buffers_t));
+        free(g_deflate_state.buf);
+        if (g_deflate_state.lock) {
+            vSemaphoreDelete(g_deflate_state.lock);
+        }
+        memset(&g_deflate_state, 0, sizeof(g_deflate_state));
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "Compressor ready: %d byte window, %zu bytes", WINDOW_SIZE, sizeof(deflate_buffers_t));
+    return ESP_OK;
+}
+
+bool http_deflate_acquire(void)
+{
+    return g_deflate_state.lock && xSemaphoreTake(g_deflate_state.lock, 0) == pdTRUE;
+}
+
+void http_deflate_release(void)
+{
+    xSemaphoreGive(g_deflate_state.lock);
+}
+
+void http_deflate_start(http_deflate_input_t input, void *user_ctx)
+{
+    g_deflate_state.input = input;
+    g_deflate_state.user_ctx = user_ctx;
+    g_deflate_state.pos = 0;
+    g_deflate_state.end = 0;
+    g_deflate_state.started = false;
+    g_deflate_state.input_done = false;
+    g_deflate_state.finished = false;
+    g_deflate_state.failed = false;
+    g_deflate_state.bit_buffer = 0;
+    g_deflate_state.bit_count = 0;
+    g_deflate_state.out_len = 0;
+    g_deflate_state.out_read = 0;
+    g_deflate_state.crc = 0;
+    g_deflate_state.total_in = 0;
+    g_deflate_state.total_out = 0;
+    memset(g_deflate_state.buf->head, 0, sizeof(g_deflate_state.buf->head));
+    memset(g_deflate_state.buf->prev, 0, sizeof(g_deflate_state.buf->prev));
+}
+
+int http_deflate_read(char *buffer, size_t len)
+{
+    size_t copied = 0;
+
+    while (copied < len && !g_deflate_state.failed) {
+        if (g_deflate_state.out_read < g_deflate_state.out_len) {
+            size_t chunk = g_deflate_state.out_len - g_deflate_state.out_read;
+            if (chunk > len - copied) {
+                chunk = len - copied;
+            }
+            memcpy(buffer + copied, g_deflate_state.buf->output + g_deflate_state.out_read, chunk);
+            g_deflate_state.out_read += chunk;
+            copied += chunk;
+            continue;
+        }
+
+        if (g_deflate_state.finished) {
+            break;
+        }
+
+        g_deflate_state.out_len = 0;
+        g_deflate_state.out_read = 0;
+        compress_step();
+    }
+
+    if (g_deflate_state.failed) {
+        return -1;
+    }
+
+    g_deflate_state.total_out += copied;
+    return copied;
+}
+
+void http_deflate_totals(size_t *bytes_in, size_t *bytes_out)
+{
+    if (bytes_in) {
+        *bytes_in = g_deflate_state.total_in;
+    }
+    if (bytes_out) {
+        *bytes_out = g_deflate_state.total_out;
+    }
+}
+
+void http_deflate_deinit(void)
+{
+    if (!g_deflate_state.buf) {
+        return;
+    }
+
+    free(g_deflate_state.buf);
+    vSemaphoreDelete(g_deflate_state.lock);
+    memset(&g_deflate_state, 0, sizeof(g_deflate_state));
+}
@@ -0,0 +1,103 @@
+/**
+ * @file http_deflate.h
+ * @brief Small gzip Compressor for Request Bodies
+ *
+ * A streaming gzip (RFC 1952) encoder built for the ESP32: LZ77 over a
+ * fixed window with hash chains and the fixed Huffman code of deflate
+ * (RFC 1951). All buffers are allocated once by http_deflate_init() and
+ * shared by every request, so compressing costs no per-request heap.
+ * One request compresses at a time; others send uncompressed while the
+ * compressor is taken.
+ *
+ * Memory: 2 * window + hash table + chain table + output staging, about
+ * 25 KB with the defaults below.
+ */
+
+#ifndef HTTP_DEFLATE_H
+#define HTTP_DEFLATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef HTTP_DEFLATE_WINDOW_BITS
+#define HTTP_DEFLATE_WINDOW_BITS 12     /**< LZ77 window of 4 KB */
+#endif
+
+#ifndef HTTP_DEFLATE_HASH_BITS
+#define HTTP_DEFLATE_HASH_BITS 12       /**< 4096 hash chains */
+#endif
+
+#ifndef HTTP_DEFLATE_MAX_CHAIN
+#define HTTP_DEFLATE_MAX_CHAIN 8        /**< Candidates tried per position */
+#endif
+
+/**
+ * @brief Input callback of the compressor
+ *
+ * @param buffer Buffer to fill with uncompressed bytes
+ * @param len Maximum number of bytes
+ * @param user_ctx Context passed to http_deflate_start()
+ * @return Bytes provided, 0 at the end of the input, -1 on error
+ */
+typedef int (*http_deflate_input_t)(uint8_t *buffer, size_t len, void *user_ctx);
+
+/**
+ * @brief Allocate the compressor buffers (idempotent)
+ *
+ * @return ESP_OK on success, ESP_ERR_NO_MEM on failure
+ */
+esp_err_t http_deflate_init(void);
+
+/**
+ * @brief Take the compressor if no other request is using it
+ *
+ * @return true if taken, false if busy or not initialized
+ */
+bool http_deflate_acquire(void);
+
+/**
+ * @brief Give the compressor back
+ */
+void http_deflate_release(void);
+
+/**
+ * @brief Start (or restart) a gzip stream
+ *
+ * @param input Input callback
+ * @param user_ctx Context passed to the callback
+ */
+void http_deflate_start(http_deflate_input_t input, void *user_ctx);
+
+/**
+ * @brief Read the next compressed bytes
+ *
+ * @param buffer Output buffer
+ * @param len Size of buffer
+ * @return Bytes written, 0 at the end of the stream, -1 on error
+ */
+int http_deflate_read(char *buffer, size_t len);
+
+/**
+ * @brief Get the sizes of the current stream so far
+ *
+ * @param bytes_in Uncompressed bytes consumed (optional)
+ * @param bytes_out Compressed bytes produced (optional)
+ */
+void http_deflate_totals(size_t *bytes_in, size_t *bytes_out);
+
+/**
+ * @brief Free the compressor buffers
+ */
+void http_deflate_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_DEFLATE_H
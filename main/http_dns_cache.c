@@ -0,0 +1,345 @@
+/**
+ * @file http_dns_cache.c
+ * @brief Hostname Resolution Cache Implementation
+ */
+
+#include "http_dns_cache.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lwip/netdb.h"
+#include "lwip/sockets.h"
+#include "lwip/dns.h"
+#include "lwip/tcpip.h"
+
+static const char *TAG = "HTTP_DNS_CACHE";
+
+#define DNS_CACHE_MAX_ENTRIES 8
+
+/**
+ * @brief Cached hostname
+ */
+typedef struct {
+    char host[64];                          /**< Empty when the entry is unused */
+    char addr[HTTP_DNS_CACHE_ADDR_SIZE];    /**< Dotted IPv4 address */
+    uint64_t expires_ms;
+    uint64_t last_used_ms;
+    bool refreshing;                        /**< Background lookup in flight */
+} dns_entry_t;
+
+/**
+ * @brief Global cache state
+ */
+static struct {
+    http_dns_cache_config_t config;
+    http_dns_cache_stats_t stats;
+    dns_entry_t entries[DNS_CACHE_MAX_ENTRIES];
+    bool initialized;
+} g_dns_state = {0};
+
+static portMUX_TYPE s_dns_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint64_t now_ms(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+/**
+ * @brief Find the entry of a hostname (lock held)
+ */
+static dns_entry_t *find_entry(const char *host)
+{
+    for (int i = 0; i < g_dns_state.config.max_entries; i++) {
+        if (strcmp(g_dns_state.entries[i].host, host) == 0) {
+            return &g_dns_state.entries[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Store a resolved address, replacing the LRU entry if needed (lock held)
+ */
+static void store_entry(const char *host, const char *addr, uint64_t now)
+{
+    dns_entry_t *entry = find_entry(host);
+    if (!entry) {
+        for (int i = 0; i < g_dns_state.config.max_entries; i++) {
+            dns_entry_t *candidate = &g_dns_state.entries[i];
+            if (candidate->host[0] == '\0') {
+                entry = candidate;
+                break;
+            }
+            if (!entry || candidate->last_used_ms < entry->last_used_ms) {
+                entry = candidate;
+            }
+        }
+        if (entry->host[0] == '\0') {
+            g_dns_state.stats.entries++;
+        }
+        strcpy(entry->host, host);
+        entry->refreshing = false;
+        entry->last_used_ms = now;
+    }
+
+    strcpy(entry->addr, addr);
+    entry->expires_ms = now + g_dns_state.config.ttl_ms;
+}
+
+/**
+ * @brief lwIP DNS callback of a background refresh (tcpip thread)
+ */
+static void refresh_done(const char *name, const ip_addr_t *ipaddr, void *arg)
+{
+    char addr[HTTP_DNS_CACHE_ADDR_SIZE] = "";
+    if (ipaddr) {
+        ipaddr_ntoa_r(ipaddr, addr, sizeof(addr));
+    }
+
+    taskENTER_CRITICAL(&s_dns_lock);
+    if (g_dns_state.initialized) {
+        dns_entry_t *entry = find_entry(name);
+        if (entry) {
+            entry->refreshing = false;
+        }
+        if (addr[0] == '\0') {
+            g_dns_state.stats.failures++;
+        } else if (entry) {
+            store_entry(name, addr, now_ms());
+        }
+    }
+    taskEXIT_CRITICAL(&s_dns_lock);
+}
+
+/**
+ * @brief Start a background refresh of an entry (tcpip thread)
+ *
+ * The entry may have been replaced since the refresh was queued; then
+ * the hostname that holds it now is refreshed instead, which is harmless.
+ */
+static void refresh_start(void *arg)
+{
+    int index = (int)(intptr_t)arg;
+    char host[sizeof(((dns_entry_t *)0)->host)];
+
+    taskENTER_CRITICAL(&s_dns_lock);
+    bool valid = g_dns_state.initialized && g_dns_state.entries[index].host[0] != '\0';
+    if (valid) {
+        strcpy(host, g_dns_state.entries[index].host);
+    }
+    taskEXIT_CRITICAL(&s_dns_lock);
+    if (!valid) {
+        return;
+    }
+
+    ip_addr_t ipaddr;
+    err_t err = dns_gethostbyname_addrtype(host, &ipaddr, refresh_done, NULL, LWIP_DNS_ADDRTYPE_IPV4);
+    if (err == ERR_OK) {
+        // Answered from lwIP's table without a query
+        refresh_done(host, &ipaddr, NULL);
+    } else if (err != ERR_INPROGRESS) {
+        refresh_done(host, NULL, NULL);
+    }
+}
+
+/**
+ * @brief Resolve a hostname with a blocking DNS lookup
+ */
+static esp_err_t lookup(const char *host, char *addr, size_t addr_size)
+{
+    struct addrinfo hints = {
+        .ai_family = AF_INET,
+        .ai_socktype = SOCK_STREAM,
+    };
+    struct addrinfo *res = NULL;
+
+    int err = getaddrinfo(host, NULL, &hints, &res);
+    if (err != 0 || !res) {
+        ESP_LOGW(TAG, "DNS lookup for %s failed: %d", host, err);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    struct sockaddr_in *sin = (struct sockaddr_in *)res->ai_addr;
+    inet_ntop(AF_INET, &sin->sin_addr, addr, addr_size);
+    freeaddrinfo(res);
+    return ESP_OK;
+}
+
+esp_err_t http_dns_cache_init(const http_dns_cache_config_t *config)
+{
+    if (g_dns_state.initialized) {
+        return ESP_OK;
+    }
+
+    http_dns_cache_config_t defaults = HTTP_DNS_CACHE_CONFIG_DEFAULT();
+    if (!config) {
+        config = &defaults;
+    }
+
+    if (config->max_entries <= 0 || config->ttl_ms <= 0 || config->prefetch_ms < 0) {
+        ESP_LOGE(TAG, "Invalid cache configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    taskENTER_CRITICAL(&s_dns_lock);
+    memset(g_dns_state.entries, 0, sizeof(g_dns_state.entries));
+    memset(&g_dns_state.stats, 0, sizeof(g_dns_state.stats));
+    g_dns_state.config = *config;
+    if (g_dns_state.config.max_entries > DNS_CACHE_MAX_ENTRIES) {
+        g_dns_state.config.max_entries = DNS_CACHE_MAX_ENTRIES;
+    }
+    g_dns_state.initialized = true;
+    taskEXIT_CRITICAL(&s_dns_lock);
+
+    ESP_LOGI(TAG, "DNS cache initialized: %d entries, TTL %d ms",
+             g_dns_state.config.max_entries, g_dns_state.config.ttl_ms);
+    return ESP_OK;
+}
+
+esp_err_t http_dns_cache_resolve(const char *host, char *addr, size_t addr_size, http_dns_result_t *result)
+{
+    if (!host || !addr || addr_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_dns_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    struct in_addr literal;
+    if (inet_pton(AF_INET, host, &literal) == 1 || strchr(host, ':')) {
+        if (strlen(host) >= addr_size) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        strcpy(addr, host);
+        if (result) {
+            *result = HTTP_DNS_LITERAL;
+        }
+        return ESP_OK;
+    }
+
+    if (strlen(host) >= sizeof(((dns_entry_t *)0)->host) || addr_size < HTTP_DNS_CACHE_ADDR_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    uint64_t now = now_ms();
+    bool fresh = false;
+    int prefetch = -1;
+    char stale[HTTP_DNS_CACHE_ADDR_SIZE] = "";
+
+    taskENTER_CRITICAL(&s_dns_lock);
+    dns_entry_t *entry = find_entry(host);
+    if (entry) {
+        entry->last_used_ms = now;
+        if (now < entry->expires_ms) {
+            fresh = true;
+            strcpy(addr, entry->addr);
+            g_dns_state.stats.hits++;
+            if (!entry->refreshing && entry->expires_ms - now <= (uint64_t)g_dns_state.config.prefetch_ms) {
+                entry->refreshing = true;
+                prefetch = entry - g_dns_state.entries;
+                g_dns_state.stats.prefetches++;
+            }
+        } else {
+            strcpy(stale, entry->addr);
+        }
+    }
+    if (!fresh) {
+        g_dns_state.stats.misses++;
+    }
+    taskEXIT_CRITICAL(&s_dns_lock);
+
+    if (fresh) {
+        if (prefetch >= 0 && tcpip_callback(refresh_start, (void *)(intptr_t)prefetch) != ERR_OK) {
+            taskENTER_CRITICAL(&s_dns_lock);
+            g_dns_state.entries[prefetch].refreshing = false;
+            taskEXIT_CRITICAL(&s_dns_lock);
+        }
+        if (result) {
+            *result = HTTP_DNS_HIT;
+        }
+        return ESP_OK;
+    }
+
+    char resolved[HTTP_DNS_CACHE_ADDR_SIZE];
+    esp_err_t err = lookup(host, resolved, sizeof(resolved));
+
+    taskENTER_CRITICAL(&s_dns_lock);
+    if (err == ESP_OK) {
+        store_entry(host, resolved, now_ms());
+    } else {
+        g_dns_state.stats.failures++;
+        if (stale[0] != '\0') {
+            g_dns_state.stats.stale++;
+        }
+    }
+    taskEXIT_CRITICAL(&s_dns_lock);
+
+    if (err == ESP_OK) {
+        strcpy(addr, resolved);
+        if (result) {
+            *result = HTTP_DNS_MISS;
+        }
+        return ESP_OK;
+    }
+
+    if (stale[0] == '\0') {
+        return err;
+    }
+
+    // A flaky network is more likely than a moved server
+    ESP_LOGW(TAG, "Using expired address %s for %s", stale, host);
+    strcpy(addr, stale);
+    if (result) {
+        *result = HTTP_DNS_STALE;
+    }
+    return ESP_OK;
+}
+
+void http_dns_cache_invalidate(const char *host)
+{
+    taskENTER_CRITICAL(&s_dns_lock);
+    for (int i = 0; i < g_dns_state.config.max_entries; i++) {
+        dns_entry_t *entry = &g_dns_state.entries[i];
+        if (entry->host[0] != '\0' && (!host || strcmp(entry->host, host) == 0)) {
+            memset(entry, 0, sizeof(dns_entry_t));
+            g_dns_state.stats.entries--;
+        }
+    }
+    taskEXIT_CRITICAL(&s_dns_lock);
+}
+
+esp_err_t http_dns_cache_get_stats(http_dns_cache_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_dns_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    taskENTER_CRITICAL(&s_dns_lock);
+    memcpy(stats, &g_dns_state.stats, sizeof(http_dns_cache_stats_t));
+    taskEXIT_CRITICAL(&s_dns_lock);
+    return ESP_OK;
+}
+
+esp_err_t http_dns_cache_deinit(void)
+{
+    if (!g_dns_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // A background lookup still in flight sees initialized == false and drops its answer
+    taskENTER_CRITICAL(&s_dns_lock);
+    memset(&g_dns_state, 0, sizeof(g_dns_state));
+    taskEXIT_CRITICAL(&s_dns_lock);
+
+    ESP_LOGI(TAG, "DNS cache deinitialized");
+    return ESP_OK;
+}
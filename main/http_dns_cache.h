@@ -0,0 +1,130 @@
+/**
+ * @file http_dns_cache.h
+ * @brief Hostname Resolution Cache for the ESP32 HTTP Client
+ *
+ * Keeps the IPv4 address of recently used hostnames so that opening a
+ * connection does not wait for a DNS lookup. The client connects to the
+ * cached address and sends the hostname in the Host header (and as the
+ * TLS server name).
+ *
+ * Features:
+ * - Fixed number of entries, LRU replacement, no allocation
+ * - Entries expire after a time to live
+ * - Prefetch: a hit close to expiry starts a background lookup, so a
+ *   busy hostname never expires in front of a request
+ * - Stale fallback: if a lookup fails, an expired address is used
+ *   rather than failing the request
+ * - IP address literals are passed through without caching
+ *
+ * lwIP does not report the TTL of the DNS records it returns, so the
+ * time to live is configured. Lookups are answered from lwIP's own DNS
+ * table while the record TTL lasts, so an entry is never older than the
+ * record TTL plus ttl_ms.
+ */
+
+#ifndef HTTP_DNS_CACHE_H
+#define HTTP_DNS_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_DNS_CACHE_ADDR_SIZE 16     /**< Dotted IPv4 address with terminator */
+
+/**
+ * @brief Resolver cache configuration
+ */
+typedef struct {
+    int max_entries;            /**< Cached hostnames (up to 8) */
+    int ttl_ms;                 /**< Lifetime of a resolved address */
+    int prefetch_ms;            /**< Hits this close to expiry refresh the entry in the background */
+} http_dns_cache_config_t;
+
+/**
+ * @brief Resolver cache statistics
+ */
+typedef struct {
+    int hits;                   /**< Lookups answered from the cache */
+    int misses;                 /**< Lookups that had to wait for DNS */
+    int prefetches;             /**< Background refreshes started */
+    int failures;               /**< DNS lookups that failed */
+    int stale;                  /**< Expired addresses used because DNS failed */
+    int entries;                /**< Hostnames currently cached */
+} http_dns_cache_stats_t;
+
+/**
+ * @brief How a lookup was answered
+ */
+typedef enum {
+    HTTP_DNS_LITERAL = 0,       /**< Host is an IP address, nothing to resolve */
+    HTTP_DNS_HIT,               /**< Fresh cache entry */
+    HTTP_DNS_MISS,              /**< Resolved now */
+    HTTP_DNS_STALE              /**< DNS failed, expired entry used */
+} http_dns_result_t;
+
+/**
+ * @brief Default resolver cache configuration
+ */
+#define HTTP_DNS_CACHE_CONFIG_DEFAULT() {           \
+    .max_entries = 4,                               \
+    .ttl_ms = 300000,                               \
+    .prefetch_ms = 30000                            \
+}
+
+/**
+ * @brief Initialize the resolver cache
+ *
+ * Calling this again while the cache is initialized is a no-op.
+ *
+ * @param config Cache configuration (NULL = defaults)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_dns_cache_init(const http_dns_cache_config_t *config);
+
+/**
+ * @brief Resolve a hostname, from the cache when possible
+ *
+ * Blocks for the DNS lookup on a miss.
+ *
+ * @param host Hostname or IPv4 address
+ * @param addr Buffer for the dotted IPv4 address
+ * @param addr_size Size of addr (HTTP_DNS_CACHE_ADDR_SIZE is enough)
+ * @param result How the lookup was answered (optional)
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if the host does not resolve
+ */
+esp_err_t http_dns_cache_resolve(const char *host, char *addr, size_t addr_size, http_dns_result_t *result);
+
+/**
+ * @brief Drop a hostname from the cache
+ *
+ * For callers that found the cached address unreachable.
+ *
+ * @param host Hostname (NULL = every entry)
+ */
+void http_dns_cache_invalidate(const char *host);
+
+/**
+ * @brief Get resolver cache statistics
+ *
+ * @param stats Pointer to statistics structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_dns_cache_get_stats(http_dns_cache_stats_t *stats);
+
+/**
+ * @brief Deinitialize the resolver cache
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t http_dns_cache_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_DNS_CACHE_H
@@ -24,6 +24,9 @@ static struct {
     int message_counter;
 } g_client_state = {0};
 
+/* Guards message_counter and stats; messages may be sent from several tasks */
+static portMUX_TYPE s_client_lock = portMUX_INITIALIZER_UNLOCKED;
+
 /**
  * @brief HTTP event handler for the client
  */
@@ -62,7 +65,7 @@ static esp_err_t http_event_handler(esp_http_client_event_t *evt)
 /**
  * @brief Generate dynamic message content
  */
-static esp_err_t generate_message_content(char *buffer, size_t buffer_size, const char *custom_message)
+static esp_err_t generate_message_content(char *buffer, size_t buffer_size, int message_number, const char *custom_message)
 {
     if (!buffer || buffer_size == 0) {
         return ESP_ERR_INVALID_ARG;
@@ -76,7 +79,7 @@ static esp_err_t generate_message_content(char *buffer, size_t buffer_size, cons
     
     // Generate calculations for verification
     int fibonacci = 1;
-    for(int i = 0; i < g_client_state.message_counter; i++) {
+    for(int i = 0; i < message_number; i++) {
         fibonacci = fibonacci * 2;
         if(fibonacci > 10000) fibonacci = 1;  // Reset if too big
     }
@@ -91,13 +94,13 @@ static esp_err_t generate_message_content(char *buffer, size_t buffer_size, cons
         "   🧮 Calculation Result: %d (2^%d simplified)\n"
         "   🆔 Message Hash: %lu\n"
         "\n",
-        g_client_state.message_counter,
+        message_number,
         (unsigned long)uptime_seconds, 
         (unsigned long)(uptime_ms % 1000), 
         (unsigned long)uptime_ms,
         fibonacci, 
-        g_client_state.message_counter,
-        (unsigned long)(g_client_state.message_counter * uptime_ms)
+        message_number,
+        (unsigned long)(message_number * uptime_ms)
     );
 
     if (written < 0 || written >= buffer_size) {
@@ -153,8 +156,8 @@ static esp_err_t generate_message_content(char *buffer, size_t buffer_size, cons
             "   📊 Counter factorial (mod 1000): %d\n"
             "\n",
             esp_random() % 1000,
-            g_client_state.message_counter * g_client_state.message_counter,
-            (g_client_state.message_counter * (g_client_state.message_counter + 1) / 2) % 1000
+            message_number * message_number,
+            (message_number * (message_number + 1) / 2) % 1000
         );
         
         if (rand_written > 0 && rand_written < remaining) {
@@ -233,10 +236,12 @@ esp_err_t http_hello_client_send_custom_message(const char *custom_message)
         return ESP_ERR_INVALID_STATE;
     }
 
-    g_client_state.message_counter++;
+    taskENTER_CRITICAL(&s_client_lock);
+    int message_number = ++g_client_state.message_counter;
+    taskEXIT_CRITICAL(&s_client_lock);
     
     ESP_LOGI(TAG, "Sending Hello World message #%d to %s:%d", 
-             g_client_state.message_counter, 
+             message_number, 
              g_client_state.config.host, 
              g_client_state.config.port);
 
@@ -253,17 +258,21 @@ esp_err_t http_hello_client_send_custom_message(const char *custom_message)
     esp_http_client_handle_t client = esp_http_client_init(&client_config);
     if (!client) {
         ESP_LOGE(TAG, "Failed to initialize HTTP client");
+        taskENTER_CRITICAL(&s_client_lock);
         g_client_state.stats.messages_failed++;
+        taskEXIT_CRITICAL(&s_client_lock);
         return ESP_FAIL;
     }
 
     // Generate message content
     char message_buffer[1024];
-    esp_err_t ret = generate_message_content(message_buffer, sizeof(message_buffer), custom_message);
+    esp_err_t ret = generate_message_content(message_buffer, sizeof(message_buffer), message_number, custom_message);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to generate message content");
         esp_http_client_cleanup(client);
+        taskENTER_CRITICAL(&s_client_lock);
         g_client_state.stats.messages_failed++;
+        taskEXIT_CRITICAL(&s_client_lock);
         return ret;
     }
 
@@ -277,7 +286,7 @@ esp_err_t http_hello_client_send_custom_message(const char *custom_message)
     char uptime_header[32];
     uint32_t uptime_ms = esp_timer_get_time() / 1000;
     
-    snprintf(counter_header, sizeof(counter_header), "%d", g_client_state.message_counter);
+    snprintf(counter_header, sizeof(counter_header), "%d", message_number);
     snprintf(uptime_header, sizeof(uptime_header), "%lu", (unsigned long)uptime_ms);
     
     esp_http_client_set_header(client, "X-ESP32-Message-Counter", counter_header);
@@ -290,29 +299,36 @@ esp_err_t http_hello_client_send_custom_message(const char *custom_message)
         int status_code = esp_http_client_get_status_code(client);
         int64_t content_length = esp_http_client_get_content_length(client);
         
+        taskENTER_CRITICAL(&s_client_lock);
         g_client_state.stats.last_response_code = status_code;
         g_client_state.stats.last_send_time_ms = esp_timer_get_time() / 1000;
         g_client_state.stats.total_uptime_ms = uptime_ms;
+        if (status_code == 200) {
+            g_client_state.stats.messages_sent++;
+        } else {
+            g_client_state.stats.messages_failed++;
+        }
+        taskEXIT_CRITICAL(&s_client_lock);
         
         ESP_LOGI(TAG, "✅ SUCCESS! Message #%d sent - HTTP POST Status = %d, content_length = %lld", 
-                g_client_state.message_counter, status_code, content_length);
+                message_number, status_code, content_length);
         
         if (status_code == 200) {
-            ESP_LOGI(TAG, "🎉 Hello World message #%d successfully sent!", g_client_state.message_counter);
+            ESP_LOGI(TAG, "🎉 Hello World message #%d successfully sent!", message_number);
             ESP_LOGI(TAG, "📊 Uptime: %lu.%03lu seconds, Free heap: %lu bytes", 
                     uptime_ms / 1000, uptime_ms % 1000, (unsigned long)esp_get_free_heap_size());
-            g_client_state.stats.messages_sent++;
         } else {
-            ESP_LOGW(TAG, "⚠️ Received response code: %d for message #%d", status_code, g_client_state.message_counter);
-            g_client_state.stats.messages_failed++;
+            ESP_LOGW(TAG, "⚠️ Received response code: %d for message #%d", status_code, message_number);
         }
     } else {
-        ESP_LOGE(TAG, "❌ HTTP POST request #%d failed: %s", g_client_state.message_counter, esp_err_to_name(err));
+        ESP_LOGE(TAG, "❌ HTTP POST request #%d failed: %s", message_number, esp_err_to_name(err));
         ESP_LOGE(TAG, "💡 Make sure:");
         ESP_LOGE(TAG, "   1. Your computer's IP is correct: %s", g_client_state.config.host);
         ESP_LOGE(TAG, "   2. HTTP server is running on port %d", g_client_state.config.port);
         ESP_LOGE(TAG, "   3. Both devices are on the same network");
+        taskENTER_CRITICAL(&s_client_lock);
         g_client_state.stats.messages_failed++;
+        taskEXIT_CRITICAL(&s_client_lock);
     }
     
     esp_http_client_cleanup(client);
@@ -329,7 +345,9 @@ esp_err_t http_hello_client_get_stats(http_hello_stats_t *stats)
         return ESP_ERR_INVALID_STATE;
     }
     
+    taskENTER_CRITICAL(&s_client_lock);
     memcpy(stats, &g_client_state.stats, sizeof(http_hello_stats_t));
+    taskEXIT_CRITICAL(&s_client_lock);
     return ESP_OK;
 }
 
@@ -0,0 +1,98 @@
+/**
+ * @file http_histogram.c
+ * @brief Fixed-Bucket Latency Histogram Implementation
+ */
+
+#include "http_histogram.h"
+
+#define SUB_BUCKET_BITS 2   /**< log2(HTTP_HISTOGRAM_SUB_BUCKETS) */
+
+int http_histogram_bucket_index(uint32_t value)
+{
+    if (value < HTTP_HISTOGRAM_SUB_BUCKETS) {
+        return value;
+    }
+
+    int octave = 31 - __builtin_clz(value);
+    int sub = (value >> (octave - SUB_BUCKET_BITS)) & (HTTP_HISTOGRAM_SUB_BUCKETS - 1);
+    int index = HTTP_HISTOGRAM_SUB_BUCKETS * (octave - SUB_BUCKET_BITS + 1) + sub;
+    return index < HTTP_HISTOGRAM_BUCKETS ? index : HTTP_HISTOGRAM_BUCKETS - 1;
+}
+
+void http_histogram_record(http_histogram_t *histogram, uint32_t value_us)
+{
+    histogram->buckets[http_histogram_bucket_index(value_us)]++;
+    histogram->count++;
+    histogram->sum_us += value_us;
+    if (value_us > histogram->max_us) {
+        histogram->max_us = value_us;
+    }
+}
+
+void http_histogram_bucket_range(int index, uint32_t *lower_us, uint32_t *upper_us)
+{
+    uint32_t lower;
+    uint32_t upper;
+
+    if (index < HTTP_HISTOGRAM_SUB_BUCKETS) {
+        lower = upper = index;
+    } else {
+        int shift = index / HTTP_HISTOGRAM_SUB_BUCKETS - 1;
+        int sub = index % HTTP_HISTOGRAM_SUB_BUCKETS;
+        lower = (uint32_t)(HTTP_HISTOGRAM_SUB_BUCKETS + sub) << shift;
+        upper = lower + (1u << shift) - 1;
+    }
+
+    // Everything beyond the range is counted in the last bucket
+    if (index == HTTP_HISTOGRAM_BUCKETS - 1) {
+        upper = UINT32_MAX;
+    }
+
+    if (lower_us) {
+        *lower_us = lower;
+    }
+    if (upper_us) {
+        *upper_us = upper;
+    }
+}
+
+uint32_t http_histogram_percentile(const http_histogram_t *histogram, int percentile)
+{
+    if (histogram->count == 0) {
+        return 0;
+    }
+
+    // Rank of the sample at the percentile, rounded up, at least 1
+    uint64_t rank = ((uint64_t)histogram->count * percentile + 99) / 100;
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (int i = 0; i < HTTP_HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= rank) {
+            uint32_t upper;
+            http_histogram_bucket_range(i, NULL, &upper);
+            return upper < histogram->max_us ? upper : histogram->max_us;
+        }
+    }
+    return histogram->max_us;
+}
+
+uint32_t http_histogram_mean(const http_histogram_t *histogram)
+{
+    return histogram->count > 0 ? (uint32_t)(histogram->sum_us / histogram->count) : 0;
+}
+
+void http_histogram_merge(http_histogram_t *into, const http_histogram_t *from)
+{
+    for (int i = 0; i < HTTP_HISTOGRAM_BUCKETS; i++) {
+        into->buckets[i] += from->buckets[i];
+    }
+    into->count += from->count;
+    into->sum_us += from->sum_us;
+    if (from->max_us > into->max_us) {
+        into->max_us = from->max_us;
+    }
+}
@@ -0,0 +1,95 @@
+/**
+ * @file http_histogram.h
+ * @brief Fixed-Bucket Latency Histogram
+ *
+ * Log-scale histogram of durations in microseconds: every power of two
+ * is split into HTTP_HISTOGRAM_SUB_BUCKETS linear buckets, so a bucket
+ * is at most 25% wide relative to its lower bound. 1 us to about 134 s
+ * fits in HTTP_HISTOGRAM_BUCKETS counters; longer values land in the
+ * last bucket. Recording is O(1) and never allocates.
+ *
+ * The histogram does no locking; the owner serializes access. Copying
+ * the structure is the snapshot export.
+ */
+
+#ifndef HTTP_HISTOGRAM_H
+#define HTTP_HISTOGRAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_HISTOGRAM_SUB_BUCKETS 4    /**< Linear buckets per power of two */
+#define HTTP_HISTOGRAM_BUCKETS 104      /**< Covers up to 2^27 us */
+
+/**
+ * @brief Latency histogram
+ */
+typedef struct {
+    uint32_t buckets[HTTP_HISTOGRAM_BUCKETS];   /**< Samples per bucket */
+    uint32_t count;                             /**< Total samples */
+    uint32_t max_us;                            /**< Largest sample */
+    uint64_t sum_us;                            /**< Sum of all samples */
+} http_histogram_t;
+
+/**
+ * @brief Add one sample
+ *
+ * @param histogram Histogram
+ * @param value_us Duration in microseconds
+ */
+void http_histogram_record(http_histogram_t *histogram, uint32_t value_us);
+
+/**
+ * @brief Get a percentile
+ *
+ * The result is the upper bound of the bucket holding the percentile,
+ * capped at the largest sample, so it never under-reports.
+ *
+ * @param histogram Histogram
+ * @param percentile Percentile, 0-100
+ * @return Duration in microseconds, 0 if the histogram is empty
+ */
+uint32_t http_histogram_percentile(const http_histogram_t *histogram, int percentile);
+
+/**
+ * @brief Get the mean of all samples
+ *
+ * @param histogram Histogram
+ * @return Mean duration in microseconds, 0 if the histogram is empty
+ */
+uint32_t http_histogram_mean(const http_histogram_t *histogram);
+
+/**
+ * @brief Get the bucket a value is counted in
+ *
+ * @param value_us Duration in microseconds
+ * @return Bucket index
+ */
+int http_histogram_bucket_index(uint32_t value_us);
+
+/**
+ * @brief Get the value range of a bucket
+ *
+ * @param index Bucket index
+ * @param lower_us Smallest value counted in the bucket (optional)
+ * @param upper_us Largest value counted in the bucket (optional)
+ */
+void http_histogram_bucket_range(int index, uint32_t *lower_us, uint32_t *upper_us);
+
+/**
+ * @brief Add the samples of one histogram to another
+ *
+ * @param into Destination histogram
+ * @param from Histogram to add
+ */
+void http_histogram_merge(http_histogram_t *into, const http_histogram_t *from);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_HISTOGRAM_H
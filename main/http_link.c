@@ -0,0 +1,158 @@
+/**
+ * @file http_link.c
+ * @brief Network Link Gate Implementation
+ */
+
+#include "http_link.h"
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "HTTP_LINK";
+
+#define LINK_UP_BIT BIT0
+
+/**
+ * @brief Global link state
+ */
+static struct {
+    http_link_stats_t stats;
+    StaticEventGroup_t group_buffer;
+    EventGroupHandle_t group;
+    bool down;                          /**< Starts false: up until told otherwise */
+    int64_t down_since_ms;
+    http_link_radio_cb_t radio_cb;
+    void *radio_ctx;
+    StaticSemaphore_t radio_lock_buffer;
+    SemaphoreHandle_t radio_lock;       /**< Keeps the switch calls in wake/sleep order */
+    int radio_holds;
+    int64_t awake_since_ms;
+} g_link_state = {0};
+
+static portMUX_TYPE s_link_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void http_link_set_up(bool up)
+{
+    if (!g_link_state.group) {
+        // Waiters only look at the group once the link was reported down, i.e. after this
+        g_link_state.group = xEventGroupCreateStatic(&g_link_state.group_buffer);
+        xEventGroupSetBits(g_link_state.group, LINK_UP_BIT);
+    }
+    EventGroupHandle_t group = g_link_state.group;
+    int64_t now = esp_timer_get_time() / 1000;
+
+    taskENTER_CRITICAL(&s_link_lock);
+    bool changed = (up == g_link_state.down);
+    int64_t down_ms = 0;
+    if (changed && up) {
+        down_ms = now - g_link_state.down_since_ms;
+        g_link_state.stats.down_time_ms += down_ms;
+    } else if (changed) {
+        g_link_state.stats.downs++;
+        g_link_state.down_since_ms = now;
+    }
+    g_link_state.down = !up;
+    taskEXIT_CRITICAL(&s_link_lock);
+
+    if (!changed) {
+        return;
+    }
+
+    if (up) {
+        xEventGroupSetBits(group, LINK_UP_BIT);
+        ESP_LOGI(TAG, "Link up after %lld ms, releasing waiting requests", (long long)down_ms);
+    } else {
+        xEventGroupClearBits(group, LINK_UP_BIT);
+        ESP_LOGW(TAG, "Link down, holding requests");
+    }
+}
+
+bool http_link_is_up(void)
+{
+    return !g_link_state.down;
+}
+
+esp_err_t http_link_wait_up(int timeout_ms)
+{
+    if (!g_link_state.down) {
+        return ESP_OK;
+    }
+
+    taskENTER_CRITICAL(&s_link_lock);
+    g_link_state.stats.waits++;
+    taskEXIT_CRITICAL(&s_link_lock);
+
+    TickType_t ticks = timeout_ms < 0 ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    EventBits_t bits = xEventGroupWaitBits(g_link_state.group, LINK_UP_BIT, pdFALSE, pdTRUE, ticks);
+    if (bits & LINK_UP_BIT) {
+        return ESP_OK;
+    }
+
+    taskENTER_CRITICAL(&s_link_lock);
+    g_link_state.stats.wait_timeouts++;
+    taskEXIT_CRITICAL(&s_link_lock);
+    return ESP_ERR_TIMEOUT;
+}
+
+void http_link_set_radio_control(http_link_radio_cb_t cb, void *ctx)
+{
+    if (!g_link_state.radio_lock) {
+        g_link_state.radio_lock = xSemaphoreCreateMutexStatic(&g_link_state.radio_lock_buffer);
+    }
+    xSemaphoreTake(g_link_state.radio_lock, portMAX_DELAY);
+    g_link_state.radio_cb = cb;
+    g_link_state.radio_ctx = ctx;
+    xSemaphoreGive(g_link_state.radio_lock);
+}
+
+void http_link_radio_wake(void)
+{
+    if (!g_link_state.radio_lock) {
+        return;
+    }
+
+    // The switch may block (esp_wifi_set_ps), so a mutex rather than the spinlock
+    xSemaphoreTake(g_link_state.radio_lock, portMAX_DELAY);
+    if (g_link_state.radio_holds++ == 0 && g_link_state.radio_cb) {
+        g_link_state.radio_cb(true, g_link_state.radio_ctx);
+        g_link_state.awake_since_ms = esp_timer_get_time() / 1000;
+
+        taskENTER_CRITICAL(&s_link_lock);
+        g_link_state.stats.radio_wakes++;
+        taskEXIT_CRITICAL(&s_link_lock);
+    }
+    xSemaphoreGive(g_link_state.radio_lock);
+}
+
+void http_link_radio_sleep(void)
+{
+    if (!g_link_state.radio_lock) {
+        return;
+    }
+
+    xSemaphoreTake(g_link_state.radio_lock, portMAX_DELAY);
+    if (g_link_state.radio_holds > 0 && --g_link_state.radio_holds == 0 && g_link_state.radio_cb) {
+        int64_t awake_ms = esp_timer_get_time() / 1000 - g_link_state.awake_since_ms;
+        g_link_state.radio_cb(false, g_link_state.radio_ctx);
+
+        taskENTER_CRITICAL(&s_link_lock);
+        g_link_state.stats.radio_awake_ms += awake_ms;
+        taskEXIT_CRITICAL(&s_link_lock);
+    }
+    xSemaphoreGive(g_link_state.radio_lock);
+}
+
+esp_err_t http_link_get_stats(http_link_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    taskENTER_CRITICAL(&s_link_lock);
+    memcpy(stats, &g_link_state.stats, sizeof(http_link_stats_t));
+    taskEXIT_CRITICAL(&s_link_lock);
+    return ESP_OK;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file http_link.h
+ * @brief Network Link Gate for the ESP32 HTTP Client
+ *
+ * Tells the HTTP layer whether the network is usable. Whoever owns the
+ * network interface (the Wi-Fi task) reports link changes; the HTTP
+ * layer waits on the gate instead of sending into a dead link:
+ *
+ * - Requests of a handle wait up to their timeout for the link, then
+ *   fail with ESP_ERR_HTTP_CONNECT without touching the network
+ * - The async worker holds queued requests while the link is down and
+ *   sends them back to back as soon as it is up
+ *
+ * The link counts as up until someone reports otherwise, so without a
+ * network manager nothing changes.
+ *
+ * The same owner can hand over control of the radio's power save
+ * (http_link_set_radio_control()). Senders that transmit in bursts wrap
+ * each burst in http_link_radio_wake() / http_link_radio_sleep(), so the
+ * radio stays awake exactly while there is traffic. Wakes nest; the
+ * radio sleeps again when the last one is released. The time spent
+ * awake is counted as a proxy for the radio's energy use.
+ */
+
+#ifndef HTTP_LINK_H
+#define HTTP_LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Link statistics
+ */
+typedef struct {
+    uint32_t downs;             /**< Times the link went down */
+    uint32_t waits;             /**< Requests that had to wait for the link */
+    uint32_t wait_timeouts;     /**< Requests that gave up waiting */
+    uint64_t down_time_ms;      /**< Total time the link was down (up to the last change) */
+    uint32_t radio_wakes;       /**< Times the radio was woken for a burst */
+    uint64_t radio_awake_ms;    /**< Total time the radio was held awake (up to the last sleep) */
+} http_link_stats_t;
+
+/**
+ * @brief Switch the radio's power save off (awake = true) or back on
+ *
+ * @param awake true before a burst, false after it
+ * @param ctx Context passed to http_link_set_radio_control()
+ */
+typedef void (*http_link_radio_cb_t)(bool awake, void *ctx);
+
+/**
+ * @brief Report a link change
+ *
+ * Call with true once the interface has an IP address, with false when
+ * it loses it. Call from one task only, the one that owns the network
+ * interface; not from an ISR.
+ *
+ * @param up true if requests can be sent
+ */
+void http_link_set_up(bool up);
+
+/**
+ * @brief Check whether the link is up
+ *
+ * @return true if up (or never reported down)
+ */
+bool http_link_is_up(void);
+
+/**
+ * @brief Wait for the link to be up
+ *
+ * @param timeout_ms Longest wait (negative = forever)
+ * @return ESP_OK if up, ESP_ERR_TIMEOUT if still down
+ */
+esp_err_t http_link_wait_up(int timeout_ms);
+
+/**
+ * @brief Hand over control of the radio's power save
+ *
+ * Call once at startup, before any sender wakes the radio. Without a
+ * control, http_link_radio_wake() and http_link_radio_sleep() do nothing.
+ *
+ * @param cb Power save switch
+ * @param ctx Context passed to cb
+ */
+void http_link_set_radio_control(http_link_radio_cb_t cb, void *ctx);
+
+/**
+ * @brief Keep the radio awake for a burst of requests
+ *
+ * Pair every call with http_link_radio_sleep().
+ */
+void http_link_radio_wake(void);
+
+/**
+ * @brief Release a wake taken with http_link_radio_wake()
+ */
+void http_link_radio_sleep(void);
+
+/**
+ * @brief Get link statistics
+ *
+ * @param stats Pointer to statistics structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_link_get_stats(http_link_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_LINK_H
@@ -0,0 +1,409 @@
+/**
+ * @file http_pipeline.c
+ * @brief Producer/Transmitter Pipeline Implementation
+ *
+ * head and tail are free-running record counters. Only the producer
+ * writes head and only the transmitter writes tail; a slot is filled
+ * before head is published (release) and sent before tail moves past it,
+ * so the two tasks share no lock. Each slot holds the 2-byte length of
+ * the http_batch framing ahead of the record, which lets a batch go out
+ * as one fragment per slot without copying.
+ */
+
+#include "http_pipeline.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "http_batch.h"
+#include "metrics.h"
+
+static const char *TAG = "HTTP_PIPELINE";
+
+#define RECORD_HEADER_SIZE 2
+
+/**
+ * @brief Global pipeline state
+ */
+static struct {
+    http_pipeline_config_t config;
+    http_pipeline_stats_t stats;        /**< Producer and transmitter fields, one writer each */
+    esp32_http_client_handle_t client;
+    http_pipeline_produce_cb_t produce;
+    void *ctx;
+    uint8_t *ring;
+    size_t slot_stride;                 /**< Bytes from one slot to the next */
+    _Atomic uint32_t head;              /**< Records produced (producer only) */
+    _Atomic uint32_t tail;              /**< Records delivered (transmitter only) */
+    uint32_t batch_sequence;            /**< Number of the last batch attempt */
+    int64_t ready_since_ms;             /**< When the oldest unsent record was seen (0 = none) */
+    int64_t retry_after_ms;             /**< No new attempt before this after a failure */
+    _Atomic bool stopping;
+    bool running;
+    SemaphoreHandle_t stopped;          /**< Given once by each task on exit */
+    TaskHandle_t producer_task;
+    TaskHandle_t transmitter_task;
+} g_pipeline_state = {0};
+
+/* Guards the transmitter's 64-bit byte count against torn reads */
+static portMUX_TYPE s_pipeline_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Get current time in milliseconds
+ */
+static int64_t now_ms(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+/**
+ * @brief Slot of a record counter
+ */
+static uint8_t *slot_at(uint32_t index)
+{
+    return g_pipeline_state.ring + (index & (g_pipeline_state.config.ring_depth - 1)) * g_pipeline_state.slot_stride;
+}
+
+/**
+ * @brief Slots filled now
+ */
+static int ring_occupancy(void)
+{
+    return (int)(atomic_load_explicit(&g_pipeline_state.head, memory_order_acquire) -
+                 atomic_load_explicit(&g_pipeline_state.tail, memory_order_acquire));
+}
+
+/**
+ * @brief Metrics collector: ring occupancy and record counts
+ */
+static void collect_metrics(metrics_writer_t *writer, void *ctx)
+{
+    http_pipeline_stats_t stats;
+    if (http_pipeline_get_stats(&stats) != ESP_OK) {
+        return;
+    }
+
+    metrics_write_gauge(writer, "http_pipeline_ring_occupancy", "Pipeline ring slots filled", stats.ring_occupancy);
+    metrics_write_gauge(writer, "http_pipeline_ring_high_water", "Most pipeline ring slots filled at once",
+                        stats.ring_high_water);
+    metrics_write_counter(writer, "http_pipeline_records_total{result=\"sent\"}", "Pipeline records by outcome",
+                          stats.records_sent);
+    metrics_write_counter(writer, "http_pipeline_records_total{result=\"dropped\"}", NULL, stats.records_dropped);
+}
+
+/**
+ * @brief Producer task: one produce callback per sample interval
+ */
+static void http_pipeline_producer_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "Producer started on core %d", xPortGetCoreID());
+
+    // A sub-tick interval would never block and starve the idle task
+    TickType_t interval = pdMS_TO_TICKS(g_pipeline_state.config.sample_interval_ms);
+    if (interval == 0) {
+        interval = 1;
+    }
+    const int depth = g_pipeline_state.config.ring_depth;
+    TickType_t next_wake = xTaskGetTickCount();
+
+    while (!atomic_load_explicit(&g_pipeline_state.stopping, memory_order_relaxed)) {
+        uint32_t head = atomic_load_explicit(&g_pipeline_state.head, memory_order_relaxed);
+        uint32_t tail = atomic_load_explicit(&g_pipeline_state.tail, memory_order_acquire);
+
+        if ((int)(head - tail) < depth) {
+            uint8_t *slot = slot_at(head);
+            size_t len = g_pipeline_state.produce(slot + RECORD_HEADER_SIZE, g_pipeline_state.config.slot_size,
+                                                  g_pipeline_state.ctx);
+            if (len > 0 && len <= g_pipeline_state.config.slot_size) {
+                slot[0] = len & 0xFF;
+                slot[1] = (len >> 8) & 0xFF;
+                atomic_store_explicit(&g_pipeline_state.head, head + 1, memory_order_release);
+
+                int occupancy = (int)(head + 1 - tail);
+                g_pipeline_state.stats.records_produced++;
+                if (occupancy > g_pipeline_state.stats.ring_high_water) {
+                    g_pipeline_state.stats.ring_high_water = occupancy;
+                }
+                // Starts the latency clock, or a full batch is ready
+                if (occupancy == 1 || occupancy == g_pipeline_state.config.batch_records) {
+                    xTaskNotifyGive(g_pipeline_state.transmitter_task);
+                }
+            }
+        } else {
+            // Never wait for the network: this sample is lost
+            g_pipeline_state.stats.records_dropped++;
+        }
+
+        // Paced on absolute ticks; an overrun skips ahead instead of bursting
+        next_wake += interval;
+        TickType_t now = xTaskGetTickCount();
+        if ((int32_t)(next_wake - now) > 0) {
+            ulTaskNotifyTake(pdTRUE, next_wake - now);
+        } else {
+            next_wake = now;
+        }
+    }
+
+    ESP_LOGI(TAG, "Producer stopped");
+    xSemaphoreGive(g_pipeline_state.stopped);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Send up to batch_records records from the tail as one request
+ *
+ * @return true if the batch was delivered
+ */
+static bool send_batch(uint32_t tail, int records)
+{
+    http_client_iovec_t fragments[HTTP_PIPELINE_MAX_BATCH];
+    size_t bytes = 0;
+    for (int i = 0; i < records; i++) {
+        uint8_t *slot = slot_at(tail + i);
+        size_t len = RECORD_HEADER_SIZE + (slot[0] | (slot[1] << 8));
+        fragments[i].data = slot;
+        fragments[i].len = len;
+        bytes += len;
+    }
+
+    uint32_t sequence = ++g_pipeline_state.batch_sequence;
+    char sequence_value[12];
+    char first_value[12];
+    char records_value[12];
+    snprintf(sequence_value, sizeof(sequence_value), "%lu", (unsigned long)sequence);
+    snprintf(first_value, sizeof(first_value), "%lu", (unsigned long)tail);
+    snprintf(records_value, sizeof(records_value), "%d", records);
+
+    http_client_header_t headers[] = {
+        { "X-ESP32-Batch-Sequence", sequence_value },
+        { "X-ESP32-Batch-First-Record", first_value },
+        { "X-ESP32-Batch-Records", records_value },
+    };
+
+    http_client_request_t request = {
+        .method = HTTP_CLIENT_METHOD_POST,
+        .content_type = HTTP_BATCH_CONTENT_TYPE,
+        .headers = headers,
+        .header_count = sizeof(headers) / sizeof(headers[0]),
+        .body_iov = fragments,
+        .body_iov_count = records,
+    };
+
+    http_client_response_t response;
+    esp_err_t ret = esp32_http_client_request(g_pipeline_state.client, g_pipeline_state.config.path,
+                                              &request, &response);
+
+    bool delivered = (ret == ESP_OK && response.status_code >= 200 && response.status_code < 300);
+    esp32_http_client_free_response(&response);
+
+    taskENTER_CRITICAL(&s_pipeline_lock);
+    g_pipeline_state.stats.last_status_code = response.status_code;
+    if (delivered) {
+        g_pipeline_state.stats.batches_sent++;
+        g_pipeline_state.stats.records_sent += records;
+        g_pipeline_state.stats.bytes_sent += bytes;
+    } else {
+        g_pipeline_state.stats.batches_failed++;
+    }
+    taskEXIT_CRITICAL(&s_pipeline_lock);
+
+    if (delivered) {
+        // Hands the slots back to the producer
+        atomic_store_explicit(&g_pipeline_state.tail, tail + records, memory_order_release);
+        g_pipeline_state.retry_after_ms = 0;
+        ESP_LOGD(TAG, "Batch %lu delivered: %d records, %zu bytes", (unsigned long)sequence, records, bytes);
+    } else {
+        g_pipeline_state.retry_after_ms = now_ms() + g_pipeline_state.config.max_latency_ms;
+        ESP_LOGW(TAG, "Batch %lu failed (%s, status %d), %d records kept",
+                 (unsigned long)sequence, esp_err_to_name(ret), response.status_code, records);
+    }
+    return delivered;
+}
+
+/**
+ * @brief Transmitter task: sends whenever a full batch or the latency bound is reached
+ */
+static void http_pipeline_transmitter_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "Transmitter started on core %d", xPortGetCoreID());
+
+    while (true) {
+        bool stopping = atomic_load_explicit(&g_pipeline_state.stopping, memory_order_relaxed);
+        uint32_t tail = atomic_load_explicit(&g_pipeline_state.tail, memory_order_relaxed);
+        int ready = (int)(atomic_load_explicit(&g_pipeline_state.head, memory_order_acquire) - tail);
+        int64_t now = now_ms();
+
+        if (ready == 0) {
+            g_pipeline_state.ready_since_ms = 0;
+            if (stopping) {
+                break;
+            }
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        if (g_pipeline_state.ready_since_ms == 0) {
+            g_pipeline_state.ready_since_ms = now;
+        }
+
+        int64_t due = g_pipeline_state.ready_since_ms + g_pipeline_state.config.max_latency_ms;
+        if (ready >= g_pipeline_state.config.batch_records || stopping) {
+            due = now;
+        }
+        if (!stopping && g_pipeline_state.retry_after_ms > due) {
+            due = g_pipeline_state.retry_after_ms;
+        }
+
+        if (due <= now) {
+            int records = ready < g_pipeline_state.config.batch_records ? ready : g_pipeline_state.config.batch_records;
+            bool delivered = send_batch(tail, records);
+            if (stopping && !delivered) {
+                ESP_LOGW(TAG, "Discarding %d undelivered records", ready);
+                break;
+            }
+            if (delivered) {
+                // Whatever is left was produced while this batch was in flight
+                g_pipeline_state.ready_since_ms = now_ms();
+            }
+            continue;
+        }
+
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(due - now) + 1);
+    }
+
+    ESP_LOGI(TAG, "Transmitter stopped");
+    xSemaphoreGive(g_pipeline_state.stopped);
+    vTaskDelete(NULL);
+}
+
+esp_err_t http_pipeline_init(esp32_http_client_handle_t client, const http_pipeline_config_t *config,
+                             http_pipeline_produce_cb_t produce, void *ctx)
+{
+    if (g_pipeline_state.running) {
+        ESP_LOGW(TAG, "Pipeline already running");
+        return ESP_OK;
+    }
+
+    if (!client || !produce) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    http_pipeline_config_t defaults = HTTP_PIPELINE_CONFIG_DEFAULT();
+    if (!config) {
+        config = &defaults;
+    }
+
+    int depth = config->ring_depth;
+    if (depth < 2 || depth > HTTP_PIPELINE_MAX_DEPTH || (depth & (depth - 1)) != 0 ||
+        config->slot_size == 0 || config->slot_size > HTTP_BATCH_MAX_RECORD ||
+        config->batch_records <= 0 || config->batch_records > HTTP_PIPELINE_MAX_BATCH || config->batch_records > depth ||
+        config->sample_interval_ms <= 0 || config->max_latency_ms <= 0 || config->task_stack_size <= 0) {
+        ESP_LOGE(TAG, "Invalid pipeline configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(&g_pipeline_state, 0, sizeof(g_pipeline_state));
+    memcpy(&g_pipeline_state.config, config, sizeof(http_pipeline_config_t));
+    g_pipeline_state.client = client;
+    g_pipeline_state.produce = produce;
+    g_pipeline_state.ctx = ctx;
+    g_pipeline_state.stats.ring_depth = depth;
+    g_pipeline_state.slot_stride = (RECORD_HEADER_SIZE + config->slot_size + 3) & ~(size_t)3;
+
+    g_pipeline_state.ring = malloc(g_pipeline_state.slot_stride * depth);
+    g_pipeline_state.stopped = xSemaphoreCreateCounting(2, 0);
+    if (!g_pipeline_state.ring || !g_pipeline_state.stopped) {
+        ESP_LOGE(TAG, "Failed to allocate pipeline ring");
+        goto fail;
+    }
+
+    g_pipeline_state.running = true;
+
+    // Transmitter first: the producer notifies it
+    BaseType_t result = xTaskCreatePinnedToCore(http_pipeline_transmitter_task, "http_pipe_tx",
+                                                config->task_stack_size, NULL,
+                                                config->transmitter_priority, &g_pipeline_state.transmitter_task,
+                                                config->transmitter_core);
+    if (result != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create transmitter task");
+        goto fail;
+    }
+
+    result = xTaskCreatePinnedToCore(http_pipeline_producer_task, "http_pipe_prod",
+                                     config->task_stack_size, NULL,
+                                     config->producer_priority, &g_pipeline_state.producer_task,
+                                     config->producer_core);
+    if (result != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create producer task");
+        atomic_store(&g_pipeline_state.stopping, true);
+        xTaskNotifyGive(g_pipeline_state.transmitter_task);
+        xSemaphoreTake(g_pipeline_state.stopped, portMAX_DELAY);
+        goto fail;
+    }
+
+    static bool collector_registered = false;
+    if (!collector_registered && metrics_register_collector(collect_metrics, NULL) == ESP_OK) {
+        collector_registered = true;
+    }
+
+    ESP_LOGI(TAG, "Pipeline initialized: %d slots of %zu bytes, sample every %d ms, batches of %d",
+             depth, config->slot_size, config->sample_interval_ms, config->batch_records);
+    return ESP_OK;
+
+fail:
+    free(g_pipeline_state.ring);
+    if (g_pipeline_state.stopped) {
+        vSemaphoreDelete(g_pipeline_state.stopped);
+    }
+    memset(&g_pipeline_state, 0, sizeof(g_pipeline_state));
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t http_pipeline_get_stats(http_pipeline_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_pipeline_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    taskENTER_CRITICAL(&s_pipeline_lock);
+    memcpy(stats, &g_pipeline_state.stats, sizeof(http_pipeline_stats_t));
+    taskEXIT_CRITICAL(&s_pipeline_lock);
+    stats->ring_occupancy = ring_occupancy();
+    return ESP_OK;
+}
+
+bool http_pipeline_is_running(void)
+{
+    return g_pipeline_state.running;
+}
+
+esp_err_t http_pipeline_deinit(void)
+{
+    if (!g_pipeline_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // The producer exits at once, the transmitter after one last attempt
+    atomic_store(&g_pipeline_state.stopping, true);
+    xTaskNotifyGive(g_pipeline_state.producer_task);
+    xTaskNotifyGive(g_pipeline_state.transmitter_task);
+    xSemaphoreTake(g_pipeline_state.stopped, portMAX_DELAY);
+    xSemaphoreTake(g_pipeline_state.stopped, portMAX_DELAY);
+    g_pipeline_state.running = false;
+
+    free(g_pipeline_state.ring);
+    vSemaphoreDelete(g_pipeline_state.stopped);
+    memset(&g_pipeline_state, 0, sizeof(g_pipeline_state));
+
+    ESP_LOGI(TAG, "Pipeline deinitialized");
+    return ESP_OK;
+}
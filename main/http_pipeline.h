@@ -0,0 +1,155 @@
+/**
+ * @file http_pipeline.h
+ * @brief Producer/Transmitter Pipeline for Sampled Records
+ *
+ * Splits sampling and sending into two tasks joined by a lock-free
+ * single-producer/single-consumer ring of fixed-size slots:
+ * - the producer task calls the produce callback every sample interval
+ *   and encodes the record straight into the next free slot;
+ * - the transmitter task sends the filled slots as one POST, zero-copy
+ *   out of the ring, and releases them once the batch is delivered.
+ *
+ * Neither side ever waits for the other: when the ring is full the
+ * producer drops the sample (counted in records_dropped) instead of
+ * blocking on the network, and the transmitter only sleeps while there
+ * is nothing to send. Each task can be pinned to its own core.
+ *
+ * Bodies use the http_batch format and headers (HTTP_BATCH_CONTENT_TYPE,
+ * X-ESP32-Batch-Sequence / -First-Record / -Records), so the same server
+ * endpoint takes both.
+ */
+
+#ifndef HTTP_PIPELINE_H
+#define HTTP_PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "esp32_http_client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_PIPELINE_MAX_DEPTH 256     /**< Largest ring */
+#define HTTP_PIPELINE_MAX_BATCH 32      /**< Most records in one POST */
+
+/**
+ * @brief Default cores: sampling away from the WiFi/lwIP core when there are two
+ */
+#if portNUM_PROCESSORS > 1
+#define HTTP_PIPELINE_PRODUCER_CORE     1
+#define HTTP_PIPELINE_TRANSMITTER_CORE  0
+#else
+#define HTTP_PIPELINE_PRODUCER_CORE     tskNO_AFFINITY
+#define HTTP_PIPELINE_TRANSMITTER_CORE  tskNO_AFFINITY
+#endif
+
+/**
+ * @brief Encode one record
+ *
+ * Runs in the producer task and writes into the ring slot directly.
+ *
+ * @param buffer Slot to write the record into
+ * @param size Slot capacity
+ * @param ctx User context from http_pipeline_init()
+ * @return Record length, 0 to skip this sample
+ */
+typedef size_t (*http_pipeline_produce_cb_t)(uint8_t *buffer, size_t size, void *ctx);
+
+/**
+ * @brief Pipeline configuration
+ */
+typedef struct {
+    char path[128];             /**< Target path on the client's host, or a full http:// or https:// URL */
+    int ring_depth;             /**< Slots in the ring (power of two, up to HTTP_PIPELINE_MAX_DEPTH) */
+    size_t slot_size;           /**< Largest record in bytes */
+    int sample_interval_ms;     /**< Time between produce callbacks (at least one tick) */
+    int batch_records;          /**< Send once this many records are ready (up to ring_depth and HTTP_PIPELINE_MAX_BATCH) */
+    int max_latency_ms;         /**< Send a partial batch after this long; also the retry delay */
+    int producer_core;          /**< Core of the producer task (tskNO_AFFINITY = any) */
+    int transmitter_core;       /**< Core of the transmitter task (tskNO_AFFINITY = any) */
+    int producer_priority;      /**< Producer task priority */
+    int transmitter_priority;   /**< Transmitter task priority */
+    int task_stack_size;        /**< Stack size of each task */
+} http_pipeline_config_t;
+
+/**
+ * @brief Pipeline statistics
+ */
+typedef struct {
+    uint32_t records_produced;  /**< Records encoded into the ring */
+    uint32_t records_dropped;   /**< Samples skipped because the ring was full */
+    uint32_t records_sent;      /**< Records delivered */
+    uint32_t batches_sent;      /**< Batches delivered */
+    uint32_t batches_failed;    /**< Batch attempts that failed (records kept) */
+    uint64_t bytes_sent;        /**< Body bytes of delivered batches */
+    int ring_depth;             /**< Slots in the ring */
+    int ring_occupancy;         /**< Slots filled now */
+    int ring_high_water;        /**< Most slots filled at once */
+    int last_status_code;       /**< HTTP status of the last batch attempt */
+} http_pipeline_stats_t;
+
+/**
+ * @brief Default pipeline configuration
+ */
+#define HTTP_PIPELINE_CONFIG_DEFAULT() {                    \
+    .path = "/batch",                                       \
+    .ring_depth = 32,                                       \
+    .slot_size = 128,                                       \
+    .sample_interval_ms = 1000,                             \
+    .batch_records = 16,                                    \
+    .max_latency_ms = 5000,                                 \
+    .producer_core = HTTP_PIPELINE_PRODUCER_CORE,           \
+    .transmitter_core = HTTP_PIPELINE_TRANSMITTER_CORE,     \
+    .producer_priority = 5,                                 \
+    .transmitter_priority = 4,                              \
+    .task_stack_size = 4096                                 \
+}
+
+/**
+ * @brief Allocate the ring and start both tasks
+ *
+ * The transmitter sends every batch with the given handle; give the
+ * pipeline its own handle.
+ *
+ * @param client Client handle used by the transmitter
+ * @param config Pipeline configuration (NULL = defaults)
+ * @param produce Record encoder called by the producer
+ * @param ctx User context for produce
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_pipeline_init(esp32_http_client_handle_t client, const http_pipeline_config_t *config,
+                             http_pipeline_produce_cb_t produce, void *ctx);
+
+/**
+ * @brief Get pipeline statistics
+ *
+ * @param stats Pointer to statistics structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_pipeline_get_stats(http_pipeline_stats_t *stats);
+
+/**
+ * @brief Check if the pipeline is running
+ *
+ * @return true if initialized, false otherwise
+ */
+bool http_pipeline_is_running(void);
+
+/**
+ * @brief Stop sampling, send what is in the ring once, then stop both tasks
+ *
+ * Records that still cannot be delivered are discarded.
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t http_pipeline_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_PIPELINE_H
@@ -0,0 +1,166 @@
+/**
+ * @file http_retry.c
+ * @brief Retry Policy and Retry Budget Implementation
+ *
+ * The budget is a token bucket counted in thousandths of a retry.
+ */
+
+#include "http_retry.h"
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "HTTP_RETRY";
+
+#define MILLI_TOKENS 1000               /**< Budget units per retry */
+
+/**
+ * @brief Global budget state
+ */
+static struct {
+    http_retry_budget_config_t config;
+    http_retry_budget_stats_t stats;
+    int64_t tokens;                     /**< Thousandths of a retry */
+    int64_t refilled_ms;                /**< Last time-based refill */
+    bool initialized;
+} g_retry_state = {0};
+
+static portMUX_TYPE s_retry_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Add tokens, up to the configured maximum (lock held)
+ */
+static void add_tokens(int64_t amount)
+{
+    int64_t limit = (int64_t)g_retry_state.config.max_tokens * MILLI_TOKENS;
+    g_retry_state.tokens += amount;
+    if (g_retry_state.tokens > limit) {
+        g_retry_state.tokens = limit;
+    }
+}
+
+/**
+ * @brief Credit the steady allowance for the time since the last refill (lock held)
+ */
+static void refill(void)
+{
+    int64_t now = esp_timer_get_time() / 1000;
+    // min_per_sec retries per second is min_per_sec thousandths per millisecond
+    add_tokens((now - g_retry_state.refilled_ms) * g_retry_state.config.min_per_sec);
+    g_retry_state.refilled_ms = now;
+}
+
+esp_err_t http_retry_budget_init(const http_retry_budget_config_t *config)
+{
+    if (g_retry_state.initialized) {
+        return ESP_OK;
+    }
+
+    http_retry_budget_config_t defaults = HTTP_RETRY_BUDGET_CONFIG_DEFAULT();
+    if (!config) {
+        config = &defaults;
+    }
+
+    if (config->ratio_pct < 0 || config->min_per_sec < 0 || config->max_tokens <= 0) {
+        ESP_LOGE(TAG, "Invalid retry budget configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    taskENTER_CRITICAL(&s_retry_lock);
+    memset(&g_retry_state.stats, 0, sizeof(g_retry_state.stats));
+    g_retry_state.config = *config;
+    g_retry_state.tokens = (int64_t)config->max_tokens * MILLI_TOKENS;
+    g_retry_state.refilled_ms = esp_timer_get_time() / 1000;
+    g_retry_state.initialized = true;
+    taskEXIT_CRITICAL(&s_retry_lock);
+
+    ESP_LOGI(TAG, "Retry budget initialized: %d%% of requests + %d/s, up to %d saved",
+             config->ratio_pct, config->min_per_sec, config->max_tokens);
+    return ESP_OK;
+}
+
+void http_retry_budget_deposit(void)
+{
+    taskENTER_CRITICAL(&s_retry_lock);
+    if (g_retry_state.initialized) {
+        add_tokens(g_retry_state.config.ratio_pct * MILLI_TOKENS / 100);
+    }
+    taskEXIT_CRITICAL(&s_retry_lock);
+}
+
+bool http_retry_budget_acquire(void)
+{
+    bool granted = true;
+
+    taskENTER_CRITICAL(&s_retry_lock);
+    if (g_retry_state.initialized) {
+        refill();
+        granted = g_retry_state.tokens >= MILLI_TOKENS;
+        if (granted) {
+            g_retry_state.tokens -= MILLI_TOKENS;
+            g_retry_state.stats.granted++;
+        } else {
+            g_retry_state.stats.denied++;
+        }
+    }
+    taskEXIT_CRITICAL(&s_retry_lock);
+
+    return granted;
+}
+
+esp_err_t http_retry_budget_get_stats(http_retry_budget_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_retry_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    taskENTER_CRITICAL(&s_retry_lock);
+    refill();
+    memcpy(stats, &g_retry_state.stats, sizeof(http_retry_budget_stats_t));
+    stats->tokens = g_retry_state.tokens / MILLI_TOKENS;
+    taskEXIT_CRITICAL(&s_retry_lock);
+    return ESP_OK;
+}
+
+esp_err_t http_retry_budget_deinit(void)
+{
+    if (!g_retry_state.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    taskENTER_CRITICAL(&s_retry_lock);
+    memset(&g_retry_state, 0, sizeof(g_retry_state));
+    taskEXIT_CRITICAL(&s_retry_lock);
+
+    ESP_LOGI(TAG, "Retry budget deinitialized");
+    return ESP_OK;
+}
+
+uint32_t http_retry_backoff_ms(const http_retry_policy_t *policy, int retry, uint32_t retry_after_ms)
+{
+    uint32_t cap = policy->max_delay_ms > 0 ? policy->max_delay_ms : 0;
+    uint32_t ceiling = policy->base_delay_ms > 0 ? policy->base_delay_ms : 0;
+    for (int i = 1; i < retry && ceiling < cap; i++) {
+        ceiling *= 2;
+    }
+    if (ceiling > cap) {
+        ceiling = cap;
+    }
+
+    // Full jitter: anywhere between no wait and the ceiling
+    uint32_t delay = esp_random() % (ceiling + 1);
+
+    if (retry_after_ms > delay) {
+        // Still spread out the devices the server told to come back at the same time
+        uint32_t spread = policy->base_delay_ms > 0 ? policy->base_delay_ms : 0;
+        delay = retry_after_ms + esp_random() % (spread + 1);
+    }
+    return delay < cap ? delay : cap;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file http_retry.h
+ * @brief Retry Policy and Retry Budget for the ESP32 HTTP Client
+ *
+ * A failed request is retried after an exponential backoff with full
+ * jitter: the n-th retry waits a random time between 0 and
+ * min(max_delay_ms, base_delay_ms * 2^(n-1)). Randomizing the whole
+ * delay keeps devices that failed at the same moment from retrying in
+ * step against a server that is already struggling.
+ *
+ * Retries also draw from a retry budget shared by all handles. Every
+ * request earns a fraction of a retry (ratio_pct), and a small steady
+ * allowance (min_per_sec) covers devices that send rarely. When the
+ * server is down, retries soon use up what the budget holds and further
+ * failures give up at once, so retries add at most about ratio_pct
+ * percent to the load instead of multiplying it.
+ *
+ * Which failures are retried is decided by the client (see
+ * esp32_http_client.h): connect failures always, other transport errors
+ * and overload statuses only for idempotent methods.
+ */
+
+#ifndef HTTP_RETRY_H
+#define HTTP_RETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Retry policy of a handle or a single request
+ */
+typedef struct {
+    int max_retries;            /**< Retries after the first attempt (0 = never retry) */
+    int base_delay_ms;          /**< Backoff ceiling of the first retry, doubled for each further one */
+    int max_delay_ms;           /**< Largest backoff, also the limit for honoring Retry-After */
+    bool retry_on_status;       /**< Retry idempotent requests answered 429, 502, 503 or 504 */
+    bool retry_non_idempotent;  /**< Also retry POST and PATCH after errors where the request may have been sent */
+} http_retry_policy_t;
+
+/**
+ * @brief Retry budget configuration
+ */
+typedef struct {
+    int ratio_pct;              /**< Retries earned per 100 requests */
+    int min_per_sec;            /**< Retries earned per second regardless of traffic */
+    int max_tokens;             /**< Retries the budget can save up */
+} http_retry_budget_config_t;
+
+/**
+ * @brief Retry budget statistics
+ */
+typedef struct {
+    uint32_t granted;           /**< Retries allowed */
+    uint32_t denied;            /**< Retries refused because the budget was empty */
+    int tokens;                 /**< Whole retries currently available */
+} http_retry_budget_stats_t;
+
+/**
+ * @brief Default retry policy: no retries
+ */
+#define HTTP_RETRY_POLICY_DEFAULT() {               \
+    .max_retries = 0,                               \
+    .base_delay_ms = 200,                           \
+    .max_delay_ms = 5000,                           \
+    .retry_on_status = true,                        \
+    .retry_non_idempotent = false                   \
+}
+
+/**
+ * @brief Default retry budget configuration
+ */
+#define HTTP_RETRY_BUDGET_CONFIG_DEFAULT() {        \
+    .ratio_pct = 10,                                \
+    .min_per_sec = 1,                               \
+    .max_tokens = 10                                \
+}
+
+/**
+ * @brief Initialize the retry budget
+ *
+ * Calling this again while the budget is initialized is a no-op. The
+ * budget starts full.
+ *
+ * @param config Budget configuration (NULL = defaults)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_retry_budget_init(const http_retry_budget_config_t *config);
+
+/**
+ * @brief Credit the budget for one new request (not for retries)
+ */
+void http_retry_budget_deposit(void);
+
+/**
+ * @brief Take one retry from the budget
+ *
+ * @return true if the retry may go ahead
+ */
+bool http_retry_budget_acquire(void);
+
+/**
+ * @brief Get retry budget statistics
+ *
+ * @param stats Pointer to statistics structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_retry_budget_get_stats(http_retry_budget_stats_t *stats);
+
+/**
+ * @brief Deinitialize the retry budget
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t http_retry_budget_deinit(void);
+
+/**
+ * @brief Pick the wait before a retry
+ *
+ * @param policy Retry policy
+ * @param retry Retry number, starting at 1
+ * @param retry_after_ms Delay asked for by the server (0 = none)
+ * @return Delay in milliseconds
+ */
+uint32_t http_retry_backoff_ms(const http_retry_policy_t *policy, int retry, uint32_t retry_after_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_RETRY_H
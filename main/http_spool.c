@@ -0,0 +1,761 @@
+/**
+ * @file http_spool.c
+ * @brief Flash Store-and-Forward Spool Implementation
+ *
+ * The ring holds sectors from the tail sector up to the head sector.
+ * Appends write at the head; when a record does not fit, the head moves
+ * to the next sector, which is erased first. The replay task reads
+ * records from the tail into a RAM batch and moves the tail once the
+ * batch has been delivered. A position is a sector index plus an offset.
+ */
+
+#include "http_spool.h"
+#include "http_batch.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "HTTP_SPOOL";
+
+#define SECTOR_MAGIC 0x4C505348         /**< "HSPL" */
+#define SECTOR_HEADER_SIZE 16
+#define RECORD_HEADER_SIZE 12
+#define BATCH_HEADER_SIZE 2             /**< Length prefix of a record in the batch body */
+
+#define STATE_ERASED 0xFF
+#define STATE_WRITTEN 0x7F              /**< Header written, payload may be incomplete */
+#define STATE_COMMITTED 0x3F            /**< Payload complete */
+#define STATE_ACKED 0x1F                /**< Last record of a delivered batch */
+
+#define ALIGN4(x) (((x) + 3) & ~(size_t)3)
+
+/**
+ * @brief Sector header as stored in flash
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t sequence;                  /**< Increases with every sector erased for writing */
+    uint32_t reserved[2];
+} sector_header_t;
+
+/**
+ * @brief Record header as stored in flash
+ */
+typedef struct {
+    uint8_t state;
+    uint8_t reserved;
+    uint16_t length;
+    uint32_t sequence;
+    uint32_t crc;
+} record_header_t;
+
+_Static_assert(sizeof(sector_header_t) == SECTOR_HEADER_SIZE, "sector header layout");
+_Static_assert(sizeof(record_header_t) == RECORD_HEADER_SIZE, "record header layout");
+
+/**
+ * @brief Place in the ring
+ */
+typedef struct {
+    uint32_t sector;
+    uint32_t offset;
+} spool_pos_t;
+
+/**
+ * @brief Global spool state
+ */
+static struct {
+    http_spool_config_t config;
+    http_spool_stats_t stats;
+    esp32_http_client_handle_t client;
+    const esp_partition_t *partition;
+    uint32_t sector_size;
+    uint32_t sector_count;
+    spool_pos_t head;                   /**< Where the next record goes */
+    spool_pos_t tail;                   /**< Oldest record not yet delivered */
+    uint32_t head_sequence;             /**< Sequence of the head sector */
+    uint32_t next_record;               /**< Sequence number of the next record */
+    uint32_t drops;                     /**< Incremented whenever the tail is pushed forward */
+    int64_t next_attempt_ms;            /**< No replay before this */
+    uint8_t *batch;                     /**< Replay body buffer */
+    bool stopping;
+    bool running;
+    SemaphoreHandle_t lock;
+    SemaphoreHandle_t stopped;
+    TaskHandle_t task;
+} g_spool_state = {0};
+
+static int64_t now_ms(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+static size_t flash_offset(spool_pos_t pos)
+{
+    return (size_t)pos.sector * g_spool_state.sector_size + pos.offset;
+}
+
+static bool pos_equal(spool_pos_t a, spool_pos_t b)
+{
+    return a.sector == b.sector && a.offset == b.offset;
+}
+
+/**
+ * @brief Largest payload that fits a sector
+ */
+static size_t max_payload(void)
+{
+    size_t room = g_spool_state.sector_size - SECTOR_HEADER_SIZE - RECORD_HEADER_SIZE;
+    return room < HTTP_BATCH_MAX_RECORD ? room : HTTP_BATCH_MAX_RECORD;
+}
+
+/**
+ * @brief Read the record header at a position
+ *
+ * @return false at the end of the records of the sector
+ */
+static bool read_record(spool_pos_t pos, record_header_t *header)
+{
+    if (pos.offset + RECORD_HEADER_SIZE > g_spool_state.sector_size ||
+        esp_partition_read(g_spool_state.partition, flash_offset(pos), header, sizeof(*header)) != ESP_OK) {
+        return false;
+    }
+
+    if (header->state != STATE_WRITTEN && header->state != STATE_COMMITTED && header->state != STATE_ACKED) {
+        return false;
+    }
+    return pos.offset + ALIGN4(RECORD_HEADER_SIZE + header->length) <= g_spool_state.sector_size;
+}
+
+/**
+ * @brief Read a sector header
+ *
+ * @return true if the sector holds spool records
+ */
+static bool read_sector(uint32_t sector, uint32_t *sequence)
+{
+    sector_header_t header;
+    if (esp_partition_read(g_spool_state.partition, (size_t)sector * g_spool_state.sector_size,
+                           &header, sizeof(header)) != ESP_OK || header.magic != SECTOR_MAGIC) {
+        return false;
+    }
+    *sequence = header.sequence;
+    return true;
+}
+
+/**
+ * @brief Erase a sector and claim it for writing (lock held)
+ */
+static esp_err_t start_sector(uint32_t sector)
+{
+    esp_err_t err = esp_partition_erase_range(g_spool_state.partition,
+                                              (size_t)sector * g_spool_state.sector_size,
+                                              g_spool_state.sector_size);
+    if (err != ESP_OK) {
+        return err;
+    }
+    g_spool_state.stats.sectors_erased++;
+
+    sector_header_t header = {
+        .magic = SECTOR_MAGIC,
+        .sequence = ++g_spool_state.head_sequence,
+        .reserved = { UINT32_MAX, UINT32_MAX },
+    };
+    err = esp_partition_write(g_spool_state.partition, (size_t)sector * g_spool_state.sector_size,
+                              &header, sizeof(header));
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    g_spool_state.head = (spool_pos_t){ sector, SECTOR_HEADER_SIZE };
+    return ESP_OK;
+}
+
+/**
+ * @brief Give up the records of the tail sector to make room (lock held)
+ */
+static void drop_tail_sector(void)
+{
+    spool_pos_t pos = g_spool_state.tail;
+    record_header_t header;
+    uint32_t dropped = 0;
+    size_t bytes = 0;
+
+    while (read_record(pos, &header)) {
+        size_t size = ALIGN4(RECORD_HEADER_SIZE + header.length);
+        if (header.state == STATE_COMMITTED) {
+            dropped++;
+            bytes += size;
+        }
+        pos.offset += size;
+    }
+
+    g_spool_state.tail = (spool_pos_t){ (pos.sector + 1) % g_spool_state.sector_count, SECTOR_HEADER_SIZE };
+    if (dropped == 0) {
+        // Only delivered records were left in the sector
+        return;
+    }
+
+    g_spool_state.drops++;
+    g_spool_state.stats.records_dropped += dropped;
+    g_spool_state.stats.records_pending -= dropped;
+    g_spool_state.stats.bytes_pending -= bytes;
+    ESP_LOGW(TAG, "Spool full, dropped %lu oldest records", (unsigned long)dropped);
+}
+
+/**
+ * @brief Move the head to the next sector (lock held)
+ */
+static esp_err_t advance_head(void)
+{
+    uint32_t next = (g_spool_state.head.sector + 1) % g_spool_state.sector_count;
+    if (next == g_spool_state.tail.sector && !pos_equal(g_spool_state.tail, g_spool_state.head)) {
+        drop_tail_sector();
+    }
+
+    bool tail_at_head = pos_equal(g_spool_state.tail, g_spool_state.head);
+    esp_err_t err = start_sector(next);
+    if (tail_at_head) {
+        // Nothing pending; the tail follows the head
+        g_spool_state.tail = g_spool_state.head;
+    }
+    return err;
+}
+
+/**
+ * @brief Rebuild head, tail and counters from flash
+ */
+static esp_err_t recover(void)
+{
+    uint32_t count = g_spool_state.sector_count;
+
+    // The head sector is the one written last
+    bool found = false;
+    uint32_t head_sector = 0;
+    uint32_t head_sequence = 0;
+    for (uint32_t s = 0; s < count; s++) {
+        uint32_t sequence;
+        if (read_sector(s, &sequence) && (!found || sequence > head_sequence)) {
+            found = true;
+            head_sector = s;
+            head_sequence = sequence;
+        }
+    }
+
+    if (!found) {
+        ESP_LOGI(TAG, "Empty spool, formatting first sector");
+        g_spool_state.head_sequence = 0;
+        esp_err_t err = start_sector(0);
+        g_spool_state.tail = g_spool_state.head;
+        return err;
+    }
+
+    // Valid sectors follow each other in ring order, oldest right after the head
+    spool_pos_t tail = { 0, 0 };
+    bool have_tail = false;
+    uint32_t pending = 0;
+    size_t bytes = 0;
+    uint32_t next_record = 0;
+    spool_pos_t head = { head_sector, SECTOR_HEADER_SIZE };
+
+    for (uint32_t i = 1; i <= count; i++) {
+        uint32_t s = (head_sector + i) % count;
+        uint32_t sequence;
+        if (!read_sector(s, &sequence)) {
+            continue;
+        }
+        if (!have_tail) {
+            tail = (spool_pos_t){ s, SECTOR_HEADER_SIZE };
+            have_tail = true;
+        }
+
+        spool_pos_t pos = { s, SECTOR_HEADER_SIZE };
+        record_header_t header;
+        while (read_record(pos, &header)) {
+            size_t size = ALIGN4(RECORD_HEADER_SIZE + header.length);
+            if (header.state != STATE_WRITTEN) {
+                next_record = header.sequence + 1;
+            }
+            pos.offset += size;
+            if (header.state == STATE_ACKED) {
+                // Everything up to here was delivered
+                tail = pos;
+                pending = 0;
+                bytes = 0;
+            } else if (header.state == STATE_COMMITTED) {
+                pending++;
+                bytes += size;
+            }
+        }
+
+        if (s == head_sector) {
+            head = pos;
+            uint8_t probe;
+            if (pos.offset < g_spool_state.sector_size &&
+                esp_partition_read(g_spool_state.partition, flash_offset(pos), &probe, 1) == ESP_OK &&
+                probe != STATE_ERASED) {
+                // A damaged header ends the sector; continue in a fresh one
+                head.offset = g_spool_state.sector_size;
+            }
+        }
+    }
+
+    g_spool_state.head = head;
+    g_spool_state.head_sequence = head_sequence;
+    g_spool_state.tail = tail;
+    g_spool_state.next_record = next_record;
+    g_spool_state.stats.records_pending = pending;
+    g_spool_state.stats.records_recovered = pending;
+    g_spool_state.stats.bytes_pending = bytes;
+
+    if (pending > 0) {
+        ESP_LOGI(TAG, "Recovered %lu pending records (%zu bytes)", (unsigned long)pending, bytes);
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Collect a replay batch from the tail (lock held)
+ *
+ * @param len Body length (output)
+ * @param end Position after the last record taken (output)
+ * @param last Position of the last record taken (output)
+ * @param first_record Sequence number of the first record (output)
+ * @param flash_bytes Flash bytes of the records taken (output)
+ * @param damaged Records skipped for a bad CRC (output)
+ * @return Number of records in the batch
+ */
+static int collect_batch(size_t *len, spool_pos_t *end, spool_pos_t *last, uint32_t *first_record,
+                         size_t *flash_bytes, int *damaged)
+{
+    spool_pos_t pos = g_spool_state.tail;
+    size_t used = 0;
+    int records = 0;
+    *flash_bytes = 0;
+    *damaged = 0;
+
+    while (!pos_equal(pos, g_spool_state.head)) {
+        record_header_t header;
+        if (!read_record(pos, &header)) {
+            if (pos.sector == g_spool_state.head.sector) {
+                // Damaged header in the head sector; appends went on in the next one
+                pos = g_spool_state.head;
+            } else {
+                // End of a sector; the next one continues the ring
+                pos = (spool_pos_t){ (pos.sector + 1) % g_spool_state.sector_count, SECTOR_HEADER_SIZE };
+            }
+            *end = pos;
+            continue;
+        }
+
+        size_t size = ALIGN4(RECORD_HEADER_SIZE + header.length);
+        if (header.state == STATE_COMMITTED) {
+            if (used + BATCH_HEADER_SIZE + header.length > g_spool_state.config.replay_batch_bytes) {
+                break;
+            }
+
+            uint8_t *out = g_spool_state.batch + used;
+            spool_pos_t payload = { pos.sector, pos.offset + RECORD_HEADER_SIZE };
+            if (esp_partition_read(g_spool_state.partition, flash_offset(payload),
+                                   out + BATCH_HEADER_SIZE, header.length) == ESP_OK &&
+                esp_rom_crc32_le(0, out + BATCH_HEADER_SIZE, header.length) == header.crc) {
+                out[0] = header.length & 0xFF;
+                out[1] = (header.length >> 8) & 0xFF;
+                if (records == 0) {
+                    *first_record = header.sequence;
+                }
+                used += BATCH_HEADER_SIZE + header.length;
+                records++;
+            } else {
+                ESP_LOGW(TAG, "Skipping damaged record %lu", (unsigned long)header.sequence);
+                (*damaged)++;
+            }
+            // Counted as pending until the batch is delivered
+            *flash_bytes += size;
+            *last = pos;
+        }
+        pos.offset += size;
+        *end = pos;
+    }
+
+    *len = used;
+    return records;
+}
+
+/**
+ * @brief Send one replay batch
+ *
+ * @param sent Body bytes sent (output)
+ * @return true if delivered, or nothing was left to send
+ */
+static bool replay_batch(size_t *sent)
+{
+    size_t len = 0;
+    size_t flash_bytes = 0;
+    uint32_t first_record = 0;
+    int damaged = 0;
+
+    xSemaphoreTake(g_spool_state.lock, portMAX_DELAY);
+    spool_pos_t end = g_spool_state.tail;
+    spool_pos_t last = g_spool_state.tail;
+    int records = collect_batch(&len, &end, &last, &first_record, &flash_bytes, &damaged);
+    uint32_t drops = g_spool_state.drops;
+    xSemaphoreGive(g_spool_state.lock);
+
+    bool delivered = true;
+    int status = 0;
+    esp_err_t ret = ESP_OK;
+    if (records > 0) {
+        char first_value[12];
+        char records_value[12];
+        snprintf(first_value, sizeof(first_value), "%lu", (unsigned long)first_record);
+        snprintf(records_value, sizeof(records_value), "%d", records);
+
+        http_client_header_t headers[] = {
+            { "X-ESP32-Batch-Sequence", first_value },
+            { "X-ESP32-Batch-First-Record", first_value },
+            { "X-ESP32-Batch-Records", records_value },
+            { "X-ESP32-Spool", "1" },
+        };
+        http_client_iovec_t body = { g_spool_state.batch, len };
+        http_client_request_t request = {
+            .method = HTTP_CLIENT_METHOD_POST,
+            .content_type = HTTP_BATCH_CONTENT_TYPE,
+            .headers = headers,
+            .header_count = sizeof(headers) / sizeof(headers[0]),
+            .body_iov = &body,
+            .body_iov_count = 1,
+        };
+
+        http_client_response_t response;
+        ret = esp32_http_client_request(g_spool_state.client, g_spool_state.config.path, &request, &response);
+        status = response.status_code;
+        delivered = (ret == ESP_OK && status >= 200 && status < 300);
+        esp32_http_client_free_response(&response);
+    }
+
+    xSemaphoreTake(g_spool_state.lock, portMAX_DELAY);
+    if (delivered) {
+        // If appends pushed the tail past the batch, it is already gone; only acknowledge otherwise
+        if (drops == g_spool_state.drops && !pos_equal(end, g_spool_state.tail)) {
+            if (records > 0 || damaged > 0) {
+                uint8_t acked = STATE_ACKED;
+                esp_partition_write(g_spool_state.partition, flash_offset(last), &acked, 1);
+            }
+            g_spool_state.tail = end;
+            g_spool_state.stats.records_pending -= records + damaged;
+            g_spool_state.stats.records_dropped += damaged;
+            g_spool_state.stats.bytes_pending -= flash_bytes;
+        }
+        if (records > 0) {
+            g_spool_state.stats.records_replayed += records;
+            g_spool_state.stats.batches_sent++;
+            g_spool_state.stats.bytes_replayed += len;
+        }
+    } else {
+        g_spool_state.stats.batches_failed++;
+    }
+    xSemaphoreGive(g_spool_state.lock);
+
+    *sent = len;
+    if (records > 0) {
+        if (delivered) {
+            ESP_LOGI(TAG, "Replayed %d records (%zu bytes) from #%lu", records, len, (unsigned long)first_record);
+        } else {
+            ESP_LOGW(TAG, "Replay of %d records failed (%s, status %d)", records, esp_err_to_name(ret), status);
+        }
+    }
+    return delivered;
+}
+
+/**
+ * @brief Replay task: drains the spool while the server accepts batches
+ */
+static void http_spool_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "Spool replay task started on core %d", xPortGetCoreID());
+
+    while (true) {
+        xSemaphoreTake(g_spool_state.lock, portMAX_DELAY);
+        bool stopping = g_spool_state.stopping;
+        bool pending = g_spool_state.stats.records_pending > 0 || !pos_equal(g_spool_state.tail, g_spool_state.head);
+        int64_t due = g_spool_state.next_attempt_ms;
+        xSemaphoreGive(g_spool_state.lock);
+
+        if (stopping) {
+            break;
+        }
+
+        int64_t now = now_ms();
+        if (!pending) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        if (due > now) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(due - now) + 1);
+            continue;
+        }
+
+        int64_t started = now_ms();
+        size_t sent = 0;
+        bool delivered = replay_batch(&sent);
+
+        xSemaphoreTake(g_spool_state.lock, portMAX_DELAY);
+        if (!delivered) {
+            g_spool_state.next_attempt_ms = now_ms() + g_spool_state.config.retry_interval_ms;
+        } else if (g_spool_state.config.replay_bytes_per_sec > 0) {
+            g_spool_state.next_attempt_ms = started + (int64_t)sent * 1000 / g_spool_state.config.replay_bytes_per_sec;
+        } else {
+            g_spool_state.next_attempt_ms = 0;
+        }
+        xSemaphoreGive(g_spool_state.lock);
+    }
+
+    ESP_LOGI(TAG, "Spool replay task stopped");
+    xSemaphoreGive(g_spool_state.stopped);
+    vTaskDelete(NULL);
+}
+
+esp_err_t http_spool_init(esp32_http_client_handle_t client, const http_spool_config_t *config)
+{
+    if (g_spool_state.running) {
+        ESP_LOGW(TAG, "Spool already running");
+        return ESP_OK;
+    }
+
+    if (!client) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    http_spool_config_t defaults = HTTP_SPOOL_CONFIG_DEFAULT();
+    if (!config) {
+        config = &defaults;
+    }
+
+    if (config->replay_batch_bytes <= BATCH_HEADER_SIZE || config->retry_interval_ms <= 0 ||
+        config->task_stack_size <= 0) {
+        ESP_LOGE(TAG, "Invalid spool configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                                HTTP_SPOOL_PARTITION_SUBTYPE,
+                                                                config->partition_label);
+    if (!partition) {
+        ESP_LOGE(TAG, "Spool partition '%s' not found", config->partition_label);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    memset(&g_spool_state, 0, sizeof(g_spool_state));
+    memcpy(&g_spool_state.config, config, sizeof(http_spool_config_t));
+    g_spool_state.client = client;
+    g_spool_state.partition = partition;
+    g_spool_state.sector_size = partition->erase_size;
+    g_spool_state.sector_count = partition->size / partition->erase_size;
+    if (g_spool_state.sector_count < 2) {
+        ESP_LOGE(TAG, "Spool partition needs at least 2 sectors");
+        memset(&g_spool_state, 0, sizeof(g_spool_state));
+        return ESP_ERR_INVALID_SIZE;
+    }
+    // One sector is always being written, so it does not count as room for the backlog
+    g_spool_state.stats.capacity_bytes = (g_spool_state.sector_count - 1) *
+                                         (g_spool_state.sector_size - SECTOR_HEADER_SIZE);
+
+    g_spool_state.batch = malloc(config->replay_batch_bytes);
+    g_spool_state.lock = xSemaphoreCreateMutex();
+    g_spool_state.stopped = xSemaphoreCreateBinary();
+    if (!g_spool_state.batch || !g_spool_state.lock || !g_spool_state.stopped) {
+        ESP_LOGE(TAG, "Failed to allocate replay buffer");
+        goto fail;
+    }
+
+    esp_err_t err = recover();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open spool: %s", esp_err_to_name(err));
+        free(g_spool_state.batch);
+        vSemaphoreDelete(g_spool_state.lock);
+        vSemaphoreDelete(g_spool_state.stopped);
+        memset(&g_spool_state, 0, sizeof(g_spool_state));
+        return err;
+    }
+
+    g_spool_state.running = true;
+
+    BaseType_t result = xTaskCreatePinnedToCore(http_spool_task, "http_spool",
+                                                config->task_stack_size, NULL,
+                                                config->task_priority, &g_spool_state.task,
+                                                config->task_core);
+    if (result != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create spool replay task");
+        goto fail;
+    }
+
+    ESP_LOGI(TAG, "Spool initialized: %lu x %lu byte sectors, replay %zu bytes per batch at %zu B/s",
+             (unsigned long)g_spool_state.sector_count, (unsigned long)g_spool_state.sector_size,
+             config->replay_batch_bytes, config->replay_bytes_per_sec);
+    return ESP_OK;
+
+fail:
+    free(g_spool_state.batch);
+    if (g_spool_state.lock) {
+        vSemaphoreDelete(g_spool_state.lock);
+    }
+    if (g_spool_state.stopped) {
+        vSemaphoreDelete(g_spool_state.stopped);
+    }
+    memset(&g_spool_state, 0, sizeof(g_spool_state));
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t http_spool_append(const void *data, size_t len)
+{
+    if (!g_spool_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (!data || len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (len > max_payload() || BATCH_HEADER_SIZE + len > g_spool_state.config.replay_batch_bytes) {
+        g_spool_state.stats.append_errors++;
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    size_t size = ALIGN4(RECORD_HEADER_SIZE + len);
+
+    xSemaphoreTake(g_spool_state.lock, portMAX_DELAY);
+    esp_err_t err = ESP_OK;
+    if (g_spool_state.head.offset + size > g_spool_state.sector_size) {
+        err = advance_head();
+    }
+
+    spool_pos_t pos = g_spool_state.head;
+    record_header_t header = {
+        .state = STATE_WRITTEN,
+        .reserved = 0xFF,
+        .length = len,
+        .sequence = g_spool_state.next_record,
+        .crc = esp_rom_crc32_le(0, data, len),
+    };
+    if (err == ESP_OK) {
+        err = esp_partition_write(g_spool_state.partition, flash_offset(pos), &header, sizeof(header));
+    }
+    if (err == ESP_OK) {
+        spool_pos_t payload = { pos.sector, pos.offset + RECORD_HEADER_SIZE };
+        err = esp_partition_write(g_spool_state.partition, flash_offset(payload), data, len);
+    }
+    if (err == ESP_OK) {
+        uint8_t committed = STATE_COMMITTED;
+        err = esp_partition_write(g_spool_state.partition, flash_offset(pos), &committed, 1);
+    }
+
+    bool wake = false;
+    if (pos_equal(g_spool_state.head, pos)) {
+        if (err == ESP_OK) {
+            g_spool_state.head.offset += size;
+        } else {
+            // A torn record has no length to step over: close the sector, so
+            // readers and recover() stop there and appends go on in the next one
+            g_spool_state.head.offset = g_spool_state.sector_size;
+        }
+    }
+    if (err == ESP_OK) {
+        g_spool_state.next_record++;
+        if (g_spool_state.stats.records_pending == 0) {
+            // The failure that brought this record here is recent; give the link time
+            g_spool_state.next_attempt_ms = now_ms() + g_spool_state.config.retry_interval_ms;
+            wake = true;
+        }
+        g_spool_state.stats.records_pending++;
+        g_spool_state.stats.records_appended++;
+        g_spool_state.stats.bytes_pending += size;
+    } else {
+        g_spool_state.stats.append_errors++;
+    }
+    xSemaphoreGive(g_spool_state.lock);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to append record: %s", esp_err_to_name(err));
+    }
+    if (wake) {
+        xTaskNotifyGive(g_spool_state.task);
+    }
+    return err;
+}
+
+esp_err_t http_spool_kick(void)
+{
+    if (!g_spool_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(g_spool_state.lock, portMAX_DELAY);
+    g_spool_state.next_attempt_ms = 0;
+    xSemaphoreGive(g_spool_state.lock);
+
+    xTaskNotifyGive(g_spool_state.task);
+    return ESP_OK;
+}
+
+int http_spool_pending(void)
+{
+    if (!g_spool_state.running) {
+        return 0;
+    }
+
+    xSemaphoreTake(g_spool_state.lock, portMAX_DELAY);
+    int records = g_spool_state.stats.records_pending;
+    xSemaphoreGive(g_spool_state.lock);
+    return records;
+}
+
+esp_err_t http_spool_get_stats(http_spool_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_spool_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(g_spool_state.lock, portMAX_DELAY);
+    memcpy(stats, &g_spool_state.stats, sizeof(http_spool_stats_t));
+    xSemaphoreGive(g_spool_state.lock);
+    return ESP_OK;
+}
+
+bool http_spool_is_running(void)
+{
+    return g_spool_state.running;
+}
+
+esp_err_t http_spool_deinit(void)
+{
+    if (!g_spool_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(g_spool_state.lock, portMAX_DELAY);
+    g_spool_state.stopping = true;
+    xSemaphoreGive(g_spool_state.lock);
+
+    xTaskNotifyGive(g_spool_state.task);
+    xSemaphoreTake(g_spool_state.stopped, portMAX_DELAY);
+    g_spool_state.running = false;
+
+    free(g_spool_state.batch);
+    vSemaphoreDelete(g_spool_state.lock);
+    vSemaphoreDelete(g_spool_state.stopped);
+    memset(&g_spool_state, 0, sizeof(g_spool_state));
+
+    ESP_LOGI(TAG, "Spool deinitialized");
+    return ESP_OK;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file http_spool.h
+ * @brief Flash Store-and-Forward Spool for the ESP32 HTTP Client
+ *
+ * Records that could not be sent are appended to an append-only log in
+ * a raw flash partition and survive a reboot. A replay task uploads
+ * them in batches, in the http_batch body format, once the server is
+ * reachable again, at a limited rate so the backlog does not crowd out
+ * live traffic.
+ *
+ * Flash layout: the partition is a ring of sectors. Each sector starts
+ * with a header carrying an increasing sequence number, followed by
+ * records written back to back, never across a sector boundary:
+ *
+ *   offset  size  field
+ *        0     1  state (0x7F written, 0x3F committed, 0x1F acknowledged)
+ *        1     1  reserved (0xFF)
+ *        2     2  payload length, little-endian
+ *        4     4  record sequence number
+ *        8     4  CRC-32 of the payload
+ *       12     n  payload, padded to 4 bytes
+ *
+ * State changes only clear bits, so they need no erase. Only the last
+ * record of a delivered batch is marked acknowledged; everything before
+ * it in ring order is delivered too. A reboot rebuilds the head and tail
+ * by scanning the record headers.
+ *
+ * Features:
+ * - O(1) append, sequential writes, each sector erased once per lap
+ * - Oldest sector dropped when the ring is full
+ * - Torn records (power loss while appending) are skipped after reboot
+ * - Replay batch size and byte rate limits
+ *
+ * Batch headers of replayed uploads are those of http_batch.h, plus
+ * X-ESP32-Spool: 1. X-ESP32-Batch-First-Record carries the persistent
+ * record sequence number, so the server can drop duplicates.
+ */
+
+#ifndef HTTP_SPOOL_H
+#define HTTP_SPOOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "esp32_http_client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Flash partition subtype of the spool (data, custom range)
+ */
+#define HTTP_SPOOL_PARTITION_SUBTYPE 0x40
+
+/**
+ * @brief Spool configuration
+ */
+typedef struct {
+    char partition_label[17];   /**< Partition to use (data type, HTTP_SPOOL_PARTITION_SUBTYPE) */
+    char path[128];             /**< Replay target path on the client's host, or a full URL */
+    size_t replay_batch_bytes;  /**< Largest replay request body (also the replay buffer size) */
+    size_t replay_bytes_per_sec; /**< Replay body bytes per second (0 = unlimited) */
+    int retry_interval_ms;      /**< Wait after a failed replay before trying again */
+    int task_priority;          /**< Replay task priority */
+    int task_stack_size;        /**< Replay task stack size */
+    int task_core;              /**< Core to pin the replay task to (tskNO_AFFINITY = any) */
+} http_spool_config_t;
+
+/**
+ * @brief Spool statistics
+ */
+typedef struct {
+    uint32_t records_appended;  /**< Records written to flash */
+    uint32_t records_replayed;  /**< Records delivered by the replay task */
+    uint32_t records_dropped;   /**< Undelivered records lost to the full ring */
+    uint32_t records_pending;   /**< Records waiting for replay */
+    uint32_t records_recovered; /**< Records found pending at startup */
+    uint32_t append_errors;     /**< Appends that failed (flash error, record too large) */
+    uint32_t batches_sent;      /**< Replay requests delivered */
+    uint32_t batches_failed;    /**< Replay requests that failed (records kept) */
+    uint64_t bytes_replayed;    /**< Body bytes of delivered replay requests */
+    uint32_t sectors_erased;    /**< Flash sector erases since startup */
+    size_t bytes_pending;       /**< Flash bytes held by pending records */
+    size_t capacity_bytes;      /**< Usable size of the ring */
+} http_spool_stats_t;
+
+/**
+ * @brief Default spool configuration
+ */
+#define HTTP_SPOOL_CONFIG_DEFAULT() {               \
+    .partition_label = "spool",                     \
+    .path = "/batch",                               \
+    .replay_batch_bytes = 4096,                     \
+    .replay_bytes_per_sec = 8192,                   \
+    .retry_interval_ms = 30000,                     \
+    .task_priority = 3,                             \
+    .task_stack_size = 4096,                        \
+    .task_core = tskNO_AFFINITY                     \
+}
+
+/**
+ * @brief Open the spool partition and start the replay task
+ *
+ * Records left from before a reboot are recovered and replayed. The
+ * replay task sends with the given handle; give it its own.
+ *
+ * @param client Client handle used for replay requests
+ * @param config Spool configuration (NULL = defaults)
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if the partition is missing, ESP_ERR_* on failure
+ */
+esp_err_t http_spool_init(esp32_http_client_handle_t client, const http_spool_config_t *config);
+
+/**
+ * @brief Append one record
+ *
+ * Writes straight to flash; returns once the record is committed.
+ *
+ * @param data Record bytes
+ * @param len Record length (1..HTTP_BATCH_MAX_RECORD, and less than a sector)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_spool_append(const void *data, size_t len);
+
+/**
+ * @brief Start replaying now
+ *
+ * Call when the network comes back; skips the retry wait.
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not initialized
+ */
+esp_err_t http_spool_kick(void);
+
+/**
+ * @brief Get number of records waiting for replay
+ *
+ * @return Pending record count
+ */
+int http_spool_pending(void);
+
+/**
+ * @brief Get spool statistics
+ *
+ * @param stats Pointer to statistics structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t http_spool_get_stats(http_spool_stats_t *stats);
+
+/**
+ * @brief Check if the spool is running
+ *
+ * @return true if initialized, false otherwise
+ */
+bool http_spool_is_running(void);
+
+/**
+ * @brief Stop the replay task
+ *
+ * Pending records stay in flash for the next http_spool_init().
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t http_spool_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_SPOOL_H
@@ -0,0 +1,242 @@
+/**
+ * @file log_ring.c
+ * @brief Deferred Binary Log Ring Implementation
+ *
+ * Writers copy one fixed-size entry under a spinlock; formatting and
+ * printing only happen in the drain task (or log_ring_flush()).
+ */
+
+#include "log_ring.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "LOG_RING";
+
+#if CONFIG_APP_LOG_RING_ENABLE
+#define RING_ENTRIES CONFIG_APP_LOG_RING_ENTRIES
+#define RATE_PER_SEC CONFIG_APP_LOG_RING_RATE
+#else
+#define RING_ENTRIES 4                  /**< Only reached by direct log_ring_write() calls */
+#define RATE_PER_SEC 20
+#endif
+
+#define LINE_MAX 160
+#define RATE_WINDOW_US 1000000          /**< Burst: one second worth of lines */
+
+/**
+ * @brief One stored line
+ */
+typedef struct {
+    uint32_t time_ms;
+    const char *tag;
+    const char *format;
+    uintptr_t args[LOG_RING_MAX_ARGS];
+    uint8_t level;
+} log_entry_t;
+
+/**
+ * @brief Ring state
+ */
+static struct {
+    log_entry_t entries[RING_ENTRIES];
+    uint32_t head;                      /**< Next entry to write */
+    uint32_t tail;                      /**< Next entry to print */
+    int64_t credit_us;                  /**< Rate limit credit; a line costs 1 s / rate */
+    int64_t credit_time_us;             /**< Time the credit was last topped up */
+    log_ring_stats_t stats;
+    uint32_t dropped_reported;          /**< Drops already announced by the drain */
+    log_ring_config_t config;
+    TaskHandle_t task_handle;
+    bool running;
+} g_ring_state = {0};
+
+static portMUX_TYPE s_ring_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Take rate limit credit for one line (lock held)
+ */
+static bool take_credit(int64_t now_us)
+{
+    const int64_t cost_us = RATE_WINDOW_US / RATE_PER_SEC;
+
+    if (g_ring_state.credit_time_us == 0) {
+        g_ring_state.credit_us = RATE_WINDOW_US;
+    } else {
+        g_ring_state.credit_us += now_us - g_ring_state.credit_time_us;
+        if (g_ring_state.credit_us > RATE_WINDOW_US) {
+            g_ring_state.credit_us = RATE_WINDOW_US;
+        }
+    }
+    g_ring_state.credit_time_us = now_us;
+
+    if (g_ring_state.credit_us < cost_us) {
+        return false;
+    }
+    g_ring_state.credit_us -= cost_us;
+    return true;
+}
+
+void log_ring_write(esp_log_level_t level, const char *tag, const char *format, int argc, ...)
+{
+    log_entry_t entry = {
+        .tag = tag,
+        .format = format,
+        .level = (uint8_t)level,
+    };
+
+    va_list args;
+    va_start(args, argc);
+    for (int i = 0; i < argc && i < LOG_RING_MAX_ARGS; i++) {
+        entry.args[i] = va_arg(args, uintptr_t);
+    }
+    va_end(args);
+
+    int64_t now_us = esp_timer_get_time();
+    entry.time_ms = (uint32_t)(now_us / 1000);
+
+    taskENTER_CRITICAL(&s_ring_lock);
+    if (!take_credit(now_us)) {
+        g_ring_state.stats.dropped_rate++;
+    } else if (g_ring_state.head - g_ring_state.tail >= RING_ENTRIES) {
+        // Keep the older lines: they explain how the ring got full
+        g_ring_state.stats.dropped_full++;
+    } else {
+        g_ring_state.entries[g_ring_state.head % RING_ENTRIES] = entry;
+        g_ring_state.head++;
+        g_ring_state.stats.written++;
+    }
+    taskEXIT_CRITICAL(&s_ring_lock);
+}
+
+/**
+ * @brief Level letter as printed by ESP_LOGx
+ */
+static char level_letter(uint8_t level)
+{
+    static const char letters[] = "NEWIDV";
+    return level < sizeof(letters) - 1 ? letters[level] : '?';
+}
+
+/**
+ * @brief Print stored lines until the ring is empty
+ */
+static void drain(void)
+{
+    char line[LINE_MAX];
+    log_entry_t entry;
+
+    while (true) {
+        taskENTER_CRITICAL(&s_ring_lock);
+        bool empty = (g_ring_state.head == g_ring_state.tail);
+        if (!empty) {
+            entry = g_ring_state.entries[g_ring_state.tail % RING_ENTRIES];
+            g_ring_state.tail++;
+            g_ring_state.stats.printed++;
+        }
+        taskEXIT_CRITICAL(&s_ring_lock);
+
+        if (empty) {
+            break;
+        }
+
+        // Every argument is one word, which is what the format expects on this target
+        snprintf(line, sizeof(line), entry.format,
+                 entry.args[0], entry.args[1], entry.args[2], entry.args[3]);
+        esp_log_write((esp_log_level_t)entry.level, entry.tag, "%c (%lu) %s: %s\n",
+                      level_letter(entry.level), (unsigned long)entry.time_ms, entry.tag, line);
+    }
+
+    taskENTER_CRITICAL(&s_ring_lock);
+    uint32_t dropped = g_ring_state.stats.dropped_full + g_ring_state.stats.dropped_rate;
+    uint32_t unreported = dropped - g_ring_state.dropped_reported;
+    g_ring_state.dropped_reported = dropped;
+    taskEXIT_CRITICAL(&s_ring_lock);
+
+    if (unreported > 0) {
+        ESP_LOGW(TAG, "%lu deferred log lines dropped", (unsigned long)unreported);
+    }
+}
+
+/**
+ * @brief Drain task
+ */
+static void log_ring_task(void *pvParameters)
+{
+    while (g_ring_state.running) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(g_ring_state.config.drain_interval_ms));
+        drain();
+    }
+
+    g_ring_state.task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
+esp_err_t log_ring_start(const log_ring_config_t *config)
+{
+    if (g_ring_state.running) {
+        ESP_LOGW(TAG, "Log ring already running");
+        return ESP_OK;
+    }
+
+    log_ring_config_t defaults = LOG_RING_CONFIG_DEFAULT();
+    if (!config) {
+        config = &defaults;
+    }
+
+    if (config->drain_interval_ms <= 0 || config->task_stack_size <= 0) {
+        ESP_LOGE(TAG, "Invalid log ring configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memcpy(&g_ring_state.config, config, sizeof(log_ring_config_t));
+    g_ring_state.running = true;
+
+    BaseType_t result = xTaskCreate(log_ring_task, "log_ring", config->task_stack_size,
+                                    NULL, config->task_priority, &g_ring_state.task_handle);
+    if (result != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create log ring task");
+        g_ring_state.running = false;
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "Log ring started (%d entries, %d lines/s, drained every %d ms)",
+             RING_ENTRIES, RATE_PER_SEC, config->drain_interval_ms);
+    return ESP_OK;
+}
+
+void log_ring_flush(void)
+{
+    drain();
+}
+
+esp_err_t log_ring_get_stats(log_ring_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    taskENTER_CRITICAL(&s_ring_lock);
+    memcpy(stats, &g_ring_state.stats, sizeof(log_ring_stats_t));
+    taskEXIT_CRITICAL(&s_ring_lock);
+    return ESP_OK;
+}
+
+esp_err_t log_ring_stop(void)
+{
+    if (!g_ring_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    g_ring_state.running = false;
+    xTaskNotifyGive(g_ring_state.task_handle);
+    while (g_ring_state.task_handle) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    drain();
+    return ESP_OK;
+}
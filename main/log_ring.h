@@ -0,0 +1,131 @@
+/**
+ * @file log_ring.h
+ * @brief Deferred Binary Log Ring
+ *
+ * Per-request log lines are too slow to print where they happen: once
+ * the UART FIFO is full, a 60 character line at 115200 baud holds the
+ * calling task for about 5 ms. LOG_RING_I() and friends instead store
+ * the format pointer, the tag and up to four arguments in a ring, and a
+ * low priority task formats and prints them later.
+ *
+ * - Levels above the file's LOG_LOCAL_LEVEL compile out, like ESP_LOGx
+ * - A token bucket limits how many lines per second are stored; lines
+ *   over the rate or into a full ring are dropped and counted, and the
+ *   drain task reports how many were lost
+ * - With CONFIG_APP_LOG_RING_ENABLE off the macros are plain ESP_LOGx
+ *
+ * Arguments are stored as machine words, so each one must be an integer
+ * of at most 32 bits or a pointer. Strings (%s) must outlive the drain:
+ * literals and other static strings only, never buffers on the stack.
+ * The format and tag must be static too.
+ */
+
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOG_RING_MAX_ARGS 4
+
+/**
+ * @brief Drain task configuration
+ */
+typedef struct {
+    int drain_interval_ms;      /**< Time between drains */
+    int task_stack_size;        /**< Drain task stack */
+    int task_priority;          /**< Drain task priority, below anything on the request path */
+} log_ring_config_t;
+
+/**
+ * @brief Default drain task configuration
+ */
+#define LOG_RING_CONFIG_DEFAULT() {                         \
+    .drain_interval_ms = CONFIG_APP_LOG_RING_DRAIN_MS,      \
+    .task_stack_size = 3072,                                \
+    .task_priority = 1                                      \
+}
+
+/**
+ * @brief Log ring statistics
+ */
+typedef struct {
+    uint32_t written;           /**< Lines stored */
+    uint32_t printed;           /**< Lines drained */
+    uint32_t dropped_full;      /**< Lines lost because the ring was full */
+    uint32_t dropped_rate;      /**< Lines lost to the rate limit */
+} log_ring_stats_t;
+
+#define LOG_RING_NARGS(...) LOG_RING_NARGS_(0, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+#define LOG_RING_NARGS_(_0, _1, _2, _3, _4, count, ...) count
+
+#if CONFIG_APP_LOG_RING_ENABLE
+#define LOG_RING_LEVEL(level, tag, format, ...) do {                                        \
+        if (LOG_LOCAL_LEVEL >= (level)) {                                                   \
+            log_ring_write((level), (tag), (format), LOG_RING_NARGS(__VA_ARGS__), ##__VA_ARGS__); \
+        }                                                                                   \
+    } while (0)
+#else
+#define LOG_RING_LEVEL(level, tag, format, ...) ESP_LOG_LEVEL_LOCAL(level, tag, format, ##__VA_ARGS__)
+#endif
+
+#define LOG_RING_E(tag, format, ...) LOG_RING_LEVEL(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define LOG_RING_W(tag, format, ...) LOG_RING_LEVEL(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define LOG_RING_I(tag, format, ...) LOG_RING_LEVEL(ESP_LOG_INFO, tag, format, ##__VA_ARGS__)
+#define LOG_RING_D(tag, format, ...) LOG_RING_LEVEL(ESP_LOG_DEBUG, tag, format, ##__VA_ARGS__)
+
+/**
+ * @brief Store a line (use the LOG_RING_x macros)
+ *
+ * Never blocks. Lines written before log_ring_start() are kept and
+ * printed by the first drain.
+ *
+ * @param level Log level
+ * @param tag Static tag
+ * @param format Static printf format
+ * @param argc Number of arguments that follow (at most LOG_RING_MAX_ARGS)
+ */
+void log_ring_write(esp_log_level_t level, const char *tag, const char *format, int argc, ...);
+
+/**
+ * @brief Start the drain task
+ *
+ * @param config Drain configuration (NULL = defaults)
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t log_ring_start(const log_ring_config_t *config);
+
+/**
+ * @brief Print everything stored, in the calling task
+ *
+ * For use before a restart, so the last lines are not lost.
+ */
+void log_ring_flush(void);
+
+/**
+ * @brief Get log ring statistics
+ *
+ * @param stats Pointer to statistics structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t log_ring_get_stats(log_ring_stats_t *stats);
+
+/**
+ * @brief Stop the drain task, printing what is left
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not running
+ */
+esp_err_t log_ring_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOG_RING_H
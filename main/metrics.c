@@ -0,0 +1,287 @@
+/**
+ * @file metrics.c
+ * @brief Metrics Registry Implementation
+ *
+ * The lists only grow, at the tail, under a lock; an export walks them
+ * without one, so a metric registered meanwhile is either seen whole or
+ * not at all.
+ */
+
+#include "metrics.h"
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+
+#define FAMILY_MAX 64
+#define LINE_MAX 192
+
+#define EXPORT_FIRST_OCTAVE 7           /**< First exported bucket ends at 2^8 - 1 us */
+#define EXPORT_LAST_OCTAVE 25           /**< Last finite bucket ends at 2^26 - 1 us (67 s) */
+
+/**
+ * @brief Export in progress
+ */
+struct metrics_writer {
+    metrics_emit_t emit;
+    void *ctx;
+    esp_err_t error;
+    char family[FAMILY_MAX];            /**< Family of the last HELP/TYPE written */
+    char line[LINE_MAX];
+};
+
+/**
+ * @brief Registry
+ */
+static struct {
+    metrics_counter_t *counters;
+    metrics_counter_t *counters_tail;
+    metrics_gauge_t *gauges;
+    metrics_gauge_t *gauges_tail;
+    metrics_histogram_t *histograms;
+    metrics_histogram_t *histograms_tail;
+    metrics_collector_t collectors[METRICS_MAX_COLLECTORS];
+    void *collector_ctx[METRICS_MAX_COLLECTORS];
+    int collector_count;
+} g_metrics_state = {0};
+
+static portMUX_TYPE s_metrics_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Append to a registry list unless already in it (lock held)
+ */
+#define LIST_APPEND(head, tail, item) do {                          \
+        for (__typeof__(item) it = (head); it; it = it->next) {     \
+            if (it == (item)) {                                     \
+                goto done;                                          \
+            }                                                       \
+        }                                                           \
+        (item)->next = NULL;                                        \
+        if (tail) {                                                 \
+            (tail)->next = (item);                                  \
+        } else {                                                    \
+            (head) = (item);                                        \
+        }                                                           \
+        (tail) = (item);                                            \
+    done:;                                                          \
+    } while (0)
+
+void metrics_register_counter(metrics_counter_t *counter)
+{
+    taskENTER_CRITICAL(&s_metrics_lock);
+    LIST_APPEND(g_metrics_state.counters, g_metrics_state.counters_tail, counter);
+    taskEXIT_CRITICAL(&s_metrics_lock);
+}
+
+void metrics_register_gauge(metrics_gauge_t *gauge)
+{
+    taskENTER_CRITICAL(&s_metrics_lock);
+    LIST_APPEND(g_metrics_state.gauges, g_metrics_state.gauges_tail, gauge);
+    taskEXIT_CRITICAL(&s_metrics_lock);
+}
+
+void metrics_register_histogram(metrics_histogram_t *histogram)
+{
+    taskENTER_CRITICAL(&s_metrics_lock);
+    LIST_APPEND(g_metrics_state.histograms, g_metrics_state.histograms_tail, histogram);
+    taskEXIT_CRITICAL(&s_metrics_lock);
+}
+
+esp_err_t metrics_register_collector(metrics_collector_t collector, void *ctx)
+{
+    if (!collector) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_ERR_NO_MEM;
+    taskENTER_CRITICAL(&s_metrics_lock);
+    if (g_metrics_state.collector_count < METRICS_MAX_COLLECTORS) {
+        g_metrics_state.collectors[g_metrics_state.collector_count] = collector;
+        g_metrics_state.collector_ctx[g_metrics_state.collector_count] = ctx;
+        g_metrics_state.collector_count++;
+        ret = ESP_OK;
+    }
+    taskEXIT_CRITICAL(&s_metrics_lock);
+    return ret;
+}
+
+/**
+ * @brief Read a 64-bit slot, retrying if the high word moved meanwhile
+ */
+static uint64_t read_slot(metrics_slot_t *slot)
+{
+    uint32_t hi;
+    uint32_t lo;
+    do {
+        hi = atomic_load_explicit(&slot->hi, memory_order_relaxed);
+        lo = atomic_load_explicit(&slot->lo, memory_order_relaxed);
+    } while (hi != atomic_load_explicit(&slot->hi, memory_order_relaxed));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+/**
+ * @brief Add to a 64-bit slot of the calling core
+ */
+static void add_slot(metrics_slot_t *slot, uint32_t amount)
+{
+    uint32_t before = atomic_fetch_add_explicit(&slot->lo, amount, memory_order_relaxed);
+    if (before + amount < before) {
+        atomic_fetch_add_explicit(&slot->hi, 1, memory_order_relaxed);
+    }
+}
+
+uint64_t metrics_counter_value(metrics_counter_t *counter)
+{
+    uint64_t value = 0;
+    for (int core = 0; core < METRICS_CORES; core++) {
+        value += read_slot(&counter->slots[core]);
+    }
+    return value;
+}
+
+void metrics_histogram_observe(metrics_histogram_t *histogram, uint32_t value_us)
+{
+    int core = xPortGetCoreID();
+    atomic_fetch_add_explicit(&histogram->buckets[core][http_histogram_bucket_index(value_us)], 1,
+                              memory_order_relaxed);
+    add_slot(&histogram->sum_us[core], value_us);
+}
+
+/**
+ * @brief Pass text to the sink, remembering the first error
+ */
+static void emit(metrics_writer_t *writer, const char *text, int len)
+{
+    if (writer->error != ESP_OK || len <= 0) {
+        return;
+    }
+    if (len >= LINE_MAX) {
+        len = LINE_MAX - 1;
+    }
+    writer->error = writer->emit(text, len, writer->ctx);
+}
+
+/**
+ * @brief Write HELP and TYPE unless the previous metric was of the same family
+ */
+static void write_header(metrics_writer_t *writer, const char *name, const char *help, const char *type)
+{
+    size_t family_len = strcspn(name, "{");
+    if (family_len >= FAMILY_MAX) {
+        family_len = FAMILY_MAX - 1;
+    }
+    if (strlen(writer->family) == family_len && strncmp(writer->family, name, family_len) == 0) {
+        return;
+    }
+
+    memcpy(writer->family, name, family_len);
+    writer->family[family_len] = '\0';
+
+    int len = snprintf(writer->line, LINE_MAX, "# HELP %s %s\n# TYPE %s %s\n",
+                       writer->family, help ? help : "", writer->family, type);
+    emit(writer, writer->line, len);
+}
+
+void metrics_write_counter(metrics_writer_t *writer, const char *name, const char *help, uint64_t value)
+{
+    write_header(writer, name, help, "counter");
+    int len = snprintf(writer->line, LINE_MAX, "%s %" PRIu64 "\n", name, value);
+    emit(writer, writer->line, len);
+}
+
+void metrics_write_gauge(metrics_writer_t *writer, const char *name, const char *help, int64_t value)
+{
+    write_header(writer, name, help, "gauge");
+    int len = snprintf(writer->line, LINE_MAX, "%s %" PRId64 "\n", name, value);
+    emit(writer, writer->line, len);
+}
+
+void metrics_write_histogram(metrics_writer_t *writer, const char *name, const char *help,
+                             const http_histogram_t *histogram)
+{
+    write_header(writer, name, help, "histogram");
+
+    // One exported bucket per power of two: cumulative up to the end of each octave
+    uint64_t cumulative = 0;
+    int index = 0;
+    for (int octave = EXPORT_FIRST_OCTAVE; octave <= EXPORT_LAST_OCTAVE; octave++) {
+        int last = HTTP_HISTOGRAM_SUB_BUCKETS * (octave - 1) + HTTP_HISTOGRAM_SUB_BUCKETS - 1;
+        for (; index <= last; index++) {
+            cumulative += histogram->buckets[index];
+        }
+
+        uint32_t upper_us;
+        http_histogram_bucket_range(last, NULL, &upper_us);
+        int len = snprintf(writer->line, LINE_MAX, "%s_bucket{le=\"%" PRIu32 ".%06" PRIu32 "\"} %" PRIu64 "\n",
+                           name, upper_us / 1000000, upper_us % 1000000, cumulative);
+        emit(writer, writer->line, len);
+    }
+
+    int len = snprintf(writer->line, LINE_MAX, "%s_bucket{le=\"+Inf\"} %" PRIu32 "\n%s_sum %" PRIu64 ".%06" PRIu64 "\n%s_count %" PRIu32 "\n",
+                       name, histogram->count, name, histogram->sum_us / 1000000, histogram->sum_us % 1000000,
+                       name, histogram->count);
+    emit(writer, writer->line, len);
+}
+
+/**
+ * @brief Uptime and heap
+ */
+static void collect_system(metrics_writer_t *writer)
+{
+    metrics_write_gauge(writer, "esp_uptime_seconds", "Time since boot", esp_timer_get_time() / 1000000);
+    metrics_write_gauge(writer, "esp_heap_free_bytes", "Free heap", esp_get_free_heap_size());
+    metrics_write_gauge(writer, "esp_heap_min_free_bytes", "Lowest free heap since boot",
+                        esp_get_minimum_free_heap_size());
+    metrics_write_gauge(writer, "esp_heap_largest_free_block_bytes", "Largest allocatable block",
+                        heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+}
+
+esp_err_t metrics_export(metrics_emit_t emit_fn, void *ctx)
+{
+    if (!emit_fn) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    metrics_writer_t writer = {
+        .emit = emit_fn,
+        .ctx = ctx,
+        .error = ESP_OK,
+    };
+
+    collect_system(&writer);
+
+    for (metrics_counter_t *counter = g_metrics_state.counters; counter; counter = counter->next) {
+        metrics_write_counter(&writer, counter->name, counter->help, metrics_counter_value(counter));
+    }
+
+    for (metrics_gauge_t *gauge = g_metrics_state.gauges; gauge; gauge = gauge->next) {
+        metrics_write_gauge(&writer, gauge->name, gauge->help,
+                            atomic_load_explicit(&gauge->value, memory_order_relaxed));
+    }
+
+    // Two scrapes can run at once on different workers: the snapshot is per call
+    http_histogram_t snapshot;
+    for (metrics_histogram_t *histogram = g_metrics_state.histograms; histogram; histogram = histogram->next) {
+        memset(&snapshot, 0, sizeof(snapshot));
+        for (int core = 0; core < METRICS_CORES; core++) {
+            for (int i = 0; i < HTTP_HISTOGRAM_BUCKETS; i++) {
+                uint32_t count = atomic_load_explicit(&histogram->buckets[core][i], memory_order_relaxed);
+                snapshot.buckets[i] += count;
+                snapshot.count += count;
+            }
+            snapshot.sum_us += read_slot(&histogram->sum_us[core]);
+        }
+        metrics_write_histogram(&writer, histogram->name, histogram->help, &snapshot);
+    }
+
+    taskENTER_CRITICAL(&s_metrics_lock);
+    int count = g_metrics_state.collector_count;
+    taskEXIT_CRITICAL(&s_metrics_lock);
+    for (int i = 0; i < count; i++) {
+        g_metrics_state.collectors[i](&writer, g_metrics_state.collector_ctx[i]);
+    }
+
+    return writer.error;
+}
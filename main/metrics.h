@@ -0,0 +1,233 @@
+/**
+ * @file metrics.h
+ * @brief Metrics Registry with Prometheus Text Export
+ *
+ * One registry for everything worth graphing:
+ * - Counters, gauges and histograms owned by a module and updated on its
+ *   hot path. Updates are relaxed atomic adds into a slot of the calling
+ *   core: no lock, no interrupt masking on targets with native atomics,
+ *   and the two cores of an ESP32 never contend for the same word.
+ * - Collectors, called at scrape time, for state that already lives in
+ *   a stats structure (heap, Wi-Fi, application counters).
+ *
+ * metrics_export() writes the Prometheus text format (version 0.0.4);
+ * the device server serves it as GET /metrics.
+ *
+ * Counters are 64 bit, kept as two 32-bit words per core. A scrape that
+ * happens exactly while one of them carries into the high word can read
+ * it 2^32 low once, which Prometheus treats like a counter reset.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "http_histogram.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define METRICS_CORES portNUM_PROCESSORS
+#define METRICS_MAX_COLLECTORS 8
+
+/**
+ * @brief 64-bit count of one core
+ */
+typedef struct {
+    _Atomic uint32_t lo;
+    _Atomic uint32_t hi;
+} metrics_slot_t;
+
+/**
+ * @brief Monotonic counter
+ *
+ * The name may carry labels, e.g. "http_requests_total{result=\"ok\"}";
+ * metrics with the same name before the labels share HELP and TYPE
+ * lines if they are registered next to each other.
+ */
+typedef struct metrics_counter {
+    const char *name;
+    const char *help;
+    metrics_slot_t slots[METRICS_CORES];
+    struct metrics_counter *next;
+} metrics_counter_t;
+
+/**
+ * @brief Gauge (value that goes up and down)
+ */
+typedef struct metrics_gauge {
+    const char *name;
+    const char *help;
+    _Atomic int32_t value;
+    struct metrics_gauge *next;
+} metrics_gauge_t;
+
+/**
+ * @brief Latency histogram in microseconds, exported in seconds
+ *
+ * Uses the buckets of http_histogram.h; the export has one bucket per
+ * power of two from 255 us to 67 s, then +Inf.
+ */
+typedef struct metrics_histogram {
+    const char *name;
+    const char *help;
+    _Atomic uint32_t buckets[METRICS_CORES][HTTP_HISTOGRAM_BUCKETS];
+    metrics_slot_t sum_us[METRICS_CORES];
+    struct metrics_histogram *next;
+} metrics_histogram_t;
+
+/**
+ * @brief Static initializers
+ */
+#define METRICS_COUNTER_INIT(metric_name, metric_help) { .name = (metric_name), .help = (metric_help) }
+#define METRICS_GAUGE_INIT(metric_name, metric_help) { .name = (metric_name), .help = (metric_help) }
+#define METRICS_HISTOGRAM_INIT(metric_name, metric_help) { .name = (metric_name), .help = (metric_help) }
+
+/**
+ * @brief Output of an export, handed to collectors
+ */
+typedef struct metrics_writer metrics_writer_t;
+
+/**
+ * @brief Sink of exported text
+ *
+ * @param text Text (not NUL-terminated)
+ * @param len Length
+ * @param ctx Context given to metrics_export()
+ * @return ESP_OK to go on, anything else stops the export
+ */
+typedef esp_err_t (*metrics_emit_t)(const char *text, size_t len, void *ctx);
+
+/**
+ * @brief Collector called at every export
+ *
+ * @param writer Writer to pass to the metrics_write_*() functions
+ * @param ctx Context given at registration
+ */
+typedef void (*metrics_collector_t)(metrics_writer_t *writer, void *ctx);
+
+/**
+ * @brief Register metrics
+ *
+ * The structures must stay valid for good (static storage). Registering
+ * the same structure twice is a no-op. Registration may run while an
+ * export is in progress.
+ */
+void metrics_register_counter(metrics_counter_t *counter);
+void metrics_register_gauge(metrics_gauge_t *gauge);
+void metrics_register_histogram(metrics_histogram_t *histogram);
+
+/**
+ * @brief Register a collector
+ *
+ * @param collector Function called at export time
+ * @param ctx Passed to the collector
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if all slots are taken
+ */
+esp_err_t metrics_register_collector(metrics_collector_t collector, void *ctx);
+
+/**
+ * @brief Add to a counter
+ */
+static inline void metrics_counter_add(metrics_counter_t *counter, uint32_t amount)
+{
+    metrics_slot_t *slot = &counter->slots[xPortGetCoreID()];
+    uint32_t before = atomic_fetch_add_explicit(&slot->lo, amount, memory_order_relaxed);
+    if (before + amount < before) {
+        atomic_fetch_add_explicit(&slot->hi, 1, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Add one to a counter
+ */
+static inline void metrics_counter_inc(metrics_counter_t *counter)
+{
+    metrics_counter_add(counter, 1);
+}
+
+/**
+ * @brief Set a gauge
+ */
+static inline void metrics_gauge_set(metrics_gauge_t *gauge, int32_t value)
+{
+    atomic_store_explicit(&gauge->value, value, memory_order_relaxed);
+}
+
+/**
+ * @brief Add to a gauge (negative to subtract)
+ */
+static inline void metrics_gauge_add(metrics_gauge_t *gauge, int32_t amount)
+{
+    atomic_fetch_add_explicit(&gauge->value, amount, memory_order_relaxed);
+}
+
+/**
+ * @brief Record one duration
+ *
+ * @param histogram Histogram
+ * @param value_us Duration in microseconds
+ */
+void metrics_histogram_observe(metrics_histogram_t *histogram, uint32_t value_us);
+
+/**
+ * @brief Read a counter (sum of all cores)
+ *
+ * @param counter Counter
+ * @return Current value
+ */
+uint64_t metrics_counter_value(metrics_counter_t *counter);
+
+/**
+ * @brief Write a counter value from a collector
+ *
+ * @param writer Writer
+ * @param name Metric name, with labels if any
+ * @param help Description
+ * @param value Value
+ */
+void metrics_write_counter(metrics_writer_t *writer, const char *name, const char *help, uint64_t value);
+
+/**
+ * @brief Write a gauge value from a collector
+ *
+ * @param writer Writer
+ * @param name Metric name, with labels if any
+ * @param help Description
+ * @param value Value
+ */
+void metrics_write_gauge(metrics_writer_t *writer, const char *name, const char *help, int64_t value);
+
+/**
+ * @brief Write a histogram snapshot from a collector
+ *
+ * @param writer Writer
+ * @param name Metric name, without labels
+ * @param help Description
+ * @param histogram Snapshot in microseconds
+ */
+void metrics_write_histogram(metrics_writer_t *writer, const char *name, const char *help,
+                             const http_histogram_t *histogram);
+
+/**
+ * @brief Export every metric in Prometheus text format
+ *
+ * Includes uptime and heap gauges.
+ *
+ * @param emit Receives the text in pieces
+ * @param ctx Passed to emit
+ * @return ESP_OK on success, the first error of emit otherwise
+ */
+esp_err_t metrics_export(metrics_emit_t emit, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // METRICS_H
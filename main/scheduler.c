@@ -0,0 +1,346 @@
+/**
+ * @file scheduler.c
+ * @brief Periodic Job Scheduler Implementation
+ *
+ * The task sleeps until the earliest due job, runs it outside the lock
+ * and moves it to its next grid slot. Sleeps are rounded up to whole
+ * ticks, so a run starts at most one tick after its due time when the
+ * task is not held up.
+ */
+
+#include "scheduler.h"
+#include <string.h>
+#include <stdio.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "metrics.h"
+
+static const char *TAG = "SCHEDULER";
+
+#define TICK_US (1000000 / configTICK_RATE_HZ)
+
+/**
+ * @brief One scheduled job
+ */
+typedef struct {
+    scheduler_job_config_t config;
+    scheduler_job_stats_t stats;
+    int64_t slot_us;                    /**< Grid slot of the next run */
+    int64_t due_us;                     /**< Slot plus this run's jitter */
+    bool active;
+} scheduler_job_t;
+
+/**
+ * @brief Scheduler state
+ */
+static struct {
+    scheduler_config_t config;
+    scheduler_job_t jobs[SCHEDULER_MAX_JOBS];
+    scheduler_job_id_t running_job;     /**< Job whose callback runs now */
+    bool stopping;
+    bool running;
+    TaskHandle_t task;
+    SemaphoreHandle_t stopped;
+} g_sched_state = { .running_job = SCHEDULER_JOB_NONE };
+
+/* Guards the job table; callbacks run with it released */
+static portMUX_TYPE s_sched_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Due time of a run in the given slot
+ */
+static int64_t due_in_slot(const scheduler_job_t *job, int64_t slot_us)
+{
+    if (job->config.jitter_ms == 0) {
+        return slot_us;
+    }
+    return slot_us + esp_random() % (job->config.jitter_ms * 1000);
+}
+
+/**
+ * @brief Metrics collector: runs, missed deadlines and lateness per job
+ */
+static void collect_metrics(metrics_writer_t *writer, void *ctx)
+{
+    scheduler_job_t jobs[SCHEDULER_MAX_JOBS];
+    taskENTER_CRITICAL(&s_sched_lock);
+    memcpy(jobs, g_sched_state.jobs, sizeof(jobs));
+    taskEXIT_CRITICAL(&s_sched_lock);
+
+    // One loop per family keeps each family's samples together
+    char name[96];
+    const char *help = "Scheduled job runs";
+    for (int i = 0; i < SCHEDULER_MAX_JOBS; i++) {
+        if (jobs[i].active) {
+            snprintf(name, sizeof(name), "scheduler_job_runs_total{job=\"%s\"}", jobs[i].config.name);
+            metrics_write_counter(writer, name, help, jobs[i].stats.runs);
+            help = NULL;
+        }
+    }
+    help = "Grid slots skipped because a run started a period or more late";
+    for (int i = 0; i < SCHEDULER_MAX_JOBS; i++) {
+        if (jobs[i].active) {
+            snprintf(name, sizeof(name), "scheduler_job_missed_total{job=\"%s\"}", jobs[i].config.name);
+            metrics_write_counter(writer, name, help, jobs[i].stats.missed);
+            help = NULL;
+        }
+    }
+    help = "Latest start of a run after its due time";
+    for (int i = 0; i < SCHEDULER_MAX_JOBS; i++) {
+        if (jobs[i].active) {
+            snprintf(name, sizeof(name), "scheduler_job_max_lateness_us{job=\"%s\"}", jobs[i].config.name);
+            metrics_write_gauge(writer, name, help, jobs[i].stats.max_lateness_us);
+            help = NULL;
+        }
+    }
+}
+
+/**
+ * @brief Scheduler task: runs each job when it is due
+ */
+static void scheduler_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "Scheduler started on core %d", xPortGetCoreID());
+
+    while (true) {
+        taskENTER_CRITICAL(&s_sched_lock);
+        if (g_sched_state.stopping) {
+            taskEXIT_CRITICAL(&s_sched_lock);
+            break;
+        }
+
+        int next = SCHEDULER_JOB_NONE;
+        for (int i = 0; i < SCHEDULER_MAX_JOBS; i++) {
+            if (g_sched_state.jobs[i].active &&
+                (next == SCHEDULER_JOB_NONE || g_sched_state.jobs[i].due_us < g_sched_state.jobs[next].due_us)) {
+                next = i;
+            }
+        }
+
+        int64_t now = esp_timer_get_time();
+        if (next != SCHEDULER_JOB_NONE && g_sched_state.jobs[next].due_us <= now) {
+            scheduler_job_t *job = &g_sched_state.jobs[next];
+            int64_t period_us = (int64_t)job->config.period_ms * 1000;
+            int64_t lateness = now - job->due_us;
+
+            // A run a period or more late stands in for the slots it overran
+            int64_t missed = lateness / period_us;
+            job->slot_us += (missed + 1) * period_us;
+            job->due_us = due_in_slot(job, job->slot_us);
+
+            job->stats.runs++;
+            job->stats.missed += missed;
+            job->stats.last_lateness_us = lateness > UINT32_MAX ? UINT32_MAX : (uint32_t)lateness;
+            if (job->stats.last_lateness_us > job->stats.max_lateness_us) {
+                job->stats.max_lateness_us = job->stats.last_lateness_us;
+            }
+
+            scheduler_job_cb_t callback = job->config.callback;
+            void *ctx = job->config.ctx;
+            g_sched_state.running_job = next;
+            taskEXIT_CRITICAL(&s_sched_lock);
+
+            if (missed > 0) {
+                ESP_LOGW(TAG, "Job %s started %lld ms late, %lld runs skipped",
+                         job->config.name, lateness / 1000, missed);
+            }
+            callback(ctx);
+
+            taskENTER_CRITICAL(&s_sched_lock);
+            g_sched_state.running_job = SCHEDULER_JOB_NONE;
+            taskEXIT_CRITICAL(&s_sched_lock);
+            continue;
+        }
+
+        // Rounded up: waking early would only mean sleeping again
+        TickType_t wait = portMAX_DELAY;
+        if (next != SCHEDULER_JOB_NONE) {
+            wait = (g_sched_state.jobs[next].due_us - now + TICK_US - 1) / TICK_US;
+        }
+        taskEXIT_CRITICAL(&s_sched_lock);
+
+        ulTaskNotifyTake(pdTRUE, wait);
+    }
+
+    ESP_LOGI(TAG, "Scheduler stopped");
+    xSemaphoreGive(g_sched_state.stopped);
+    vTaskDelete(NULL);
+}
+
+esp_err_t scheduler_init(const scheduler_config_t *config)
+{
+    if (g_sched_state.running) {
+        return ESP_OK;
+    }
+
+    scheduler_config_t defaults = SCHEDULER_CONFIG_DEFAULT();
+    if (!config) {
+        config = &defaults;
+    }
+
+    if (config->task_stack_size <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(&g_sched_state, 0, sizeof(g_sched_state));
+    memcpy(&g_sched_state.config, config, sizeof(scheduler_config_t));
+    g_sched_state.running_job = SCHEDULER_JOB_NONE;
+
+    g_sched_state.stopped = xSemaphoreCreateBinary();
+    if (!g_sched_state.stopped) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    g_sched_state.running = true;
+
+    BaseType_t result = xTaskCreatePinnedToCore(scheduler_task, "scheduler",
+                                                config->task_stack_size, NULL,
+                                                config->task_priority, &g_sched_state.task,
+                                                config->task_core);
+    if (result != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create scheduler task");
+        vSemaphoreDelete(g_sched_state.stopped);
+        memset(&g_sched_state, 0, sizeof(g_sched_state));
+        g_sched_state.running_job = SCHEDULER_JOB_NONE;
+        return ESP_FAIL;
+    }
+
+    static bool collector_registered = false;
+    if (!collector_registered && metrics_register_collector(collect_metrics, NULL) == ESP_OK) {
+        collector_registered = true;
+    }
+
+    ESP_LOGI(TAG, "Scheduler initialized");
+    return ESP_OK;
+}
+
+esp_err_t scheduler_add_job(const scheduler_job_config_t *job, scheduler_job_id_t *id)
+{
+    if (!job || !job->callback || job->period_ms == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_sched_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    scheduler_job_id_t slot = SCHEDULER_JOB_NONE;
+    taskENTER_CRITICAL(&s_sched_lock);
+    for (int i = 0; i < SCHEDULER_MAX_JOBS; i++) {
+        if (!g_sched_state.jobs[i].active) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot != SCHEDULER_JOB_NONE) {
+        scheduler_job_t *entry = &g_sched_state.jobs[slot];
+        memset(entry, 0, sizeof(scheduler_job_t));
+        memcpy(&entry->config, job, sizeof(scheduler_job_config_t));
+        if (!entry->config.name) {
+            entry->config.name = "job";
+        }
+        // Jitter beyond the period would reorder runs
+        if (entry->config.jitter_ms >= entry->config.period_ms) {
+            entry->config.jitter_ms = entry->config.period_ms - 1;
+        }
+        entry->slot_us = esp_timer_get_time() + (int64_t)job->phase_ms * 1000;
+        entry->due_us = due_in_slot(entry, entry->slot_us);
+        entry->active = true;
+    }
+    taskEXIT_CRITICAL(&s_sched_lock);
+
+    if (slot == SCHEDULER_JOB_NONE) {
+        ESP_LOGE(TAG, "No free job slot for %s", job->name ? job->name : "job");
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (id) {
+        *id = slot;
+    }
+    xTaskNotifyGive(g_sched_state.task);
+
+    ESP_LOGI(TAG, "Job %s every %lu ms (phase %lu ms, jitter %lu ms)",
+             g_sched_state.jobs[slot].config.name, (unsigned long)job->period_ms,
+             (unsigned long)job->phase_ms, (unsigned long)g_sched_state.jobs[slot].config.jitter_ms);
+    return ESP_OK;
+}
+
+esp_err_t scheduler_remove_job(scheduler_job_id_t id)
+{
+    if (id < 0 || id >= SCHEDULER_MAX_JOBS) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    bool own_task = (xTaskGetCurrentTaskHandle() == g_sched_state.task);
+
+    while (true) {
+        taskENTER_CRITICAL(&s_sched_lock);
+        if (!g_sched_state.jobs[id].active) {
+            taskEXIT_CRITICAL(&s_sched_lock);
+            return ESP_ERR_NOT_FOUND;
+        }
+        if (own_task || g_sched_state.running_job != id) {
+            g_sched_state.jobs[id].active = false;
+            taskEXIT_CRITICAL(&s_sched_lock);
+            break;
+        }
+        taskEXIT_CRITICAL(&s_sched_lock);
+
+        // The callback is running on the scheduler task
+        vTaskDelay(1);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t scheduler_get_job_stats(scheduler_job_id_t id, scheduler_job_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (id < 0 || id >= SCHEDULER_MAX_JOBS) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+    taskENTER_CRITICAL(&s_sched_lock);
+    if (g_sched_state.jobs[id].active) {
+        memcpy(stats, &g_sched_state.jobs[id].stats, sizeof(scheduler_job_stats_t));
+        ret = ESP_OK;
+    }
+    taskEXIT_CRITICAL(&s_sched_lock);
+    return ret;
+}
+
+bool scheduler_is_running(void)
+{
+    return g_sched_state.running;
+}
+
+esp_err_t scheduler_deinit(void)
+{
+    if (!g_sched_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    taskENTER_CRITICAL(&s_sched_lock);
+    g_sched_state.stopping = true;
+    taskEXIT_CRITICAL(&s_sched_lock);
+
+    xTaskNotifyGive(g_sched_state.task);
+    xSemaphoreTake(g_sched_state.stopped, portMAX_DELAY);
+    vSemaphoreDelete(g_sched_state.stopped);
+
+    taskENTER_CRITICAL(&s_sched_lock);
+    memset(&g_sched_state, 0, sizeof(g_sched_state));
+    g_sched_state.running_job = SCHEDULER_JOB_NONE;
+    taskEXIT_CRITICAL(&s_sched_lock);
+
+    ESP_LOGI(TAG, "Scheduler deinitialized");
+    return ESP_OK;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file scheduler.h
+ * @brief Periodic Job Scheduler
+ *
+ * Runs periodic jobs on one task at a fixed cadence. Every job has its
+ * own period and phase offset, and its runs are placed on an absolute
+ * grid (start + phase + k * period) measured with esp_timer, so neither
+ * the time a job takes nor any delay of the scheduler accumulates into
+ * drift.
+ *
+ * A run that starts a whole period or more after its slot counts the
+ * slots it overran as missed deadlines; they are skipped, not run in a
+ * burst. With jitter_ms set, each run is moved by a random amount within
+ * [0, jitter_ms) after its grid slot, so a fleet of devices started
+ * together does not hit the server in sync; the grid itself stays fixed.
+ *
+ * Jobs run on the scheduler task and should return quickly: hand work
+ * that may block (HTTP requests) to a queue such as http_async.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SCHEDULER_MAX_JOBS 8
+#define SCHEDULER_JOB_NONE (-1)
+
+/**
+ * @brief Job identifier returned by scheduler_add_job()
+ */
+typedef int scheduler_job_id_t;
+
+/**
+ * @brief Job callback, runs on the scheduler task
+ *
+ * @param ctx User context from the job configuration
+ */
+typedef void (*scheduler_job_cb_t)(void *ctx);
+
+/**
+ * @brief Scheduler configuration
+ */
+typedef struct {
+    int task_priority;          /**< Scheduler task priority */
+    int task_stack_size;        /**< Scheduler task stack size */
+    int task_core;              /**< Core to pin the task to (tskNO_AFFINITY = any) */
+} scheduler_config_t;
+
+/**
+ * @brief Default scheduler configuration
+ */
+#define SCHEDULER_CONFIG_DEFAULT() {                \
+    .task_priority = 5,                             \
+    .task_stack_size = 4096,                        \
+    .task_core = tskNO_AFFINITY                     \
+}
+
+/**
+ * @brief Job configuration
+ */
+typedef struct {
+    const char *name;           /**< Job name for logs and metrics (must stay valid) */
+    uint32_t period_ms;         /**< Time between runs */
+    uint32_t phase_ms;          /**< Delay of the first run after scheduler_add_job() */
+    uint32_t jitter_ms;         /**< Random delay of each run after its slot (0 = exact) */
+    scheduler_job_cb_t callback;
+    void *ctx;                  /**< Passed to the callback */
+} scheduler_job_config_t;
+
+/**
+ * @brief Job statistics
+ */
+typedef struct {
+    uint32_t runs;              /**< Callbacks made */
+    uint32_t missed;            /**< Slots skipped because a run started a period or more late */
+    uint32_t last_lateness_us;  /**< Start of the last run after its due time */
+    uint32_t max_lateness_us;   /**< Latest start seen */
+} scheduler_job_stats_t;
+
+/**
+ * @brief Start the scheduler task
+ *
+ * @param config Scheduler configuration (NULL = defaults)
+ * @return ESP_OK on success (also if already running), ESP_ERR_* on failure
+ */
+esp_err_t scheduler_init(const scheduler_config_t *config);
+
+/**
+ * @brief Add a periodic job
+ *
+ * @param job Job configuration (copied)
+ * @param id Receives the job identifier (optional)
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if SCHEDULER_MAX_JOBS are in use, ESP_ERR_* on failure
+ */
+esp_err_t scheduler_add_job(const scheduler_job_config_t *job, scheduler_job_id_t *id);
+
+/**
+ * @brief Remove a job
+ *
+ * When called from another task while the job runs, this waits for the
+ * run to finish, so the job's context can be released afterwards.
+ *
+ * @param id Job identifier
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND for an unknown job
+ */
+esp_err_t scheduler_remove_job(scheduler_job_id_t id);
+
+/**
+ * @brief Get job statistics
+ *
+ * @param id Job identifier
+ * @param stats Pointer to statistics structure
+ * @return ESP_OK on success, ESP_ERR_* on failure
+ */
+esp_err_t scheduler_get_job_stats(scheduler_job_id_t id, scheduler_job_stats_t *stats);
+
+/**
+ * @brief Check if the scheduler is running
+ *
+ * @return true if initialized, false otherwise
+ */
+bool scheduler_is_running(void);
+
+/**
+ * @brief Stop the scheduler task and drop all jobs
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t scheduler_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SCHEDULER_H
@@ -0,0 +1,365 @@
+/**
+ * @file hello_world_task.c
+ * @brief Hello World Application Task Implementation
+ *
+ * The task owns scheduling only: commands arrive through a FreeRTOS
+ * queue and messages are handed to the http_async worker, so neither
+ * the callers nor this task wait for the network round trip. Auto mode
+ * is a scheduler job of the application, which keeps its cadence.
+ */
+
+// Before any include: levels above CONFIG_HELLO_APP_LOG_LEVEL are compiled out
+#include "sdkconfig.h"
+#define LOG_LOCAL_LEVEL CONFIG_HELLO_APP_LOG_LEVEL
+
+#include "hello_world_task.h"
+#include <string.h>
+#include <stdio.h>
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "hello_world_app.h"
+#include "http_async.h"
+
+static const char *TAG = "HELLO_WORLD_TASK";
+
+#define COMMAND_QUEUE_DEPTH 8
+
+/**
+ * @brief Task command types
+ */
+typedef enum {
+    HW_CMD_SEND = 0,
+    HW_CMD_SEQUENCE,
+    HW_CMD_AUTO_START,
+    HW_CMD_AUTO_STOP,
+    HW_CMD_STOP
+} hw_command_type_t;
+
+/**
+ * @brief Task command
+ */
+typedef struct {
+    hw_command_type_t type;
+    bool has_text;
+    char text[128];
+    int count;
+    int delay_ms;
+} hw_command_t;
+
+/**
+ * @brief Task state
+ */
+static struct {
+    hello_world_task_config_t config;
+    QueueHandle_t commands;
+    TaskHandle_t task_handle;
+    bool running;
+    bool auto_mode;
+    bool owns_async;            /**< http_async was started by this task */
+} g_task_state = {0};
+
+/**
+ * @brief Map the task configuration onto the application configuration
+ */
+static void make_app_config(const hello_world_task_config_t *config, hello_world_config_t *app_config)
+{
+    hello_world_config_t defaults = HELLO_WORLD_CONFIG_DEFAULT();
+    *app_config = defaults;
+
+    strncpy(app_config->target_host, config->target_host, sizeof(app_config->target_host) - 1);
+    app_config->target_port = config->target_port;
+    strncpy(app_config->target_path, config->target_path, sizeof(app_config->target_path) - 1);
+    app_config->include_system_info = config->include_system_info;
+    app_config->include_random_data = config->include_random_data;
+    app_config->message_interval_ms = config->message_interval_ms;
+    app_config->message_jitter_ms = config->message_jitter_ms;
+    app_config->max_retries = config->max_retries;
+}
+
+/**
+ * @brief Queue one message on the async worker
+ */
+static void queue_message(const char *text)
+{
+    esp_err_t ret = hello_world_app_send_custom_message_async(text);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Message not queued: %s", esp_err_to_name(ret));
+    }
+}
+
+/**
+ * @brief Main task loop
+ */
+static void hello_world_task(void *pvParameters)
+{
+    hw_command_t cmd;
+
+    ESP_LOGI(TAG, "🚀 Hello World task started");
+
+    if (g_task_state.auto_mode && hello_world_app_start_auto_mode() != ESP_OK) {
+        g_task_state.auto_mode = false;
+    }
+
+    while (true) {
+        xQueueReceive(g_task_state.commands, &cmd, portMAX_DELAY);
+
+        if (cmd.type == HW_CMD_STOP) {
+            break;
+        }
+
+        switch (cmd.type) {
+            case HW_CMD_SEND:
+                queue_message(cmd.has_text ? cmd.text : NULL);
+                break;
+            case HW_CMD_SEQUENCE: {
+                // Fixed cadence: queueing takes no time on this task anyway. A zero
+                // increment asserts in xTaskDelayUntil(), so wait at least a tick
+                TickType_t period = pdMS_TO_TICKS(cmd.delay_ms) > 0 ? pdMS_TO_TICKS(cmd.delay_ms) : 1;
+                TickType_t last_start = xTaskGetTickCount();
+                for (int i = 0; i < cmd.count; i++) {
+                    char text[64];
+                    snprintf(text, sizeof(text), "Demo sequence message %d of %d", i + 1, cmd.count);
+                    queue_message(text);
+                    if (i < cmd.count - 1) {
+                        xTaskDelayUntil(&last_start, period);
+                    }
+                }
+                break;
+            }
+            case HW_CMD_AUTO_START:
+                if (!g_task_state.auto_mode && hello_world_app_start_auto_mode() == ESP_OK) {
+                    g_task_state.auto_mode = true;
+                }
+                break;
+            case HW_CMD_AUTO_STOP:
+                if (g_task_state.auto_mode) {
+                    hello_world_app_stop_auto_mode();
+                    g_task_state.auto_mode = false;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    ESP_LOGI(TAG, "Hello World task stopped");
+    g_task_state.task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Post a command to the task
+ */
+static esp_err_t post_command(const hw_command_t *cmd)
+{
+    if (!g_task_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (xQueueSend(g_task_state.commands, cmd, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "Command queue full");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t hello_world_task_start(const hello_world_task_config_t *config)
+{
+    if (!config) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (g_task_state.running) {
+        ESP_LOGW(TAG, "Hello World task already running");
+        return ESP_OK;
+    }
+
+    if (config->message_interval_ms <= 0 || config->task_stack_size <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memcpy(&g_task_state.config, config, sizeof(hello_world_task_config_t));
+
+    hello_world_config_t app_config;
+    make_app_config(config, &app_config);
+    esp_err_t ret = hello_world_app_init(&app_config);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    if (config->use_spool) {
+        // Messages still go out without it, undeliverable ones are dropped
+        ret = hello_world_app_start_spool(NULL);
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Flash spool not available: %s", esp_err_to_name(ret));
+        }
+    }
+
+    if (!http_async_is_running()) {
+        ret = http_async_init(NULL);
+        if (ret != ESP_OK) {
+            hello_world_app_deinit();
+            return ret;
+        }
+        g_task_state.owns_async = true;
+    }
+
+    g_task_state.commands = xQueueCreate(COMMAND_QUEUE_DEPTH, sizeof(hw_command_t));
+    if (!g_task_state.commands) {
+        ret = ESP_ERR_NO_MEM;
+        goto fail;
+    }
+
+    g_task_state.auto_mode = config->auto_mode;
+    g_task_state.running = true;
+
+    BaseType_t result = xTaskCreate(hello_world_task, "hello_world", config->task_stack_size,
+                                    NULL, config->task_priority, &g_task_state.task_handle);
+    if (result != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create Hello World task");
+        g_task_state.running = false;
+        vQueueDelete(g_task_state.commands);
+        ret = ESP_FAIL;
+        goto fail;
+    }
+
+    ESP_LOGI(TAG, "Hello World task started (priority %d, stack %d)",
+             config->task_priority, config->task_stack_size);
+    return ESP_OK;
+
+fail:
+    if (g_task_state.owns_async) {
+        http_async_deinit();
+    }
+    hello_world_app_deinit();
+    memset(&g_task_state, 0, sizeof(g_task_state));
+    return ret;
+}
+
+esp_err_t hello_world_task_stop(void)
+{
+    if (!g_task_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    hw_command_t cmd = { .type = HW_CMD_STOP };
+    xQueueSend(g_task_state.commands, &cmd, portMAX_DELAY);
+    g_task_state.running = false;
+
+    // Let the task drain its queue and exit
+    while (g_task_state.task_handle) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    vQueueDelete(g_task_state.commands);
+
+    // Before the worker goes, or the job would fall back to sending inline
+    hello_world_app_stop_auto_mode();
+    if (g_task_state.owns_async) {
+        http_async_deinit();
+    }
+    hello_world_app_deinit();
+
+    memset(&g_task_state, 0, sizeof(g_task_state));
+    return ESP_OK;
+}
+
+esp_err_t hello_world_task_send_message(void)
+{
+    hw_command_t cmd = { .type = HW_CMD_SEND };
+    return post_command(&cmd);
+}
+
+esp_err_t hello_world_task_send_custom_message(const char *custom_message)
+{
+    hw_command_t cmd = { .type = HW_CMD_SEND };
+    if (custom_message) {
+        strncpy(cmd.text, custom_message, sizeof(cmd.text) - 1);
+        cmd.has_text = true;
+    }
+    return post_command(&cmd);
+}
+
+esp_err_t hello_world_task_start_auto_mode(void)
+{
+    hw_command_t cmd = { .type = HW_CMD_AUTO_START };
+    return post_command(&cmd);
+}
+
+esp_err_t hello_world_task_stop_auto_mode(void)
+{
+    hw_command_t cmd = { .type = HW_CMD_AUTO_STOP };
+    return post_command(&cmd);
+}
+
+esp_err_t hello_world_task_send_sequence(int count, int interval_ms)
+{
+    if (count <= 0 || interval_ms < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    hw_command_t cmd = {
+        .type = HW_CMD_SEQUENCE,
+        .count = count,
+        .delay_ms = interval_ms,
+    };
+    return post_command(&cmd);
+}
+
+esp_err_t hello_world_task_get_stats(hello_world_task_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    hello_world_stats_t app_stats;
+    esp_err_t ret = hello_world_app_get_stats(&app_stats);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    stats->messages_sent = app_stats.messages_sent;
+    stats->messages_failed = app_stats.messages_failed;
+    stats->uptime_at_last_message = app_stats.uptime_at_last_message;
+    stats->last_message_time = app_stats.last_message_time;
+    stats->last_response_code = app_stats.last_response_code;
+    return ESP_OK;
+}
+
+esp_err_t hello_world_task_reset_stats(void)
+{
+    return hello_world_app_reset_stats();
+}
+
+esp_err_t hello_world_task_update_config(const hello_world_task_config_t *config)
+{
+    if (!config) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!g_task_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Priority and stack size only take effect on the next start
+    hello_world_config_t app_config;
+    make_app_config(config, &app_config);
+    esp_err_t ret = hello_world_app_update_config(&app_config);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    g_task_state.config.message_interval_ms = config->message_interval_ms;
+    return ESP_OK;
+}
+
+bool hello_world_task_is_running(void)
+{
+    return g_task_state.running;
+}
+
+bool hello_world_task_is_auto_mode(void)
+{
+    return g_task_state.auto_mode;
+}
@@ -27,9 +27,12 @@ typedef struct {
     int target_port;                /**< Target server port */
     char target_path[128];          /**< HTTP endpoint path */
     int message_interval_ms;        /**< Interval between messages */
+    int message_jitter_ms;          /**< Random delay of each auto message after its slot (0 = exact cadence) */
     bool include_system_info;       /**< Include ESP32 system info */
     bool include_random_data;       /**< Include random data */
     bool auto_mode;                 /**< Automatic continuous sending */
+    int max_retries;                /**< Retries of a message that could not be delivered */
+    bool use_spool;                 /**< Keep undelivered messages in flash for replay */
     int task_priority;              /**< Task priority */
     int task_stack_size;            /**< Task stack size */
 } hello_world_task_config_t;
@@ -53,9 +56,12 @@ typedef struct {
     .target_port = 8000,                       \
     .target_path = "/hello",                   \
     .message_interval_ms = 5000,               \
+    .message_jitter_ms = 0,                    \
     .include_system_info = true,               \
     .include_random_data = true,               \
     .auto_mode = false,                        \
+    .max_retries = 3,                          \
+    .use_spool = true,                         \
     .task_priority = 3,                        \
     .task_stack_size = 8192                    \
 }
@@ -97,7 +103,8 @@ esp_err_t hello_world_task_send_custom_message(const char *custom_message);
 /**
  * @brief Start automatic message sending
  * 
- * Starts continuous message sending at configured interval.
+ * Starts continuous message sending at configured interval, on a
+ * fixed cadence kept by the scheduler (see scheduler.h).
  * 
  * @return ESP_OK on success
  */
@@ -114,10 +121,10 @@ esp_err_t hello_world_task_stop_auto_mode(void);
  * @brief Send a sequence of test messages
  * 
  * @param count Number of messages to send
- * @param base_delay_ms Base delay between messages
+ * @param interval_ms Time between the starts of two messages (at least one tick)
  * @return ESP_OK on success
  */
-esp_err_t hello_world_task_send_sequence(int count, int base_delay_ms);
+esp_err_t hello_world_task_send_sequence(int count, int interval_ms);
 
 /**
  * @brief Get task statistics
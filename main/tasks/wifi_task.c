@@ -0,0 +1,361 @@
+/**
+ * @file wifi_task.c
+ * @brief WiFi Management Task Implementation
+ *
+ * The driver reports status changes from the event loop; this task only
+ * gets a notification and reads the driver status, so all connection
+ * decisions and all subscriber callbacks happen here.
+ */
+
+#include "wifi_task.h"
+#include "http_link.h"
+#include "metrics.h"
+#include <string.h>
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "WIFI_TASK";
+
+#define NOTIFY_STATUS       BIT0        /**< Driver status changed */
+#define NOTIFY_RECONNECT    BIT1        /**< wifi_task_reconnect() */
+#define NOTIFY_STOP         BIT2        /**< wifi_task_stop() */
+
+#define MAX_BACKOFF_SHIFT   16
+
+/**
+ * @brief Task state
+ */
+static struct {
+    wifi_task_config_t config;
+    EventGroupHandle_t events;
+    TaskHandle_t task_handle;
+    bool running;
+} g_task_state = {0};
+
+/**
+ * @brief Subscribers, kept across stop and start
+ */
+static struct {
+    wifi_event_callback_t callbacks[WIFI_TASK_MAX_SUBSCRIBERS];
+    int count;
+} g_wifi_subscribers = {0};
+
+static portMUX_TYPE s_subscribers_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Driver callback (event loop task): wake the WiFi task
+ */
+static void on_driver_event(wifi_status_t status, const wifi_info_t *info)
+{
+    TaskHandle_t task = g_task_state.task_handle;
+    if (task) {
+        xTaskNotify(task, NOTIFY_STATUS, eSetBits);
+    }
+}
+
+/**
+ * @brief Tell every subscriber about a connection change
+ */
+static void publish(wifi_status_t status)
+{
+    wifi_event_callback_t callbacks[WIFI_TASK_MAX_SUBSCRIBERS];
+    wifi_info_t info = { 0 };
+
+    if (status == WIFI_STATUS_CONNECTED) {
+        wifi_driver_get_info(&info);
+    }
+
+    taskENTER_CRITICAL(&s_subscribers_lock);
+    int count = g_wifi_subscribers.count;
+    memcpy(callbacks, g_wifi_subscribers.callbacks, sizeof(callbacks));
+    taskEXIT_CRITICAL(&s_subscribers_lock);
+
+    for (int i = 0; i < count; i++) {
+        callbacks[i](status, &info);
+    }
+}
+
+/**
+ * @brief Wait before the next attempt after a run of failures
+ */
+static int backoff_ms(int failures)
+{
+    const wifi_task_config_t *config = &g_task_state.config;
+    if (failures >= config->max_retries) {
+        return config->max_retry_delay_ms;
+    }
+
+    int shift = failures - 1 < MAX_BACKOFF_SHIFT ? failures - 1 : MAX_BACKOFF_SHIFT;
+    int64_t delay = (int64_t)config->retry_delay_ms << shift;
+    return delay < config->max_retry_delay_ms ? (int)delay : config->max_retry_delay_ms;
+}
+
+/**
+ * @brief Metrics collector: connection and link state
+ */
+static void collect_metrics(metrics_writer_t *writer, void *ctx)
+{
+    wifi_info_t info;
+    bool connected = g_task_state.running && wifi_driver_get_info(&info) == ESP_OK;
+
+    metrics_write_gauge(writer, "wifi_connected", "1 while associated with an IP address", connected);
+    if (connected) {
+        metrics_write_gauge(writer, "wifi_rssi_dbm", "Signal strength of the AP", info.rssi);
+    }
+
+    http_link_stats_t link;
+    if (http_link_get_stats(&link) == ESP_OK) {
+        metrics_write_counter(writer, "http_link_downs_total", "Times the link went down", link.downs);
+        metrics_write_counter(writer, "http_link_waits_total", "Requests that waited for the link", link.waits);
+        metrics_write_counter(writer, "http_link_wait_timeouts_total", "Requests that gave up waiting",
+                              link.wait_timeouts);
+        metrics_write_counter(writer, "http_link_down_seconds_total", "Time the link was down",
+                              link.down_time_ms / 1000);
+    }
+}
+
+/**
+ * @brief Main task loop
+ */
+static void wifi_task(void *pvParameters)
+{
+    const wifi_task_config_t *config = &g_task_state.config;
+    bool connected = false;
+    bool attempting = false;            // An attempt is in flight
+    bool retry_scheduled = false;
+    bool gave_up = false;               // Out of retries without auto_reconnect
+    TickType_t retry_at = 0;
+    int failures = 0;
+
+    ESP_LOGI(TAG, "📶 WiFi task started");
+
+    // If this cannot even start, the driver reports FAILED and the retry logic takes over
+    attempting = true;
+    wifi_driver_connect(config->ssid, config->password, on_driver_event);
+
+    while (true) {
+        TickType_t wait = portMAX_DELAY;
+        if (retry_scheduled) {
+            TickType_t now = xTaskGetTickCount();
+            wait = ((int32_t)(retry_at - now) > 0) ? retry_at - now : 0;
+        }
+
+        uint32_t notified = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &notified, wait);
+        if (notified & NOTIFY_STOP) {
+            break;
+        }
+
+        bool attempt_now = false;
+        if (notified & NOTIFY_RECONNECT) {
+            ESP_LOGI(TAG, "Reconnect requested");
+            failures = 0;
+            gave_up = false;
+            attempt_now = true;
+        } else if (retry_scheduled && (int32_t)(retry_at - xTaskGetTickCount()) <= 0) {
+            attempt_now = true;
+        }
+
+        wifi_status_t status = wifi_driver_get_status();
+
+        if ((status == WIFI_STATUS_CONNECTED) != connected) {
+            connected = !connected;
+            if (connected) {
+                ESP_LOGI(TAG, "✅ Connected%s", failures ? " after retries" : "");
+                failures = 0;
+                attempting = false;
+                retry_scheduled = false;
+                gave_up = false;
+                xEventGroupClearBits(g_task_state.events, WIFI_TASK_DISCONNECTED_BIT | WIFI_TASK_FAILED_BIT);
+                xEventGroupSetBits(g_task_state.events, WIFI_TASK_CONNECTED_BIT);
+            } else {
+                ESP_LOGW(TAG, "⚠️ Connection lost");
+                xEventGroupClearBits(g_task_state.events, WIFI_TASK_CONNECTED_BIT);
+                xEventGroupSetBits(g_task_state.events, WIFI_TASK_DISCONNECTED_BIT);
+                // The driver keeps trying on a lost IP; count its outcome as an attempt
+                // so a FAILED after it schedules a retry
+                attempting = true;
+                // A link that just worked is most likely back at once: no delay for this one
+                if (status == WIFI_STATUS_DISCONNECTED && config->auto_reconnect) {
+                    attempt_now = true;
+                }
+            }
+            publish(status);
+        }
+
+        // FAILED with nothing in flight and nothing pending would otherwise wait forever
+        if (status == WIFI_STATUS_FAILED && !attempt_now && (attempting || (!retry_scheduled && !gave_up))) {
+            attempting = false;
+            failures++;
+            if (failures == config->max_retries) {
+                ESP_LOGW(TAG, "❌ %d attempts failed, falling back to a full scan", failures);
+                xEventGroupSetBits(g_task_state.events, WIFI_TASK_FAILED_BIT);
+                wifi_driver_forget_ap();
+            }
+
+            if (failures < config->max_retries || config->auto_reconnect) {
+                int delay = backoff_ms(failures);
+                ESP_LOGI(TAG, "Retrying in %d ms (attempt %d)", delay, failures + 1);
+                retry_at = xTaskGetTickCount() + pdMS_TO_TICKS(delay);
+                retry_scheduled = true;
+            } else {
+                gave_up = true;
+            }
+        }
+
+        if (attempt_now) {
+            retry_scheduled = false;
+            attempting = true;
+            if (wifi_driver_reconnect() != ESP_OK) {
+                // The driver reports FAILED, which schedules the next attempt
+                ESP_LOGW(TAG, "Reconnect attempt could not start");
+            }
+        }
+    }
+
+    ESP_LOGI(TAG, "WiFi task stopped");
+    g_task_state.task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
+esp_err_t wifi_task_start(const wifi_task_config_t *config)
+{
+    if (!config) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (g_task_state.running) {
+        ESP_LOGW(TAG, "WiFi task already running");
+        return ESP_OK;
+    }
+
+    if (strlen(config->ssid) == 0 || config->max_retries <= 0 || config->retry_delay_ms <= 0 ||
+        config->max_retry_delay_ms < config->retry_delay_ms || config->task_stack_size <= 0) {
+        ESP_LOGE(TAG, "Invalid WiFi task configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memcpy(&g_task_state.config, config, sizeof(wifi_task_config_t));
+    g_task_state.config.ssid[sizeof(g_task_state.config.ssid) - 1] = '\0';
+    g_task_state.config.password[sizeof(g_task_state.config.password) - 1] = '\0';
+
+    esp_err_t ret = wifi_driver_init();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    if (strlen(config->static_ip) > 0) {
+        ret = wifi_driver_set_static_ip(config->static_ip, config->gateway, config->netmask,
+                                        strlen(config->dns) > 0 ? config->dns : NULL);
+        if (ret != ESP_OK) {
+            wifi_driver_deinit();
+            return ret;
+        }
+    }
+
+    wifi_driver_set_lease_reuse(config->reuse_lease);
+    wifi_driver_set_power_save(config->power_save, config->listen_interval);
+
+    // Collectors cannot be removed: register once and report disconnected while stopped
+    static bool collector_registered = false;
+    if (!collector_registered && metrics_register_collector(collect_metrics, NULL) == ESP_OK) {
+        collector_registered = true;
+    }
+
+    g_task_state.events = xEventGroupCreate();
+    if (!g_task_state.events) {
+        wifi_driver_deinit();
+        return ESP_ERR_NO_MEM;
+    }
+
+    g_task_state.running = true;
+
+    BaseType_t result = xTaskCreate(wifi_task, "wifi_task", config->task_stack_size,
+                                    NULL, config->task_priority, &g_task_state.task_handle);
+    if (result != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create WiFi task");
+        vEventGroupDelete(g_task_state.events);
+        wifi_driver_deinit();
+        memset(&g_task_state, 0, sizeof(g_task_state));
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "WiFi task started for %s (retry %d..%d ms)", config->ssid,
+             config->retry_delay_ms, config->max_retry_delay_ms);
+    return ESP_OK;
+}
+
+esp_err_t wifi_task_stop(void)
+{
+    if (!g_task_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xTaskNotify(g_task_state.task_handle, NOTIFY_STOP, eSetBits);
+    g_task_state.running = false;
+
+    while (g_task_state.task_handle) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    wifi_driver_disconnect();
+    wifi_driver_deinit();
+    vEventGroupDelete(g_task_state.events);
+
+    memset(&g_task_state, 0, sizeof(g_task_state));
+    return ESP_OK;
+}
+
+EventGroupHandle_t wifi_task_get_event_group(void)
+{
+    return g_task_state.events;
+}
+
+esp_err_t wifi_task_wait_connected(uint32_t timeout_ms)
+{
+    if (!g_task_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    TickType_t ticks = (timeout_ms == portMAX_DELAY) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    EventBits_t bits = xEventGroupWaitBits(g_task_state.events, WIFI_TASK_CONNECTED_BIT,
+                                           pdFALSE, pdTRUE, ticks);
+    return (bits & WIFI_TASK_CONNECTED_BIT) ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+esp_err_t wifi_task_reconnect(void)
+{
+    if (!g_task_state.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xTaskNotify(g_task_state.task_handle, NOTIFY_RECONNECT, eSetBits);
+    return ESP_OK;
+}
+
+esp_err_t wifi_task_subscribe(wifi_event_callback_t callback)
+{
+    if (!callback) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_ERR_NO_MEM;
+    taskENTER_CRITICAL(&s_subscribers_lock);
+    if (g_wifi_subscribers.count < WIFI_TASK_MAX_SUBSCRIBERS) {
+        g_wifi_subscribers.callbacks[g_wifi_subscribers.count++] = callback;
+        ret = ESP_OK;
+    }
+    taskEXIT_CRITICAL(&s_subscribers_lock);
+    return ret;
+}
+
+esp_err_t wifi_task_get_info(wifi_info_t *info)
+{
+    return wifi_driver_get_info(info);
+}
+
+bool wifi_task_is_running(void)
+{
+    return g_task_state.running;
+}
@@ -5,6 +5,15 @@
  * This task handles WiFi connection management, monitoring,
  * and automatic reconnection. It uses the WiFi driver for
  * all hardware operations.
+ *
+ * A lost connection is retried at once; failed attempts back off from
+ * retry_delay_ms, doubling up to max_retry_delay_ms. After max_retries
+ * failed attempts in a row the FAILED bit is set and the cached access
+ * point is forgotten, but with auto_reconnect the task keeps trying.
+ *
+ * Subscribers (wifi_task_subscribe()) hear about every change between
+ * "connected with an IP" and "not connected". They run in this task, in
+ * order, so they can tell the HTTP layer about the link (http_link.h).
  */
 
 #ifndef WIFI_TASK_H
@@ -26,6 +35,8 @@ extern "C" {
 #define WIFI_TASK_DISCONNECTED_BIT  BIT1
 #define WIFI_TASK_FAILED_BIT        BIT2
 
+#define WIFI_TASK_MAX_SUBSCRIBERS   4
+
 /**
  * @brief WiFi task configuration
  */
@@ -33,8 +44,16 @@ typedef struct {
     char ssid[32];
     char password[64];
     int max_retries;
-    int retry_delay_ms;
+    int retry_delay_ms;             /**< Wait after the first failed attempt */
+    int max_retry_delay_ms;         /**< Longest wait between attempts */
     bool auto_reconnect;
+    char static_ip[16];             /**< Static address, empty = DHCP */
+    char gateway[16];
+    char netmask[16];
+    char dns[16];                   /**< Empty = gateway */
+    bool reuse_lease;               /**< Apply the last DHCP lease statically (see wifi_driver_set_lease_reuse()) */
+    wifi_ps_type_t power_save;      /**< Modem sleep mode (see wifi_driver_set_power_save()) */
+    uint16_t listen_interval;       /**< Beacon intervals between wakes in max modem sleep (0 = default) */
     int task_priority;
     int task_stack_size;
 } wifi_task_config_t;
@@ -47,7 +66,15 @@ typedef struct {
     .password = "",                            \
     .max_retries = 10,                         \
     .retry_delay_ms = 2000,                    \
+    .max_retry_delay_ms = 30000,               \
     .auto_reconnect = true,                    \
+    .static_ip = "",                           \
+    .gateway = "",                             \
+    .netmask = "",                             \
+    .dns = "",                                 \
+    .reuse_lease = false,                      \
+    .power_save = WIFI_PS_MIN_MODEM,           \
+    .listen_interval = 0,                      \
     .task_priority = 5,                        \
     .task_stack_size = 4096                    \
 }
@@ -97,6 +124,18 @@ esp_err_t wifi_task_wait_connected(uint32_t timeout_ms);
  */
 esp_err_t wifi_task_reconnect(void);
 
+/**
+ * @brief Subscribe to connection changes
+ *
+ * The callback runs in the WiFi task with WIFI_STATUS_CONNECTED when an
+ * IP is available and with another status when it is lost. Subscribe
+ * before wifi_task_start() to also see the first connection.
+ *
+ * @param callback Function to call
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if all slots are taken
+ */
+esp_err_t wifi_task_subscribe(wifi_event_callback_t callback);
+
 /**
  * @brief Get current WiFi connection info
  * 
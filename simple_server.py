@@ -5,21 +5,191 @@ Run with: python simple_server.py
 """
 
 from http.server import HTTPServer, BaseHTTPRequestHandler
+import gzip
 import json
+import struct
+import zlib
 from datetime import datetime
 
 
+HELLO_RECORD_CONTENT_TYPE = 'application/x-esp32-hello'
+HELLO_RECORD_MAGIC = b'HW'
+HELLO_RECORD_V1 = struct.Struct('<2sBBIIIIIIHIIHH')
+HELLO_FLAG_SYSTEM_INFO = 1 << 0
+HELLO_FLAG_RANDOM_DATA = 1 << 1
+HELLO_FLAG_CUSTOM_TEXT = 1 << 2
+
+
+def decode_hello_record(data):
+    """Decode a binary Hello World record (see main/hello_world_record.h).
+
+    Returns a dict of the fields that are present.
+    """
+    if len(data) < HELLO_RECORD_V1.size or data[:2] != HELLO_RECORD_MAGIC:
+        raise ValueError("not a Hello World record")
+    (_, version, flags, number, uptime_ms, verification, msg_hash,
+     free_heap, min_free_heap, port, random_value, squared, sum_formula,
+     text_len) = HELLO_RECORD_V1.unpack_from(data)
+    if version < 1:
+        raise ValueError(f"unsupported record version {version}")
+
+    # Later versions only append fields: the text follows their longer header
+    header_size = HELLO_RECORD_V1.size
+    record = {
+        'version': version,
+        'message_number': number,
+        'uptime_ms': uptime_ms,
+        'verification': verification,
+        'hash': msg_hash,
+    }
+    if flags & HELLO_FLAG_SYSTEM_INFO:
+        record.update(free_heap=free_heap, min_free_heap=min_free_heap,
+                      target_port=port)
+    if flags & HELLO_FLAG_RANDOM_DATA:
+        record.update(random_value=random_value, counter_squared=squared,
+                      sum_formula=sum_formula)
+    if flags & HELLO_FLAG_CUSTOM_TEXT:
+        text = data[len(data) - text_len:] if version > 1 else \
+            data[header_size:header_size + text_len]
+        record['custom_text'] = text.decode('utf-8', errors='replace')
+    return record
+
+
+def format_hello_record(record):
+    return ' '.join(f"{key}={value}" for key, value in record.items())
+
+
+def decode_content_encoding(body, encoding):
+    """Undo a gzip or deflate Content-Encoding
+
+    Returns None for an encoding this server does not know and raises
+    ValueError for a corrupt body.
+    """
+    encoding = encoding.strip().lower()
+    try:
+        if encoding in ('gzip', 'x-gzip'):
+            return gzip.decompress(body)
+        if encoding == 'deflate':
+            return zlib.decompress(body)
+    except (OSError, EOFError, zlib.error) as e:
+        raise ValueError(f"corrupt {encoding} body: {e}")
+    if encoding in ('', 'identity'):
+        return body
+    return None
+
+
+def read_request_body(rfile, headers):
+    """Read a request body, with Content-Length or chunked encoding"""
+    if 'chunked' in headers.get('Transfer-Encoding', '').lower():
+        chunks = []
+        while True:
+            size = int(rfile.readline().split(b';')[0].strip(), 16)
+            if size == 0:
+                rfile.readline()  # blank line after the last chunk
+                return b''.join(chunks)
+            chunks.append(rfile.read(size))
+            rfile.readline()  # CRLF after each chunk
+
+    content_length = int(headers.get('Content-Length', 0))
+    return rfile.read(content_length)
+
+
+def split_batch(body):
+    """Split an application/x-esp32-batch body into its records.
+
+    Each record is a 2-byte little-endian length followed by the record bytes.
+    """
+    records = []
+    offset = 0
+    while offset + 2 <= len(body):
+        (length,) = struct.unpack_from('<H', body, offset)
+        offset += 2
+        records.append(body[offset:offset + length])
+        offset += length
+    if offset != len(body):
+        raise ValueError(f"truncated batch: {len(body) - offset} stray bytes")
+    return records
+
+
 class ESP32RequestHandler(BaseHTTPRequestHandler):
     message_count = 0  # Class variable to track total messages
 
+    def read_body(self):
+        return read_request_body(self.rfile, self.headers)
+
+    def handle_batch(self, body):
+        first_record = int(self.headers.get('X-ESP32-Batch-First-Record', 0))
+        sequence = self.headers.get('X-ESP32-Batch-Sequence', 'N/A')
+        try:
+            records = split_batch(body)
+        except ValueError as e:
+            print(f"❌ Bad batch #{sequence}: {e}")
+            self.send_response(400)
+            self.end_headers()
+            return
+
+        expected = int(self.headers.get('X-ESP32-Batch-Records', len(records)))
+        ESP32RequestHandler.message_count += len(records)
+
+        timestamp = datetime.now().strftime("%Y-%m-%d %H:%M:%S.%f")[:-3]
+        # Replayed from the device's flash spool: records were queued while offline
+        label = "REPLAYED BATCH" if self.headers.get('X-ESP32-Spool') == '1' else "BATCH"
+        print(f"\n📦 ESP32 {label} #{sequence} - {len(records)} records "
+              f"({len(body)} bytes) from {self.client_address[0]} - {timestamp}")
+        if expected != len(records):
+            print(f"   ⚠️  Header announced {expected} records")
+        for index, record in enumerate(records):
+            if record[:2] == HELLO_RECORD_MAGIC:
+                text = format_hello_record(decode_hello_record(record))
+            else:
+                text = record.decode('utf-8', errors='replace')
+            print(f"   [{first_record + index}] {text}")
+
+        self.send_response(200)
+        self.send_header('Content-type', 'text/plain')
+        self.end_headers()
+        self.wfile.write(f"✅ Batch #{sequence}: {len(records)} records received\n".encode('utf-8'))
+
     def do_POST(self):
-        ESP32RequestHandler.message_count += 1
+        body = self.read_body()
 
-        # Get the content length
-        content_length = int(self.headers.get('Content-Length', 0))
+        encoding = self.headers.get('Content-Encoding', '')
+        if encoding:
+            wire_length = len(body)
+            try:
+                body = decode_content_encoding(body, encoding)
+            except ValueError as e:
+                print(f"❌ Bad request body: {e}")
+                self.send_response(400)
+                self.end_headers()
+                return
+            if body is None:
+                print(f"❌ Unsupported Content-Encoding: {encoding}")
+                self.send_response(415)
+                self.end_headers()
+                return
+            ratio = 100 * wire_length // len(body) if body else 100
+            print(f"\n🗜️  {encoding} body: {wire_length} -> {len(body)} bytes ({ratio}% on the wire)")
+
+        if 'X-ESP32-Batch-Records' in self.headers:
+            self.handle_batch(body)
+            return
+
+        ESP32RequestHandler.message_count += 1
 
-        # Read the POST data
-        post_data = self.rfile.read(content_length).decode('utf-8')
+        # Binary records carry the values only; show them as text below
+        if self.headers.get('Content-Type', '').startswith(HELLO_RECORD_CONTENT_TYPE):
+            try:
+                record = decode_hello_record(body)
+            except ValueError as e:
+                print(f"❌ Bad binary record: {e}")
+                self.send_response(400)
+                self.end_headers()
+                return
+            print(f"\n🔣 Binary record ({len(body)} bytes): {format_hello_record(record)}")
+            post_data = '\n'.join(f"{key}: {value}" for key, value in record.items())
+        else:
+            post_data = body.decode('utf-8', errors='replace')
 
         # Extract ESP32 custom headers
         esp32_counter = self.headers.get('X-ESP32-Message-Counter', 'N/A')